@@ -12,6 +12,8 @@ import android.media.ImageReader;
 import android.os.Build;
 import android.os.Handler;
 import android.os.HandlerThread;
+import android.os.SystemClock;
+import android.os.Trace;
 import android.os.Environment;
 import android.util.Log;
 import android.util.SizeF;
@@ -35,26 +37,103 @@ public class Camera2Helper {
     
     private Context context;
     private CameraManager cameraManager;
-    private CameraDevice cameraDevice;
-    private CameraCaptureSession captureSession;
+    // Written on backgroundHandler, read by pause/resume on the game thread
+    private volatile CameraDevice cameraDevice;
+    private volatile CameraCaptureSession captureSession;
     private ImageReader imageReader;
     private HandlerThread backgroundThread;
     private Handler backgroundHandler;
     
-    // Frame data storage
-    private byte[] latestFrameData;
-    private int frameWidth = 1280;
-    private int frameHeight = 960;
+    // Grayscale fallback buffers, reused across frames (native copies onFrameAvailable's array before returning)
+    private byte[] grayscaleLuma;
+    private byte[] grayscaleRow;
+    private byte[] grayscaleRgba;
+    private static final int DEFAULT_FRAME_WIDTH = 1280;
+    private static final int DEFAULT_FRAME_HEIGHT = 960;
+    private int frameWidth = DEFAULT_FRAME_WIDTH;
+    private int frameHeight = DEFAULT_FRAME_HEIGHT;
     private boolean isCapturing = false;
+
+    // Paused: repeating request stopped, device, session, readers and threads kept for a fast resume
+    private static final int RESUME_FAILED = 0;
+    private static final int RESUME_WARM_SESSION = 1;
+    private static final int RESUME_REOPEN = 2;
+    private volatile boolean isPaused = false;
+
+    // ImageReader queue configuration (set from native before startCamera)
+    private int maxImages = 2;
+    private boolean inOrderConsumption = false;
+    private final FrameDropTracker dropTracker = new FrameDropTracker();
+
+    // Manual capture controls: written from the game thread, applied at most once per frame on backgroundHandler
+    private volatile CaptureControls pendingControls = new CaptureControls();
+    private CaptureControls appliedControls;
+    // AF lock as the HAL holds it: CONTROL_AF_TRIGGER_START sent and not cancelled yet (backgroundHandler only)
+    private boolean afTriggerLocked = false;
+    private CameraCharacteristics cameraCharacteristics;
+    // From cameraCharacteristics: AE_MODE_OFF and manual sensor values need MANUAL_SENSOR; -1 = fixed focus
+    private boolean manualSensorSupported = false;
+    private int lockableAfMode = -1;
+
+    // High-speed request from native and the AE target FPS range the session runs at
+    private boolean highSpeedRequested = false;
+    private int highSpeedTargetFps = 120;
+    private android.util.Range<Integer> sessionFpsRange;
+
+    // Extra output surfaces next to the display stream (stream id 0)
+    private static final int DISPLAY_STREAM_ID = 0;
+    private final java.util.ArrayList<AnalysisStream> analysisStreams = new java.util.ArrayList<AnalysisStream>();
+
+    // Last Image.getDataSpace() of the display stream; native picks the YUV matrix/range from it
+    private int lastDataSpace = -1;
+
+    // Full-resolution still output (opt-in from native before startCamera). Its reader runs on its own thread
+    // so copying a large image never delays the preview callbacks on backgroundHandler.
+    private static final int STILL_FORMAT_JPEG = 0;
+    private static final int STILL_FORMAT_YUV = 1;
+    private boolean stillRequested = false;
+    private int stillFormat = STILL_FORMAT_JPEG;
+    private int stillRequestedWidth, stillRequestedHeight;
+    private int stillJpegQuality = 95;
+    private ImageReader stillReader;
+    private HandlerThread stillThread;
+    private Handler stillHandler;
+    // Request id by sensor timestamp: written in onCaptureStarted (backgroundHandler), read by the still reader
+    private final java.util.HashMap<Long, Integer> stillRequestIds = new java.util.HashMap<Long, Integer>();
+
+    // Per-frame paths log at most once per interval; stage timing lives in the native Camera2 trace channel
+    private static final long FRAME_LOG_INTERVAL_MS = 5000;
+    private long lastFrameLogMs = -FRAME_LOG_INTERVAL_MS;
+    private long suppressedFrameLogs = 0;
     
     // Native callback
-    private static native void onFrameAvailable(byte[] data, int width, int height);
+    private static native void onFrameAvailable(byte[] data, int width, int height, long timestampNs);
     private static native void onIntrinsicsAvailable(float fx, float fy, float cx, float cy, float skew, int width, int height);
     private static native void onDistortionAvailable(float[] coeffs, int length);
     private static native void onOriginalResolutionAvailable(int width, int height);
     private static native void onPixelArraySizeAvailable(int width, int height);
-    private static native void onActiveArraySizeAvailable(int width, int height);
+    private static native void onActiveArraySizeAvailable(int left, int top, int width, int height,
+            int preCorrectionLeft, int preCorrectionTop, int preCorrectionWidth, int preCorrectionHeight);
     private static native void onCharacteristicsDumpAvailable(String json);
+    private static native void onFrameStatsAvailable(long capturesCompleted, long framesDelivered, long queueDrops,
+                                                     long sensorDrops, long buffersLost, int maxImages, boolean inOrder);
+    private static native void onYuvFrameAvailable(int streamId, ByteBuffer y, ByteBuffer u, ByteBuffer v, int width, int height,
+                                                   int yRowStride, int uvRowStride, int uvPixelStride, long timestampNs);
+    private static native void onStreamSizeSelected(int width, int height, int targetFps);
+    private static native void onSessionConfigured(boolean highSpeed, int targetFps);
+    private static native void onStreamDataSpaceChanged(int streamId, int dataSpace);
+    private static native void onAnalysisStreamConfigured(int streamId, int width, int height, boolean lumaOnly, boolean accepted);
+    private static native void onSessionConfigureFailed();
+    private static native void onSensorClockSample(long sensorTimestampNs);
+    private static native void onSensorTimestampSourceAvailable(int source);
+    private static native void onStillCaptureConfigured(boolean accepted, int format, int width, int height);
+    private static native void onStillCaptureCompleted(int requestId, long sensorTimestampNs);
+    private static native void onStillCaptureFailed(int requestId);
+    private static native void onStillImageAvailable(int requestId, int format, ByteBuffer y, ByteBuffer u, ByteBuffer v,
+        int dataOffset, int dataLength, int width, int height, int yRowStride, int uvRowStride, int uvPixelStride, long timestampNs);
+    private static native void onCaptureMetadataAvailable(long frameNumber, long sensorTimestampNs, long exposureTimeNs,
+                                                          int sensitivity, long frameDurationNs, int aeState, int afState,
+                                                          float focusDistance, long rollingShutterSkewNs);
     
     private Camera2Helper(Context ctx) {
         this.context = ctx;
@@ -95,6 +174,66 @@ public class Camera2Helper {
         }
     }
     
+    // Configure ImageReader depth and drain mode; takes effect on the next startCamera
+    public void configureImageQueue(int maxImages, boolean inOrder) {
+        int minImages = inOrder ? 1 : 2; // acquireLatestImage needs a spare buffer to skip to
+        this.maxImages = Math.max(minImages, Math.min(16, maxImages));
+        this.inOrderConsumption = inOrder;
+        Log.d(TAG, "Image queue configured: maxImages=" + this.maxImages + " inOrder=" + inOrder);
+    }
+
+    // Opt into the highest fixed frame rate for the next startCamera
+    public void configureHighSpeed(boolean enable, int targetFps) {
+        highSpeedRequested = enable;
+        highSpeedTargetFps = targetFps;
+        Log.d(TAG, "High-speed configured: enable=" + enable + " targetFps=" + targetFps);
+    }
+
+    /**
+     * Pick the stream size and FPS range before any reader is created, so native sizes its pipeline for the
+     * session that actually runs. Constrained high-speed sessions accept only preview and video-encoder
+     * surfaces; every output here is a CPU-readable ImageReader, so a high-speed request runs a regular
+     * session at the highest fixed AE target range instead, with the analysis and still outputs kept.
+     */
+    private void selectStreamConfiguration(CameraCharacteristics cc) {
+        frameWidth = DEFAULT_FRAME_WIDTH;
+        frameHeight = DEFAULT_FRAME_HEIGHT;
+        sessionFpsRange = null;
+
+        if (highSpeedRequested) {
+            if (hasCapability(cc, CameraCharacteristics.REQUEST_AVAILABLE_CAPABILITIES_CONSTRAINED_HIGH_SPEED_VIDEO)) {
+                Log.w(TAG, "CONSTRAINED_HIGH_SPEED_VIDEO needs preview/encoder surfaces, not the YUV readers; "
+                    + "using a regular session at the highest fixed AE FPS range");
+            }
+            sessionFpsRange = highestFixedAeFpsRange(cc);
+            Log.d(TAG, "High-speed request (target " + highSpeedTargetFps + " fps) runs at " + sessionFpsRange);
+        }
+
+        int targetFps = sessionFpsRange != null ? sessionFpsRange.getUpper() : 30;
+        onStreamSizeSelected(frameWidth, frameHeight, targetFps);
+    }
+
+    /**
+     * Highest fixed (lower == upper) AE target range, so AE cannot lower the frame rate in dim light.
+     * Devices without a fixed range get the range with the highest upper bound and the narrowest span.
+     */
+    private static android.util.Range<Integer> highestFixedAeFpsRange(CameraCharacteristics cc) {
+        android.util.Range<Integer>[] ranges = cc.get(CameraCharacteristics.CONTROL_AE_AVAILABLE_TARGET_FPS_RANGES);
+        android.util.Range<Integer> best = null;
+        if (ranges != null) {
+            for (android.util.Range<Integer> range : ranges) {
+                boolean fixed = range.getLower().equals(range.getUpper());
+                boolean bestFixed = best != null && best.getLower().equals(best.getUpper());
+                if (best == null || (fixed && !bestFixed)
+                    || (fixed == bestFixed && (range.getUpper() > best.getUpper()
+                        || (range.getUpper().equals(best.getUpper()) && range.getLower() > best.getLower())))) {
+                    best = range;
+                }
+            }
+        }
+        return best;
+    }
+
     public boolean startCamera() {
         Log.d(TAG, ">>> startCamera called");
         try {
@@ -219,10 +358,21 @@ public class Camera2Helper {
             this.currentCameraId = cameraId;
             // Trigger an immediate dump of characteristics for this camera
             try { dumpCameraCharacteristics(); } catch (Exception e) { Log.w(TAG, "Auto dump failed: " + e.getMessage()); }
+
+            // Stream size must be known before intrinsics are scaled and the ImageReader is created
+            selectStreamConfiguration(cameraManager.getCameraCharacteristics(cameraId));
             
             // Query intrinsics for selected camera (if available)
             try {
                 CameraCharacteristics cc = cameraManager.getCameraCharacteristics(cameraId);
+                cameraCharacteristics = cc;
+                manualSensorSupported = hasCapability(cc, CameraCharacteristics.REQUEST_AVAILABLE_CAPABILITIES_MANUAL_SENSOR);
+                lockableAfMode = chooseLockableAfMode(cc);
+
+                // SENSOR_TIMESTAMP clock domain varies by device; native maps it to engine time either way
+                Integer timestampSource = cc.get(CameraCharacteristics.SENSOR_INFO_TIMESTAMP_SOURCE);
+                onSensorTimestampSourceAvailable(timestampSource != null ? timestampSource : -1);
+
                 float[] intr = cc.get(CameraCharacteristics.LENS_INTRINSIC_CALIBRATION);
                 float fx = 0, fy = 0, cx = 0, cy = 0, skew = 0;
                 if (intr != null && intr.length >= 4) {
@@ -233,6 +383,16 @@ public class Camera2Helper {
                     Log.w(TAG, "LENS_INTRINSIC_CALIBRATION not available or too short");
                 }
 
+                // Intrinsics are in pre-correction active array pixels; streams crop the active array
+                android.graphics.Rect active = cc.get(CameraCharacteristics.SENSOR_INFO_ACTIVE_ARRAY_SIZE);
+                android.graphics.Rect preCorrection = null;
+                if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.M) {
+                    preCorrection = cc.get(CameraCharacteristics.SENSOR_INFO_PRE_CORRECTION_ACTIVE_ARRAY_SIZE);
+                }
+                if (preCorrection == null) {
+                    preCorrection = active;
+                }
+
                 // Also try focal lengths in pixels if available
                 float[] focalLengthsMm = cc.get(CameraCharacteristics.LENS_INFO_AVAILABLE_FOCAL_LENGTHS);
                 SizeF sensorSizeMm = cc.get(CameraCharacteristics.SENSOR_INFO_PHYSICAL_SIZE);
@@ -245,8 +405,8 @@ public class Camera2Helper {
                     float pixelsPerMmY = pixelArrayH / sensorSizeMm.getHeight();
                     fx = focalLengthsMm[0] * pixelsPerMmX;
                     fy = focalLengthsMm[0] * pixelsPerMmY;
-                    cx = pixelArrayW * 0.5f;
-                    cy = pixelArrayH * 0.5f;
+                    cx = preCorrection != null ? preCorrection.width() * 0.5f : pixelArrayW * 0.5f;
+                    cy = preCorrection != null ? preCorrection.height() * 0.5f : pixelArrayH * 0.5f;
                     Log.d(TAG, "Derived intrinsics from focal length: fx="+fx+" fy="+fy+" cx="+cx+" cy="+cy);
                 }
 
@@ -264,18 +424,16 @@ public class Camera2Helper {
                     Log.w(TAG, "SENSOR_INFO_PIXEL_ARRAY_SIZE unavailable: " + e.getMessage());
                 }
 
-                if (srcW == 0 || srcH == 0) {
-                    try {
-                        android.graphics.Rect active = cc.get(CameraCharacteristics.SENSOR_INFO_ACTIVE_ARRAY_SIZE);
-                        if (active != null) {
-                            srcW = active.width();
-                            srcH = active.height();
-                            Log.d(TAG, "Active array size: " + srcW + "x" + srcH);
-                            onActiveArraySizeAvailable(srcW, srcH);
-                        }
-                    } catch (Exception e) {
-                        Log.w(TAG, "ACTIVE_ARRAY_SIZE unavailable: " + e.getMessage());
+                if (active != null) {
+                    Log.d(TAG, "Active array: " + active + ", pre-correction: " + preCorrection);
+                    onActiveArraySizeAvailable(active.left, active.top, active.width(), active.height(),
+                            preCorrection.left, preCorrection.top, preCorrection.width(), preCorrection.height());
+                    if (srcW == 0 || srcH == 0) {
+                        srcW = active.width();
+                        srcH = active.height();
                     }
+                } else {
+                    Log.w(TAG, "ACTIVE_ARRAY_SIZE unavailable");
                 }
 
                 if (srcW > 0 && srcH > 0) {
@@ -314,8 +472,10 @@ public class Camera2Helper {
                     Log.d(TAG, "No distortion array available on this device");
                 }
 
-                Intr kStream = intrinsicsForStream(fx, fy, cx, cy, srcW, srcH, frameWidth, frameHeight);
-                onIntrinsicsAvailable(fx, fy, cx, cy, skew, frameWidth, frameHeight);
+                // Sensor-space calibration; native derives each stream's intrinsics from it and the arrays above
+                int calibW = preCorrection != null ? preCorrection.width() : srcW;
+                int calibH = preCorrection != null ? preCorrection.height() : srcH;
+                onIntrinsicsAvailable(fx, fy, cx, cy, skew, calibW, calibH);
 
                 onOriginalResolutionAvailable(srcW, srcH); // keep sending this if your native side logs it
 
@@ -326,56 +486,44 @@ public class Camera2Helper {
             
 
             // Setup ImageReader for camera frames
-            Log.d(TAG, "Creating ImageReader " + frameWidth + "x" + frameHeight);
+            Log.d(TAG, "Creating ImageReader " + frameWidth + "x" + frameHeight +
+                  " maxImages=" + maxImages + " inOrder=" + inOrderConsumption);
             imageReader = ImageReader.newInstance(frameWidth, frameHeight, 
-                ImageFormat.YUV_420_888, 2);
+                ImageFormat.YUV_420_888, maxImages);
+            dropTracker.reset();
+            lastDataSpace = -1;
             Log.d(TAG, "ImageReader created successfully");
                 
             Log.d(TAG, "Setting up ImageReader listener...");
             imageReader.setOnImageAvailableListener(new ImageReader.OnImageAvailableListener() {
                 @Override
                 public void onImageAvailable(ImageReader reader) {
-                    Image image = null;
+                    // Shows up in system traces (Perfetto) next to the native Camera2 handoff scope
+                    Trace.beginSection("Camera2 acquire");
                     try {
-                        image = reader.acquireLatestImage();
-                        if (image != null) {
-                            processImage(image);
+                        if (inOrderConsumption) {
+                            // Drain every queued image in capture order
+                            while (consumeImage(reader.acquireNextImage())) { }
+                        } else {
+                            // Skipped images are accounted for by the drop tracker via their timestamps
+                            consumeImage(reader.acquireLatestImage());
                         }
                     } catch (Exception e) {
-                        Log.e(TAG, "Error processing image: " + e.getMessage());
+                        // IllegalStateException: maxImages already acquired, or the reader closed by stop/pause
+                        logFrameError("Failed to acquire image: " + e.getMessage());
                     } finally {
-                        if (image != null) {
-                            image.close();
-                        }
+                        Trace.endSection();
                     }
                 }
             }, backgroundHandler);
             Log.d(TAG, "ImageReader listener set");
+
+            configureAnalysisStreams(cameraCharacteristics);
+            configureStillOutput(cameraCharacteristics);
             
             // Open camera
             Log.d(TAG, "Opening camera...");
-            cameraManager.openCamera(cameraId, new CameraDevice.StateCallback() {
-                @Override
-                public void onOpened(CameraDevice camera) {
-                    Log.d(TAG, "Camera opened");
-                    cameraDevice = camera;
-                    createCaptureSession();
-                }
-                
-                @Override
-                public void onDisconnected(CameraDevice camera) {
-                    Log.w(TAG, "Camera disconnected");
-                    camera.close();
-                    cameraDevice = null;
-                }
-                
-                @Override
-                public void onError(CameraDevice camera, int error) {
-                    Log.e(TAG, "Camera error: " + error);
-                    camera.close();
-                    cameraDevice = null;
-                }
-            }, backgroundHandler);
+            cameraManager.openCamera(cameraId, cameraStateCallback, backgroundHandler);
             
             Log.d(TAG, "Camera open request submitted");
             isCapturing = true;
@@ -389,23 +537,321 @@ public class Camera2Helper {
         }
     }
 
-    private static class Intr {
-        float fx, fy, cx, cy;
+    // Shared by startCamera and the reopen after a pause; the readers and their surfaces outlive the device
+    private final CameraDevice.StateCallback cameraStateCallback = new CameraDevice.StateCallback() {
+        @Override
+        public void onOpened(CameraDevice camera) {
+            Log.d(TAG, "Camera opened");
+            cameraDevice = camera;
+            if (isPaused) {
+                // Paused again before the reopen finished; resume creates the session
+                return;
+            }
+            createCaptureSession();
+        }
+
+        @Override
+        public void onDisconnected(CameraDevice camera) {
+            // Typically the camera being taken away while the app is in the background
+            Log.w(TAG, "Camera disconnected" + (isPaused ? " while paused" : ""));
+            camera.close();
+            if (cameraDevice == camera) {
+                cameraDevice = null;
+                captureSession = null;
+            }
+        }
+
+        @Override
+        public void onError(CameraDevice camera, int error) {
+            Log.e(TAG, "Camera error: " + error);
+            camera.close();
+            if (cameraDevice == camera) {
+                cameraDevice = null;
+                captureSession = null;
+            }
+        }
+    };
+
+    /**
+     * Callable from C++. Stops the repeating request but keeps the device, session, readers and threads so
+     * resumeCamera only has to resubmit it. Frames already captured are still delivered.
+     */
+    public boolean pauseCamera() {
+        if (!isCapturing) {
+            return false;
+        }
+        isPaused = true;
+        CameraCaptureSession session = captureSession;
+        if (session != null) {
+            try {
+                session.stopRepeating();
+            } catch (Exception e) {
+                // Session already closed (device taken away); resume reopens it
+                Log.w(TAG, "stopRepeating failed: " + e.getMessage());
+            }
+        }
+        Log.d(TAG, "Camera paused");
+        return true;
     }
 
-    private static android.graphics.Rect centerCrop(int srcW, int srcH, int dstW, int dstH) {
-        float srcAspect = (float) srcW / (float) srcH;
-        float dstAspect = (float) dstW / (float) dstH;
-        if (dstAspect > srcAspect) {
-            // Wider output: crop height
-            int cropH = Math.round(srcW / dstAspect);
-            int top = (srcH - cropH) / 2;
-            return new android.graphics.Rect(0, top, srcW, top + cropH);
-        } else {
-            // Taller output: crop width
-            int cropW = Math.round(srcH * dstAspect);
-            int left = (srcW - cropW) / 2;
-            return new android.graphics.Rect(left, 0, left + cropW, srcH);
+    /**
+     * Callable from C++. Resubmits the repeating request on the kept session, or reopens the device with the
+     * cached readers and configuration if the session was lost while paused.
+     * @return RESUME_WARM_SESSION, RESUME_REOPEN or RESUME_FAILED (caller falls back to a full restart)
+     */
+    public int resumeCamera() {
+        if (!isCapturing || !isPaused) {
+            return RESUME_FAILED;
+        }
+        isPaused = false;
+        final CameraCaptureSession session = captureSession;
+        if (session != null && cameraDevice != null) {
+            backgroundHandler.post(new Runnable() {
+                @Override
+                public void run() {
+                    dropTracker.restartSequence();
+                    try {
+                        submitRepeatingRequest(appliedControls != null ? appliedControls : pendingControls);
+                        Log.d(TAG, "Camera resumed on the warm session");
+                    } catch (Exception e) {
+                        // The session went away between the check and the post
+                        Log.w(TAG, "Warm resume failed (" + e.getMessage() + "), reopening the camera");
+                        reopenCamera();
+                    }
+                }
+            });
+            return RESUME_WARM_SESSION;
+        }
+        if (cameraDevice != null) {
+            // Paused between onOpened and the session: only the session has to be built
+            backgroundHandler.post(new Runnable() {
+                @Override
+                public void run() {
+                    dropTracker.restartSequence();
+                    createCaptureSession();
+                }
+            });
+            return RESUME_REOPEN;
+        }
+
+        backgroundHandler.post(new Runnable() {
+            @Override
+            public void run() {
+                dropTracker.restartSequence();
+                reopenCamera();
+            }
+        });
+        return RESUME_REOPEN;
+    }
+
+    // backgroundHandler: open the device again; onOpened builds the session on the existing reader surfaces
+    private void reopenCamera() {
+        if (captureSession != null) {
+            captureSession.close();
+            captureSession = null;
+        }
+        if (cameraDevice != null) {
+            cameraDevice.close();
+            cameraDevice = null;
+        }
+        try {
+            cameraManager.openCamera(currentCameraId, cameraStateCallback, backgroundHandler);
+            Log.d(TAG, "Camera reopen requested");
+        } catch (Exception e) {
+            Log.e(TAG, "Camera reopen failed: " + e.getMessage());
+        }
+    }
+
+    // Process one acquired image; returns false when there was nothing to process
+    private boolean consumeImage(Image image) {
+        if (image == null) {
+            return false;
+        }
+        try {
+            dropTracker.onImageDelivered(image.getTimestamp());
+            processImage(image);
+        } catch (Exception e) {
+            logFrameError("Error processing image: " + e.getMessage());
+        } finally {
+            image.close();
+        }
+        onFrameStatsAvailable(dropTracker.capturesCompleted, dropTracker.framesDelivered, dropTracker.queueDrops,
+                              dropTracker.sensorDrops, dropTracker.buffersLost, maxImages, inOrderConsumption);
+        return true;
+    }
+
+    // Capture callbacks feed the sensor clock mapping and the drop tracker; runs on backgroundHandler like the ImageReader listener
+    private final CameraCaptureSession.CaptureCallback captureCallback = new CameraCaptureSession.CaptureCallback() {
+        @Override
+        public void onCaptureStarted(CameraCaptureSession session, CaptureRequest request, long timestamp, long frameNumber) {
+            // Fires at start of exposure, the earliest point a sensor timestamp can be paired with engine time
+            onSensorClockSample(timestamp);
+        }
+
+        @Override
+        public void onCaptureCompleted(CameraCaptureSession session, CaptureRequest request, TotalCaptureResult result) {
+            // Coalesce any control changes made since the last frame into a single request rebuild
+            CaptureControls pending = pendingControls;
+            if (pending != appliedControls) {
+                if (pending.equals(appliedControls)) {
+                    appliedControls = pending; // changed and changed back before this frame
+                } else {
+                    rebuildRepeatingRequest();
+                }
+            }
+
+            Long timestamp = result.get(CaptureResult.SENSOR_TIMESTAMP);
+            long sensorTimestamp = timestamp != null ? timestamp : -1L;
+            dropTracker.onCaptureCompleted(result.getFrameNumber(), sensorTimestamp);
+
+            // Forward as primitives into the native metadata ring so nothing is allocated on the JNI side
+            Long exposure = result.get(CaptureResult.SENSOR_EXPOSURE_TIME);
+            Integer sensitivity = result.get(CaptureResult.SENSOR_SENSITIVITY);
+            Long frameDuration = result.get(CaptureResult.SENSOR_FRAME_DURATION);
+            Integer aeState = result.get(CaptureResult.CONTROL_AE_STATE);
+            Integer afState = result.get(CaptureResult.CONTROL_AF_STATE);
+            Long shutterSkew = result.get(CaptureResult.SENSOR_ROLLING_SHUTTER_SKEW);
+            Float focusDistance = result.get(CaptureResult.LENS_FOCUS_DISTANCE);
+            onCaptureMetadataAvailable(result.getFrameNumber(), sensorTimestamp,
+                exposure != null ? exposure : 0L,
+                sensitivity != null ? sensitivity : 0,
+                frameDuration != null ? frameDuration : 0L,
+                aeState != null ? aeState : -1,
+                afState != null ? afState : -1,
+                focusDistance != null ? focusDistance : 0.0f,
+                shutterSkew != null ? shutterSkew : 0L);
+        }
+
+        @Override
+        public void onCaptureBufferLost(CameraCaptureSession session, CaptureRequest request, Surface target, long frameNumber) {
+            dropTracker.onBufferLost();
+        }
+    };
+
+    /**
+     * Exact frame-drop accounting. Completed capture results are matched against delivered images by
+     * SENSOR_TIMESTAMP (Image.getTimestamp() uses the same clock); a completed capture whose timestamp is
+     * passed over by a newer delivered image was dropped in the ImageReader queue. Gaps in the completed
+     * frame-number sequence are captures that failed before producing a result.
+     * Only touched from backgroundHandler, so no synchronization is needed.
+     */
+    private static final class FrameDropTracker {
+        private static final int RING_SIZE = 64;
+
+        // Completed capture timestamps whose image has not been seen yet
+        private final long[] pendingCaptures = new long[RING_SIZE];
+        private int pendingCount = 0;
+        // Delivered image timestamps whose capture result has not arrived yet
+        private final long[] pendingImages = new long[RING_SIZE];
+        private int pendingImageCount = 0;
+
+        private long lastFrameNumber = -1;
+        private long lastDeliveredTimestamp = -1;
+        private long lostBufferCredit = 0;
+
+        long capturesCompleted = 0;
+        long framesDelivered = 0;
+        long queueDrops = 0;
+        long sensorDrops = 0;
+        long buffersLost = 0;
+
+        void reset() {
+            pendingCount = 0;
+            pendingImageCount = 0;
+            lastFrameNumber = -1;
+            lastDeliveredTimestamp = -1;
+            lostBufferCredit = 0;
+            capturesCompleted = framesDelivered = queueDrops = sensorDrops = buffersLost = 0;
+        }
+
+        // After a pause: frame numbers may jump (or restart on a reopened device), counters are kept
+        void restartSequence() {
+            pendingCount = 0;
+            pendingImageCount = 0;
+            lastFrameNumber = -1;
+            lastDeliveredTimestamp = -1;
+            lostBufferCredit = 0;
+        }
+
+        void onCaptureCompleted(long frameNumber, long timestamp) {
+            capturesCompleted++;
+            if (lastFrameNumber >= 0 && frameNumber > lastFrameNumber + 1) {
+                sensorDrops += frameNumber - lastFrameNumber - 1;
+            }
+            lastFrameNumber = Math.max(lastFrameNumber, frameNumber);
+            if (timestamp < 0) {
+                return;
+            }
+
+            // Image already delivered before its result arrived
+            int idx = indexOf(pendingImages, pendingImageCount, timestamp);
+            if (idx >= 0) {
+                pendingImageCount = removeAt(pendingImages, pendingImageCount, idx);
+                return;
+            }
+            // Images are delivered in timestamp order, so an older result can no longer be matched
+            if (timestamp < lastDeliveredTimestamp) {
+                countQueueDrop();
+                return;
+            }
+            if (pendingCount == RING_SIZE) {
+                // Results far ahead of images: the oldest can never be matched anymore
+                pendingCount = removeAt(pendingCaptures, pendingCount, 0);
+                countQueueDrop();
+            }
+            pendingCaptures[pendingCount++] = timestamp;
+        }
+
+        void onBufferLost() {
+            buffersLost++;
+            // The lost capture still completes with a timestamp; don't count it again as a queue drop
+            lostBufferCredit++;
+        }
+
+        void onImageDelivered(long timestamp) {
+            framesDelivered++;
+            lastDeliveredTimestamp = timestamp;
+
+            boolean matched = false;
+            int write = 0;
+            for (int i = 0; i < pendingCount; i++) {
+                long ts = pendingCaptures[i];
+                if (ts < timestamp) {
+                    countQueueDrop();
+                } else if (ts == timestamp) {
+                    matched = true;
+                } else {
+                    pendingCaptures[write++] = ts;
+                }
+            }
+            pendingCount = write;
+
+            if (!matched) {
+                if (pendingImageCount == RING_SIZE) {
+                    pendingImageCount = removeAt(pendingImages, pendingImageCount, 0);
+                }
+                pendingImages[pendingImageCount++] = timestamp;
+            }
+        }
+
+        private void countQueueDrop() {
+            if (lostBufferCredit > 0) {
+                lostBufferCredit--;
+            } else {
+                queueDrops++;
+            }
+        }
+
+        private static int indexOf(long[] values, int count, long value) {
+            for (int i = 0; i < count; i++) {
+                if (values[i] == value) return i;
+            }
+            return -1;
+        }
+
+        private static int removeAt(long[] values, int count, int index) {
+            System.arraycopy(values, index + 1, values, index, count - index - 1);
+            return count - 1;
         }
     }
 
@@ -566,18 +1012,6 @@ public class Camera2Helper {
         return String.valueOf(val);
     }
 
-    private static Intr intrinsicsForStream(float fx, float fy, float cx, float cy,  int sensorW, int sensorH, int outW, int outH) {
-        android.graphics.Rect crop = centerCrop(sensorW, sensorH, outW, outH);
-        float sx = (float) outW / (float) crop.width();
-        float sy = (float) outH / (float) crop.height();
-        Intr k = new Intr();
-        k.fx = fx * sx;
-        k.fy = fy * sy;
-        k.cx = (cx - crop.left) * sx;
-        k.cy = (cy - crop.top) * sy;
-        return k;
-    }
-	
 	private void saveJsonToFile(String fileName, String jsonContent) {
 		File baseDir = null;
 		try {
@@ -629,42 +1063,464 @@ public class Camera2Helper {
     
     private void createCaptureSession() {
         try {
-            Surface surface = imageReader.getSurface();
-            
-            cameraDevice.createCaptureSession(Arrays.asList(surface),
+            // The still output is part of the session but only targeted by still requests
+            List<Surface> outputs = getSessionSurfaces();
+            if (stillReader != null) {
+                outputs.add(stillReader.getSurface());
+            }
+            cameraDevice.createCaptureSession(outputs,
                 new CameraCaptureSession.StateCallback() {
                     @Override
                     public void onConfigured(CameraCaptureSession session) {
                         Log.d(TAG, "Capture session configured");
                         captureSession = session;
+                        onSessionConfigured(false, sessionFpsRange != null ? sessionFpsRange.getUpper() : 30);
                         startCapture();
                     }
                     
                     @Override
                     public void onConfigureFailed(CameraCaptureSession session) {
-                        Log.e(TAG, "Failed to configure capture session");
+                        onSessionRejected("configuration failed");
                     }
                 }, backgroundHandler);
                 
         } catch (Exception e) {
-            Log.e(TAG, "Failed to create capture session: " + e.getMessage());
+            onSessionRejected(e.getMessage());
+        }
+    }
+
+    /**
+     * The HAL can still reject a combination the guaranteed tables allow. Retry with the display stream alone
+     * and tell native which outputs were dropped; if even that is rejected, native learns the start failed.
+     */
+    private void onSessionRejected(String reason) {
+        if (dropExtraOutputs()) {
+            Log.w(TAG, "Capture session rejected (" + reason + "), retrying with the display stream only");
+            createCaptureSession();
+            return;
+        }
+        Log.e(TAG, "Failed to configure capture session: " + reason);
+        onSessionConfigureFailed();
+    }
+
+    // Closes the analysis and still readers; false when the session had only the display stream
+    private boolean dropExtraOutputs() {
+        boolean dropped = false;
+        for (AnalysisStream stream : analysisStreams) {
+            if (stream.reader != null) {
+                stream.reader.close();
+                stream.reader = null;
+                onAnalysisStreamConfigured(stream.id, stream.width, stream.height, stream.lumaOnly, false);
+                dropped = true;
+            }
+        }
+        if (stillReader != null) {
+            stillReader.close();
+            stillReader = null;
+            onStillCaptureConfigured(false, stillFormat, 0, 0);
+            dropped = true;
         }
+        return dropped;
     }
     
+    // Extra output requested from native; each gets its own ImageReader and native pipeline
+    private static final class AnalysisStream {
+        int id;
+        int requestedWidth, requestedHeight;
+        boolean lumaOnly;
+        int width, height;
+        int format;
+        ImageReader reader;
+    }
+
+    // Callable from C++ before startCamera
+    public void clearAnalysisStreams() {
+        analysisStreams.clear();
+    }
+
+    public void addAnalysisStream(int streamId, int width, int height, boolean lumaOnly) {
+        AnalysisStream stream = new AnalysisStream();
+        stream.id = streamId;
+        stream.requestedWidth = width;
+        stream.requestedHeight = height;
+        stream.lumaOnly = lumaOnly;
+        analysisStreams.add(stream);
+    }
+
+    private List<Surface> getSessionSurfaces() {
+        java.util.ArrayList<Surface> surfaces = new java.util.ArrayList<Surface>();
+        surfaces.add(imageReader.getSurface());
+        for (AnalysisStream stream : analysisStreams) {
+            if (stream.reader != null) {
+                surfaces.add(stream.reader.getSurface());
+            }
+        }
+        return surfaces;
+    }
+
+    /**
+     * Choose a size/format per analysis stream and keep only those that form a guaranteed stream
+     * combination with the display stream. Y8 is used for luma-only streams on MONOCHROME cameras only: the
+     * guaranteed tables list Y8 for those alone, so other devices get YUV_420_888 and the Y plane.
+     */
+    private void configureAnalysisStreams(CameraCharacteristics cc) {
+        android.hardware.camera2.params.StreamConfigurationMap map =
+            cc != null ? cc.get(CameraCharacteristics.SCALER_STREAM_CONFIGURATION_MAP) : null;
+        Integer level = cc != null ? cc.get(CameraCharacteristics.INFO_SUPPORTED_HARDWARE_LEVEL) : null;
+        int hardwareLevel = level != null ? level : CameraCharacteristics.INFO_SUPPORTED_HARDWARE_LEVEL_LEGACY;
+        boolean monochrome = Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q
+            && hasCapability(cc, CameraCharacteristics.REQUEST_AVAILABLE_CAPABILITIES_MONOCHROME);
+
+        java.util.ArrayList<android.util.Size> accepted = new java.util.ArrayList<android.util.Size>();
+        accepted.add(new android.util.Size(frameWidth, frameHeight));
+
+        for (AnalysisStream stream : analysisStreams) {
+            boolean ok = false;
+            if (map != null) {
+                stream.format = ImageFormat.YUV_420_888;
+                if (stream.lumaOnly && monochrome && map.isOutputSupportedFor(ImageFormat.Y8)) {
+                    stream.format = ImageFormat.Y8;
+                }
+                android.util.Size size = chooseOutputSize(map.getOutputSizes(stream.format), stream.requestedWidth, stream.requestedHeight);
+                if (size != null) {
+                    accepted.add(size);
+                    ok = isGuaranteedYuvCombination(hardwareLevel, largestSize(map.getOutputSizes(ImageFormat.YUV_420_888)), accepted);
+                    if (ok) {
+                        stream.width = size.getWidth();
+                        stream.height = size.getHeight();
+                    } else {
+                        accepted.remove(accepted.size() - 1);
+                    }
+                }
+            }
+
+            if (ok) {
+                final AnalysisStream target = stream;
+                stream.reader = ImageReader.newInstance(stream.width, stream.height, stream.format, 2);
+                stream.reader.setOnImageAvailableListener(new ImageReader.OnImageAvailableListener() {
+                    @Override
+                    public void onImageAvailable(ImageReader reader) {
+                        Trace.beginSection("Camera2 acquire analysis");
+                        Image image = null;
+                        try {
+                            image = reader.acquireLatestImage();
+                            if (image != null) {
+                                processAnalysisImage(target, image);
+                            }
+                        } catch (Exception e) {
+                            logFrameError("Analysis stream " + target.id + ": failed to acquire image: " + e.getMessage());
+                        } finally {
+                            if (image != null) {
+                                image.close();
+                            }
+                            Trace.endSection();
+                        }
+                    }
+                }, backgroundHandler);
+                Log.d(TAG, "Analysis stream " + stream.id + ": " + stream.width + "x" + stream.height +
+                      (stream.format == ImageFormat.Y8 ? " Y8" : " YUV_420_888"));
+            }
+            onAnalysisStreamConfigured(stream.id, stream.width, stream.height, stream.lumaOnly, ok);
+        }
+    }
+
+    private void processAnalysisImage(AnalysisStream stream, Image image) {
+        Image.Plane[] planes = image.getPlanes();
+        if (planes.length == 0) {
+            return;
+        }
+        Image.Plane yPlane = planes[0];
+        if (stream.lumaOnly || planes.length < 3) {
+            onYuvFrameAvailable(stream.id, yPlane.getBuffer(), null, null, image.getWidth(), image.getHeight(),
+                yPlane.getRowStride(), 0, 0, image.getTimestamp());
+        } else {
+            onYuvFrameAvailable(stream.id, yPlane.getBuffer(), planes[1].getBuffer(), planes[2].getBuffer(),
+                image.getWidth(), image.getHeight(), yPlane.getRowStride(), planes[1].getRowStride(),
+                planes[1].getPixelStride(), image.getTimestamp());
+        }
+    }
+
+    // Callable from C++ before startCamera
+    public void configureStillCapture(boolean enable, int format, int width, int height, int jpegQuality) {
+        stillRequested = enable;
+        stillFormat = format == STILL_FORMAT_YUV ? STILL_FORMAT_YUV : STILL_FORMAT_JPEG;
+        stillRequestedWidth = width;
+        stillRequestedHeight = height;
+        stillJpegQuality = Math.max(1, Math.min(100, jpegQuality));
+    }
+
+    /**
+     * Add the still ImageReader if it forms a guaranteed stream combination with the display and analysis
+     * streams.
+     */
+    private void configureStillOutput(CameraCharacteristics cc) {
+        if (!stillRequested) {
+            return;
+        }
+        android.hardware.camera2.params.StreamConfigurationMap map =
+            cc != null ? cc.get(CameraCharacteristics.SCALER_STREAM_CONFIGURATION_MAP) : null;
+        Integer level = cc != null ? cc.get(CameraCharacteristics.INFO_SUPPORTED_HARDWARE_LEVEL) : null;
+        int hardwareLevel = level != null ? level : CameraCharacteristics.INFO_SUPPORTED_HARDWARE_LEVEL_LEGACY;
+        int format = stillFormat == STILL_FORMAT_YUV ? ImageFormat.YUV_420_888 : ImageFormat.JPEG;
+
+        android.util.Size size = null;
+        boolean ok = false;
+        if (map != null) {
+            android.util.Size[] sizes = map.getOutputSizes(format);
+            size = (stillRequestedWidth > 0 && stillRequestedHeight > 0)
+                ? chooseOutputSize(sizes, stillRequestedWidth, stillRequestedHeight) : largestSize(sizes);
+            if (size != null) {
+                java.util.ArrayList<android.util.Size> yuvSizes = new java.util.ArrayList<android.util.Size>();
+                yuvSizes.add(new android.util.Size(frameWidth, frameHeight));
+                for (AnalysisStream stream : analysisStreams) {
+                    if (stream.reader != null) {
+                        yuvSizes.add(new android.util.Size(stream.width, stream.height));
+                    }
+                }
+                android.util.Size yuvMaximum = largestSize(map.getOutputSizes(ImageFormat.YUV_420_888));
+                if (format == ImageFormat.JPEG) {
+                    ok = isGuaranteedWithJpegStill(hardwareLevel, yuvSizes);
+                } else {
+                    yuvSizes.add(size);
+                    ok = isGuaranteedYuvCombination(hardwareLevel, yuvMaximum, yuvSizes);
+                }
+            }
+        }
+
+        if (ok) {
+            stillThread = new HandlerThread("CameraStill");
+            stillThread.start();
+            stillHandler = new Handler(stillThread.getLooper());
+            synchronized (stillRequestIds) {
+                stillRequestIds.clear();
+            }
+            stillReader = ImageReader.newInstance(size.getWidth(), size.getHeight(), format, 2);
+            stillReader.setOnImageAvailableListener(new ImageReader.OnImageAvailableListener() {
+                @Override
+                public void onImageAvailable(ImageReader reader) {
+                    Trace.beginSection("Camera2 still");
+                    Image image = reader.acquireNextImage();
+                    try {
+                        if (image != null) {
+                            processStillImage(image);
+                        }
+                    } finally {
+                        if (image != null) {
+                            image.close();
+                        }
+                        Trace.endSection();
+                    }
+                }
+            }, stillHandler);
+            Log.d(TAG, "Still output: " + size.getWidth() + "x" + size.getHeight() +
+                  (format == ImageFormat.JPEG ? " JPEG" : " YUV_420_888"));
+        }
+        onStillCaptureConfigured(ok, stillFormat, ok ? size.getWidth() : 0, ok ? size.getHeight() : 0);
+    }
+
+    /**
+     * JPEG MAXIMUM is guaranteed next to one YUV PREVIEW on every hardware level and next to two YUV PREVIEW
+     * streams from LIMITED up (PREVIEW is bounded at 1080p)
+     */
+    private static boolean isGuaranteedWithJpegStill(int hardwareLevel, List<android.util.Size> yuvSizes) {
+        final long previewArea = 1920L * 1080L;
+        for (android.util.Size size : yuvSizes) {
+            if (area(size) > previewArea) {
+                return false;
+            }
+        }
+        if (yuvSizes.size() == 1) {
+            return true;
+        }
+        return yuvSizes.size() == 2 && hardwareLevel != CameraCharacteristics.INFO_SUPPORTED_HARDWARE_LEVEL_LEGACY;
+    }
+
+    /**
+     * Callable from C++ (any thread). A single TEMPLATE_STILL_CAPTURE request that also targets the streaming
+     * surfaces, so the preview gets that frame as well and keeps its cadence. The request is built on
+     * backgroundHandler from appliedControls, so it carries exactly the controls the preview runs with.
+     */
+    public boolean captureStill(final int requestId) {
+        Handler handler = backgroundHandler;
+        if (captureSession == null || cameraDevice == null || stillReader == null || handler == null) {
+            return false;
+        }
+        return handler.post(new Runnable() {
+            @Override
+            public void run() {
+                submitStillRequest(requestId);
+            }
+        });
+    }
+
+    // backgroundHandler: failures after captureStill returned are reported through onStillCaptureFailed
+    private void submitStillRequest(int requestId) {
+        CameraCaptureSession session = captureSession;
+        CameraDevice device = cameraDevice;
+        ImageReader reader = stillReader;
+        if (session == null || device == null || reader == null) {
+            Log.w(TAG, "Still " + requestId + " dropped: the session closed before it was submitted");
+            onStillCaptureFailed(requestId);
+            return;
+        }
+        try {
+            CaptureRequest.Builder builder = device.createCaptureRequest(CameraDevice.TEMPLATE_STILL_CAPTURE);
+            builder.addTarget(reader.getSurface());
+            for (Surface surface : getSessionSurfaces()) {
+                builder.addTarget(surface);
+            }
+            applyCaptureControls(builder, appliedControls != null ? appliedControls : pendingControls);
+            if (stillFormat == STILL_FORMAT_JPEG) {
+                builder.set(CaptureRequest.JPEG_QUALITY, (byte) stillJpegQuality);
+            }
+            builder.setTag(Integer.valueOf(requestId));
+            session.capture(builder.build(), stillCaptureCallback, backgroundHandler);
+        } catch (Exception e) {
+            Log.e(TAG, "Failed to capture still: " + e.getMessage());
+            onStillCaptureFailed(requestId);
+        }
+    }
+
+    private static int stillRequestId(CaptureRequest request) {
+        Object tag = request.getTag();
+        return tag instanceof Integer ? (Integer) tag : -1;
+    }
+
+    // Still requests feed the same clock mapping, drop tracker and metadata ring as the repeating request
+    private final CameraCaptureSession.CaptureCallback stillCaptureCallback = new CameraCaptureSession.CaptureCallback() {
+        @Override
+        public void onCaptureStarted(CameraCaptureSession session, CaptureRequest request, long timestamp, long frameNumber) {
+            synchronized (stillRequestIds) {
+                if (stillRequestIds.size() > 16) {
+                    stillRequestIds.clear(); // entries of failed requests
+                }
+                stillRequestIds.put(timestamp, stillRequestId(request));
+            }
+            captureCallback.onCaptureStarted(session, request, timestamp, frameNumber);
+        }
+
+        @Override
+        public void onCaptureCompleted(CameraCaptureSession session, CaptureRequest request, TotalCaptureResult result) {
+            captureCallback.onCaptureCompleted(session, request, result);
+            Long timestamp = result.get(CaptureResult.SENSOR_TIMESTAMP);
+            onStillCaptureCompleted(stillRequestId(request), timestamp != null ? timestamp : -1L);
+        }
+
+        @Override
+        public void onCaptureFailed(CameraCaptureSession session, CaptureRequest request, CaptureFailure failure) {
+            onStillCaptureFailed(stillRequestId(request));
+        }
+
+        @Override
+        public void onCaptureBufferLost(CameraCaptureSession session, CaptureRequest request, Surface target, long frameNumber) {
+            ImageReader reader = stillReader;
+            if (reader != null && target.equals(reader.getSurface())) {
+                onStillCaptureFailed(stillRequestId(request));
+            } else {
+                captureCallback.onCaptureBufferLost(session, request, target, frameNumber);
+            }
+        }
+    };
+
+    // Still reader thread: native copies the planes (or JPEG bytes) out before the image is closed
+    private void processStillImage(Image image) {
+        Integer requestId;
+        synchronized (stillRequestIds) {
+            requestId = stillRequestIds.remove(image.getTimestamp());
+        }
+        Image.Plane[] planes = image.getPlanes();
+        if (image.getFormat() == ImageFormat.JPEG && planes.length > 0) {
+            ByteBuffer data = planes[0].getBuffer();
+            onStillImageAvailable(requestId != null ? requestId : -1, STILL_FORMAT_JPEG, data, null, null,
+                data.position(), data.remaining(), image.getWidth(), image.getHeight(), 0, 0, 0, image.getTimestamp());
+        } else if (planes.length >= 3) {
+            onStillImageAvailable(requestId != null ? requestId : -1, STILL_FORMAT_YUV, planes[0].getBuffer(),
+                planes[1].getBuffer(), planes[2].getBuffer(), 0, 0, image.getWidth(), image.getHeight(),
+                planes[0].getRowStride(), planes[1].getRowStride(), planes[1].getPixelStride(), image.getTimestamp());
+        }
+    }
+
+    // Exact size if offered, else the smallest size covering the request, else the largest size
+    private static android.util.Size chooseOutputSize(android.util.Size[] sizes, int width, int height) {
+        if (sizes == null || sizes.length == 0) {
+            return null;
+        }
+        android.util.Size covering = null;
+        for (android.util.Size size : sizes) {
+            if (size.getWidth() == width && size.getHeight() == height) {
+                return size;
+            }
+            if (size.getWidth() >= width && size.getHeight() >= height
+                && (covering == null || area(size) < area(covering))) {
+                covering = size;
+            }
+        }
+        return covering != null ? covering : largestSize(sizes);
+    }
+
+    private static android.util.Size largestSize(android.util.Size[] sizes) {
+        android.util.Size largest = null;
+        if (sizes != null) {
+            for (android.util.Size size : sizes) {
+                if (largest == null || area(size) > area(largest)) {
+                    largest = size;
+                }
+            }
+        }
+        return largest;
+    }
+
+    private static long area(android.util.Size size) {
+        return (long) size.getWidth() * size.getHeight();
+    }
+
+    /**
+     * Guaranteed YUV-only stream combinations from the CameraDevice.createCaptureSession tables
+     * (PREVIEW and RECORD bounded at 1080p, MAXIMUM = largest YUV size):
+     * LEGACY: one YUV stream. LIMITED: YUV PREVIEW + YUV RECORD.
+     * FULL: YUV PREVIEW + YUV MAXIMUM, YUV 640x480 + YUV PREVIEW + YUV MAXIMUM.
+     */
+    private static boolean isGuaranteedYuvCombination(int hardwareLevel, android.util.Size maximum, List<android.util.Size> sizes) {
+        final long previewArea = 1920L * 1080L;
+        final long recordArea = 1920L * 1080L;
+        final long vgaArea = 640L * 480L;
+        long maxArea = maximum != null ? area(maximum) : recordArea;
+
+        long[] areas = new long[sizes.size()];
+        for (int i = 0; i < areas.length; i++) {
+            areas[i] = area(sizes.get(i));
+        }
+        Arrays.sort(areas);
+
+        boolean legacy = hardwareLevel == CameraCharacteristics.INFO_SUPPORTED_HARDWARE_LEVEL_LEGACY;
+        boolean full = hardwareLevel == CameraCharacteristics.INFO_SUPPORTED_HARDWARE_LEVEL_FULL
+            || hardwareLevel == CameraCharacteristics.INFO_SUPPORTED_HARDWARE_LEVEL_3;
+
+        switch (areas.length) {
+            case 1:
+                return areas[0] <= maxArea;
+            case 2:
+                if (legacy) return false;
+                if (areas[0] <= previewArea && areas[1] <= recordArea) return true;
+                return full && areas[0] <= previewArea && areas[1] <= maxArea;
+            case 3:
+                return full && areas[0] <= vgaArea && areas[1] <= previewArea && areas[2] <= maxArea;
+            default:
+                return false;
+        }
+    }
+
     private void startCapture() {
+        if (isPaused) {
+            // Session configured after a pause request; resumeCamera submits the repeating request
+            return;
+        }
         try {
-            CaptureRequest.Builder requestBuilder = 
-                cameraDevice.createCaptureRequest(CameraDevice.TEMPLATE_PREVIEW);
-            requestBuilder.addTarget(imageReader.getSurface());
-            
-            // Set auto-focus and auto-exposure
-            requestBuilder.set(CaptureRequest.CONTROL_AF_MODE,
-                CaptureRequest.CONTROL_AF_MODE_CONTINUOUS_PICTURE);
-            requestBuilder.set(CaptureRequest.CONTROL_AE_MODE,
-                CaptureRequest.CONTROL_AE_MODE_ON_AUTO_FLASH);
-            
-            captureSession.setRepeatingRequest(requestBuilder.build(),
-                null, backgroundHandler);
+            CaptureControls controls = pendingControls;
+            appliedControls = controls;
+            afTriggerLocked = false; // a new session starts with AF unlocked
+            submitRepeatingRequest(controls);
+            updateAfLock(controls);
                 
             Log.d(TAG, "Camera capture started");
             
@@ -672,7 +1528,215 @@ public class Camera2Helper {
             Log.e(TAG, "Failed to start capture: " + e.getMessage());
         }
     }
+
+    /**
+     * Manual capture control values. Instances are immutable once published through pendingControls, and a new
+     * instance is only published when a value differs, so a reference comparison is enough to detect a change.
+     * Mode fields use the Camera2 constants, or -1 to keep the template default.
+     */
+    private static final class CaptureControls {
+        boolean aeLock, afLock, awbLock;
+        boolean manualExposure;
+        long exposureTimeNs;
+        int sensitivity;
+        long frameDurationNs;
+        int noiseReductionMode = -1;
+        int edgeMode = -1;
+        int fpsMin, fpsMax;
+
+        @Override
+        public boolean equals(Object other) {
+            if (this == other) {
+                return true;
+            }
+            if (!(other instanceof CaptureControls)) {
+                return false;
+            }
+            CaptureControls o = (CaptureControls) other;
+            return aeLock == o.aeLock && afLock == o.afLock && awbLock == o.awbLock
+                && manualExposure == o.manualExposure && exposureTimeNs == o.exposureTimeNs
+                && sensitivity == o.sensitivity && frameDurationNs == o.frameDurationNs
+                && noiseReductionMode == o.noiseReductionMode && edgeMode == o.edgeMode
+                && fpsMin == o.fpsMin && fpsMax == o.fpsMax;
+        }
+
+        @Override
+        public int hashCode() {
+            int h = (aeLock ? 1 : 0) | (afLock ? 2 : 0) | (awbLock ? 4 : 0) | (manualExposure ? 8 : 0);
+            h = 31 * h + Long.hashCode(exposureTimeNs);
+            h = 31 * h + sensitivity;
+            h = 31 * h + Long.hashCode(frameDurationNs);
+            h = 31 * h + noiseReductionMode;
+            h = 31 * h + edgeMode;
+            h = 31 * h + fpsMin;
+            return 31 * h + fpsMax;
+        }
+    }
+
+    // Callable from C++; only records the values, the session is rebuilt on the next capture result
+    public void setCaptureControls(boolean aeLock, boolean afLock, boolean awbLock,
+                                   boolean manualExposure, long exposureTimeNs, int sensitivity, long frameDurationNs,
+                                   int noiseReductionMode, int edgeMode, int fpsMin, int fpsMax) {
+        CaptureControls c = new CaptureControls();
+        c.aeLock = aeLock;
+        c.afLock = afLock;
+        c.awbLock = awbLock;
+        c.manualExposure = manualExposure;
+        c.exposureTimeNs = exposureTimeNs;
+        c.sensitivity = sensitivity;
+        c.frameDurationNs = frameDurationNs;
+        c.noiseReductionMode = noiseReductionMode;
+        c.edgeMode = edgeMode;
+        c.fpsMin = fpsMin;
+        c.fpsMax = fpsMax;
+        // Called every tick from Blueprint: unchanged values must not trigger a request rebuild
+        if (!c.equals(pendingControls)) {
+            pendingControls = c;
+        }
+    }
+
+    private void rebuildRepeatingRequest() {
+        CaptureControls controls = pendingControls;
+        appliedControls = controls; // mark applied even on failure so a bad value can't retry every frame
+        if (captureSession == null || cameraDevice == null) {
+            return;
+        }
+        try {
+            submitRepeatingRequest(controls);
+            updateAfLock(controls);
+            Log.d(TAG, "Repeating request rebuilt for new capture controls");
+        } catch (Exception e) {
+            Log.e(TAG, "Failed to apply capture controls: " + e.getMessage());
+        }
+    }
+
+    private void submitRepeatingRequest(CaptureControls controls) throws CameraAccessException {
+        captureSession.setRepeatingRequest(buildPreviewRequest(controls), captureCallback, backgroundHandler);
+    }
+
+    // Fresh request from the template so cleared controls fall back to their defaults
+    private CaptureRequest buildPreviewRequest(CaptureControls c) throws CameraAccessException {
+        CaptureRequest.Builder builder = cameraDevice.createCaptureRequest(CameraDevice.TEMPLATE_PREVIEW);
+        for (Surface surface : getSessionSurfaces()) {
+            builder.addTarget(surface);
+        }
+        applyCaptureControls(builder, c);
+        return builder.build();
+    }
+
+    /**
+     * AF lock is the standard trigger: CONTROL_AF_TRIGGER_START in CONTINUOUS_PICTURE/AUTO locks the lens where
+     * AF is, CANCEL releases it. The trigger goes out in a single capture; the repeating request keeps
+     * AF_TRIGGER_IDLE so the scan isn't restarted every frame, and the HAL holds the lock in between.
+     */
+    private void updateAfLock(CaptureControls controls) throws CameraAccessException {
+        if (controls.afLock == afTriggerLocked || lockableAfMode < 0) {
+            return;
+        }
+        CaptureRequest.Builder builder = cameraDevice.createCaptureRequest(CameraDevice.TEMPLATE_PREVIEW);
+        for (Surface surface : getSessionSurfaces()) {
+            builder.addTarget(surface);
+        }
+        applyCaptureControls(builder, controls);
+        builder.set(CaptureRequest.CONTROL_AF_TRIGGER, controls.afLock
+            ? CaptureRequest.CONTROL_AF_TRIGGER_START : CaptureRequest.CONTROL_AF_TRIGGER_CANCEL);
+        captureSession.capture(builder.build(), captureCallback, backgroundHandler);
+        afTriggerLocked = controls.afLock;
+    }
+
+    private static boolean hasCapability(CameraCharacteristics cc, int capability) {
+        int[] caps = cc != null ? cc.get(CameraCharacteristics.REQUEST_AVAILABLE_CAPABILITIES) : null;
+        if (caps != null) {
+            for (int cap : caps) {
+                if (cap == capability) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // CONTINUOUS_PICTURE if offered, else AUTO; -1 for fixed-focus lenses, which have nothing to lock
+    private static int chooseLockableAfMode(CameraCharacteristics cc) {
+        int[] modes = cc.get(CameraCharacteristics.CONTROL_AF_AVAILABLE_MODES);
+        int best = -1;
+        if (modes != null) {
+            for (int mode : modes) {
+                if (mode == CaptureRequest.CONTROL_AF_MODE_CONTINUOUS_PICTURE) {
+                    return mode;
+                }
+                if (mode == CaptureRequest.CONTROL_AF_MODE_AUTO) {
+                    best = mode;
+                }
+            }
+        }
+        return best;
+    }
+
+    private void applyCaptureControls(CaptureRequest.Builder builder, CaptureControls c) {
+        CameraCharacteristics cc = cameraCharacteristics;
+
+        if (lockableAfMode >= 0) {
+            builder.set(CaptureRequest.CONTROL_AF_MODE, lockableAfMode);
+        }
+        if (c.manualExposure && !manualSensorSupported) {
+            Log.w(TAG, "Manual exposure ignored: the camera lacks the MANUAL_SENSOR capability");
+        }
+        if (c.manualExposure && manualSensorSupported) {
+            long exposure = c.exposureTimeNs;
+            int iso = c.sensitivity;
+            long frameDuration = c.frameDurationNs;
+            if (cc != null) {
+                android.util.Range<Long> exposureRange = cc.get(CameraCharacteristics.SENSOR_INFO_EXPOSURE_TIME_RANGE);
+                android.util.Range<Integer> isoRange = cc.get(CameraCharacteristics.SENSOR_INFO_SENSITIVITY_RANGE);
+                Long maxFrameDuration = cc.get(CameraCharacteristics.SENSOR_INFO_MAX_FRAME_DURATION);
+                if (exposureRange != null) exposure = exposureRange.clamp(exposure);
+                if (isoRange != null) iso = isoRange.clamp(iso);
+                if (maxFrameDuration != null) frameDuration = Math.min(frameDuration, maxFrameDuration);
+            }
+            builder.set(CaptureRequest.CONTROL_AE_MODE, CaptureRequest.CONTROL_AE_MODE_OFF);
+            builder.set(CaptureRequest.SENSOR_EXPOSURE_TIME, exposure);
+            builder.set(CaptureRequest.SENSOR_SENSITIVITY, iso);
+            if (frameDuration > 0) {
+                builder.set(CaptureRequest.SENSOR_FRAME_DURATION, Math.max(frameDuration, exposure));
+            }
+        } else {
+            builder.set(CaptureRequest.CONTROL_AE_MODE,
+                CaptureRequest.CONTROL_AE_MODE_ON_AUTO_FLASH);
+        }
+
+        builder.set(CaptureRequest.CONTROL_AE_LOCK, c.aeLock);
+        builder.set(CaptureRequest.CONTROL_AWB_LOCK, c.awbLock);
+
+        if (c.noiseReductionMode >= 0) {
+            builder.set(CaptureRequest.NOISE_REDUCTION_MODE, c.noiseReductionMode);
+        }
+        if (c.edgeMode >= 0) {
+            builder.set(CaptureRequest.EDGE_MODE, c.edgeMode);
+        }
+        if (c.fpsMin > 0 && c.fpsMax >= c.fpsMin) {
+            builder.set(CaptureRequest.CONTROL_AE_TARGET_FPS_RANGE,
+                new android.util.Range<Integer>(c.fpsMin, c.fpsMax));
+        } else if (sessionFpsRange != null) {
+            builder.set(CaptureRequest.CONTROL_AE_TARGET_FPS_RANGE, sessionFpsRange);
+        }
+    }
     
+    // Rate-limited logging for code running once per frame on backgroundHandler
+    private void logFrameError(String message) {
+        long now = SystemClock.elapsedRealtime();
+        if (now - lastFrameLogMs < FRAME_LOG_INTERVAL_MS) {
+            suppressedFrameLogs++;
+            return;
+        }
+        if (suppressedFrameLogs > 0) {
+            message += " (" + suppressedFrameLogs + " similar messages suppressed)";
+        }
+        Log.w(TAG, message);
+        lastFrameLogMs = now;
+        suppressedFrameLogs = 0;
+    }
+
     private void processImage(Image image) {
         try {
             // Get all planes (Y, U, V) for full color processing
@@ -685,52 +1749,29 @@ public class Camera2Helper {
                 int imageWidth = image.getWidth();
                 int imageHeight = image.getHeight();
                 
-                Log.v(TAG, "Full color processing: " + imageWidth + "x" + imageHeight + 
-                      " planes=" + planes.length);
-                
-                // Extract Y data (full resolution)
+                // Plane buffers are direct; native reads them in place and copies into its ring
                 ByteBuffer yBuffer = yPlane.getBuffer();
-                int ySize = yBuffer.remaining();
-                byte[] yData = new byte[ySize];
-                yBuffer.get(yData);
-                
-                // Extract U data (usually half resolution)
                 ByteBuffer uBuffer = uPlane.getBuffer();
-                int uSize = uBuffer.remaining();
-                byte[] uData = new byte[uSize];
-                uBuffer.get(uData);
-                
-                // Extract V data (usually half resolution)
                 ByteBuffer vBuffer = vPlane.getBuffer();
-                int vSize = vBuffer.remaining();
-                byte[] vData = new byte[vSize];
-                vBuffer.get(vData);
-                
-                Log.d(TAG, "YUV data sizes - Y: " + ySize + ", U: " + uSize + ", V: " + vSize);
-                Log.d(TAG, "Plane strides - Y: " + yPlane.getRowStride() + 
-                      ", U: " + uPlane.getRowStride() + ", V: " + vPlane.getRowStride());
-                Log.d(TAG, "Pixel strides - Y: " + yPlane.getPixelStride() + 
-                      ", U: " + uPlane.getPixelStride() + ", V: " + vPlane.getPixelStride());
-                
-                // Convert YUV to RGB
-                byte[] rgbaData = convertYuvToRgba(yData, uData, vData, imageWidth, imageHeight,
-                    yPlane.getRowStride(), uPlane.getRowStride(), vPlane.getRowStride(),
-                    yPlane.getPixelStride(), uPlane.getPixelStride(), vPlane.getPixelStride());
-                
-                // Send to native
-                if (rgbaData != null) {
-                    latestFrameData = rgbaData;
-                    Log.v(TAG, "Sending full color RGBA data to native: size=" + rgbaData.length);
-                    onFrameAvailable(rgbaData, frameWidth, frameHeight);
+
+                if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.P) {
+                    int dataSpace = image.getDataSpace();
+                    if (dataSpace != lastDataSpace) {
+                        lastDataSpace = dataSpace;
+                        onStreamDataSpaceChanged(DISPLAY_STREAM_ID, dataSpace);
+                    }
                 }
+
+                // Conversion to BGRA happens on native worker threads
+                onYuvFrameAvailable(DISPLAY_STREAM_ID, yBuffer, uBuffer, vBuffer, imageWidth, imageHeight,
+                    yPlane.getRowStride(), uPlane.getRowStride(), uPlane.getPixelStride(), image.getTimestamp());
             } else {
-                Log.w(TAG, "Not enough planes for color processing (got " + planes.length + "), falling back to grayscale");
+                logFrameError("Not enough planes for color processing (got " + planes.length + "), falling back to grayscale");
                 // Fallback to grayscale processing if not enough planes
                 processImageGrayscale(image);
             }
         } catch (Exception e) {
-            Log.e(TAG, "Error in processImage: " + e.getMessage());
-            e.printStackTrace();
+            logFrameError("Error in processImage: " + e.getMessage());
         }
     }
     
@@ -746,14 +1787,20 @@ public class Camera2Helper {
                 int imageHeight = image.getHeight();
                 
                 // Extract Y data
-                byte[] yData = new byte[frameWidth * frameHeight];
+                if (grayscaleLuma == null || grayscaleLuma.length != frameWidth * frameHeight) {
+                    grayscaleLuma = new byte[frameWidth * frameHeight];
+                }
+                byte[] yData = grayscaleLuma;
                 int pixelStride = yPlane.getPixelStride();
                 int rowStride = yPlane.getRowStride();
                 
                 if (pixelStride == 1 && rowStride == imageWidth) {
                     yBuffer.get(yData);
                 } else {
-                    byte[] rowData = new byte[rowStride];
+                    if (grayscaleRow == null || grayscaleRow.length < rowStride) {
+                        grayscaleRow = new byte[rowStride];
+                    }
+                    byte[] rowData = grayscaleRow;
                     for (int row = 0; row < Math.min(imageHeight, frameHeight); row++) {
                         if (yBuffer.remaining() >= rowStride) {
                             yBuffer.get(rowData, 0, rowStride);
@@ -768,87 +1815,20 @@ public class Camera2Helper {
                 byte[] rgbaData = convertGrayscaleToRgba(yData, frameWidth, frameHeight);
                 
                 if (rgbaData != null) {
-                    latestFrameData = rgbaData;
-                    onFrameAvailable(rgbaData, frameWidth, frameHeight);
-                }
-            }
-        } catch (Exception e) {
-            Log.e(TAG, "Error in grayscale processing: " + e.getMessage());
-        }
-    }
-    
-    // New full-color YUV to RGBA conversion
-    private byte[] convertYuvToRgba(byte[] yData, byte[] uData, byte[] vData, 
-                                   int width, int height,
-                                   int yRowStride, int uRowStride, int vRowStride,
-                                   int yPixelStride, int uPixelStride, int vPixelStride) {
-        
-        byte[] rgba = new byte[frameWidth * frameHeight * 4];
-        
-        try {
-            // YUV420 typically has U and V planes at half resolution
-            int uvHeight = height / 2;
-            int uvWidth = width / 2;
-            
-            Log.d(TAG, "YUV conversion - Full: " + width + "x" + height + 
-                  ", UV: " + uvWidth + "x" + uvHeight);
-            
-            for (int row = 0; row < frameHeight && row < height; row++) {
-                for (int col = 0; col < frameWidth && col < width; col++) {
-                    
-                    // Get Y value (full resolution)
-                    int yIndex = row * yRowStride + col * yPixelStride;
-                    int yValue = (yIndex < yData.length) ? (yData[yIndex] & 0xFF) : 128;
-                    
-                    // Get U and V values (half resolution, so divide by 2)
-                    int uvRow = row / 2;
-                    int uvCol = col / 2;
-                    int uIndex = uvRow * uRowStride + uvCol * uPixelStride;
-                    int vIndex = uvRow * vRowStride + uvCol * vPixelStride;
-                    
-                    int uValue = (uIndex < uData.length) ? (uData[uIndex] & 0xFF) : 128;
-                    int vValue = (vIndex < vData.length) ? (vData[vIndex] & 0xFF) : 128;
-                    
-                    // YUV to RGB conversion - try full range (0-255) first
-                    // Many modern cameras use full range YUV instead of limited range
-                    int y = yValue;
-                    int u = uValue - 128;
-                    int v = vValue - 128;
-                    
-                    // Apply conversion matrix (full range version)
-                    int r = (int)(y + 1.402f * v);
-                    int g = (int)(y - 0.344f * u - 0.714f * v);
-                    int b = (int)(y + 1.772f * u);
-                    
-                    // Clamp to 0-255 range
-                    r = Math.max(0, Math.min(255, r));
-                    g = Math.max(0, Math.min(255, g));
-                    b = Math.max(0, Math.min(255, b));
-                    
-                    // Set BGRA format for UE5
-                    int pixelIndex = (row * frameWidth + col) * 4;
-                    rgba[pixelIndex] = (byte)b;       // B
-                    rgba[pixelIndex + 1] = (byte)g;   // G
-                    rgba[pixelIndex + 2] = (byte)r;   // R
-                    rgba[pixelIndex + 3] = (byte)255; // A
+                    onFrameAvailable(rgbaData, frameWidth, frameHeight, image.getTimestamp());
                 }
             }
-            
-            // Log first few RGB values for debugging
-            Log.d(TAG, "RGB conversion sample - R:" + (rgba[2] & 0xFF) + 
-                  " G:" + (rgba[1] & 0xFF) + " B:" + (rgba[0] & 0xFF));
-            
-            return rgba;
-            
         } catch (Exception e) {
-            Log.e(TAG, "Error in YUV to RGBA conversion: " + e.getMessage());
-            return convertGrayscaleToRgba(yData, frameWidth, frameHeight);
+            logFrameError("Error in grayscale processing: " + e.getMessage());
         }
     }
     
     // Legacy grayscale conversion method (renamed)
     private byte[] convertGrayscaleToRgba(byte[] yuv, int width, int height) {
-        byte[] rgba = new byte[width * height * 4];
+        if (grayscaleRgba == null || grayscaleRgba.length != width * height * 4) {
+            grayscaleRgba = new byte[width * height * 4];
+        }
+        byte[] rgba = grayscaleRgba;
         
         // Check if YUV data is all zeros (debugging)
         boolean allZero = true;
@@ -860,7 +1840,7 @@ public class Camera2Helper {
         }
         
         if (allZero) {
-            Log.w(TAG, "YUV data appears to be all zeros, generating test pattern");
+            logFrameError("YUV data appears to be all zeros, generating test pattern");
             // Generate bright colorful test pattern - quarters with different colors
             for (int y = 0; y < height; y++) {
                 for (int x = 0; x < width; x++) {
@@ -889,15 +1869,7 @@ public class Camera2Helper {
                     rgba[i + 3] = (byte)255;   // A (fully opaque)
                 }
             }
-            
-            // Log first few RGBA values to verify pattern generation
-            Log.d(TAG, "Test pattern generated - first RGBA values: [" +
-                  (rgba[0] & 0xFF) + "," + (rgba[1] & 0xFF) + "," + 
-                  (rgba[2] & 0xFF) + "," + (rgba[3] & 0xFF) + "] [" +
-                  (rgba[4] & 0xFF) + "," + (rgba[5] & 0xFF) + "," + 
-                  (rgba[6] & 0xFF) + "," + (rgba[7] & 0xFF) + "]");
         } else {
-            Log.d(TAG, "YUV data has values, converting to grayscale");
             // Convert Y channel to RGBA (grayscale)
             for (int i = 0; i < width * height; i++) {
                 int y = yuv[i] & 0xFF;
@@ -914,6 +1886,7 @@ public class Camera2Helper {
     
     public void stopCamera() {
         isCapturing = false;
+        isPaused = false;
         
         if (captureSession != null) {
             captureSession.close();
@@ -929,8 +1902,35 @@ public class Camera2Helper {
             imageReader.close();
             imageReader = null;
         }
+
+        for (AnalysisStream stream : analysisStreams) {
+            if (stream.reader != null) {
+                stream.reader.close();
+                stream.reader = null;
+            }
+        }
+
+        if (stillReader != null) {
+            stillReader.close();
+            stillReader = null;
+        }
+        if (stillThread != null) {
+            stillThread.quitSafely();
+            try {
+                stillThread.join();
+            } catch (InterruptedException e) {
+                Log.e(TAG, "Error stopping still thread");
+            }
+            stillThread = null;
+            stillHandler = null;
+        }
         
         stopBackgroundThread();
+        // The background thread is gone, nothing fills the fallback buffers any more
+        grayscaleLuma = null;
+        grayscaleRow = null;
+        grayscaleRgba = null;
+        afTriggerLocked = false;
         Log.d(TAG, "Camera stopped");
     }
     
@@ -953,8 +1953,9 @@ public class Camera2Helper {
         }
     }
     
+    // Last grayscale fallback frame as RGBA; the array is reused and overwritten by the next frame
     public byte[] getLatestFrame() {
-        return latestFrameData;
+        return grayscaleRgba;
     }
     
     // Method to check permission status (callable from C++)
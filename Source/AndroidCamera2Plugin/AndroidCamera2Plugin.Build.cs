@@ -20,7 +20,10 @@ public class AndroidCamera2Plugin : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
-				// Keep it minimal for now
+				"RenderCore",     // ENQUEUE_RENDER_COMMAND / FlushRenderingCommands
+				"RHI",
+				"Sockets",        // preview streaming
+				"Networking"      // FTcpSocketBuilder
 			}
 		);
 
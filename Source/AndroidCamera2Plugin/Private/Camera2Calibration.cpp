@@ -0,0 +1,160 @@
+#include "Camera2Calibration.h"
+
+#include "Async/ParallelFor.h"
+
+namespace Camera2Calibration
+{
+    // Rows per ParallelFor band of the ray table
+    static constexpr int32 RayTableBandRows = 32;
+
+    FCropRect GetOutputCrop(const FIntRect& CropRegion, int32 Width, int32 Height)
+    {
+        FCropRect Crop;
+        Crop.Left = CropRegion.Min.X;
+        Crop.Top = CropRegion.Min.Y;
+        Crop.Width = CropRegion.Width();
+        Crop.Height = CropRegion.Height();
+        if (Width <= 0 || Height <= 0 || Crop.Width <= 0.0 || Crop.Height <= 0.0)
+        {
+            return Crop;
+        }
+
+        // Compare aspects as cross products so equal aspects never round into a sliver crop
+        const double OutputSpan = static_cast<double>(Width) * Crop.Height;
+        const double CropSpan = static_cast<double>(Height) * Crop.Width;
+        if (OutputSpan > CropSpan)
+        {
+            // Wider output: letterbox the crop region
+            const double CroppedHeight = Crop.Width * Height / Width;
+            Crop.Top += (Crop.Height - CroppedHeight) * 0.5;
+            Crop.Height = CroppedHeight;
+        }
+        else if (OutputSpan < CropSpan)
+        {
+            // Taller output: pillarbox the crop region
+            const double CroppedWidth = Crop.Height * Width / Height;
+            Crop.Left += (Crop.Width - CroppedWidth) * 0.5;
+            Crop.Width = CroppedWidth;
+        }
+        return Crop;
+    }
+
+    bool ComputeStreamIntrinsics(const FSensorCalibration& Sensor, const FIntRect& CropRegion, int32 Width, int32 Height,
+        FCamera2StreamIntrinsics& OutIntrinsics)
+    {
+        OutIntrinsics = FCamera2StreamIntrinsics();
+        if (!Sensor.IsValid() || Width <= 0 || Height <= 0 || CropRegion.Width() <= 0 || CropRegion.Height() <= 0)
+        {
+            return false;
+        }
+
+        const FCropRect Crop = GetOutputCrop(CropRegion, Width, Height);
+        const double ScaleX = Width / Crop.Width;
+        const double ScaleY = Height / Crop.Height;
+
+        // Principal point in active array pixels; without a pre-correction array both arrays coincide
+        const FIntPoint PreCorrectionOrigin = Sensor.PreCorrectionArray.Width() > 0 ? Sensor.PreCorrectionArray.Min : Sensor.ActiveArray.Min;
+        const double ActiveCx = Sensor.Cx + (PreCorrectionOrigin.X - Sensor.ActiveArray.Min.X);
+        const double ActiveCy = Sensor.Cy + (PreCorrectionOrigin.Y - Sensor.ActiveArray.Min.Y);
+
+        const double Fx = Sensor.Fx * ScaleX;
+        const double Fy = Sensor.Fy * ScaleY;
+        const double Cx = (ActiveCx + 0.5 - Crop.Left) * ScaleX - 0.5;
+        const double Cy = (ActiveCy + 0.5 - Crop.Top) * ScaleY - 0.5;
+
+        OutIntrinsics.bValid = true;
+        OutIntrinsics.Size = FIntPoint(Width, Height);
+        OutIntrinsics.Fx = static_cast<float>(Fx);
+        OutIntrinsics.Fy = static_cast<float>(Fy);
+        OutIntrinsics.Cx = static_cast<float>(Cx);
+        OutIntrinsics.Cy = static_cast<float>(Cy);
+        OutIntrinsics.Skew = static_cast<float>(Sensor.Skew * ScaleX);
+        OutIntrinsics.K1 = static_cast<float>(Sensor.K[0]);
+        OutIntrinsics.K2 = static_cast<float>(Sensor.K[1]);
+        OutIntrinsics.K3 = static_cast<float>(Sensor.K[2]);
+        OutIntrinsics.P1 = static_cast<float>(Sensor.P[0]);
+        OutIntrinsics.P2 = static_cast<float>(Sensor.P[1]);
+        OutIntrinsics.CropOrigin = FVector2D(Crop.Left, Crop.Top);
+        OutIntrinsics.CropSize = FVector2D(Crop.Width, Crop.Height);
+
+        // Image edges are half a pixel outside the first and last pixel centers
+        const double RadToDeg = 180.0 / UE_DOUBLE_PI;
+        OutIntrinsics.HorizontalFovDegrees = static_cast<float>(
+            (FMath::Atan2(Cx + 0.5, Fx) + FMath::Atan2(Width - 0.5 - Cx, Fx)) * RadToDeg);
+        OutIntrinsics.VerticalFovDegrees = static_cast<float>(
+            (FMath::Atan2(Cy + 0.5, Fy) + FMath::Atan2(Height - 0.5 - Cy, Fy)) * RadToDeg);
+        return true;
+    }
+
+    bool ComputeStreamIntrinsics(const FSensorCalibration& Sensor, int32 Width, int32 Height, FCamera2StreamIntrinsics& OutIntrinsics)
+    {
+        const FIntRect DefaultCrop(FIntPoint::ZeroValue, FIntPoint(Sensor.ActiveArray.Width(), Sensor.ActiveArray.Height()));
+        return ComputeStreamIntrinsics(Sensor, DefaultCrop, Width, Height, OutIntrinsics);
+    }
+
+    void DistortNormalized(const double K[3], const double P[2], double X, double Y, double& OutX, double& OutY)
+    {
+        const double R2 = X * X + Y * Y;
+        const double Radial = 1.0 + R2 * (K[0] + R2 * (K[1] + R2 * K[2]));
+        OutX = X * Radial + 2.0 * P[0] * X * Y + P[1] * (R2 + 2.0 * X * X);
+        OutY = Y * Radial + P[0] * (R2 + 2.0 * Y * Y) + 2.0 * P[1] * X * Y;
+    }
+
+    void UndistortNormalized(const double K[3], const double P[2], double X, double Y, double& OutX, double& OutY)
+    {
+        double Ux = X;
+        double Uy = Y;
+        if (K[0] != 0.0 || K[1] != 0.0 || K[2] != 0.0 || P[0] != 0.0 || P[1] != 0.0)
+        {
+            for (int32 Iteration = 0; Iteration < 10; ++Iteration)
+            {
+                const double R2 = Ux * Ux + Uy * Uy;
+                const double Radial = 1.0 + R2 * (K[0] + R2 * (K[1] + R2 * K[2]));
+                const double Dx = 2.0 * P[0] * Ux * Uy + P[1] * (R2 + 2.0 * Ux * Ux);
+                const double Dy = P[0] * (R2 + 2.0 * Uy * Uy) + 2.0 * P[1] * Ux * Uy;
+                Ux = (X - Dx) / Radial;
+                Uy = (Y - Dy) / Radial;
+            }
+        }
+        OutX = Ux;
+        OutY = Uy;
+    }
+
+    void BuildRayTable(const FCamera2StreamIntrinsics& Intrinsics, FCamera2RayTable& OutTable)
+    {
+        OutTable.Width = Intrinsics.bValid ? Intrinsics.Size.X : 0;
+        OutTable.Height = Intrinsics.bValid ? Intrinsics.Size.Y : 0;
+        OutTable.Directions.SetNumUninitialized(OutTable.Width * OutTable.Height);
+        if (OutTable.Directions.Num() == 0)
+        {
+            return;
+        }
+
+        const double K[3] = { Intrinsics.K1, Intrinsics.K2, Intrinsics.K3 };
+        const double P[2] = { Intrinsics.P1, Intrinsics.P2 };
+        const int32 Width = OutTable.Width;
+        const int32 Height = OutTable.Height;
+        const int32 NumBands = (Height + RayTableBandRows - 1) / RayTableBandRows;
+        FVector3f* Directions = OutTable.Directions.GetData();
+        ParallelFor(NumBands, [&](int32 Band)
+        {
+            const int32 EndRow = FMath::Min(Height, (Band + 1) * RayTableBandRows);
+            for (int32 Row = Band * RayTableBandRows; Row < EndRow; ++Row)
+            {
+                const double DistortedY = (Row - Intrinsics.Cy) / Intrinsics.Fy;
+                FVector3f* Out = Directions + static_cast<int64>(Row) * Width;
+                for (int32 Column = 0; Column < Width; ++Column)
+                {
+                    const double DistortedX = (Column - Intrinsics.Cx - Intrinsics.Skew * DistortedY) / Intrinsics.Fx;
+                    double X, Y;
+                    UndistortNormalized(K, P, DistortedX, DistortedY, X, Y);
+
+                    // Camera axes (x right, y down, z forward) to UE camera axes (X forward, Y right, Z up)
+                    const double InvLength = 1.0 / FMath::Sqrt(X * X + Y * Y + 1.0);
+                    Out[Column] = FVector3f(static_cast<float>(InvLength), static_cast<float>(X * InvLength),
+                        static_cast<float>(-Y * InvLength));
+                }
+            }
+        });
+    }
+}
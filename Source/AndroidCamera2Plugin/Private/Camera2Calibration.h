@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera2Types.h"
+
+/**
+ * Lens calibration of the camera mapped to its output streams.
+ *
+ * LENS_INTRINSIC_CALIBRATION is given in SENSOR_INFO_PRE_CORRECTION_ACTIVE_ARRAY_SIZE pixels. An output stream
+ * shows the request's crop region (SCALER_CROP_REGION, active array pixels, the whole active array by default)
+ * further cut to the stream's aspect ratio around its center and scaled to the stream size, so its intrinsics
+ * follow from shifting the principal point into the crop and scaling by stream size / crop size. Pixel centers
+ * are at integer coordinates, so the scale is applied about pixel edges. LENS_DISTORTION acts on normalized
+ * coordinates and carries over unchanged (streams are assumed to run with DISTORTION_CORRECTION_MODE off).
+ */
+namespace Camera2Calibration
+{
+    /** Calibration of the sensor as reported by the camera characteristics */
+    struct FSensorCalibration
+    {
+        // Pre-correction active array pixels
+        double Fx = 0.0;
+        double Fy = 0.0;
+        double Cx = 0.0;
+        double Cy = 0.0;
+        double Skew = 0.0;
+        // Brown-Conrady k1..k3 and p1, p2
+        double K[3] = { 0.0, 0.0, 0.0 };
+        double P[2] = { 0.0, 0.0 };
+        // Both in pixel array coordinates
+        FIntRect ActiveArray;
+        FIntRect PreCorrectionArray;
+
+        bool IsValid() const { return Fx > 0.0 && Fy > 0.0 && ActiveArray.Width() > 0 && ActiveArray.Height() > 0; }
+    };
+
+    /** Region of the active array an output of Width x Height shows for a crop region (active array pixels) */
+    struct FCropRect
+    {
+        double Left = 0.0;
+        double Top = 0.0;
+        double Width = 0.0;
+        double Height = 0.0;
+    };
+    FCropRect GetOutputCrop(const FIntRect& CropRegion, int32 Width, int32 Height);
+
+    /**
+     * Intrinsics and distortion of a Width x Height output for a crop region in active array pixels
+     * @return false (OutIntrinsics.bValid unset) if the calibration or the size is missing
+     */
+    bool ComputeStreamIntrinsics(const FSensorCalibration& Sensor, const FIntRect& CropRegion, int32 Width, int32 Height,
+        FCamera2StreamIntrinsics& OutIntrinsics);
+
+    /** Same with the default crop region (the whole active array) */
+    bool ComputeStreamIntrinsics(const FSensorCalibration& Sensor, int32 Width, int32 Height, FCamera2StreamIntrinsics& OutIntrinsics);
+
+    /** Invert the Brown-Conrady model on normalized coordinates by fixed-point iteration */
+    void UndistortNormalized(const double K[3], const double P[2], double X, double Y, double& OutX, double& OutY);
+
+    /** Apply the Brown-Conrady model to normalized coordinates */
+    void DistortNormalized(const double K[3], const double P[2], double X, double Y, double& OutX, double& OutY);
+
+    /** Undistorted unit ray of every stream pixel; rows are built in parallel */
+    void BuildRayTable(const FCamera2StreamIntrinsics& Intrinsics, FCamera2RayTable& OutTable);
+}
@@ -0,0 +1,314 @@
+#include "Camera2ClockMapper.h"
+#include <algorithm>
+
+void FCamera2ClockMapper::Reset()
+{
+    bHasReference = false;
+    ReferenceNs = 0;
+    BucketHead = 0;
+    BucketCount = 0;
+    Current = FBucket();
+    CurrentStart = 0.0;
+    LatestTime = 0.0;
+    PendingStep = FBucket();
+    LastEstimate = FEstimate();
+    Publish(LastEstimate);
+    SampleCount.store(0, std::memory_order_relaxed);
+    StepCount.store(0, std::memory_order_relaxed);
+}
+
+void FCamera2ClockMapper::AddSample(int64 SensorTimestampNs, double EngineSeconds)
+{
+    if (!bHasReference)
+    {
+        ReferenceNs = SensorTimestampNs;
+        bHasReference = true;
+    }
+
+    // Offsets are kept relative to the first sensor timestamp so doubles keep sub-microsecond precision
+    const double Time = static_cast<double>(SensorTimestampNs - ReferenceNs) * 1.0e-9;
+    if (Time < LatestTime)
+    {
+        return;
+    }
+    LatestTime = Time;
+    SampleCount.fetch_add(1, std::memory_order_relaxed);
+
+    const double Delta = EngineSeconds - Time;
+    if (Current.Count > 0 && Time - CurrentStart >= BucketSeconds)
+    {
+        CloseBucket();
+    }
+    if (Current.Count == 0)
+    {
+        CurrentStart = Time;
+        Current.Time = Time;
+        Current.Delta = Delta;
+        Current.MaxDelta = Delta;
+    }
+    else
+    {
+        if (Delta < Current.Delta)
+        {
+            Current.Time = Time;
+            Current.Delta = Delta;
+        }
+        Current.MaxDelta = FMath::Max(Current.MaxDelta, Delta);
+    }
+    ++Current.Count;
+
+    FEstimate Estimate;
+    if (Fit(Estimate))
+    {
+        LastEstimate = Estimate;
+        Publish(Estimate);
+    }
+}
+
+void FCamera2ClockMapper::CloseBucket()
+{
+    const FBucket Closed = Current;
+    Current = FBucket();
+
+    if (BucketCount >= 2 && FMath::Abs(Closed.Delta - Predict(LastEstimate, Closed.Time)) > StepSeconds)
+    {
+        // A single off-line window is a stall and dropped; two in a row agreeing on a new offset are a clock step
+        if (PendingStep.Count > 0 && FMath::Abs(Closed.Delta - PendingStep.Delta) <= StepSeconds)
+        {
+            Buckets[0] = PendingStep;
+            Buckets[1] = Closed;
+            BucketHead = 2;
+            BucketCount = 2;
+            PendingStep = FBucket();
+            StepCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            PendingStep = Closed;
+        }
+        return;
+    }
+
+    PendingStep = FBucket();
+    Buckets[BucketHead] = Closed;
+    BucketHead = (BucketHead + 1) % NumBuckets;
+    BucketCount = FMath::Min(BucketCount + 1, NumBuckets);
+}
+
+bool FCamera2ClockMapper::Fit(FEstimate& Out) const
+{
+    double Times[NumBuckets + 1];
+    double Deltas[NumBuckets + 1];
+    bool bUse[NumBuckets + 1];
+    double LatencySpread = 0.0;
+    int32 Num = 0;
+    for (int32 i = 0; i < BucketCount; ++i)
+    {
+        const FBucket& Bucket = Buckets[(BucketHead - BucketCount + i + NumBuckets) % NumBuckets];
+        Times[Num] = Bucket.Time;
+        Deltas[Num] = Bucket.Delta;
+        LatencySpread = FMath::Max(LatencySpread, Bucket.MaxDelta - Bucket.Delta);
+        ++Num;
+    }
+    // The open window joins the fit unless it is already off the line (possible stall or step)
+    if (Current.Count > 0 && (BucketCount < 2 || FMath::Abs(Current.Delta - Predict(LastEstimate, Current.Time)) <= StepSeconds))
+    {
+        Times[Num] = Current.Time;
+        Deltas[Num] = Current.Delta;
+        LatencySpread = FMath::Max(LatencySpread, Current.MaxDelta - Current.Delta);
+        ++Num;
+    }
+    if (Num == 0)
+    {
+        return false;
+    }
+    for (int32 i = 0; i < Num; ++i)
+    {
+        bUse[i] = true;
+    }
+
+    Out.ReferenceNs = ReferenceNs;
+    Out.LatestTime = LatestTime;
+    for (int32 Pass = 0; Pass < 2; ++Pass)
+    {
+        int32 Count = 0;
+        double SumTime = 0.0;
+        double SumDelta = 0.0;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            if (bUse[i])
+            {
+                SumTime += Times[i];
+                SumDelta += Deltas[i];
+                ++Count;
+            }
+        }
+        const double MeanTime = SumTime / Count;
+        const double MeanDelta = SumDelta / Count;
+        double Sxx = 0.0;
+        double Sxy = 0.0;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            if (bUse[i])
+            {
+                Sxx += (Times[i] - MeanTime) * (Times[i] - MeanTime);
+                Sxy += (Times[i] - MeanTime) * (Deltas[i] - MeanDelta);
+            }
+        }
+
+        // Drift needs the window to span some time; until then it is an offset-only estimate
+        const bool bHasSlope = Count >= 2 && Sxx > 1.0e-2;
+        Out.MeanTime = MeanTime;
+        Out.Offset = MeanDelta;
+        Out.Drift = bHasSlope ? Sxy / Sxx : 0.0;
+        Out.InvCount = 1.0 / Count;
+        Out.InvSxx = bHasSlope ? 1.0 / Sxx : 0.0;
+        Out.Points = Count;
+
+        double Residuals[NumBuckets + 1];
+        double SquaredSum = 0.0;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            Residuals[i] = Deltas[i] - Predict(Out, Times[i]);
+            if (bUse[i])
+            {
+                SquaredSum += Residuals[i] * Residuals[i];
+            }
+        }
+
+        if (Count < 3)
+        {
+            // Too few windows for a residual spread; bound by the latency jitter seen so far
+            Out.Sigma = 0.0;
+            Out.ErrorFloor = FMath::Max(LatencySpread, 1.0e-6);
+            return true;
+        }
+        Out.Sigma = FMath::Sqrt(SquaredSum / (Count - 2));
+        Out.ErrorFloor = 1.0e-6;
+
+        if (Pass == 1 || Count < 4)
+        {
+            break;
+        }
+
+        // Latency only ever adds to a window's minimum, so only windows well above the line are rejected
+        double AbsResiduals[NumBuckets + 1];
+        int32 NumAbs = 0;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            if (bUse[i])
+            {
+                AbsResiduals[NumAbs++] = FMath::Abs(Residuals[i]);
+            }
+        }
+        std::nth_element(AbsResiduals, AbsResiduals + NumAbs / 2, AbsResiduals + NumAbs);
+        const double Threshold = FMath::Max(4.0 * 1.4826 * AbsResiduals[NumAbs / 2], 1.0e-4);
+
+        int32 Rejected = 0;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            if (bUse[i] && Residuals[i] > Threshold && Count - Rejected > 3)
+            {
+                bUse[i] = false;
+                ++Rejected;
+            }
+        }
+        if (Rejected == 0)
+        {
+            break;
+        }
+    }
+    return true;
+}
+
+void FCamera2ClockMapper::Publish(const FEstimate& Estimate)
+{
+    const uint32 Begin = Sequence.load(std::memory_order_relaxed) + 1;
+    Sequence.store(Begin, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    PublishedReferenceNs.store(Estimate.ReferenceNs, std::memory_order_relaxed);
+    PublishedOffset.store(Estimate.Offset, std::memory_order_relaxed);
+    PublishedDrift.store(Estimate.Drift, std::memory_order_relaxed);
+    PublishedMeanTime.store(Estimate.MeanTime, std::memory_order_relaxed);
+    PublishedSigma.store(Estimate.Sigma, std::memory_order_relaxed);
+    PublishedInvCount.store(Estimate.InvCount, std::memory_order_relaxed);
+    PublishedInvSxx.store(Estimate.InvSxx, std::memory_order_relaxed);
+    PublishedErrorFloor.store(Estimate.ErrorFloor, std::memory_order_relaxed);
+    PublishedLatestTime.store(Estimate.LatestTime, std::memory_order_relaxed);
+    PublishedPoints.store(Estimate.Points, std::memory_order_relaxed);
+
+    Sequence.store(Begin + 1, std::memory_order_release);
+}
+
+bool FCamera2ClockMapper::ReadEstimate(FEstimate& Out) const
+{
+    for (;;)
+    {
+        const uint32 Begin = Sequence.load(std::memory_order_acquire);
+        if (Begin & 1)
+        {
+            FPlatformProcess::YieldThread();
+            continue;
+        }
+
+        Out.ReferenceNs = PublishedReferenceNs.load(std::memory_order_relaxed);
+        Out.Offset = PublishedOffset.load(std::memory_order_relaxed);
+        Out.Drift = PublishedDrift.load(std::memory_order_relaxed);
+        Out.MeanTime = PublishedMeanTime.load(std::memory_order_relaxed);
+        Out.Sigma = PublishedSigma.load(std::memory_order_relaxed);
+        Out.InvCount = PublishedInvCount.load(std::memory_order_relaxed);
+        Out.InvSxx = PublishedInvSxx.load(std::memory_order_relaxed);
+        Out.ErrorFloor = PublishedErrorFloor.load(std::memory_order_relaxed);
+        Out.LatestTime = PublishedLatestTime.load(std::memory_order_relaxed);
+        Out.Points = PublishedPoints.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (Sequence.load(std::memory_order_relaxed) == Begin)
+        {
+            return Out.Points > 0;
+        }
+    }
+}
+
+double FCamera2ClockMapper::ErrorAt(const FEstimate& Estimate, double Time)
+{
+    // Confidence band of a least-squares line, widening away from the window's mean time
+    const double FromMean = Time - Estimate.MeanTime;
+    return FMath::Max(Estimate.ErrorFloor,
+        3.0 * Estimate.Sigma * FMath::Sqrt(Estimate.InvCount + FromMean * FromMean * Estimate.InvSxx));
+}
+
+bool FCamera2ClockMapper::MapToEngineSeconds(int64 SensorTimestampNs, double& OutEngineSeconds, double& OutErrorSeconds) const
+{
+    FEstimate Estimate;
+    if (!ReadEstimate(Estimate))
+    {
+        return false;
+    }
+
+    const double Time = static_cast<double>(SensorTimestampNs - Estimate.ReferenceNs) * 1.0e-9;
+    OutEngineSeconds = Time + Predict(Estimate, Time);
+    OutErrorSeconds = ErrorAt(Estimate, Time);
+    return true;
+}
+
+FCamera2ClockMapping FCamera2ClockMapper::GetMapping() const
+{
+    FCamera2ClockMapping Mapping;
+    Mapping.Samples = SampleCount.load(std::memory_order_relaxed);
+    Mapping.ClockSteps = StepCount.load(std::memory_order_relaxed);
+
+    FEstimate Estimate;
+    if (!ReadEstimate(Estimate))
+    {
+        return Mapping;
+    }
+
+    Mapping.bValid = true;
+    Mapping.OffsetSeconds = Predict(Estimate, Estimate.LatestTime) - static_cast<double>(Estimate.ReferenceNs) * 1.0e-9;
+    Mapping.DriftPpm = static_cast<float>(Estimate.Drift * 1.0e6);
+    Mapping.ErrorSeconds = ErrorAt(Estimate, Estimate.LatestTime);
+    Mapping.WindowPoints = Estimate.Points;
+    return Mapping;
+}
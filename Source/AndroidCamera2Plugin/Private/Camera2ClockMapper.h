@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera2Types.h"
+#include <atomic>
+
+/**
+ * Online mapping from the camera's SENSOR_TIMESTAMP clock to FPlatformTime::Seconds.
+ *
+ * The sensor clock is CLOCK_MONOTONIC-like or elapsedRealtime depending on SENSOR_INFO_TIMESTAMP_SOURCE,
+ * so instead of assuming a domain the mapper pairs every onCaptureStarted timestamp with the engine time
+ * the callback arrived at. Each pair is the true offset plus a positive, jittery callback latency. Per
+ * BucketSeconds window only the pair with the smallest difference is kept, and a line fitted through the
+ * last NumBuckets minima gives offset and drift. Outlier windows (scheduler stalls) are rejected; a
+ * persistent step (device suspend with a boot-time clock) restarts the fit.
+ *
+ * One writer (Camera2Helper background thread). The estimate is published through a sequence lock, so
+ * readers on any thread never block and never see a torn estimate.
+ */
+class FCamera2ClockMapper
+{
+public:
+    static constexpr int32 NumBuckets = 16;
+    static constexpr double BucketSeconds = 0.5;
+    // Bucket minima further than this from the fit are outliers, or a clock step if it persists
+    static constexpr double StepSeconds = 0.02;
+
+    /** While no writer is running (camera stopped) */
+    void Reset();
+
+    /** Writer thread: one sensor timestamp and the engine time it was observed at */
+    void AddSample(int64 SensorTimestampNs, double EngineSeconds);
+
+    /**
+     * Any thread, lock-free
+     * @param OutErrorSeconds 3-sigma bound of the fitted line at that time; the constant latency floor of the
+     *        capture callback itself is not observable and not included
+     * @return false until the first sample arrived
+     */
+    bool MapToEngineSeconds(int64 SensorTimestampNs, double& OutEngineSeconds, double& OutErrorSeconds) const;
+
+    /** Any thread: current estimate (TimestampSource is filled in by the caller) */
+    FCamera2ClockMapping GetMapping() const;
+
+private:
+    struct FBucket
+    {
+        double Time = 0.0;      // sensor seconds since ReferenceNs of the minimum
+        double Delta = 0.0;     // engine - sensor seconds of the minimum
+        double MaxDelta = 0.0;
+        int32 Count = 0;
+    };
+
+    struct FEstimate
+    {
+        int64 ReferenceNs = 0;
+        double Offset = 0.0;
+        double Drift = 0.0;
+        double MeanTime = 0.0;
+        double Sigma = 0.0;
+        double InvCount = 0.0;
+        double InvSxx = 0.0;
+        double ErrorFloor = 0.0;
+        double LatestTime = 0.0;
+        int32 Points = 0;
+    };
+
+    void CloseBucket();
+    bool Fit(FEstimate& Out) const;
+    void Publish(const FEstimate& Estimate);
+    bool ReadEstimate(FEstimate& Out) const;
+    static double ErrorAt(const FEstimate& Estimate, double Time);
+    static double Predict(const FEstimate& Estimate, double Time) { return Estimate.Offset + Estimate.Drift * (Time - Estimate.MeanTime); }
+
+    // Writer state
+    int64 ReferenceNs = 0;
+    bool bHasReference = false;
+    FBucket Buckets[NumBuckets];
+    int32 BucketHead = 0;
+    int32 BucketCount = 0;
+    FBucket Current;
+    double CurrentStart = 0.0;
+    double LatestTime = 0.0;
+    FBucket PendingStep;
+    FEstimate LastEstimate;
+
+    // Published estimate; Sequence is odd while the writer updates the fields
+    std::atomic<uint32> Sequence{0};
+    std::atomic<int64> PublishedReferenceNs{0};
+    std::atomic<double> PublishedOffset{0.0};
+    std::atomic<double> PublishedDrift{0.0};
+    std::atomic<double> PublishedMeanTime{0.0};
+    std::atomic<double> PublishedSigma{0.0};
+    std::atomic<double> PublishedInvCount{0.0};
+    std::atomic<double> PublishedInvSxx{0.0};
+    std::atomic<double> PublishedErrorFloor{0.0};
+    std::atomic<double> PublishedLatestTime{0.0};
+    std::atomic<int32> PublishedPoints{0};
+
+    std::atomic<int64> SampleCount{0};
+    std::atomic<int32> StepCount{0};
+};
@@ -0,0 +1,111 @@
+#include "Camera2ColorTransform.h"
+
+namespace Camera2Yuv
+{
+    FYuvMatrix MakeYuvMatrix(ECamera2ColorStandard Standard, bool bFullRange)
+    {
+        // Luma weights of the standard
+        double Kr = 0.299;
+        double Kb = 0.114;
+        if (Standard == ECamera2ColorStandard::BT709)
+        {
+            Kr = 0.2126;
+            Kb = 0.0722;
+        }
+        else if (Standard == ECamera2ColorStandard::BT2020)
+        {
+            Kr = 0.2627;
+            Kb = 0.0593;
+        }
+        const double Kg = 1.0 - Kr - Kb;
+
+        const double YScale = bFullRange ? 1.0 : 255.0 / 219.0;
+        const double CScale = bFullRange ? 1.0 : 255.0 / 224.0;
+        const double One = static_cast<double>(1 << MatrixShift);
+        auto ToFixed = [One](double Value) { return static_cast<int32>(Value * One + (Value < 0.0 ? -0.5 : 0.5)); };
+
+        FYuvMatrix Matrix;
+        Matrix.YOffset = bFullRange ? 0 : 16;
+        Matrix.YScale = ToFixed(YScale);
+        Matrix.RV = ToFixed(2.0 * (1.0 - Kr) * CScale);
+        Matrix.BU = ToFixed(2.0 * (1.0 - Kb) * CScale);
+        Matrix.GU = ToFixed(-2.0 * Kb * (1.0 - Kb) / Kg * CScale);
+        Matrix.GV = ToFixed(-2.0 * Kr * (1.0 - Kr) / Kg * CScale);
+        return Matrix;
+    }
+
+    void ResolveDataSpace(int32 DataSpace, ECamera2ColorStandard& OutStandard, bool& bOutFullRange)
+    {
+        OutStandard = ECamera2ColorStandard::BT601;
+        bOutFullRange = true;
+
+        // Legacy DataSpace constants
+        switch (DataSpace)
+        {
+        case 0x101: // JFIF
+            return;
+        case 0x102: // BT601_625
+        case 0x103: // BT601_525
+            bOutFullRange = false;
+            return;
+        case 0x104: // BT709
+            OutStandard = ECamera2ColorStandard::BT709;
+            bOutFullRange = false;
+            return;
+        default:
+            break;
+        }
+
+        const int32 StandardBits = (DataSpace >> 16) & 0x3F;
+        const int32 RangeBits = (DataSpace >> 27) & 0x7;
+        if (StandardBits == 1)
+        {
+            OutStandard = ECamera2ColorStandard::BT709;
+        }
+        else if (StandardBits == 6 || StandardBits == 7)
+        {
+            OutStandard = ECamera2ColorStandard::BT2020;
+        }
+        bOutFullRange = (RangeBits != 2);
+    }
+
+    bool BuildColorLut(int32 Size, const float* Rgb, FColorLut& OutLut)
+    {
+        if (Size < 2 || Size > MaxLutSize || !Rgb)
+        {
+            return false;
+        }
+
+        auto ToByte = [](float Value) -> uint32
+        {
+            const int32 Scaled = static_cast<int32>(Value * 255.0f + 0.5f);
+            return static_cast<uint32>(Scaled < 0 ? 0 : (Scaled > 255 ? 255 : Scaled));
+        };
+
+        const int32 NumEntries = Size * Size * Size;
+        OutLut.Size = Size;
+        OutLut.Entries.SetNumUninitialized(NumEntries);
+        for (int32 i = 0; i < NumEntries; ++i)
+        {
+            const float* Src = Rgb + i * 3;
+            OutLut.Entries[i] = ToByte(Src[2]) | (ToByte(Src[1]) << 8) | (ToByte(Src[0]) << 16) | 0xFF000000u;
+        }
+
+        for (int32 Value = 0; Value < 256; ++Value)
+        {
+            // Position on the lattice in 1/256 steps
+            const int32 Position = (Value * (Size - 1) * 256 + 127) / 255;
+            int32 Cell = Position >> 8;
+            int32 Fraction = Position & 255;
+            if (Cell >= Size - 1)
+            {
+                Cell = Size - 2;
+                Fraction = 256;
+            }
+            OutLut.Lookup[0][Value] = (Cell << FColorLut::FractionBits) | Fraction;
+            OutLut.Lookup[1][Value] = ((Cell * Size) << FColorLut::FractionBits) | Fraction;
+            OutLut.Lookup[2][Value] = ((Cell * Size * Size) << FColorLut::FractionBits) | Fraction;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera2Types.h"
+
+/**
+ * Color stage fused into the YUV conversion kernels: a fixed-point YUV -> RGB matrix chosen from the
+ * stream's DataSpace (or forced by the user) and an optional calibration 3D LUT sampled with
+ * tetrahedral interpolation. Matrix and LUT paths are bit-identical between SIMD and scalar code.
+ */
+namespace Camera2Yuv
+{
+    /** Coefficients in MatrixShift fixed point: C = (YScale * (Y - YOffset) + CU * (U - 128) + CV * (V - 128)) >> MatrixShift */
+    struct FYuvMatrix
+    {
+        int32 YOffset = 0;
+        int32 YScale = 0;
+        int32 RV = 0;
+        int32 GU = 0;
+        int32 GV = 0;
+        int32 BU = 0;
+    };
+
+    static constexpr int32 MatrixShift = 13;
+
+    FYuvMatrix MakeYuvMatrix(ECamera2ColorStandard Standard, bool bFullRange);
+
+    /**
+     * Resolve an android.hardware.DataSpace value (legacy or STANDARD/RANGE bit fields) to a matrix
+     * standard and range. Unknown values map to JFIF (BT.601 full range), the camera YUV_420_888 default.
+     */
+    void ResolveDataSpace(int32 DataSpace, ECamera2ColorStandard& OutStandard, bool& bOutFullRange);
+
+    /**
+     * 3D LUT with BGRA8 entries (red index fastest) and per-axis lookup tables mapping an 8-bit value to
+     * its lattice cell offset (high bits) and fraction in 1/256 steps (low bits, 256 on the last lattice point).
+     */
+    struct FColorLut
+    {
+        static constexpr int32 FractionBits = 9;
+
+        int32 Size = 0;
+        TArray<uint32> Entries;
+        int32 Lookup[3][256];
+
+        bool IsValid() const { return Size >= 2; }
+    };
+
+    static constexpr int32 MaxLutSize = 65;
+
+    /** Build from Size^3 RGB float triples in [0, 1], red index fastest (.cube order) */
+    bool BuildColorLut(int32 Size, const float* Rgb, FColorLut& OutLut);
+
+    struct FColorTransform
+    {
+        ECamera2ColorStandard Standard = ECamera2ColorStandard::BT601;
+        bool bFullRange = true;
+        FYuvMatrix Matrix = MakeYuvMatrix(ECamera2ColorStandard::BT601, true);
+        FColorLut Lut;
+    };
+}
@@ -0,0 +1,482 @@
+#include "Camera2FeatureDetector.h"
+#include <algorithm>
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#define CAMERA2_FAST_NEON 1
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#define CAMERA2_FAST_SSE2 1
+#endif
+
+namespace Camera2Features
+{
+    // Bresenham circle of radius 3, clockwise from the top
+    static const int32 CircleX[16] = { 0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3, -3, -3, -2, -1 };
+    static const int32 CircleY[16] = { -3, -3, -2, -1, 0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3 };
+
+    static void MakeCircleOffsets(int32 Stride, int32* OutOffsets)
+    {
+        for (int32 i = 0; i < 16; ++i)
+        {
+            OutOffsets[i] = CircleY[i] * Stride + CircleX[i];
+        }
+    }
+
+    /** True if the 16-bit circular mask has a run of at least 9 set bits */
+    static FORCEINLINE bool HasArc9(uint32 Bits)
+    {
+        uint32 Run = Bits | (Bits << 16);
+        Run &= Run >> 1;    // runs >= 2
+        Run &= Run >> 2;    // runs >= 4
+        Run &= Run >> 4;    // runs >= 8
+        Run &= Run >> 1;    // runs >= 9
+        return Run != 0;
+    }
+
+    static FORCEINLINE bool IsCornerScalar(const uint8* Center, const int32* Offsets, int32 Threshold)
+    {
+        const int32 Bright = Center[0] + Threshold;
+        const int32 Dark = Center[0] - Threshold;
+
+        // Any 9-pixel arc covers two neighbouring compass points
+        const int32 C0 = Center[Offsets[0]], C4 = Center[Offsets[4]], C8 = Center[Offsets[8]], C12 = Center[Offsets[12]];
+        const bool bMaybeBright = (C0 > Bright || C8 > Bright) && (C4 > Bright || C12 > Bright);
+        const bool bMaybeDark = (C0 < Dark || C8 < Dark) && (C4 < Dark || C12 < Dark);
+        if (!bMaybeBright && !bMaybeDark)
+        {
+            return false;
+        }
+
+        uint32 BrightBits = 0;
+        uint32 DarkBits = 0;
+        for (int32 i = 0; i < 16; ++i)
+        {
+            const int32 Value = Center[Offsets[i]];
+            BrightBits |= static_cast<uint32>(Value > Bright) << i;
+            DarkBits |= static_cast<uint32>(Value < Dark) << i;
+        }
+        return HasArc9(BrightBits) || HasArc9(DarkBits);
+    }
+
+    /** Max over the 16 circular 9-pixel arcs of the arc minimum, from minima of 2, 4 and 8 neighbours */
+    template <typename VectorType, typename MinFn, typename MaxFn>
+    static FORCEINLINE VectorType MaxArcMin9(const VectorType* Diff, VectorType Zero, MinFn Min, MaxFn Max)
+    {
+        VectorType Min2[16];
+        VectorType Min4[16];
+        for (int32 i = 0; i < 16; ++i)
+        {
+            Min2[i] = Min(Diff[i], Diff[(i + 1) & 15]);
+        }
+        for (int32 i = 0; i < 16; ++i)
+        {
+            Min4[i] = Min(Min2[i], Min2[(i + 2) & 15]);
+        }
+        VectorType Best = Zero;
+        for (int32 i = 0; i < 16; ++i)
+        {
+            Best = Max(Best, Min(Min(Min4[i], Min4[(i + 4) & 15]), Diff[(i + 8) & 15]));
+        }
+        return Best;
+    }
+
+    /**
+     * FAST score: largest minimum center difference over all 9-pixel arcs, bright or dark (> Threshold for a
+     * corner). Differences are clamped at 0 so an arc with a pixel on the wrong side scores 0.
+     */
+    static int32 CornerScore(const uint8* Center, const int32* Offsets)
+    {
+        int32 Bright[16];
+        int32 Dark[16];
+        for (int32 i = 0; i < 16; ++i)
+        {
+            const int32 Diff = static_cast<int32>(Center[Offsets[i]]) - Center[0];
+            Bright[i] = FMath::Max(Diff, 0);
+            Dark[i] = FMath::Max(-Diff, 0);
+        }
+        auto Min = [](int32 A, int32 B) { return FMath::Min(A, B); };
+        auto Max = [](int32 A, int32 B) { return FMath::Max(A, B); };
+        return FMath::Max(MaxArcMin9(Bright, 0, Min, Max), MaxArcMin9(Dark, 0, Min, Max));
+    }
+
+#if CAMERA2_FAST_SSE2
+    /** Segment test for 16 consecutive centers; bit i set if Center + i is a corner, whose score goes to OutScores[i] */
+    static FORCEINLINE uint32 CornerMask16(const uint8* Center, const int32* Offsets, int32 Threshold, uint8* OutScores)
+    {
+        const __m128i Zero = _mm_setzero_si128();
+        const __m128i T = _mm_set1_epi8(static_cast<char>(Threshold));
+        const __m128i P = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Center));
+        const __m128i BrightLevel = _mm_adds_epu8(P, T);
+        const __m128i DarkLevel = _mm_subs_epu8(P, T);
+
+        // Masks are inverted (0xFF = not brighter / not darker) so the saturating differences need no extra compare
+        __m128i Circle[16];
+        __m128i NotBright[16];
+        __m128i NotDark[16];
+        auto LoadMasks = [&](int32 i)
+        {
+            Circle[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Center + Offsets[i]));
+            NotBright[i] = _mm_cmpeq_epi8(_mm_subs_epu8(Circle[i], BrightLevel), Zero);
+            NotDark[i] = _mm_cmpeq_epi8(_mm_subs_epu8(DarkLevel, Circle[i]), Zero);
+        };
+        LoadMasks(0);
+        LoadMasks(4);
+        LoadMasks(8);
+        LoadMasks(12);
+
+        const __m128i NoBright = _mm_or_si128(_mm_and_si128(NotBright[0], NotBright[8]), _mm_and_si128(NotBright[4], NotBright[12]));
+        const __m128i NoDark = _mm_or_si128(_mm_and_si128(NotDark[0], NotDark[8]), _mm_and_si128(NotDark[4], NotDark[12]));
+        const uint32 Candidates = static_cast<uint32>(_mm_movemask_epi8(_mm_and_si128(NoBright, NoDark))) ^ 0xFFFFu;
+        if (Candidates == 0)
+        {
+            return 0;
+        }
+
+        for (int32 i = 0; i < 16; ++i)
+        {
+            if ((i & 3) != 0)
+            {
+                LoadMasks(i);
+            }
+        }
+
+        // Per-lane run lengths over the circle walked 1.5 times
+        const __m128i One = _mm_set1_epi8(1);
+        __m128i RunBright = Zero;
+        __m128i RunDark = Zero;
+        __m128i MaxRun = Zero;
+        for (int32 k = 0; k < 25; ++k)
+        {
+            RunBright = _mm_andnot_si128(NotBright[k & 15], _mm_add_epi8(RunBright, One));
+            RunDark = _mm_andnot_si128(NotDark[k & 15], _mm_add_epi8(RunDark, One));
+            MaxRun = _mm_max_epu8(MaxRun, _mm_max_epu8(RunBright, RunDark));
+        }
+        const __m128i Nine = _mm_set1_epi8(9);
+        const uint32 Corners = static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(MaxRun, Nine), Nine))) & Candidates;
+        if (Corners == 0)
+        {
+            return 0;
+        }
+
+        // Saturating differences are the clamped bright/dark differences of the scalar score
+        __m128i Bright[16];
+        __m128i Dark[16];
+        for (int32 i = 0; i < 16; ++i)
+        {
+            Bright[i] = _mm_subs_epu8(Circle[i], P);
+            Dark[i] = _mm_subs_epu8(P, Circle[i]);
+        }
+        auto Min = [](__m128i A, __m128i B) { return _mm_min_epu8(A, B); };
+        auto Max = [](__m128i A, __m128i B) { return _mm_max_epu8(A, B); };
+        const __m128i Scores = _mm_max_epu8(MaxArcMin9(Bright, Zero, Min, Max), MaxArcMin9(Dark, Zero, Min, Max));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(OutScores), Scores);
+        return Corners;
+    }
+#elif CAMERA2_FAST_NEON
+    static FORCEINLINE uint32 MoveMask(uint8x16_t Mask)
+    {
+        static const uint8 WeightValues[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        const uint8x16_t Bits = vandq_u8(Mask, vld1q_u8(WeightValues));
+        return static_cast<uint32>(vaddv_u8(vget_low_u8(Bits))) | (static_cast<uint32>(vaddv_u8(vget_high_u8(Bits))) << 8);
+    }
+
+    /** Segment test for 16 consecutive centers; bit i set if Center + i is a corner, whose score goes to OutScores[i] */
+    static FORCEINLINE uint32 CornerMask16(const uint8* Center, const int32* Offsets, int32 Threshold, uint8* OutScores)
+    {
+        const uint8x16_t T = vdupq_n_u8(static_cast<uint8>(Threshold));
+        const uint8x16_t P = vld1q_u8(Center);
+        const uint8x16_t BrightLevel = vqaddq_u8(P, T);
+        const uint8x16_t DarkLevel = vqsubq_u8(P, T);
+
+        uint8x16_t Circle[16];
+        uint8x16_t IsBright[16];
+        uint8x16_t IsDark[16];
+        auto LoadMasks = [&](int32 i)
+        {
+            Circle[i] = vld1q_u8(Center + Offsets[i]);
+            IsBright[i] = vcgtq_u8(Circle[i], BrightLevel);
+            IsDark[i] = vcltq_u8(Circle[i], DarkLevel);
+        };
+        LoadMasks(0);
+        LoadMasks(4);
+        LoadMasks(8);
+        LoadMasks(12);
+
+        const uint8x16_t MaybeBright = vandq_u8(vorrq_u8(IsBright[0], IsBright[8]), vorrq_u8(IsBright[4], IsBright[12]));
+        const uint8x16_t MaybeDark = vandq_u8(vorrq_u8(IsDark[0], IsDark[8]), vorrq_u8(IsDark[4], IsDark[12]));
+        const uint8x16_t Candidates = vorrq_u8(MaybeBright, MaybeDark);
+        if (vmaxvq_u8(Candidates) == 0)
+        {
+            return 0;
+        }
+
+        for (int32 i = 0; i < 16; ++i)
+        {
+            if ((i & 3) != 0)
+            {
+                LoadMasks(i);
+            }
+        }
+
+        const uint8x16_t One = vdupq_n_u8(1);
+        uint8x16_t RunBright = vdupq_n_u8(0);
+        uint8x16_t RunDark = vdupq_n_u8(0);
+        uint8x16_t MaxRun = vdupq_n_u8(0);
+        for (int32 k = 0; k < 25; ++k)
+        {
+            RunBright = vandq_u8(vaddq_u8(RunBright, One), IsBright[k & 15]);
+            RunDark = vandq_u8(vaddq_u8(RunDark, One), IsDark[k & 15]);
+            MaxRun = vmaxq_u8(MaxRun, vmaxq_u8(RunBright, RunDark));
+        }
+        const uint32 Corners = MoveMask(vandq_u8(vcgeq_u8(MaxRun, vdupq_n_u8(9)), Candidates));
+        if (Corners == 0)
+        {
+            return 0;
+        }
+
+        uint8x16_t Bright[16];
+        uint8x16_t Dark[16];
+        for (int32 i = 0; i < 16; ++i)
+        {
+            Bright[i] = vqsubq_u8(Circle[i], P);
+            Dark[i] = vqsubq_u8(P, Circle[i]);
+        }
+        auto Min = [](uint8x16_t A, uint8x16_t B) { return vminq_u8(A, B); };
+        auto Max = [](uint8x16_t A, uint8x16_t B) { return vmaxq_u8(A, B); };
+        const uint8x16_t Zero = vdupq_n_u8(0);
+        vst1q_u8(OutScores, vmaxq_u8(MaxArcMin9(Bright, Zero, Min, Max), MaxArcMin9(Dark, Zero, Min, Max)));
+        return Corners;
+    }
+#endif
+
+    void DownsampleHalf(const uint8* Src, int32 Width, int32 Height, int32 SrcStride, uint8* Dst)
+    {
+        const int32 DstWidth = Width / 2;
+        const int32 DstHeight = Height / 2;
+        for (int32 Y = 0; Y < DstHeight; ++Y)
+        {
+            const uint8* Row0 = Src + (2 * Y) * SrcStride;
+            const uint8* Row1 = Row0 + SrcStride;
+            uint8* Out = Dst + Y * DstWidth;
+            int32 X = 0;
+#if CAMERA2_FAST_SSE2
+            const __m128i LowBytes = _mm_set1_epi16(0x00FF);
+            for (; X + 16 <= DstWidth; X += 16)
+            {
+                const __m128i A0 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Row0 + 2 * X)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row1 + 2 * X)));
+                const __m128i A1 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Row0 + 2 * X + 16)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row1 + 2 * X + 16)));
+                const __m128i H0 = _mm_avg_epu16(_mm_and_si128(A0, LowBytes), _mm_srli_epi16(A0, 8));
+                const __m128i H1 = _mm_avg_epu16(_mm_and_si128(A1, LowBytes), _mm_srli_epi16(A1, 8));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + X), _mm_packus_epi16(H0, H1));
+            }
+#elif CAMERA2_FAST_NEON
+            for (; X + 16 <= DstWidth; X += 16)
+            {
+                const uint8x16x2_t R0 = vld2q_u8(Row0 + 2 * X);
+                const uint8x16x2_t R1 = vld2q_u8(Row1 + 2 * X);
+                vst1q_u8(Out + X, vrhaddq_u8(vrhaddq_u8(R0.val[0], R1.val[0]), vrhaddq_u8(R0.val[1], R1.val[1])));
+            }
+#endif
+            for (; X < DstWidth; ++X)
+            {
+                const int32 Even = (Row0[2 * X] + Row1[2 * X] + 1) >> 1;
+                const int32 Odd = (Row0[2 * X + 1] + Row1[2 * X + 1] + 1) >> 1;
+                Out[X] = static_cast<uint8>((Even + Odd + 1) >> 1);
+            }
+        }
+    }
+
+    // Emit the corners of row Y that are 3x3 maxima; earlier neighbours in raster order may tie, later ones may not
+    static void SuppressRow(const TArray<FCorner>& RowCorners, const uint8* ScoreRows, int32 Width, TArray<FCorner>& OutCorners)
+    {
+        for (const FCorner& Corner : RowCorners)
+        {
+            const int32 Y = Corner.Y;
+            const uint8* Above = ScoreRows + ((Y + 2) % 3) * Width + Corner.X;
+            const uint8* Here = ScoreRows + (Y % 3) * Width + Corner.X;
+            const uint8* Below = ScoreRows + ((Y + 1) % 3) * Width + Corner.X;
+            const int32 Score = Corner.Score;
+            if (Score >= Above[-1] && Score >= Above[0] && Score >= Above[1] && Score >= Here[-1]
+                && Score > Here[1] && Score > Below[-1] && Score > Below[0] && Score > Below[1])
+            {
+                OutCorners.Add(Corner);
+            }
+        }
+    }
+
+    void DetectFast9(const uint8* Image, int32 Width, int32 Height, int32 Stride, int32 Threshold, bool bNonMaxSuppression,
+        FDetectorScratch& Scratch, TArray<FCorner>& OutCorners)
+    {
+        OutCorners.Reset();
+        if (Width < 7 || Height < 7)
+        {
+            return;
+        }
+
+        const int32 T = FMath::Clamp(Threshold, 1, 254);
+        int32 Offsets[16];
+        MakeCircleOffsets(Stride, Offsets);
+
+        // Scores of the last three rows (0 = no corner) for the 3x3 suppression
+        Scratch.ScoreRows.SetNumUninitialized(3 * Width);
+        FMemory::Memzero(Scratch.ScoreRows.GetData(), 3 * Width);
+        TArray<FCorner>* Previous = &Scratch.RowCorners[0];
+        TArray<FCorner>* Current = &Scratch.RowCorners[1];
+        Previous->Reset();
+
+        for (int32 Y = 3; Y < Height - 3; ++Y)
+        {
+            uint8* ScoreRow = Scratch.ScoreRows.GetData() + (Y % 3) * Width;
+            FMemory::Memzero(ScoreRow, Width);
+            Current->Reset();
+
+            const uint8* Row = Image + Y * Stride;
+            auto AddCorner = [&](int32 X, int32 Score)
+            {
+                FCorner Corner;
+                Corner.X = X;
+                Corner.Y = Y;
+                Corner.Score = Score;
+                ScoreRow[X] = static_cast<uint8>(Score);
+                Current->Add(Corner);
+            };
+
+            int32 X = 3;
+#if CAMERA2_FAST_SSE2 || CAMERA2_FAST_NEON
+            uint8 Scores[16];
+            for (; X + 16 <= Width - 3; X += 16)
+            {
+                uint32 Mask = CornerMask16(Row + X, Offsets, T, Scores);
+                while (Mask != 0)
+                {
+                    const int32 Lane = static_cast<int32>(FMath::CountTrailingZeros(Mask));
+                    AddCorner(X + Lane, Scores[Lane]);
+                    Mask &= Mask - 1;
+                }
+            }
+#endif
+            for (; X < Width - 3; ++X)
+            {
+                if (IsCornerScalar(Row + X, Offsets, T))
+                {
+                    AddCorner(X, CornerScore(Row + X, Offsets));
+                }
+            }
+
+            if (bNonMaxSuppression)
+            {
+                SuppressRow(*Previous, Scratch.ScoreRows.GetData(), Width, OutCorners);
+            }
+            else
+            {
+                OutCorners.Append(*Current);
+            }
+            Swap(Previous, Current);
+        }
+
+        if (bNonMaxSuppression)
+        {
+            // The row below the last detected row has no corners
+            FMemory::Memzero(Scratch.ScoreRows.GetData() + ((Height - 3) % 3) * Width, Width);
+            SuppressRow(*Previous, Scratch.ScoreRows.GetData(), Width, OutCorners);
+        }
+    }
+
+    void SelectGridBudget(TArray<FCorner>& InOutCorners, int32 Width, int32 Height, int32 GridColumns, int32 GridRows,
+        int32 MaxCorners, FDetectorScratch& Scratch)
+    {
+        if (MaxCorners <= 0)
+        {
+            InOutCorners.Reset();
+            return;
+        }
+        if (InOutCorners.Num() <= MaxCorners)
+        {
+            return;
+        }
+
+        // Strongest first; ties in raster order so the selection is deterministic
+        InOutCorners.Sort([](const FCorner& A, const FCorner& B)
+        {
+            return A.Score != B.Score ? A.Score > B.Score : (A.Y != B.Y ? A.Y < B.Y : A.X < B.X);
+        });
+
+        const int32 Columns = FMath::Max(GridColumns, 1);
+        const int32 Rows = FMath::Max(GridRows, 1);
+        const int32 CellBudget = FMath::Max((MaxCorners + Columns * Rows - 1) / (Columns * Rows), 1);
+        Scratch.CellCounts.Reset();
+        Scratch.CellCounts.SetNumZeroed(Columns * Rows);
+        Scratch.Selected.Reset();
+
+        for (FCorner& Corner : InOutCorners)
+        {
+            const int32 Cell = (Corner.Y * Rows / Height) * Columns + (Corner.X * Columns / Width);
+            if (Scratch.CellCounts[Cell] < CellBudget)
+            {
+                ++Scratch.CellCounts[Cell];
+                Scratch.Selected.Add(Corner);
+                Corner.Score = -Corner.Score; // taken
+                if (Scratch.Selected.Num() == MaxCorners)
+                {
+                    break;
+                }
+            }
+        }
+        for (const FCorner& Corner : InOutCorners)
+        {
+            if (Scratch.Selected.Num() == MaxCorners)
+            {
+                break;
+            }
+            if (Corner.Score > 0)
+            {
+                Scratch.Selected.Add(Corner);
+            }
+        }
+        for (FCorner& Corner : Scratch.Selected)
+        {
+            Corner.Score = FMath::Abs(Corner.Score);
+        }
+        Swap(InOutCorners, Scratch.Selected);
+    }
+
+    int32 DetectKeypoints(const uint8* Y, int32 Width, int32 Height, const FCamera2FeatureConfig& Config,
+        FDetectorScratch& Scratch, TArray<FCamera2Keypoint>& OutKeypoints)
+    {
+        OutKeypoints.Reset();
+
+        // Build the requested pyramid level; each level is a tight image
+        const uint8* Image = Y;
+        int32 LevelWidth = Width;
+        int32 LevelHeight = Height;
+        const int32 Level = FMath::Clamp(Config.PyramidLevel, 0, MaxPyramidLevel);
+        for (int32 i = 0; i < Level; ++i)
+        {
+            TArray<uint8>& Dst = Scratch.Levels[i];
+            Dst.SetNumUninitialized((LevelWidth / 2) * (LevelHeight / 2));
+            DownsampleHalf(Image, LevelWidth, LevelHeight, LevelWidth, Dst.GetData());
+            Image = Dst.GetData();
+            LevelWidth /= 2;
+            LevelHeight /= 2;
+        }
+
+        DetectFast9(Image, LevelWidth, LevelHeight, LevelWidth, Config.Threshold, Config.bNonMaxSuppression, Scratch, Scratch.Corners);
+        const int32 NumDetected = Scratch.Corners.Num();
+        SelectGridBudget(Scratch.Corners, LevelWidth, LevelHeight, Config.GridColumns, Config.GridRows, Config.MaxKeypoints, Scratch);
+
+        // Level pixel (x, y) covers full-resolution pixels [x * 2^L, (x + 1) * 2^L)
+        const double Scale = static_cast<double>(1 << Level);
+        const double Center = (Scale - 1.0) * 0.5;
+        OutKeypoints.SetNum(Scratch.Corners.Num());
+        for (int32 i = 0; i < Scratch.Corners.Num(); ++i)
+        {
+            const FCorner& Corner = Scratch.Corners[i];
+            OutKeypoints[i].Position = FVector2D(Corner.X * Scale + Center, Corner.Y * Scale + Center);
+            OutKeypoints[i].Score = Corner.Score;
+        }
+        return NumDetected;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera2Types.h"
+
+/**
+ * FAST-9 corner detection on 8-bit luma for in-plugin tracking.
+ * The segment test runs 16 pixels at a time (NEON on arm64, SSE2 on x64) with a scalar tail; scoring,
+ * non-max suppression and the grid budget are scalar and only touch corner pixels. All paths produce
+ * the same corners.
+ */
+namespace Camera2Features
+{
+    static constexpr int32 MaxPyramidLevel = 3;
+
+    struct FCorner
+    {
+        int32 X = 0;
+        int32 Y = 0;
+        int32 Score = 0;
+    };
+
+    /** Reusable buffers; keep one per detecting thread so steady-state detection does not allocate */
+    struct FDetectorScratch
+    {
+        TArray<uint8> Levels[MaxPyramidLevel];
+        TArray<uint8> ScoreRows;
+        TArray<FCorner> RowCorners[2];
+        TArray<FCorner> Corners;
+        TArray<FCorner> Selected;
+        TArray<int32> CellCounts;
+    };
+
+    /** 2x2 box downsample (rounded average of the vertical then the horizontal pair) into a tight (W/2)x(H/2) image */
+    void DownsampleHalf(const uint8* Src, int32 Width, int32 Height, int32 SrcStride, uint8* Dst);
+
+    /**
+     * Pixels whose 16-pixel Bresenham circle of radius 3 has 9 contiguous pixels all brighter than
+     * center + Threshold or all darker than center - Threshold. The 3-pixel border is skipped.
+     * With bNonMaxSuppression only corners whose score is a 3x3 maximum are kept.
+     */
+    void DetectFast9(const uint8* Image, int32 Width, int32 Height, int32 Stride, int32 Threshold, bool bNonMaxSuppression,
+        FDetectorScratch& Scratch, TArray<FCorner>& OutCorners);
+
+    /**
+     * Keep at most MaxCorners, strongest first, with at most ceil(MaxCorners / cells) per grid cell so
+     * keypoints cover the image; budget left unused by sparse cells goes to the strongest remaining corners.
+     */
+    void SelectGridBudget(TArray<FCorner>& InOutCorners, int32 Width, int32 Height, int32 GridColumns, int32 GridRows,
+        int32 MaxCorners, FDetectorScratch& Scratch);
+
+    /**
+     * Pyramid level, FAST-9 and grid budget as configured. Keypoint positions are in full-resolution
+     * pixels; Normalized is left zero for the caller to fill in from the intrinsics.
+     * @return corners detected before the budget was applied
+     */
+    int32 DetectKeypoints(const uint8* Y, int32 Width, int32 Height, const FCamera2FeatureConfig& Config,
+        FDetectorScratch& Scratch, TArray<FCamera2Keypoint>& OutKeypoints);
+}
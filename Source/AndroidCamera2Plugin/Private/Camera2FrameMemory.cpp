@@ -0,0 +1,274 @@
+#include "Camera2FrameMemory.h"
+#include <atomic>
+
+LLM_DEFINE_TAG(Camera2_PipelineSlots);
+LLM_DEFINE_TAG(Camera2_Textures);
+LLM_DEFINE_TAG(Camera2_Uploads);
+LLM_DEFINE_TAG(Camera2_Stills);
+LLM_DEFINE_TAG(Camera2_Streaming);
+
+namespace Camera2Memory
+{
+    static constexpr int32 NumPools = static_cast<int32>(EPool::Num);
+
+    static std::atomic<int64> GBudgetBytes{0};
+    static std::atomic<int64> GLiveBytes{0};
+    static std::atomic<int64> GPeakBytes{0};
+    static std::atomic<int64> GPoolBytes[NumPools] = {};
+    static std::atomic<int64> GDeniedReservations{0};
+    static std::atomic<int64> GBudgetDrops{0};
+
+    void SetBudget(int64 BudgetBytes)
+    {
+        GBudgetBytes.store(FMath::Max<int64>(BudgetBytes, 0), std::memory_order_relaxed);
+        ResetPeak();
+    }
+
+    int64 GetBudget()
+    {
+        return GBudgetBytes.load(std::memory_order_relaxed);
+    }
+
+    bool TryReserve(EPool Pool, int64 Bytes, bool bAllowOverBudget)
+    {
+        check(Pool < EPool::Num);
+        if (Bytes <= 0)
+        {
+            return true;
+        }
+
+        // The budget may change concurrently; a reservation is checked against the value it raced with
+        const int64 Budget = GBudgetBytes.load(std::memory_order_relaxed);
+        int64 Live = GLiveBytes.load(std::memory_order_relaxed);
+        do
+        {
+            if (!bAllowOverBudget && Budget > 0 && Live + Bytes > Budget)
+            {
+                GDeniedReservations.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        while (!GLiveBytes.compare_exchange_weak(Live, Live + Bytes, std::memory_order_relaxed));
+
+        GPoolBytes[static_cast<int32>(Pool)].fetch_add(Bytes, std::memory_order_relaxed);
+        const int64 NewLive = Live + Bytes;
+        int64 Peak = GPeakBytes.load(std::memory_order_relaxed);
+        while (NewLive > Peak && !GPeakBytes.compare_exchange_weak(Peak, NewLive, std::memory_order_relaxed))
+        {
+        }
+        return true;
+    }
+
+    void Release(EPool Pool, int64 Bytes)
+    {
+        check(Pool < EPool::Num);
+        if (Bytes <= 0)
+        {
+            return;
+        }
+        GPoolBytes[static_cast<int32>(Pool)].fetch_sub(Bytes, std::memory_order_relaxed);
+        const int64 Previous = GLiveBytes.fetch_sub(Bytes, std::memory_order_relaxed);
+        checkSlow(Previous >= Bytes);
+    }
+
+    void NoteBudgetDrop()
+    {
+        GBudgetDrops.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void* MallocTagged(EPool Pool, int64 Bytes)
+    {
+        switch (Pool)
+        {
+        case EPool::PipelineSlots:
+        {
+            LLM_SCOPE_BYTAG(Camera2_PipelineSlots);
+            return FMemory::Malloc(Bytes);
+        }
+        case EPool::Textures:
+        {
+            LLM_SCOPE_BYTAG(Camera2_Textures);
+            return FMemory::Malloc(Bytes);
+        }
+        case EPool::Uploads:
+        {
+            LLM_SCOPE_BYTAG(Camera2_Uploads);
+            return FMemory::Malloc(Bytes);
+        }
+        case EPool::Stills:
+        {
+            LLM_SCOPE_BYTAG(Camera2_Stills);
+            return FMemory::Malloc(Bytes);
+        }
+        default:
+        {
+            LLM_SCOPE_BYTAG(Camera2_Streaming);
+            return FMemory::Malloc(Bytes);
+        }
+        }
+    }
+
+    uint8* Allocate(EPool Pool, int64 Bytes)
+    {
+        if (Bytes <= 0 || !TryReserve(Pool, Bytes))
+        {
+            return nullptr;
+        }
+        return static_cast<uint8*>(MallocTagged(Pool, Bytes));
+    }
+
+    void Free(EPool Pool, uint8* Data, int64 Bytes)
+    {
+        if (Data)
+        {
+            FMemory::Free(Data);
+            Release(Pool, Bytes);
+        }
+    }
+
+    void ResetPeak()
+    {
+        GPeakBytes.store(GLiveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    void FillStats(FCamera2MemoryStats& OutStats)
+    {
+        OutStats.BudgetBytes = GBudgetBytes.load(std::memory_order_relaxed);
+        OutStats.LiveBytes = GLiveBytes.load(std::memory_order_relaxed);
+        OutStats.PeakBytes = GPeakBytes.load(std::memory_order_relaxed);
+        OutStats.PipelineSlotBytes = GPoolBytes[static_cast<int32>(EPool::PipelineSlots)].load(std::memory_order_relaxed);
+        OutStats.TextureBytes = GPoolBytes[static_cast<int32>(EPool::Textures)].load(std::memory_order_relaxed);
+        OutStats.UploadBytes = GPoolBytes[static_cast<int32>(EPool::Uploads)].load(std::memory_order_relaxed);
+        OutStats.StillBytes = GPoolBytes[static_cast<int32>(EPool::Stills)].load(std::memory_order_relaxed);
+        OutStats.StreamingBytes = GPoolBytes[static_cast<int32>(EPool::Streaming)].load(std::memory_order_relaxed);
+        OutStats.DeniedReservations = GDeniedReservations.load(std::memory_order_relaxed);
+        OutStats.BudgetDrops = GBudgetDrops.load(std::memory_order_relaxed);
+    }
+
+    FReservation::FReservation(FReservation&& Other)
+        : Pool(Other.Pool)
+        , Bytes(Other.Bytes)
+    {
+        Other.Bytes = 0;
+    }
+
+    FReservation& FReservation::operator=(FReservation&& Other)
+    {
+        if (this != &Other)
+        {
+            Reset();
+            Pool = Other.Pool;
+            Bytes = Other.Bytes;
+            Other.Bytes = 0;
+        }
+        return *this;
+    }
+
+    bool FReservation::Reserve(EPool InPool, int64 InBytes, bool bAllowOverBudget)
+    {
+        Reset();
+        if (InBytes <= 0 || !TryReserve(InPool, InBytes, bAllowOverBudget))
+        {
+            return false;
+        }
+        Pool = InPool;
+        Bytes = InBytes;
+        return true;
+    }
+
+    void FReservation::Reset()
+    {
+        Release(Pool, Bytes);
+        Bytes = 0;
+    }
+
+    FBuffer::FBuffer(FBuffer&& Other)
+        : Pool(Other.Pool)
+        , Data(Other.Data)
+        , Size(Other.Size)
+    {
+        Other.Data = nullptr;
+        Other.Size = 0;
+    }
+
+    FBuffer& FBuffer::operator=(FBuffer&& Other)
+    {
+        if (this != &Other)
+        {
+            Free();
+            Pool = Other.Pool;
+            Data = Other.Data;
+            Size = Other.Size;
+            Other.Data = nullptr;
+            Other.Size = 0;
+        }
+        return *this;
+    }
+
+    bool FBuffer::Allocate(EPool InPool, int64 InSize)
+    {
+        if (Data && InPool == Pool && InSize == Size)
+        {
+            return true;
+        }
+        // Free first so a reallocation of the same owner does not count twice against the budget
+        Free();
+        if (InSize <= 0)
+        {
+            return InSize == 0;
+        }
+        Data = Camera2Memory::Allocate(InPool, InSize);
+        if (!Data)
+        {
+            return false;
+        }
+        Pool = InPool;
+        Size = InSize;
+        return true;
+    }
+
+    void FBuffer::Free()
+    {
+        Camera2Memory::Free(Pool, Data, Size);
+        Data = nullptr;
+        Size = 0;
+    }
+
+    int32 AllocateRing(EPool Pool, const int64* BufferSizes, int32 NumBuffers, int32 Depth, TArray<FBuffer>& OutBuffers)
+    {
+        OutBuffers.Reset(NumBuffers * Depth);
+        for (int32 Set = 0; Set < Depth; ++Set)
+        {
+            for (int32 Index = 0; Index < NumBuffers; ++Index)
+            {
+                if (!OutBuffers.AddDefaulted_GetRef().Allocate(Pool, BufferSizes[Index]))
+                {
+                    // Shrinking frees the partial set
+                    OutBuffers.SetNum(Set * NumBuffers);
+                    return Set;
+                }
+            }
+        }
+        return Depth;
+    }
+
+    uint8* FInFlightBuffers::TryAllocate(int64 Bytes)
+    {
+        uint8* Data = InFlight.fetch_add(1, std::memory_order_acquire) < MaxInFlight ? Allocate(Pool, Bytes) : nullptr;
+        if (!Data)
+        {
+            InFlight.fetch_sub(1, std::memory_order_release);
+            NoteBudgetDrop();
+        }
+        return Data;
+    }
+
+    void FInFlightBuffers::Free(uint8* Data, int64 Bytes)
+    {
+        if (Data)
+        {
+            Camera2Memory::Free(Pool, Data, Bytes);
+            InFlight.fetch_sub(1, std::memory_order_release);
+        }
+    }
+}
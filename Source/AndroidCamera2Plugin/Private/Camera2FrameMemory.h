@@ -0,0 +1,134 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Camera2Types.h"
+#include <atomic>
+
+LLM_DECLARE_TAG(Camera2_PipelineSlots);
+LLM_DECLARE_TAG(Camera2_Textures);
+LLM_DECLARE_TAG(Camera2_Uploads);
+LLM_DECLARE_TAG(Camera2_Stills);
+LLM_DECLARE_TAG(Camera2_Streaming);
+
+/**
+ * Accounting of all frame memory the plugin owns: native ring slots, camera textures, frame copies in flight to
+ * the render thread, stills held until they are taken and the preview streamer's buffers.
+ *
+ * Every owner reserves its bytes against one process-wide budget before allocating and returns them when the
+ * memory is freed, so live and peak usage are exact per pool. A reservation that would exceed the budget fails and
+ * the caller degrades instead of growing: rings get fewer slots, frames and stills are dropped, streaming skips
+ * frames. Memory already allocated is never reclaimed when the budget is lowered; it only limits what comes next.
+ * The allocations are tagged Camera2/<Pool> in LLM (-llm, `stat LLM`).
+ */
+namespace Camera2Memory
+{
+    enum class EPool : uint8
+    {
+        PipelineSlots,
+        Textures,
+        Uploads,
+        Stills,
+        Streaming,
+        Num
+    };
+
+    /** Any thread; 0 = unlimited */
+    void SetBudget(int64 BudgetBytes);
+    int64 GetBudget();
+
+    /**
+     * Any thread. Lock-free; succeeds only if the live total stays within the budget.
+     * @param bAllowOverBudget account the bytes even past the budget (memory the plugin cannot work without)
+     */
+    bool TryReserve(EPool Pool, int64 Bytes, bool bAllowOverBudget = false);
+    void Release(EPool Pool, int64 Bytes);
+
+    /** A frame or still that was dropped because its memory did not fit in the budget */
+    void NoteBudgetDrop();
+
+    /** Raw buffer under the pool's LLM tag; null when the bytes do not fit (not counted as a budget drop) */
+    uint8* Allocate(EPool Pool, int64 Bytes);
+    void Free(EPool Pool, uint8* Data, int64 Bytes);
+
+    void ResetPeak();
+    void FillStats(FCamera2MemoryStats& OutStats);
+
+    /** Bytes accounted against the budget for as long as the object lives; move-only */
+    class FReservation
+    {
+    public:
+        FReservation() = default;
+        FReservation(FReservation&& Other);
+        FReservation& operator=(FReservation&& Other);
+        FReservation(const FReservation&) = delete;
+        FReservation& operator=(const FReservation&) = delete;
+        ~FReservation() { Reset(); }
+
+        /** Replaces the current reservation; false (and nothing held) if the bytes do not fit */
+        bool Reserve(EPool InPool, int64 InBytes, bool bAllowOverBudget = false);
+        void Reset();
+
+        bool IsValid() const { return Bytes > 0; }
+        int64 GetBytes() const { return Bytes; }
+
+    private:
+        EPool Pool = EPool::PipelineSlots;
+        int64 Bytes = 0;
+    };
+
+    /** Budgeted heap buffer with TArray-like access; move-only, freed with the object */
+    class FBuffer
+    {
+    public:
+        FBuffer() = default;
+        FBuffer(FBuffer&& Other);
+        FBuffer& operator=(FBuffer&& Other);
+        FBuffer(const FBuffer&) = delete;
+        FBuffer& operator=(const FBuffer&) = delete;
+        ~FBuffer() { Free(); }
+
+        /** Keeps the memory if the size is unchanged; false (and empty) if the new size does not fit */
+        bool Allocate(EPool InPool, int64 InSize);
+        void Free();
+
+        uint8* GetData() { return Data; }
+        const uint8* GetData() const { return Data; }
+        int64 Num() const { return Size; }
+
+    private:
+        EPool Pool = EPool::PipelineSlots;
+        uint8* Data = nullptr;
+        int64 Size = 0;
+    };
+
+    /**
+     * Up to Depth sets of NumBuffers buffers, one of each BufferSizes entry (zero sizes stay empty), allocated in
+     * order until a set does not fit in the budget; that partial set is freed again. OutBuffers holds the complete
+     * sets one after another.
+     * @return the number of complete sets
+     */
+    int32 AllocateRing(EPool Pool, const int64* BufferSizes, int32 NumBuffers, int32 Depth, TArray<FBuffer>& OutBuffers);
+
+    /** Raw buffers of one pool of which at most MaxInFlight are live at once, for frame copies handed to other threads; any thread */
+    class FInFlightBuffers
+    {
+    public:
+        FInFlightBuffers(EPool InPool, int32 InMaxInFlight)
+            : Pool(InPool)
+            , MaxInFlight(InMaxInFlight)
+        {
+        }
+
+        /** Null when MaxInFlight buffers are out or the bytes do not fit; either is noted as a budget drop */
+        uint8* TryAllocate(int64 Bytes);
+        void Free(uint8* Data, int64 Bytes);
+
+        int32 Num() const { return InFlight.load(std::memory_order_relaxed); }
+
+    private:
+        const EPool Pool;
+        const int32 MaxInFlight;
+        std::atomic<int32> InFlight{0};
+    };
+}
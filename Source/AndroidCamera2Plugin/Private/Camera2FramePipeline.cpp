@@ -0,0 +1,572 @@
+#include "Camera2FramePipeline.h"
+#include "Camera2YuvConvert.h"
+#include "Camera2ImageStats.h"
+#include "Camera2Trace.h"
+#include "SimpleCamera2Test.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Texture2D.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "Rendering/Texture2DResource.h"
+
+FCamera2FramePipeline& FCamera2FramePipeline::Get(int32 StreamId)
+{
+    static FCamera2FramePipeline* Instances = []()
+    {
+        static FCamera2FramePipeline Storage[MaxStreams];
+        for (int32 i = 0; i < MaxStreams; ++i)
+        {
+            Storage[i].StreamId = i;
+        }
+        return Storage;
+    }();
+    check(StreamId >= 0 && StreamId < MaxStreams);
+    return Instances[StreamId];
+}
+
+// UpdateTexture2D calls that block the render thread longer than this count as stalls
+static constexpr float UploadStallThresholdMs = 1.0f;
+
+FDelegateHandle FCamera2FramePipeline::AddConsumer(FOnCamera2StreamFrame::FDelegate&& Delegate)
+{
+    FScopeLock Lock(&ConsumersLock);
+    return Consumers.Add(MoveTemp(Delegate));
+}
+
+void FCamera2FramePipeline::RemoveConsumer(FDelegateHandle Handle)
+{
+    FScopeLock Lock(&ConsumersLock);
+    Consumers.Remove(Handle);
+}
+
+void FCamera2FramePipeline::SetImageStats(bool bEnable, const FCamera2ImageStatsConfig& InConfig)
+{
+    FScopeLock Lock(&ImageStatsLock);
+    ImageStatsConfig = InConfig;
+    ImageStatsConfig.BlockSize = Camera2Stats::ClampBlockSize(InConfig.BlockSize);
+    ImageStatsConfig.ChangeThreshold = FMath::Max(InConfig.ChangeThreshold, 0.0f);
+    PreviousBlockSums.Reset();
+    PreviousStatsTimestampNs = 0;
+    LatestImageStats = FCamera2ImageStats();
+    bHasImageStats = false;
+    bImageStatsEnabled.store(bEnable, std::memory_order_relaxed);
+}
+
+bool FCamera2FramePipeline::GetLatestImageStats(FCamera2ImageStats& OutStats) const
+{
+    FScopeLock Lock(&ImageStatsLock);
+    OutStats = LatestImageStats;
+    return bHasImageStats;
+}
+
+void FCamera2FramePipeline::Configure(int32 Width, int32 Height, const FConfig& InConfig)
+{
+    check(IsInGameThread());
+
+    FConfig Clamped = InConfig;
+    Clamped.RingDepth = FMath::Clamp(InConfig.RingDepth, 2, 8);
+    Clamped.ConversionThreads = FMath::Clamp(InConfig.ConversionThreads, 1, 4);
+    if (Width == FrameWidth && Height == FrameHeight && Clamped.RingDepth == Slots.Num()
+        && Clamped.bUploadToTexture == Config.bUploadToTexture && Clamped.bLumaOnly == Config.bLumaOnly
+        && Clamped.OutputFormat == Config.OutputFormat)
+    {
+        Config = Clamped;
+        return;
+    }
+
+    Flush();
+
+    FrameWidth = Width;
+    FrameHeight = Height;
+    Config = Clamped;
+
+    const int32 ChromaSize = Config.bLumaOnly ? 0 : ((Width + 1) / 2) * ((Height + 1) / 2);
+    const bool bNeedsConversion = Config.bUploadToTexture && Config.OutputFormat != ECamera2OutputFormat::Luma;
+    const int32 ConvertedSize = bNeedsConversion ? Camera2Yuv::GetOutputLayout(Config.OutputFormat, Width, Height).GetSizeBytes() : 0;
+    Slots.Reset();
+
+    // Y, U, V and converted buffer of each slot
+    const int64 SlotBufferSizes[] = { static_cast<int64>(Width) * Height, ChromaSize, ChromaSize, ConvertedSize };
+    TArray<Camera2Memory::FBuffer> Buffers;
+    const int32 NumSlots = Camera2Memory::AllocateRing(Camera2Memory::EPool::PipelineSlots, SlotBufferSizes,
+        UE_ARRAY_COUNT(SlotBufferSizes), Config.RingDepth, Buffers);
+    if (NumSlots < Config.RingDepth)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("Frame pipeline %d: frame memory budget allows %d of %d ring slots"),
+            StreamId, NumSlots, Config.RingDepth);
+    }
+    for (int32 i = 0; i < NumSlots; ++i)
+    {
+        TUniquePtr<FSlot> Slot = MakeUnique<FSlot>();
+        Slot->Y = MoveTemp(Buffers[i * 4 + 0]);
+        Slot->U = MoveTemp(Buffers[i * 4 + 1]);
+        Slot->V = MoveTemp(Buffers[i * 4 + 2]);
+        Slot->Converted = MoveTemp(Buffers[i * 4 + 3]);
+        Slots.Add(MoveTemp(Slot));
+    }
+
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Frame pipeline %d configured: %dx%d ring=%d conversionThreads=%d format=%d%s%s"),
+        StreamId, Width, Height, Slots.Num(), Config.ConversionThreads, static_cast<int32>(Config.OutputFormat),
+        Config.bUploadToTexture ? TEXT(" display") : TEXT(" analysis"), Config.bLumaOnly ? TEXT(" luma-only") : TEXT(""));
+}
+
+void FCamera2FramePipeline::SetTargetTextures(const TArray<UTexture2D*>& Textures)
+{
+    check(IsInGameThread());
+    TargetTextures.Reset();
+    for (int32 i = 0; i < FMath::Min(Textures.Num(), MaxTextureBuffers); ++i)
+    {
+        TargetTextures.Add(Textures[i]);
+    }
+    LatestTextureIndex = INDEX_NONE;
+}
+
+void FCamera2FramePipeline::SetColorTransform(TSharedPtr<const Camera2Yuv::FColorTransform, ESPMode::ThreadSafe> InTransform)
+{
+    FScopeLock Lock(&ColorTransformLock);
+    ColorTransform = MoveTemp(InTransform);
+}
+
+void FCamera2FramePipeline::SetIntrinsics(TSharedPtr<const FCamera2StreamIntrinsics, ESPMode::ThreadSafe> InIntrinsics)
+{
+    FScopeLock Lock(&IntrinsicsLock);
+    Intrinsics = MoveTemp(InIntrinsics);
+}
+
+TSharedPtr<const FCamera2StreamIntrinsics, ESPMode::ThreadSafe> FCamera2FramePipeline::GetIntrinsics() const
+{
+    FScopeLock Lock(&IntrinsicsLock);
+    return Intrinsics;
+}
+
+void FCamera2FramePipeline::Shutdown()
+{
+    Flush();
+    Slots.Reset();
+    FrameWidth = 0;
+    FrameHeight = 0;
+    SetIntrinsics(nullptr);
+}
+
+void FCamera2FramePipeline::Flush()
+{
+    // Frames still waiting for a capture result are dropped; ResolveMetadata schedules under the same lock, so
+    // anything it dispatched before this is counted in TasksInFlight below
+    {
+        FScopeLock Lock(&WaitingSlotsLock);
+        WaitingSlots.Reset();
+    }
+
+    // Process tasks own their slot (and run consumers on it) until they return; slots are only recycled or
+    // freed once none is outstanding, however long a consumer takes
+    const double WaitStartSeconds = FPlatformTime::Seconds();
+    bool bLoggedSlowWait = false;
+    while (TasksInFlight.load(std::memory_order_acquire) > 0)
+    {
+        if (!bLoggedSlowWait && FPlatformTime::Seconds() - WaitStartSeconds > 1.0)
+        {
+            UE_LOG(LogSimpleCamera2, Warning, TEXT("Frame pipeline %d: waiting for %d frame tasks to finish"),
+                StreamId, TasksInFlight.load(std::memory_order_relaxed));
+            bLoggedSlowWait = true;
+        }
+        FPlatformProcess::Sleep(0.001f);
+    }
+
+    if (IsInGameThread())
+    {
+        FlushRenderingCommands();
+    }
+
+    LatestReadySlot.store(INDEX_NONE);
+    for (const TUniquePtr<FSlot>& Slot : Slots)
+    {
+        Slot->State.store(ESlotState::Free);
+    }
+}
+
+bool FCamera2FramePipeline::SubmitYuvFrame(const uint8* Y, int32 YRowStride,
+    const uint8* U, const uint8* V, int32 UVRowStride, int32 UVPixelStride,
+    int32 Width, int32 Height, const FCamera2FrameMetadata& Metadata)
+{
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 Enqueue"));
+    if (Width != FrameWidth || Height != FrameHeight || Slots.Num() == 0 || (!Config.bLumaOnly && (!U || !V)))
+    {
+        if (Slots.Num() < Config.RingDepth && FrameWidth > 0)
+        {
+            Camera2Memory::NoteBudgetDrop();
+        }
+        Camera2Trace::SetPipelineDrops(StreamId, PipelineDrops.fetch_add(1, std::memory_order_relaxed) + 1);
+        return false;
+    }
+
+    // Frame rate from sensor timestamps (EMA over roughly half a second at 120 fps)
+    if (LastSubmitTimestampNs > 0 && Metadata.SensorTimestampNs > LastSubmitTimestampNs)
+    {
+        const float InstantFps = 1.0e9f / static_cast<float>(Metadata.SensorTimestampNs - LastSubmitTimestampNs);
+        const float Previous = MeasuredFps.load(std::memory_order_relaxed);
+        MeasuredFps.store(Previous > 0.0f ? FMath::Lerp(Previous, InstantFps, 0.05f) : InstantFps, std::memory_order_relaxed);
+    }
+    LastSubmitTimestampNs = Metadata.SensorTimestampNs;
+
+    int32 SlotIndex = INDEX_NONE;
+    for (int32 i = 0; i < Slots.Num(); ++i)
+    {
+        ESlotState Expected = ESlotState::Free;
+        if (Slots[i]->State.compare_exchange_strong(Expected, ESlotState::Busy, std::memory_order_acquire))
+        {
+            SlotIndex = i;
+            break;
+        }
+    }
+
+    if (SlotIndex == INDEX_NONE)
+    {
+        // With the ring held short by the budget, a full ring is a budget drop as well
+        if (Slots.Num() < Config.RingDepth)
+        {
+            Camera2Memory::NoteBudgetDrop();
+        }
+        Camera2Trace::SetPipelineDrops(StreamId, PipelineDrops.fetch_add(1, std::memory_order_relaxed) + 1);
+        return false;
+    }
+    if (CAMERA2_TRACE_ENABLED())
+    {
+        int32 SlotsInUse = 0;
+        for (const TUniquePtr<FSlot>& Other : Slots)
+        {
+            SlotsInUse += Other->State.load(std::memory_order_relaxed) != ESlotState::Free ? 1 : 0;
+        }
+        Camera2Trace::SetQueueDepth(StreamId, SlotsInUse);
+    }
+
+    FSlot& Slot = *Slots[SlotIndex];
+    const int32 ChromaWidth = (Width + 1) / 2;
+    const int32 ChromaHeight = (Height + 1) / 2;
+    Camera2Yuv::CopyPlane(Y, YRowStride, 1, Width, Height, Slot.Y.GetData());
+    if (!Config.bLumaOnly)
+    {
+        Camera2Yuv::CopyPlane(U, UVRowStride, UVPixelStride, ChromaWidth, ChromaHeight, Slot.U.GetData());
+        Camera2Yuv::CopyPlane(V, UVRowStride, UVPixelStride, ChromaWidth, ChromaHeight, Slot.V.GetData());
+    }
+    Slot.Metadata = Metadata;
+    Slot.TimestampNs.store(Metadata.SensorTimestampNs, std::memory_order_relaxed);
+
+    if (Metadata.bValid)
+    {
+        Dispatch(SlotIndex);
+        return true;
+    }
+
+    // The capture result usually follows the image within a frame; consumers wait for it rather than run on a
+    // frame without exposure, focus and frame number
+    FScopeLock Lock(&WaitingSlotsLock);
+    WaitingSlots.Add(SlotIndex);
+    const int32 MaxWaiting = FMath::Max(Slots.Num() - 1, 0);
+    while (WaitingSlots.Num() > MaxWaiting)
+    {
+        Dispatch(WaitingSlots[0]);
+        WaitingSlots.RemoveAt(0);
+    }
+    return true;
+}
+
+void FCamera2FramePipeline::ResolveMetadata(const FCamera2FrameMetadata& Metadata)
+{
+    FScopeLock Lock(&WaitingSlotsLock);
+    for (int32 i = 0; i < WaitingSlots.Num();)
+    {
+        FSlot& Slot = *Slots[WaitingSlots[i]];
+        const int64 Timestamp = Slot.TimestampNs.load(std::memory_order_relaxed);
+        if (Timestamp > Metadata.SensorTimestampNs)
+        {
+            ++i;
+            continue;
+        }
+        if (Timestamp == Metadata.SensorTimestampNs)
+        {
+            Slot.Metadata = Metadata;
+        }
+        Dispatch(WaitingSlots[i]);
+        WaitingSlots.RemoveAt(i);
+    }
+}
+
+void FCamera2FramePipeline::Dispatch(int32 SlotIndex)
+{
+    TasksInFlight.fetch_add(1, std::memory_order_relaxed);
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, SlotIndex]()
+    {
+        Process(SlotIndex);
+        TasksInFlight.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+void FCamera2FramePipeline::Process(int32 SlotIndex)
+{
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 Process"));
+    FSlot& Slot = *Slots[SlotIndex];
+
+    // Single pass over the freshly copied Y plane, before consumers that may skip unchanged frames
+    const bool bImageStats = bImageStatsEnabled.load(std::memory_order_relaxed);
+    if (bImageStats)
+    {
+        ComputeImageStats(Slot);
+    }
+
+    {
+        FScopeLock Lock(&ConsumersLock);
+        if (Consumers.IsBound())
+        {
+            CAMERA2_TRACE_SCOPE(TEXT("Camera2 Consumers"));
+            FCamera2FrameView View;
+            View.StreamId = StreamId;
+            View.Width = FrameWidth;
+            View.Height = FrameHeight;
+            View.Y = Slot.Y.GetData();
+            View.U = Config.bLumaOnly ? nullptr : Slot.U.GetData();
+            View.V = Config.bLumaOnly ? nullptr : Slot.V.GetData();
+            View.Metadata = &Slot.Metadata;
+            View.Stats = bImageStats ? &Slot.Stats : nullptr;
+            const TSharedPtr<const FCamera2StreamIntrinsics, ESPMode::ThreadSafe> FrameIntrinsics = GetIntrinsics();
+            View.Intrinsics = FrameIntrinsics.Get();
+            Consumers.Broadcast(View);
+        }
+    }
+
+    if (Config.bUploadToTexture)
+    {
+        Convert(SlotIndex);
+        Publish(SlotIndex);
+    }
+    else
+    {
+        FramesConverted.fetch_add(1, std::memory_order_relaxed);
+        ReleaseSlot(SlotIndex);
+    }
+}
+
+void FCamera2FramePipeline::ComputeImageStats(FSlot& Slot)
+{
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 ImageStats"));
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    int32 BlockSize;
+    float ChangeThreshold;
+    {
+        FScopeLock Lock(&ImageStatsLock);
+        BlockSize = ImageStatsConfig.BlockSize;
+        ChangeThreshold = ImageStatsConfig.ChangeThreshold;
+    }
+
+    Camera2Stats::FLumaTotals Totals;
+    Camera2Stats::ComputeLumaTotals(Slot.Y.GetData(), FrameWidth, FrameHeight, BlockSize, Totals, Slot.BlockSums);
+
+    FCamera2ImageStats& Stats = Slot.Stats;
+    Stats.StreamId = StreamId;
+    Stats.FrameNumber = Slot.Metadata.FrameNumber;
+    Stats.SensorTimestampNs = Slot.Metadata.SensorTimestampNs;
+    Camera2Stats::FillStats(Totals, static_cast<int64>(FrameWidth) * FrameHeight, Stats);
+
+    FScopeLock Lock(&ImageStatsLock);
+    Stats.ChangeScore = Camera2Stats::ComputeChangeScore(Slot.BlockSums, PreviousBlockSums, BlockSize * BlockSize, ChangeThreshold);
+    Stats.ComputeMs = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+    if (Stats.SensorTimestampNs >= PreviousStatsTimestampNs)
+    {
+        // The slot's block buffer is refilled by its next frame, so the arrays can trade places
+        Swap(PreviousBlockSums, Slot.BlockSums);
+        PreviousStatsTimestampNs = Stats.SensorTimestampNs;
+        LatestImageStats = Stats;
+        bHasImageStats = true;
+    }
+}
+
+void FCamera2FramePipeline::Convert(int32 SlotIndex)
+{
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 Convert"));
+    FSlot& Slot = *Slots[SlotIndex];
+
+    Camera2Yuv::FI420View Src;
+    Src.Y = Slot.Y.GetData();
+    Src.U = Slot.U.GetData();
+    Src.V = Slot.V.GetData();
+    Src.Width = FrameWidth;
+    Src.Height = FrameHeight;
+
+    if (Config.OutputFormat == ECamera2OutputFormat::Luma)
+    {
+        // The Y plane is uploaded as is
+        FramesConverted.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint8* Dst = Slot.Converted.GetData();
+    const int32 DstPitch = Camera2Yuv::GetOutputLayout(Config.OutputFormat, FrameWidth, FrameHeight).Pitch;
+    const ECamera2OutputFormat Format = Config.OutputFormat;
+
+    TSharedPtr<const Camera2Yuv::FColorTransform, ESPMode::ThreadSafe> Transform;
+    {
+        FScopeLock Lock(&ColorTransformLock);
+        Transform = ColorTransform;
+    }
+    static const Camera2Yuv::FColorTransform DefaultTransform;
+    const Camera2Yuv::FColorTransform& Color = Transform.IsValid() ? *Transform : DefaultTransform;
+
+    // Bands are kept on even rows so each band owns whole chroma rows
+    const int32 NumBands = Config.ConversionThreads;
+    const int32 BandRows = ((FrameHeight / NumBands) + 1) & ~1;
+    ParallelFor(NumBands, [&](int32 Band)
+    {
+        const int32 RowBegin = FMath::Min(Band * BandRows, FrameHeight);
+        const int32 RowEnd = (Band == NumBands - 1) ? FrameHeight : FMath::Min(RowBegin + BandRows, FrameHeight);
+        switch (Format)
+        {
+        case ECamera2OutputFormat::RGB565:
+            Camera2Yuv::ConvertI420ToRGB565(Src, Color, Dst, DstPitch, RowBegin, RowEnd);
+            break;
+        case ECamera2OutputFormat::NV12:
+            Camera2Yuv::PackI420ToNV12(Src, Dst, DstPitch, RowBegin, RowEnd);
+            break;
+        default:
+            Camera2Yuv::ConvertI420ToBGRA(Src, Color, Dst, DstPitch, RowBegin, RowEnd);
+            break;
+        }
+    }, NumBands == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+    FramesConverted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FCamera2FramePipeline::Publish(int32 SlotIndex)
+{
+    const int64 Timestamp = Slots[SlotIndex]->TimestampNs.load(std::memory_order_relaxed);
+    Slots[SlotIndex]->State.store(ESlotState::Ready, std::memory_order_release);
+
+    int32 Previous = LatestReadySlot.load(std::memory_order_acquire);
+    for (;;)
+    {
+        // Conversions can finish out of order; never replace a newer frame with an older one
+        if (Previous != INDEX_NONE && Slots[Previous]->TimestampNs.load(std::memory_order_relaxed) > Timestamp)
+        {
+            ReleaseSlot(SlotIndex);
+            UploadsSuperseded.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (LatestReadySlot.compare_exchange_weak(Previous, SlotIndex, std::memory_order_acq_rel))
+        {
+            break;
+        }
+    }
+
+    if (Previous != INDEX_NONE)
+    {
+        ReleaseSlot(Previous);
+        UploadsSuperseded.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // One game-thread task at a time; it always takes the newest ready slot
+    if (!bUploadTaskPending.exchange(true, std::memory_order_acq_rel))
+    {
+        AsyncTask(ENamedThreads::GameThread, [this]()
+        {
+            bUploadTaskPending.store(false, std::memory_order_release);
+            UploadLatest();
+        });
+    }
+}
+
+void FCamera2FramePipeline::UploadLatest()
+{
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 Upload Enqueue"));
+    const int32 SlotIndex = LatestReadySlot.exchange(INDEX_NONE, std::memory_order_acq_rel);
+    if (SlotIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    FSlot& Slot = *Slots[SlotIndex];
+    const int32 TextureIndex = TargetTextures.Num() > 0 ? (LatestTextureIndex + 1) % TargetTextures.Num() : INDEX_NONE;
+    UTexture2D* Texture = TextureIndex != INDEX_NONE ? TargetTextures[TextureIndex] : nullptr;
+    FTexture2DResource* TextureResource = Texture ? static_cast<FTexture2DResource*>(Texture->GetResource()) : nullptr;
+    const Camera2Yuv::FOutputLayout Layout = Camera2Yuv::GetOutputLayout(Config.OutputFormat, FrameWidth, FrameHeight);
+    if (!TextureResource || Texture->GetSizeX() != Layout.TextureWidth || Texture->GetSizeY() != Layout.TextureHeight
+        || Texture->GetPixelFormat() != Layout.PixelFormat)
+    {
+        ReleaseSlot(SlotIndex);
+        return;
+    }
+
+    Slot.State.store(ESlotState::Uploading, std::memory_order_release);
+    LatestTextureIndex = TextureIndex;
+    if (OnFrameUploaded)
+    {
+        OnFrameUploaded(Slot.Metadata, Texture);
+    }
+
+    const uint32 SrcPitch = static_cast<uint32>(Layout.Pitch);
+    const FUpdateTextureRegion2D Region(0, 0, 0, 0, static_cast<uint32>(Layout.TextureWidth), static_cast<uint32>(Layout.TextureHeight));
+    const uint8* Data = (Config.OutputFormat == ECamera2OutputFormat::Luma) ? Slot.Y.GetData() : Slot.Converted.GetData();
+    const uint64 EnqueueCycles = FPlatformTime::Cycles64();
+    ENQUEUE_RENDER_COMMAND(UpdateCameraTexture2D)(
+        [this, TextureResource, Region, SrcPitch, Data, SlotIndex, EnqueueCycles](FRHICommandListImmediate& RHICmdList)
+        {
+            CAMERA2_TRACE_SCOPE(TEXT("Camera2 RHI Upload"));
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            RHICmdList.UpdateTexture2D(TextureResource->GetTexture2DRHI(), 0, Region, SrcPitch, Data);
+            ReleaseSlot(SlotIndex);
+            RecordUpload(EnqueueCycles, StartCycles, FPlatformTime::Cycles64());
+        });
+}
+
+void FCamera2FramePipeline::RecordUpload(uint64 EnqueueCycles, uint64 StartCycles, uint64 EndCycles)
+{
+    // Latency: game-thread enqueue until the texture holds the frame for any pass sampling it.
+    // Cost: time UpdateTexture2D held the render thread (driver syncs on a texture still in use show up here).
+    const float LatencyMs = static_cast<float>(FPlatformTime::ToMilliseconds64(EndCycles - EnqueueCycles));
+    const float CostMs = static_cast<float>(FPlatformTime::ToMilliseconds64(EndCycles - StartCycles));
+    if (CostMs > UploadStallThresholdMs)
+    {
+        UploadStalls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const float PreviousLatency = UploadLatencyMs.load(std::memory_order_relaxed);
+    const float PreviousCost = UploadCostMs.load(std::memory_order_relaxed);
+    UploadLatencyMs.store(PreviousLatency > 0.0f ? FMath::Lerp(PreviousLatency, LatencyMs, 0.1f) : LatencyMs, std::memory_order_relaxed);
+    UploadCostMs.store(PreviousCost > 0.0f ? FMath::Lerp(PreviousCost, CostMs, 0.1f) : CostMs, std::memory_order_relaxed);
+}
+
+void FCamera2FramePipeline::ResetStats()
+{
+    FramesConverted.store(0);
+    PipelineDrops.store(0);
+    UploadsSuperseded.store(0);
+    MeasuredFps.store(0.0f);
+    UploadStalls.store(0);
+    UploadLatencyMs.store(0.0f);
+    UploadCostMs.store(0.0f);
+    LastSubmitTimestampNs = 0;
+}
+
+void FCamera2FramePipeline::FillStats(FCamera2PipelineStats& OutStats) const
+{
+    OutStats.FramesConverted = FramesConverted.load(std::memory_order_relaxed);
+    OutStats.PipelineDrops = PipelineDrops.load(std::memory_order_relaxed);
+    OutStats.UploadsSuperseded = UploadsSuperseded.load(std::memory_order_relaxed);
+    OutStats.MeasuredFps = MeasuredFps.load(std::memory_order_relaxed);
+    OutStats.RingDepth = Slots.Num();
+    OutStats.ConversionThreads = Config.ConversionThreads;
+    OutStats.TextureBuffers = TargetTextures.Num();
+    OutStats.OutputFormat = Config.OutputFormat;
+    {
+        FScopeLock Lock(&ColorTransformLock);
+        if (ColorTransform.IsValid())
+        {
+            OutStats.ColorStandard = ColorTransform->Standard;
+            OutStats.ColorRange = ColorTransform->bFullRange ? ECamera2ColorRange::Full : ECamera2ColorRange::Limited;
+            OutStats.ColorLutSize = ColorTransform->Lut.Size;
+        }
+    }
+    OutStats.UploadBytesPerFrame = Config.bUploadToTexture && FrameWidth > 0
+        ? Camera2Yuv::GetOutputLayout(Config.OutputFormat, FrameWidth, FrameHeight).GetSizeBytes() : 0;
+    OutStats.UploadStalls = UploadStalls.load(std::memory_order_relaxed);
+    OutStats.UploadLatencyMs = UploadLatencyMs.load(std::memory_order_relaxed);
+    OutStats.UploadCostMs = UploadCostMs.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "HAL/CriticalSection.h"
+#include "Camera2Types.h"
+#include "Camera2ColorTransform.h"
+#include "Camera2FrameMemory.h"
+#include <atomic>
+
+class UTexture2D;
+
+/**
+ * Native YUV pipeline, one instance per camera output stream.
+ *
+ * Camera2Helper hands each YUV_420_888 image over on its background thread. The planes are copied into
+ * a preallocated ring slot and processed on worker threads: stream consumers run on the planes and, for
+ * the display stream, the frame is converted and the newest converted slot is uploaded to the camera
+ * texture once per game-thread tick. Ring depth and conversion parallelism are sized for the session
+ * frame rate reported when the stream size is selected.
+ *
+ * The display stream can upload into a set of up to MaxTextureBuffers textures, rotated per upload, so
+ * UpdateTexture2D never targets the texture the GPU sampled for the previous frame.
+ *
+ * Drop policy: a frame arriving while every slot is in use is dropped (PipelineDrops); a converted frame
+ * replaced by a newer one before the game thread picked it up is skipped for upload (UploadsSuperseded).
+ * Slots are accounted against the frame memory budget (Camera2Memory): when it runs out, the ring keeps the
+ * slots that fit, so the stream drops more frames instead of allocating more.
+ */
+class FCamera2FramePipeline
+{
+public:
+    struct FConfig
+    {
+        int32 RingDepth = 3;
+        int32 ConversionThreads = 1;
+        // Display stream: convert to BGRA and upload to the target texture
+        bool bUploadToTexture = true;
+        // Analysis streams and Luma output skip chroma entirely
+        bool bLumaOnly = false;
+        // Display stream texture layout (Luma uploads the Y plane without conversion)
+        ECamera2OutputFormat OutputFormat = ECamera2OutputFormat::BGRA8;
+    };
+
+    /** Stream 0 is the display stream; analysis streams use 1..MaxStreams-1 */
+    static constexpr int32 MaxStreams = 4;
+    static constexpr int32 DisplayStreamId = 0;
+    static constexpr int32 MaxTextureBuffers = 3;
+
+    static FCamera2FramePipeline& Get(int32 StreamId = DisplayStreamId);
+
+    /**
+     * Game thread, while the camera is stopped. Reallocates slots only when the size or depth changes, or when
+     * the frame memory budget held the ring below the requested depth last time.
+     */
+    void Configure(int32 Width, int32 Height, const FConfig& InConfig);
+
+    /**
+     * Game thread: wait (unbounded) for every frame task still running consumers or conversions, flush the
+     * pending uploads, then mark all slots free. Slot memory is released by Shutdown or a reconfigure only after this.
+     */
+    void Flush();
+
+    /** Game thread: textures that converted frames are uploaded into, rotated per upload (empty = no uploads) */
+    void SetTargetTextures(const TArray<UTexture2D*>& Textures);
+
+    /**
+     * Game thread: texture that received the most recent upload. Render commands run in order, so anything
+     * bound to it on the game thread afterwards samples the completed upload.
+     */
+    UTexture2D* GetLatestTexture() const { return TargetTextures.IsValidIndex(LatestTextureIndex) ? TargetTextures[LatestTextureIndex] : nullptr; }
+
+    /**
+     * Color stage applied by the BGRA/RGB565 conversions (matrix + optional LUT); safe from any thread,
+     * frames already being converted keep the transform they started with. Null = BT.601 full range.
+     */
+    void SetColorTransform(TSharedPtr<const Camera2Yuv::FColorTransform, ESPMode::ThreadSafe> InTransform);
+
+    /**
+     * Luma histogram, moments, sharpness and change score of every frame, computed on the worker before the
+     * consumers run (they get them in FCamera2FrameView::Stats); safe from any thread
+     */
+    void SetImageStats(bool bEnable, const FCamera2ImageStatsConfig& InConfig);
+
+    /** @return false until a frame was measured since the stats were enabled */
+    bool GetLatestImageStats(FCamera2ImageStats& OutStats) const;
+
+    /**
+     * Intrinsics of the stream's current configuration, handed to consumers in FCamera2FrameView::Intrinsics;
+     * safe from any thread, frames already in the consumers keep the intrinsics they started with
+     */
+    void SetIntrinsics(TSharedPtr<const FCamera2StreamIntrinsics, ESPMode::ThreadSafe> InIntrinsics);
+    TSharedPtr<const FCamera2StreamIntrinsics, ESPMode::ThreadSafe> GetIntrinsics() const;
+
+    /** Consumers are called on a worker thread for every frame that enters the ring; safe from any thread */
+    FDelegateHandle AddConsumer(FOnCamera2StreamFrame::FDelegate&& Delegate);
+    void RemoveConsumer(FDelegateHandle Handle);
+
+    bool IsConfigured() const { return Slots.Num() > 0; }
+    int32 GetStreamId() const { return StreamId; }
+    int32 GetWidth() const { return FrameWidth; }
+    int32 GetHeight() const { return FrameHeight; }
+
+    /** Release slot memory (stream removed from the session) */
+    void Shutdown();
+
+    /** Game thread callback invoked for every frame that is uploaded, with the texture it was written to */
+    void SetOnFrameUploaded(TFunction<void(const FCamera2FrameMetadata&, UTexture2D*)> Callback) { OnFrameUploaded = MoveTemp(Callback); }
+
+    /**
+     * Camera2Helper background thread. Copies the planes and schedules processing.
+     * U/V may be null for luma-only streams. A frame whose capture result has not arrived yet (Metadata.bValid
+     * false) waits in its slot for ResolveMetadata; at most RingDepth-1 frames wait, beyond that the oldest is
+     * processed with the sensor timestamp only.
+     * @return false if the frame was dropped
+     */
+    bool SubmitYuvFrame(const uint8* Y, int32 YRowStride,
+        const uint8* U, const uint8* V, int32 UVRowStride, int32 UVPixelStride,
+        int32 Width, int32 Height, const FCamera2FrameMetadata& Metadata);
+
+    /**
+     * Camera2Helper background thread, for every capture result: a waiting frame with the same sensor timestamp
+     * gets the result and is scheduled. Results arrive in frame order, so waiting frames older than the result
+     * lost theirs and are scheduled as they are.
+     */
+    void ResolveMetadata(const FCamera2FrameMetadata& Metadata);
+
+    void ResetStats();
+    void FillStats(FCamera2PipelineStats& OutStats) const;
+
+private:
+    enum class ESlotState : uint8
+    {
+        Free,
+        Busy,       // being filled or converted
+        Ready,      // converted, waiting for the game thread
+        Uploading   // owned by a render command
+    };
+
+    struct FSlot
+    {
+        Camera2Memory::FBuffer Y;
+        Camera2Memory::FBuffer U;
+        Camera2Memory::FBuffer V;
+        Camera2Memory::FBuffer Converted;
+        TArray<uint32> BlockSums;
+        FCamera2ImageStats Stats;
+        FCamera2FrameMetadata Metadata;
+        std::atomic<int64> TimestampNs{0};
+        std::atomic<ESlotState> State{ESlotState::Free};
+    };
+
+    void Dispatch(int32 SlotIndex);
+    void Process(int32 SlotIndex);
+    void ComputeImageStats(FSlot& Slot);
+    void Convert(int32 SlotIndex);
+    void Publish(int32 SlotIndex);
+    void UploadLatest();
+    void RecordUpload(uint64 EnqueueCycles, uint64 StartCycles, uint64 EndCycles);
+    void ReleaseSlot(int32 SlotIndex) { Slots[SlotIndex]->State.store(ESlotState::Free, std::memory_order_release); }
+
+    TArray<TUniquePtr<FSlot>> Slots;
+    FConfig Config;
+    int32 StreamId = DisplayStreamId;
+    int32 FrameWidth = 0;
+    int32 FrameHeight = 0;
+
+    TArray<UTexture2D*, TInlineAllocator<MaxTextureBuffers>> TargetTextures;
+    int32 LatestTextureIndex = INDEX_NONE; // game thread only
+    TFunction<void(const FCamera2FrameMetadata&, UTexture2D*)> OnFrameUploaded;
+
+    FOnCamera2StreamFrame Consumers;
+    FCriticalSection ConsumersLock;
+
+    // Image stats; frames can finish out of order, so the newest measured frame is the change reference
+    std::atomic<bool> bImageStatsEnabled{false};
+    FCamera2ImageStatsConfig ImageStatsConfig;
+    TArray<uint32> PreviousBlockSums;
+    int64 PreviousStatsTimestampNs = 0;
+    FCamera2ImageStats LatestImageStats;
+    bool bHasImageStats = false;
+    mutable FCriticalSection ImageStatsLock;
+
+    TSharedPtr<const Camera2Yuv::FColorTransform, ESPMode::ThreadSafe> ColorTransform;
+    mutable FCriticalSection ColorTransformLock;
+
+    TSharedPtr<const FCamera2StreamIntrinsics, ESPMode::ThreadSafe> Intrinsics;
+    mutable FCriticalSection IntrinsicsLock;
+
+    std::atomic<int32> LatestReadySlot{INDEX_NONE};
+    // Process tasks scheduled by SubmitYuvFrame that have not returned yet
+    std::atomic<int32> TasksInFlight{0};
+    // Filled slots waiting for their capture result, oldest first
+    TArray<int32, TInlineAllocator<8>> WaitingSlots;
+    FCriticalSection WaitingSlotsLock;
+    std::atomic<bool> bUploadTaskPending{false};
+
+    std::atomic<int64> FramesConverted{0};
+    std::atomic<int64> PipelineDrops{0};
+    std::atomic<int64> UploadsSuperseded{0};
+    std::atomic<float> MeasuredFps{0.0f};
+    std::atomic<int64> UploadStalls{0};
+    std::atomic<float> UploadLatencyMs{0.0f};   // render thread writes
+    std::atomic<float> UploadCostMs{0.0f};      // render thread writes
+    int64 LastSubmitTimestampNs = 0; // Camera2Helper thread only
+};
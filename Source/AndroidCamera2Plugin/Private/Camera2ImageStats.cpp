@@ -0,0 +1,249 @@
+#include "Camera2ImageStats.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#define CAMERA2_STATS_NEON 1
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#define CAMERA2_STATS_SSE2 1
+#endif
+
+namespace Camera2Stats
+{
+    // Laplacian squares are flushed from 32-bit lanes at least this often (max 2 * 1020^2 per lane per 8 pixels)
+    static constexpr int32 LaplacianChunkPixels = 1024;
+
+    int32 ClampBlockSize(int32 BlockSize)
+    {
+        return FMath::Clamp((BlockSize + 8) / 16, 1, 8) * 16;
+    }
+
+    /** Histogram with four interleaved sub-histograms so repeated values do not serialize on one counter */
+    static void AccumulateHistogram(const uint8* Row, int32 Width, uint32 (*Partial)[256])
+    {
+        int32 x = 0;
+        for (; x + 4 <= Width; x += 4)
+        {
+            ++Partial[0][Row[x]];
+            ++Partial[1][Row[x + 1]];
+            ++Partial[2][Row[x + 2]];
+            ++Partial[3][Row[x + 3]];
+        }
+        for (; x < Width; ++x)
+        {
+            ++Partial[0][Row[x]];
+        }
+    }
+
+    /** Sum and sum of squares of a row; 16-pixel sums also go to the block they belong to */
+    static void AccumulateMoments(const uint8* Row, int32 Width, int32 BlockSize, int32 BlockLimit, uint32* BlockRow,
+        uint64& InOutSum, uint64& InOutSumSquares)
+    {
+        int32 x = 0;
+        uint64 Sum = 0;
+        uint64 SumSquares = 0;
+#if CAMERA2_STATS_NEON
+        // 16 pixels add at most 4 * 255^2 per lane, so a 32-bit lane holds any realistic row
+        uint32x4_t Squares = vdupq_n_u32(0);
+        for (; x + 16 <= Width; x += 16)
+        {
+            const uint8x16_t Pixels = vld1q_u8(Row + x);
+            const uint32 ChunkSum = vaddlvq_u8(Pixels);
+            Sum += ChunkSum;
+            if (x < BlockLimit)
+            {
+                BlockRow[x / BlockSize] += ChunkSum;
+            }
+            const uint16x8_t Low = vmovl_u8(vget_low_u8(Pixels));
+            const uint16x8_t High = vmovl_u8(vget_high_u8(Pixels));
+            Squares = vmlal_u16(Squares, vget_low_u16(Low), vget_low_u16(Low));
+            Squares = vmlal_u16(Squares, vget_high_u16(Low), vget_high_u16(Low));
+            Squares = vmlal_u16(Squares, vget_low_u16(High), vget_low_u16(High));
+            Squares = vmlal_u16(Squares, vget_high_u16(High), vget_high_u16(High));
+        }
+        SumSquares += vaddlvq_u32(Squares);
+#elif CAMERA2_STATS_SSE2
+        const __m128i Zero = _mm_setzero_si128();
+        __m128i Squares = _mm_setzero_si128();
+        for (; x + 16 <= Width; x += 16)
+        {
+            const __m128i Pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row + x));
+            const __m128i Sad = _mm_sad_epu8(Pixels, Zero);
+            const uint32 ChunkSum = static_cast<uint32>(_mm_cvtsi128_si32(Sad) + _mm_cvtsi128_si32(_mm_srli_si128(Sad, 8)));
+            Sum += ChunkSum;
+            if (x < BlockLimit)
+            {
+                BlockRow[x / BlockSize] += ChunkSum;
+            }
+            const __m128i Low = _mm_unpacklo_epi8(Pixels, Zero);
+            const __m128i High = _mm_unpackhi_epi8(Pixels, Zero);
+            Squares = _mm_add_epi32(Squares, _mm_add_epi32(_mm_madd_epi16(Low, Low), _mm_madd_epi16(High, High)));
+        }
+        alignas(16) uint32 Lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(Lanes), Squares);
+        SumSquares += static_cast<uint64>(Lanes[0]) + Lanes[1] + Lanes[2] + Lanes[3];
+#endif
+        // BlockLimit is a multiple of 16, so the scalar tail only reaches a block when there is no SIMD path
+        for (; x < Width; ++x)
+        {
+            const uint32 Value = Row[x];
+            Sum += Value;
+            SumSquares += Value * Value;
+            if (x < BlockLimit)
+            {
+                BlockRow[x / BlockSize] += Value;
+            }
+        }
+        InOutSum += Sum;
+        InOutSumSquares += SumSquares;
+    }
+
+    /** 4 * center - left - right - up - down over the interior columns of a row */
+    static void AccumulateLaplacian(const uint8* Up, const uint8* Row, const uint8* Down, int32 Width,
+        int64& InOutSum, uint64& InOutSumSquares)
+    {
+        int32 x = 1;
+        int64 Sum = 0;
+        uint64 SumSquares = 0;
+#if CAMERA2_STATS_NEON || CAMERA2_STATS_SSE2
+        const int32 VectorEnd = 1 + ((Width - 2) / 8) * 8;
+#endif
+#if CAMERA2_STATS_NEON
+        while (x < VectorEnd)
+        {
+            const int32 ChunkEnd = FMath::Min(x + LaplacianChunkPixels, VectorEnd);
+            int32x4_t Sums = vdupq_n_s32(0);
+            uint32x4_t Squares = vdupq_n_u32(0);
+            for (; x < ChunkEnd; x += 8)
+            {
+                const int16x8_t Center = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(Row + x)));
+                const int16x8_t Left = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(Row + x - 1)));
+                const int16x8_t Right = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(Row + x + 1)));
+                const int16x8_t Above = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(Up + x)));
+                const int16x8_t Below = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(Down + x)));
+                const int16x8_t Laplacian = vsubq_s16(vshlq_n_s16(Center, 2),
+                    vaddq_s16(vaddq_s16(Left, Right), vaddq_s16(Above, Below)));
+                Sums = vpadalq_s16(Sums, Laplacian);
+                Squares = vreinterpretq_u32_s32(vmlal_s16(vreinterpretq_s32_u32(Squares), vget_low_s16(Laplacian), vget_low_s16(Laplacian)));
+                Squares = vreinterpretq_u32_s32(vmlal_s16(vreinterpretq_s32_u32(Squares), vget_high_s16(Laplacian), vget_high_s16(Laplacian)));
+            }
+            Sum += vaddlvq_s32(Sums);
+            SumSquares += vaddlvq_u32(Squares);
+        }
+#elif CAMERA2_STATS_SSE2
+        const __m128i Zero = _mm_setzero_si128();
+        const __m128i Ones = _mm_set1_epi16(1);
+        while (x < VectorEnd)
+        {
+            const int32 ChunkEnd = FMath::Min(x + LaplacianChunkPixels, VectorEnd);
+            __m128i Sums = _mm_setzero_si128();
+            __m128i Squares = _mm_setzero_si128();
+            for (; x < ChunkEnd; x += 8)
+            {
+                const __m128i Center = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Row + x)), Zero);
+                const __m128i Left = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Row + x - 1)), Zero);
+                const __m128i Right = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Row + x + 1)), Zero);
+                const __m128i Above = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Up + x)), Zero);
+                const __m128i Below = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Down + x)), Zero);
+                const __m128i Laplacian = _mm_sub_epi16(_mm_slli_epi16(Center, 2),
+                    _mm_add_epi16(_mm_add_epi16(Left, Right), _mm_add_epi16(Above, Below)));
+                Sums = _mm_add_epi32(Sums, _mm_madd_epi16(Laplacian, Ones));
+                Squares = _mm_add_epi32(Squares, _mm_madd_epi16(Laplacian, Laplacian));
+            }
+            alignas(16) int32 SumLanes[4];
+            alignas(16) uint32 SquareLanes[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(SumLanes), Sums);
+            _mm_store_si128(reinterpret_cast<__m128i*>(SquareLanes), Squares);
+            Sum += static_cast<int64>(SumLanes[0]) + SumLanes[1] + SumLanes[2] + SumLanes[3];
+            SumSquares += static_cast<uint64>(SquareLanes[0]) + SquareLanes[1] + SquareLanes[2] + SquareLanes[3];
+        }
+#endif
+        for (; x < Width - 1; ++x)
+        {
+            const int32 Laplacian = 4 * Row[x] - Row[x - 1] - Row[x + 1] - Up[x] - Down[x];
+            Sum += Laplacian;
+            SumSquares += static_cast<uint64>(Laplacian * Laplacian);
+        }
+        InOutSum += Sum;
+        InOutSumSquares += SumSquares;
+    }
+
+    void ComputeLumaTotals(const uint8* Y, int32 Width, int32 Height, int32 BlockSize, FLumaTotals& OutTotals,
+        TArray<uint32>& OutBlockSums)
+    {
+        OutTotals = FLumaTotals();
+        OutTotals.BlocksX = Width / BlockSize;
+        OutTotals.BlocksY = Height / BlockSize;
+        OutBlockSums.Reset();
+        OutBlockSums.SetNumZeroed(OutTotals.BlocksX * OutTotals.BlocksY);
+        const int32 BlockLimit = OutTotals.BlocksX * BlockSize;
+
+        uint32 Partial[4][256];
+        FMemory::Memzero(Partial, sizeof(Partial));
+        for (int32 y = 0; y < Height; ++y)
+        {
+            const uint8* Row = Y + y * Width;
+            AccumulateHistogram(Row, Width, Partial);
+            const int32 BlockY = y / BlockSize;
+            uint32* BlockRow = BlockY < OutTotals.BlocksY ? OutBlockSums.GetData() + BlockY * OutTotals.BlocksX : nullptr;
+            AccumulateMoments(Row, Width, BlockSize, BlockRow ? BlockLimit : 0, BlockRow, OutTotals.Sum, OutTotals.SumSquares);
+            if (y > 0 && y < Height - 1 && Width > 2)
+            {
+                AccumulateLaplacian(Row - Width, Row, Row + Width, Width, OutTotals.LaplacianSum, OutTotals.LaplacianSumSquares);
+            }
+        }
+        for (int32 Bin = 0; Bin < 256; ++Bin)
+        {
+            OutTotals.Histogram[Bin] = Partial[0][Bin] + Partial[1][Bin] + Partial[2][Bin] + Partial[3][Bin];
+        }
+        OutTotals.LaplacianCount = static_cast<int64>(FMath::Max(Width - 2, 0)) * FMath::Max(Height - 2, 0);
+    }
+
+    float ComputeChangeScore(const TArray<uint32>& Current, const TArray<uint32>& Previous, int32 PixelsPerBlock, float Threshold)
+    {
+        const int32 NumBlocks = Current.Num();
+        if (NumBlocks == 0 || Previous.Num() != NumBlocks || PixelsPerBlock <= 0)
+        {
+            return 1.0f;
+        }
+
+        int64 TotalShift = 0;
+        for (int32 i = 0; i < NumBlocks; ++i)
+        {
+            TotalShift += static_cast<int64>(Current[i]) - static_cast<int64>(Previous[i]);
+        }
+        // Compare block sums directly: a mean difference of Threshold is Threshold * PixelsPerBlock in sums
+        const double Shift = static_cast<double>(TotalShift) / NumBlocks;
+        const double Limit = static_cast<double>(Threshold) * PixelsPerBlock;
+        int32 Changed = 0;
+        for (int32 i = 0; i < NumBlocks; ++i)
+        {
+            const double Difference = static_cast<double>(Current[i]) - static_cast<double>(Previous[i]) - Shift;
+            Changed += FMath::Abs(Difference) > Limit ? 1 : 0;
+        }
+        return static_cast<float>(Changed) / NumBlocks;
+    }
+
+    void FillStats(const FLumaTotals& Totals, int64 NumPixels, FCamera2ImageStats& OutStats)
+    {
+        OutStats.Histogram.SetNumUninitialized(256);
+        for (int32 Bin = 0; Bin < 256; ++Bin)
+        {
+            OutStats.Histogram[Bin] = static_cast<int32>(Totals.Histogram[Bin]);
+        }
+        if (NumPixels <= 0)
+        {
+            return;
+        }
+
+        const double Mean = static_cast<double>(Totals.Sum) / NumPixels;
+        OutStats.Mean = static_cast<float>(Mean);
+        OutStats.Variance = static_cast<float>(FMath::Max(static_cast<double>(Totals.SumSquares) / NumPixels - Mean * Mean, 0.0));
+        if (Totals.LaplacianCount > 0)
+        {
+            const double LaplacianMean = static_cast<double>(Totals.LaplacianSum) / Totals.LaplacianCount;
+            OutStats.Sharpness = static_cast<float>(FMath::Max(
+                static_cast<double>(Totals.LaplacianSumSquares) / Totals.LaplacianCount - LaplacianMean * LaplacianMean, 0.0));
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera2Types.h"
+
+/**
+ * Per-frame luma statistics gathered in a single pass over the Y plane: each row is visited once for the
+ * histogram, mean/variance, Laplacian (sharpness) and block sums (change detection) while it is in L1.
+ * Sums, squares, Laplacian and block sums use NEON (arm64) or SSE2 (x64) with a scalar tail; all paths
+ * produce identical integer totals.
+ */
+namespace Camera2Stats
+{
+    struct FLumaTotals
+    {
+        uint32 Histogram[256];
+        uint64 Sum = 0;
+        uint64 SumSquares = 0;
+        // 4-neighbour Laplacian over the interior pixels
+        int64 LaplacianSum = 0;
+        uint64 LaplacianSumSquares = 0;
+        int64 LaplacianCount = 0;
+        int32 BlocksX = 0;
+        int32 BlocksY = 0;
+    };
+
+    /** Block edge used for change detection: a multiple of 16 in [16, 128] */
+    int32 ClampBlockSize(int32 BlockSize);
+
+    /**
+     * @param BlockSize from ClampBlockSize; OutBlockSums gets BlocksX * BlocksY sums of whole blocks (the partial
+     *        blocks at the right and bottom edges are left out)
+     */
+    void ComputeLumaTotals(const uint8* Y, int32 Width, int32 Height, int32 BlockSize, FLumaTotals& OutTotals,
+        TArray<uint32>& OutBlockSums);
+
+    /**
+     * Fraction of blocks whose mean moved by more than Threshold luma levels against the previous frame, after
+     * removing the average shift of all blocks so exposure changes alone do not count as motion
+     */
+    float ComputeChangeScore(const TArray<uint32>& Current, const TArray<uint32>& Previous, int32 PixelsPerBlock, float Threshold);
+
+    /** Histogram, moments and scores of a frame */
+    void FillStats(const FLumaTotals& Totals, int64 NumPixels, FCamera2ImageStats& OutStats);
+}
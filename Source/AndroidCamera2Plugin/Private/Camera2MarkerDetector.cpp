@@ -0,0 +1,1147 @@
+#include "Camera2MarkerDetector.h"
+#include "Camera2FeatureDetector.h"
+#include "Camera2Calibration.h"
+#include "Async/ParallelFor.h"
+
+namespace Camera2Markers
+{
+    static constexpr int32 TileSize = 4;
+    static constexpr int32 StatCount = 0;
+    static constexpr int32 StatMinX = 1;
+    static constexpr int32 StatMinY = 2;
+    static constexpr int32 StatMaxX = 3;
+    static constexpr int32 StatMaxY = 4;
+    static constexpr int32 NumStats = 5;
+
+    // Threshold classes; uniform areas (inside a large black border, plain walls) are neither dark nor light
+    static constexpr uint8 Light = 0;
+    static constexpr uint8 Dark = 1;
+    static constexpr uint8 Uniform = 2;
+
+    FDictionary MakeArucoOriginalDictionary()
+    {
+        // Columns 1 and 3 of each row carry two bits of the id, the other three are parity
+        static const uint64 Words[4] = { 0x10, 0x17, 0x09, 0x0e };
+
+        FDictionary Dictionary;
+        Dictionary.Bits = 5;
+        Dictionary.Codes.SetNumUninitialized(1024);
+        for (int32 Id = 0; Id < 1024; ++Id)
+        {
+            uint64 Code = 0;
+            for (int32 Row = 0; Row < 5; ++Row)
+            {
+                Code = (Code << 5) | Words[(Id >> (2 * (4 - Row))) & 3];
+            }
+            Dictionary.Codes[Id] = Code;
+        }
+        return Dictionary;
+    }
+
+    /** Split [0, Num) into contiguous bands, one task each */
+    template <typename FunctionType>
+    static void RunBands(int32 Num, int32 NumThreads, const FunctionType& Function)
+    {
+        const int32 NumBands = FMath::Clamp(NumThreads, 1, FMath::Max(Num, 1));
+        const int32 BandSize = (Num + NumBands - 1) / NumBands;
+        ParallelFor(NumBands, [&](int32 Band)
+        {
+            const int32 Begin = FMath::Min(Band * BandSize, Num);
+            Function(Begin, FMath::Min(Begin + BandSize, Num));
+        }, NumBands == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+    }
+
+    /**
+     * Dark = below the midpoint of the min and max over the surrounding 3x3 tiles, Light = above it.
+     * Pixels whose tile neighbourhood has less than MinContrast are Uniform.
+     */
+    static void Threshold(const uint8* Image, int32 Width, int32 Height, int32 MinContrast, int32 NumThreads, FDetectorScratch& Scratch)
+    {
+        const int32 TilesX = (Width + TileSize - 1) / TileSize;
+        const int32 TilesY = (Height + TileSize - 1) / TileSize;
+        Scratch.TileMin.SetNumUninitialized(TilesX * TilesY);
+        Scratch.TileMax.SetNumUninitialized(TilesX * TilesY);
+        Scratch.TileMinDilated.SetNumUninitialized(TilesX * TilesY);
+        Scratch.TileMaxDilated.SetNumUninitialized(TilesX * TilesY);
+        Scratch.Classes.SetNumUninitialized(Width * Height);
+
+        uint8* TileMin = Scratch.TileMin.GetData();
+        uint8* TileMax = Scratch.TileMax.GetData();
+        RunBands(TilesY, NumThreads, [&](int32 Begin, int32 End)
+        {
+            for (int32 TileY = Begin; TileY < End; ++TileY)
+            {
+                const int32 RowEnd = FMath::Min((TileY + 1) * TileSize, Height);
+                for (int32 TileX = 0; TileX < TilesX; ++TileX)
+                {
+                    const int32 ColumnEnd = FMath::Min((TileX + 1) * TileSize, Width);
+                    uint8 Lo = 255;
+                    uint8 Hi = 0;
+                    for (int32 y = TileY * TileSize; y < RowEnd; ++y)
+                    {
+                        const uint8* Row = Image + y * Width;
+                        for (int32 x = TileX * TileSize; x < ColumnEnd; ++x)
+                        {
+                            Lo = FMath::Min(Lo, Row[x]);
+                            Hi = FMath::Max(Hi, Row[x]);
+                        }
+                    }
+                    TileMin[TileY * TilesX + TileX] = Lo;
+                    TileMax[TileY * TilesX + TileX] = Hi;
+                }
+            }
+        });
+
+        // Pixels next to a tile edge need both sides of the black/white transition in their neighbourhood
+        uint8* MinDilated = Scratch.TileMinDilated.GetData();
+        uint8* MaxDilated = Scratch.TileMaxDilated.GetData();
+        RunBands(TilesY, NumThreads, [&](int32 Begin, int32 End)
+        {
+            for (int32 TileY = Begin; TileY < End; ++TileY)
+            {
+                for (int32 TileX = 0; TileX < TilesX; ++TileX)
+                {
+                    uint8 Lo = 255;
+                    uint8 Hi = 0;
+                    for (int32 y = FMath::Max(TileY - 1, 0); y <= FMath::Min(TileY + 1, TilesY - 1); ++y)
+                    {
+                        for (int32 x = FMath::Max(TileX - 1, 0); x <= FMath::Min(TileX + 1, TilesX - 1); ++x)
+                        {
+                            Lo = FMath::Min(Lo, TileMin[y * TilesX + x]);
+                            Hi = FMath::Max(Hi, TileMax[y * TilesX + x]);
+                        }
+                    }
+                    MinDilated[TileY * TilesX + TileX] = Lo;
+                    MaxDilated[TileY * TilesX + TileX] = Hi;
+                }
+            }
+        });
+
+        uint8* Classes = Scratch.Classes.GetData();
+        RunBands(Height, NumThreads, [&](int32 Begin, int32 End)
+        {
+            for (int32 y = Begin; y < End; ++y)
+            {
+                const uint8* Row = Image + y * Width;
+                uint8* Out = Classes + y * Width;
+                const int32 TileRow = (y / TileSize) * TilesX;
+                for (int32 x = 0; x < Width; ++x)
+                {
+                    const int32 Lo = MinDilated[TileRow + x / TileSize];
+                    const int32 Hi = MaxDilated[TileRow + x / TileSize];
+                    Out[x] = Hi - Lo < MinContrast ? Uniform : (Row[x] * 2 < Lo + Hi ? Dark : Light);
+                }
+            }
+        });
+    }
+
+    static FORCEINLINE int32 FindRoot(TArray<int32>& Parent, int32 Label)
+    {
+        while (Parent[Label] != Label)
+        {
+            Parent[Label] = Parent[Parent[Label]];
+            Label = Parent[Label];
+        }
+        return Label;
+    }
+
+    /** 4-connected Dark components; Labels ends up holding the component index per pixel (-1 = not dark) */
+    static int32 LabelComponents(int32 Width, int32 Height, FDetectorScratch& Scratch)
+    {
+        const uint8* Classes = Scratch.Classes.GetData();
+        Scratch.Labels.SetNumUninitialized(Width * Height);
+        int32* Labels = Scratch.Labels.GetData();
+        TArray<int32>& Parent = Scratch.Parent;
+        Parent.Reset();
+
+        for (int32 y = 0; y < Height; ++y)
+        {
+            for (int32 x = 0; x < Width; ++x)
+            {
+                const int32 Index = y * Width + x;
+                if (Classes[Index] != Dark)
+                {
+                    Labels[Index] = -1;
+                    continue;
+                }
+                const int32 Left = x > 0 ? Labels[Index - 1] : -1;
+                const int32 Up = y > 0 ? Labels[Index - Width] : -1;
+                if (Left < 0 && Up < 0)
+                {
+                    Labels[Index] = Parent.Add(Parent.Num());
+                }
+                else if (Left >= 0 && Up >= 0 && Left != Up)
+                {
+                    const int32 RootLeft = FindRoot(Parent, Left);
+                    const int32 RootUp = FindRoot(Parent, Up);
+                    Parent[FMath::Max(RootLeft, RootUp)] = FMath::Min(RootLeft, RootUp);
+                    Labels[Index] = Left;
+                }
+                else
+                {
+                    Labels[Index] = Left >= 0 ? Left : Up;
+                }
+            }
+        }
+
+        Scratch.RootComponent.Reset();
+        Scratch.RootComponent.SetNumUninitialized(Parent.Num());
+        Scratch.ComponentStats.Reset();
+        int32 NumComponents = 0;
+        for (int32 Label = 0; Label < Parent.Num(); ++Label)
+        {
+            const int32 Root = FindRoot(Parent, Label);
+            if (Root == Label)
+            {
+                Scratch.RootComponent[Label] = NumComponents++;
+                const int32 Stats[NumStats] = { 0, MAX_int32, MAX_int32, -1, -1 };
+                Scratch.ComponentStats.Append(Stats, NumStats);
+            }
+            else
+            {
+                // Roots always have the smaller label, so they are numbered already
+                Scratch.RootComponent[Label] = Scratch.RootComponent[Root];
+            }
+        }
+
+        int32* Stats = Scratch.ComponentStats.GetData();
+        for (int32 y = 0; y < Height; ++y)
+        {
+            for (int32 x = 0; x < Width; ++x)
+            {
+                int32& Label = Labels[y * Width + x];
+                if (Label < 0)
+                {
+                    continue;
+                }
+                Label = Scratch.RootComponent[Label];
+                int32* Component = Stats + Label * NumStats;
+                ++Component[StatCount];
+                Component[StatMinX] = FMath::Min(Component[StatMinX], x);
+                Component[StatMinY] = FMath::Min(Component[StatMinY], y);
+                Component[StatMaxX] = FMath::Max(Component[StatMaxX], x);
+                Component[StatMaxY] = FMath::Max(Component[StatMaxY], y);
+            }
+        }
+        return NumComponents;
+    }
+
+    /** Components big enough to be a marker border, and the dark pixels on their edges grouped per candidate */
+    static void CollectCandidates(int32 Width, int32 Height, int32 NumComponents, int32 MinSide, FDetectorScratch& Scratch)
+    {
+        const int32* Stats = Scratch.ComponentStats.GetData();
+        Scratch.Candidates.Reset();
+        Scratch.RootComponent.SetNumUninitialized(NumComponents);
+        int32* CandidateOf = Scratch.RootComponent.GetData();
+        for (int32 Component = 0; Component < NumComponents; ++Component)
+        {
+            const int32* Box = Stats + Component * NumStats;
+            const int32 BoxWidth = Box[StatMaxX] - Box[StatMinX] + 1;
+            const int32 BoxHeight = Box[StatMaxY] - Box[StatMinY] + 1;
+            // The quiet zone around the marker has to be visible
+            const bool bInside = Box[StatMinX] > 0 && Box[StatMinY] > 0 && Box[StatMaxX] < Width - 1 && Box[StatMaxY] < Height - 1;
+            CandidateOf[Component] = -1;
+            if (bInside && BoxWidth >= MinSide && BoxHeight >= MinSide && Box[StatCount] >= 2 * MinSide)
+            {
+                CandidateOf[Component] = Scratch.Candidates.Add(Component);
+            }
+        }
+
+        const int32 NumCandidates = Scratch.Candidates.Num();
+        Scratch.BoundaryOffsets.Reset();
+        Scratch.BoundaryOffsets.SetNumZeroed(NumCandidates + 1);
+        const uint8* Classes = Scratch.Classes.GetData();
+        const int32* Labels = Scratch.Labels.GetData();
+        // Only dark/light transitions are edges; the inner rim of a wide border next to Uniform pixels is not
+        auto IsEdge = [Classes, Width](int32 Index)
+        {
+            return Classes[Index - 1] == Light || Classes[Index + 1] == Light || Classes[Index - Width] == Light || Classes[Index + Width] == Light;
+        };
+
+        // Candidates never touch the image border, so their pixels always have four neighbours
+        for (int32 Pass = 0; Pass < 2; ++Pass)
+        {
+            if (Pass == 1)
+            {
+                for (int32 i = 0; i < NumCandidates; ++i)
+                {
+                    Scratch.BoundaryOffsets[i + 1] += Scratch.BoundaryOffsets[i];
+                }
+                Scratch.Boundary.SetNumUninitialized(Scratch.BoundaryOffsets[NumCandidates]);
+                Scratch.BoundaryCursor = Scratch.BoundaryOffsets;
+            }
+            for (int32 y = 1; y < Height - 1; ++y)
+            {
+                for (int32 x = 1; x < Width - 1; ++x)
+                {
+                    const int32 Index = y * Width + x;
+                    const int32 Candidate = Labels[Index] >= 0 ? CandidateOf[Labels[Index]] : -1;
+                    if (Candidate >= 0 && IsEdge(Index))
+                    {
+                        if (Pass == 0)
+                        {
+                            ++Scratch.BoundaryOffsets[Candidate + 1];
+                        }
+                        else
+                        {
+                            Scratch.Boundary[Scratch.BoundaryCursor[Candidate]++] = Index;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    struct FLine
+    {
+        // Points p with Normal . p = Distance
+        double NormalX = 0.0;
+        double NormalY = 0.0;
+        double Distance = 0.0;
+    };
+
+    /** Total least squares line through weighted points */
+    static bool FitLine(const double* Xs, const double* Ys, const double* Weights, int32 Num, FLine& OutLine)
+    {
+        double SumW = 0.0;
+        double MeanX = 0.0;
+        double MeanY = 0.0;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            SumW += Weights[i];
+            MeanX += Weights[i] * Xs[i];
+            MeanY += Weights[i] * Ys[i];
+        }
+        if (Num < 3 || SumW <= 0.0)
+        {
+            return false;
+        }
+        MeanX /= SumW;
+        MeanY /= SumW;
+        double Sxx = 0.0;
+        double Sxy = 0.0;
+        double Syy = 0.0;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            const double Dx = Xs[i] - MeanX;
+            const double Dy = Ys[i] - MeanY;
+            Sxx += Weights[i] * Dx * Dx;
+            Sxy += Weights[i] * Dx * Dy;
+            Syy += Weights[i] * Dy * Dy;
+        }
+        // Direction of the largest eigenvector of the scatter matrix; the normal is perpendicular to it
+        const double Angle = 0.5 * FMath::Atan2(2.0 * Sxy, Sxx - Syy);
+        OutLine.NormalX = -FMath::Sin(Angle);
+        OutLine.NormalY = FMath::Cos(Angle);
+        OutLine.Distance = OutLine.NormalX * MeanX + OutLine.NormalY * MeanY;
+        return true;
+    }
+
+    static bool IntersectLines(const FLine& A, const FLine& B, double& OutX, double& OutY)
+    {
+        const double Det = A.NormalX * B.NormalY - A.NormalY * B.NormalX;
+        if (FMath::Abs(Det) < 1.0e-6)
+        {
+            return false;
+        }
+        OutX = (A.Distance * B.NormalY - A.NormalY * B.Distance) / Det;
+        OutY = (A.NormalX * B.Distance - A.Distance * B.NormalX) / Det;
+        return true;
+    }
+
+    /** Convex, clockwise on screen (y down), no side much shorter than the others */
+    static bool IsPlausibleQuad(const double Corners[4][2], double MinSide)
+    {
+        double Shortest = MAX_dbl;
+        double Longest = 0.0;
+        for (int32 i = 0; i < 4; ++i)
+        {
+            const double* A = Corners[i];
+            const double* B = Corners[(i + 1) & 3];
+            const double* C = Corners[(i + 2) & 3];
+            const double Cross = (B[0] - A[0]) * (C[1] - B[1]) - (B[1] - A[1]) * (C[0] - B[0]);
+            if (Cross <= 0.0)
+            {
+                return false;
+            }
+            const double Side = FMath::Sqrt((B[0] - A[0]) * (B[0] - A[0]) + (B[1] - A[1]) * (B[1] - A[1]));
+            Shortest = FMath::Min(Shortest, Side);
+            Longest = FMath::Max(Longest, Side);
+        }
+        return Shortest >= MinSide && Shortest * 4.0 >= Longest;
+    }
+
+    /**
+     * Corners from the extremes of the boundary (farthest point from the centroid, farthest from that, then
+     * farthest on each side of the diagonal), then refined by fitting a line to the straight middle part of
+     * each side and intersecting neighbouring lines.
+     */
+    static bool FitQuad(const int32* Boundary, int32 Num, int32 Width, double MinSide, double OutCorners[4][2])
+    {
+        if (Num < 8)
+        {
+            return false;
+        }
+        double CenterX = 0.0;
+        double CenterY = 0.0;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            CenterX += Boundary[i] % Width;
+            CenterY += Boundary[i] / Width;
+        }
+        CenterX /= Num;
+        CenterY /= Num;
+
+        auto FarthestFrom = [Boundary, Num, Width](double X, double Y)
+        {
+            int32 Best = 0;
+            double BestDistance = -1.0;
+            for (int32 i = 0; i < Num; ++i)
+            {
+                const double Dx = Boundary[i] % Width - X;
+                const double Dy = Boundary[i] / Width - Y;
+                if (Dx * Dx + Dy * Dy > BestDistance)
+                {
+                    BestDistance = Dx * Dx + Dy * Dy;
+                    Best = i;
+                }
+            }
+            return Best;
+        };
+        const int32 First = FarthestFrom(CenterX, CenterY);
+        const double X0 = Boundary[First] % Width;
+        const double Y0 = Boundary[First] / Width;
+        const int32 Opposite = FarthestFrom(X0, Y0);
+        const double DiagonalX = Boundary[Opposite] % Width - X0;
+        const double DiagonalY = Boundary[Opposite] / Width - Y0;
+        const double DiagonalLength = FMath::Sqrt(DiagonalX * DiagonalX + DiagonalY * DiagonalY);
+        if (DiagonalLength < MinSide)
+        {
+            return false;
+        }
+
+        int32 Side[2] = { First, First };
+        double SideDistance[2] = { 0.0, 0.0 };
+        for (int32 i = 0; i < Num; ++i)
+        {
+            const double Cross = DiagonalX * (Boundary[i] / Width - Y0) - DiagonalY * (Boundary[i] % Width - X0);
+            if (Cross > SideDistance[0])
+            {
+                SideDistance[0] = Cross;
+                Side[0] = i;
+            }
+            if (Cross < SideDistance[1])
+            {
+                SideDistance[1] = Cross;
+                Side[1] = i;
+            }
+        }
+        // A square's other corners are half a diagonal away from it
+        const double MinOffset = 0.2 * DiagonalLength * DiagonalLength;
+        if (SideDistance[0] < MinOffset || -SideDistance[1] < MinOffset)
+        {
+            return false;
+        }
+
+        // With y pointing down the negative side of the diagonal comes next going clockwise on screen
+        const int32 Order[4] = { First, Side[1], Opposite, Side[0] };
+        double Rough[4][2];
+        for (int32 i = 0; i < 4; ++i)
+        {
+            Rough[i][0] = Boundary[Order[i]] % Width;
+            Rough[i][1] = Boundary[Order[i]] / Width;
+        }
+
+        FLine Lines[4];
+        TArray<double, TInlineAllocator<256>> Xs;
+        TArray<double, TInlineAllocator<256>> Ys;
+        TArray<double, TInlineAllocator<256>> Weights;
+        for (int32 i = 0; i < 4; ++i)
+        {
+            const double* A = Rough[i];
+            const double* B = Rough[(i + 1) & 3];
+            const double DirX = B[0] - A[0];
+            const double DirY = B[1] - A[1];
+            const double Length = FMath::Sqrt(DirX * DirX + DirY * DirY);
+            if (Length < 1.0)
+            {
+                return false;
+            }
+            // Stay clear of the corners and of the border's inner edge
+            const double Tolerance = FMath::Max(1.5, 0.05 * Length);
+            Xs.Reset();
+            Ys.Reset();
+            for (int32 j = 0; j < Num; ++j)
+            {
+                const double Px = Boundary[j] % Width - A[0];
+                const double Py = Boundary[j] / Width - A[1];
+                const double Along = (Px * DirX + Py * DirY) / (Length * Length);
+                const double Across = (Px * DirY - Py * DirX) / Length;
+                if (Along > 0.12 && Along < 0.88 && FMath::Abs(Across) <= Tolerance)
+                {
+                    Xs.Add(Px + A[0]);
+                    Ys.Add(Py + A[1]);
+                }
+            }
+            const int32 NumPoints = Xs.Num();
+            Weights.Reset();
+            Weights.Init(1.0, NumPoints);
+            if (!FitLine(Xs.GetData(), Ys.GetData(), Weights.GetData(), NumPoints, Lines[i]))
+            {
+                Lines[i].NormalX = DirY / Length;
+                Lines[i].NormalY = -DirX / Length;
+                Lines[i].Distance = Lines[i].NormalX * A[0] + Lines[i].NormalY * A[1];
+            }
+            // Boundary pixels are the outermost dark ones; the edge lies half a pixel further out
+            if (Lines[i].NormalX * CenterX + Lines[i].NormalY * CenterY > Lines[i].Distance)
+            {
+                Lines[i].NormalX = -Lines[i].NormalX;
+                Lines[i].NormalY = -Lines[i].NormalY;
+                Lines[i].Distance = -Lines[i].Distance;
+            }
+            Lines[i].Distance += 0.5;
+        }
+
+        for (int32 i = 0; i < 4; ++i)
+        {
+            if (!IntersectLines(Lines[(i + 3) & 3], Lines[i], OutCorners[i][0], OutCorners[i][1]))
+            {
+                return false;
+            }
+        }
+        return IsPlausibleQuad(OutCorners, MinSide);
+    }
+
+    static FORCEINLINE double SampleBilinear(const uint8* Y, int32 Width, int32 Height, double X, double Yf)
+    {
+        X = FMath::Clamp(X, 0.0, Width - 1.001);
+        Yf = FMath::Clamp(Yf, 0.0, Height - 1.001);
+        const int32 X0 = static_cast<int32>(X);
+        const int32 Y0 = static_cast<int32>(Yf);
+        const double Fx = X - X0;
+        const double Fy = Yf - Y0;
+        const uint8* Row = Y + Y0 * Width + X0;
+        const double Top = Row[0] + (Row[1] - Row[0]) * Fx;
+        const double Bottom = Row[Width] + (Row[Width + 1] - Row[Width]) * Fx;
+        return Top + (Bottom - Top) * Fy;
+    }
+
+    /**
+     * Move each side onto the strongest dark-to-light step along its outward normal in the full-resolution
+     * image, which recovers the precision lost to decimation, and re-intersect the sides.
+     */
+    static bool RefineEdges(const uint8* Y, int32 Width, int32 Height, double SearchRadius, double Corners[4][2])
+    {
+        static constexpr int32 SamplesPerSide = 16;
+        FLine Lines[4];
+        for (int32 i = 0; i < 4; ++i)
+        {
+            const double* A = Corners[i];
+            const double* B = Corners[(i + 1) & 3];
+            const double DirX = B[0] - A[0];
+            const double DirY = B[1] - A[1];
+            const double Length = FMath::Sqrt(DirX * DirX + DirY * DirY);
+            // Clockwise quad: the outward normal is the direction rotated counter-clockwise on screen
+            const double NormalX = DirY / Length;
+            const double NormalY = -DirX / Length;
+
+            double Xs[SamplesPerSide];
+            double Ys[SamplesPerSide];
+            double Weights[SamplesPerSide];
+            int32 Num = 0;
+            for (int32 s = 0; s < SamplesPerSide; ++s)
+            {
+                const double Along = 0.1 + 0.8 * (s + 0.5) / SamplesPerSide;
+                const double Px = A[0] + DirX * Along;
+                const double Py = A[1] + DirY * Along;
+
+                // Gradient across the edge at half-pixel steps
+                static constexpr int32 MaxSteps = 20;
+                const int32 Steps = FMath::Min(static_cast<int32>(SearchRadius * 2.0), MaxSteps);
+                double Profile[2 * MaxSteps + 3];
+                for (int32 k = -Steps - 1; k <= Steps + 1; ++k)
+                {
+                    const double Offset = k * 0.5;
+                    Profile[k + Steps + 1] = SampleBilinear(Y, Width, Height, Px + NormalX * Offset, Py + NormalY * Offset);
+                }
+                int32 Best = 0;
+                double BestGradient = 0.0;
+                for (int32 k = -Steps; k <= Steps; ++k)
+                {
+                    const double Gradient = Profile[k + Steps + 2] - Profile[k + Steps];
+                    if (Gradient > BestGradient)
+                    {
+                        BestGradient = Gradient;
+                        Best = k;
+                    }
+                }
+                if (BestGradient <= 0.0)
+                {
+                    continue;
+                }
+                double Peak = Best * 0.5;
+                if (Best > -Steps && Best < Steps)
+                {
+                    const double Left = Profile[Best + Steps + 1] - Profile[Best + Steps - 1];
+                    const double Right = Profile[Best + Steps + 3] - Profile[Best + Steps + 1];
+                    const double Denominator = Left - 2.0 * BestGradient + Right;
+                    if (Denominator < 0.0)
+                    {
+                        Peak += 0.25 * (Left - Right) / Denominator;
+                    }
+                }
+                Xs[Num] = Px + NormalX * Peak;
+                Ys[Num] = Py + NormalY * Peak;
+                Weights[Num] = BestGradient;
+                ++Num;
+            }
+            if (Num < SamplesPerSide / 2 || !FitLine(Xs, Ys, Weights, Num, Lines[i]))
+            {
+                return false;
+            }
+        }
+
+        double Refined[4][2];
+        for (int32 i = 0; i < 4; ++i)
+        {
+            if (!IntersectLines(Lines[(i + 3) & 3], Lines[i], Refined[i][0], Refined[i][1]))
+            {
+                return false;
+            }
+            // A side snapping to the wrong edge shows up as a large corner jump
+            const double Dx = Refined[i][0] - Corners[i][0];
+            const double Dy = Refined[i][1] - Corners[i][1];
+            if (Dx * Dx + Dy * Dy > 4.0 * SearchRadius * SearchRadius)
+            {
+                return false;
+            }
+        }
+        FMemory::Memcpy(Corners, Refined, sizeof(Refined));
+        return true;
+    }
+
+    /** Solve the n x n system A x = b in place (partial pivoting); A is row-major */
+    static bool SolveLinear(double* A, double* B, int32 N)
+    {
+        for (int32 Column = 0; Column < N; ++Column)
+        {
+            int32 Pivot = Column;
+            for (int32 Row = Column + 1; Row < N; ++Row)
+            {
+                if (FMath::Abs(A[Row * N + Column]) > FMath::Abs(A[Pivot * N + Column]))
+                {
+                    Pivot = Row;
+                }
+            }
+            if (FMath::Abs(A[Pivot * N + Column]) < 1.0e-12)
+            {
+                return false;
+            }
+            if (Pivot != Column)
+            {
+                for (int32 k = 0; k < N; ++k)
+                {
+                    Swap(A[Pivot * N + k], A[Column * N + k]);
+                }
+                Swap(B[Pivot], B[Column]);
+            }
+            for (int32 Row = Column + 1; Row < N; ++Row)
+            {
+                const double Factor = A[Row * N + Column] / A[Column * N + Column];
+                for (int32 k = Column; k < N; ++k)
+                {
+                    A[Row * N + k] -= Factor * A[Column * N + k];
+                }
+                B[Row] -= Factor * B[Column];
+            }
+        }
+        for (int32 Row = N - 1; Row >= 0; --Row)
+        {
+            double Sum = B[Row];
+            for (int32 k = Row + 1; k < N; ++k)
+            {
+                Sum -= A[Row * N + k] * B[k];
+            }
+            B[Row] = Sum / A[Row * N + Row];
+        }
+        return true;
+    }
+
+    /** Homography (row-major, H[8] = 1) taking the four Src points to the four Dst points */
+    static bool ComputeHomography(const double Src[4][2], const double Dst[4][2], double OutH[9])
+    {
+        double A[64];
+        double B[8];
+        for (int32 i = 0; i < 4; ++i)
+        {
+            const double X = Src[i][0];
+            const double Y = Src[i][1];
+            const double U = Dst[i][0];
+            const double V = Dst[i][1];
+            double* RowU = A + (2 * i) * 8;
+            double* RowV = A + (2 * i + 1) * 8;
+            RowU[0] = X; RowU[1] = Y; RowU[2] = 1.0; RowU[3] = 0.0; RowU[4] = 0.0; RowU[5] = 0.0; RowU[6] = -U * X; RowU[7] = -U * Y;
+            RowV[0] = 0.0; RowV[1] = 0.0; RowV[2] = 0.0; RowV[3] = X; RowV[4] = Y; RowV[5] = 1.0; RowV[6] = -V * X; RowV[7] = -V * Y;
+            B[2 * i] = U;
+            B[2 * i + 1] = V;
+        }
+        if (!SolveLinear(A, B, 8))
+        {
+            return false;
+        }
+        FMemory::Memcpy(OutH, B, sizeof(B));
+        OutH[8] = 1.0;
+        return true;
+    }
+
+    static FORCEINLINE void ApplyHomography(const double H[9], double X, double Y, double& OutX, double& OutY)
+    {
+        const double W = H[6] * X + H[7] * Y + H[8];
+        OutX = (H[0] * X + H[1] * Y + H[2]) / W;
+        OutY = (H[3] * X + H[4] * Y + H[5]) / W;
+    }
+
+    static uint64 RotateCode(uint64 Code, int32 Bits)
+    {
+        // Quarter turn counter-clockwise: the new (row, column) cell is the old (column, Bits - 1 - row)
+        uint64 Rotated = 0;
+        const int32 Last = Bits * Bits - 1;
+        for (int32 Row = 0; Row < Bits; ++Row)
+        {
+            for (int32 Column = 0; Column < Bits; ++Column)
+            {
+                const uint64 Bit = (Code >> (Last - (Column * Bits + (Bits - 1 - Row)))) & 1;
+                Rotated |= Bit << (Last - (Row * Bits + Column));
+            }
+        }
+        return Rotated;
+    }
+
+    /**
+     * Sample the cells through the quad's homography. Black is the border's mean, white the quiet zone's;
+     * the code is read against their midpoint and matched in all four orientations.
+     * @return false if the quad is not a marker; otherwise Id, HammingDistance and corners reordered so
+     *         Corners[0] is the marker's top-left
+     */
+    static bool DecodeQuad(const uint8* Y, int32 Width, int32 Height, const FDictionary& Dictionary, int32 MinContrast,
+        int32 MaxHamming, FMarkerDetection& Marker)
+    {
+        static const double UnitSquare[4][2] = { { 0.0, 0.0 }, { 1.0, 0.0 }, { 1.0, 1.0 }, { 0.0, 1.0 } };
+        double H[9];
+        if (!ComputeHomography(UnitSquare, Marker.Corners, H))
+        {
+            return false;
+        }
+
+        const int32 Bits = Dictionary.Bits;
+        const int32 Cells = Bits + 2;
+        const double Cell = 1.0 / Cells;
+        auto Sample = [&](double U, double V)
+        {
+            double X;
+            double Yf;
+            ApplyHomography(H, U, V, X, Yf);
+            return SampleBilinear(Y, Width, Height, X, Yf);
+        };
+        // Centre plus four points a quarter cell away so one blurred sample cannot flip a bit
+        auto SampleCell = [&](int32 Row, int32 Column)
+        {
+            const double U = (Column + 0.5) * Cell;
+            const double V = (Row + 0.5) * Cell;
+            const double Offset = 0.25 * Cell;
+            return (Sample(U, V) + Sample(U - Offset, V) + Sample(U + Offset, V) + Sample(U, V - Offset) + Sample(U, V + Offset)) * 0.2;
+        };
+
+        double CellValues[10 * 10];
+        double Black = 0.0;
+        double White = 0.0;
+        for (int32 i = 0; i < Cells; ++i)
+        {
+            CellValues[i] = SampleCell(0, i);
+            CellValues[(Cells - 1) * Cells + i] = SampleCell(Cells - 1, i);
+            CellValues[i * Cells] = SampleCell(i, 0);
+            CellValues[i * Cells + Cells - 1] = SampleCell(i, Cells - 1);
+
+            const double Along = (i + 0.5) * Cell;
+            const double Outside = 0.4 * Cell;
+            White += Sample(Along, -Outside) + Sample(Along, 1.0 + Outside) + Sample(-Outside, Along) + Sample(1.0 + Outside, Along);
+        }
+        for (int32 i = 0; i < Cells; ++i)
+        {
+            Black += CellValues[i] + CellValues[(Cells - 1) * Cells + i];
+            if (i > 0 && i < Cells - 1)
+            {
+                Black += CellValues[i * Cells] + CellValues[i * Cells + Cells - 1];
+            }
+        }
+        const int32 NumBorder = 4 * Cells - 4;
+        Black /= NumBorder;
+        White /= 4 * Cells;
+        if (White - Black < MinContrast)
+        {
+            return false;
+        }
+        const double Middle = 0.5 * (Black + White);
+
+        int32 BorderErrors = 0;
+        for (int32 i = 0; i < Cells; ++i)
+        {
+            BorderErrors += (CellValues[i] >= Middle) + (CellValues[(Cells - 1) * Cells + i] >= Middle);
+            if (i > 0 && i < Cells - 1)
+            {
+                BorderErrors += (CellValues[i * Cells] >= Middle) + (CellValues[i * Cells + Cells - 1] >= Middle);
+            }
+        }
+        if (BorderErrors > NumBorder / 8)
+        {
+            return false;
+        }
+
+        uint64 Code = 0;
+        for (int32 Row = 1; Row <= Bits; ++Row)
+        {
+            for (int32 Column = 1; Column <= Bits; ++Column)
+            {
+                Code = (Code << 1) | (SampleCell(Row, Column) >= Middle ? 1 : 0);
+            }
+        }
+
+        int32 BestId = INDEX_NONE;
+        int32 BestDistance = MaxHamming + 1;
+        int32 BestTurns = 0;
+        for (int32 Turns = 0; Turns < 4; ++Turns)
+        {
+            for (int32 Id = 0; Id < Dictionary.Codes.Num(); ++Id)
+            {
+                const int32 Distance = static_cast<int32>(FPlatformMath::CountBits(Code ^ Dictionary.Codes[Id]));
+                if (Distance < BestDistance)
+                {
+                    BestDistance = Distance;
+                    BestId = Id;
+                    BestTurns = Turns;
+                }
+            }
+            Code = RotateCode(Code, Bits);
+        }
+        if (BestId == INDEX_NONE)
+        {
+            return false;
+        }
+
+        // The marker appears turned clockwise by BestTurns quarters, so its top-left is image corner BestTurns
+        double Observed[4][2];
+        FMemory::Memcpy(Observed, Marker.Corners, sizeof(Observed));
+        for (int32 i = 0; i < 4; ++i)
+        {
+            Marker.Corners[i][0] = Observed[(i + BestTurns) & 3][0];
+            Marker.Corners[i][1] = Observed[(i + BestTurns) & 3][1];
+        }
+        Marker.Id = BestId;
+        Marker.HammingDistance = BestDistance;
+        return true;
+    }
+
+    void UndistortPixel(const FCameraModel& Camera, double X, double Y, double& OutX, double& OutY)
+    {
+        const double DistortedY = (Y - Camera.Cy) / Camera.Fy;
+        const double DistortedX = (X - Camera.Cx - Camera.Skew * DistortedY) / Camera.Fx;
+        Camera2Calibration::UndistortNormalized(Camera.K, Camera.P, DistortedX, DistortedY, OutX, OutY);
+    }
+
+    void ProjectPoint(const FCameraModel& Camera, const double Point[3], double& OutX, double& OutY)
+    {
+        double Dx, Dy;
+        Camera2Calibration::DistortNormalized(Camera.K, Camera.P, Point[0] / Point[2], Point[1] / Point[2], Dx, Dy);
+        OutX = Camera.Fx * Dx + Camera.Skew * Dy + Camera.Cx;
+        OutY = Camera.Fy * Dy + Camera.Cy;
+    }
+
+    static void Cross(const double A[3], const double B[3], double Out[3])
+    {
+        Out[0] = A[1] * B[2] - A[2] * B[1];
+        Out[1] = A[2] * B[0] - A[0] * B[2];
+        Out[2] = A[0] * B[1] - A[1] * B[0];
+    }
+
+    static void Normalize(double V[3])
+    {
+        const double Length = FMath::Sqrt(V[0] * V[0] + V[1] * V[1] + V[2] * V[2]);
+        V[0] /= Length;
+        V[1] /= Length;
+        V[2] /= Length;
+    }
+
+    /** Rotation matrix of a rotation vector (Rodrigues) */
+    static void RotationFromVector(const double W[3], double OutR[9])
+    {
+        const double Theta = FMath::Sqrt(W[0] * W[0] + W[1] * W[1] + W[2] * W[2]);
+        const double Kx[9] = { 0.0, -W[2], W[1], W[2], 0.0, -W[0], -W[1], W[0], 0.0 };
+        double A = 1.0;
+        double B = 0.5;
+        if (Theta > 1.0e-9)
+        {
+            A = FMath::Sin(Theta) / Theta;
+            B = (1.0 - FMath::Cos(Theta)) / (Theta * Theta);
+        }
+        for (int32 Row = 0; Row < 3; ++Row)
+        {
+            for (int32 Column = 0; Column < 3; ++Column)
+            {
+                double K2 = 0.0;
+                for (int32 k = 0; k < 3; ++k)
+                {
+                    K2 += Kx[Row * 3 + k] * Kx[k * 3 + Column];
+                }
+                OutR[Row * 3 + Column] = (Row == Column ? 1.0 : 0.0) + A * Kx[Row * 3 + Column] + B * K2;
+            }
+        }
+    }
+
+    /**
+     * Pose from the undistorted corners: the plane-to-image homography gives an initial rotation and
+     * translation, Gauss-Newton on the normalized reprojection error refines all six degrees of freedom.
+     * A square seen nearly face-on has a second, mirrored pose with a similar error; the one closest to the
+     * homography is kept.
+     */
+    static bool EstimatePose(const FCameraModel& Camera, double MarkerSize, FMarkerDetection& Marker)
+    {
+        const double Half = 0.5 * MarkerSize;
+        const double Object[4][2] = { { -Half, Half }, { Half, Half }, { Half, -Half }, { -Half, -Half } };
+        double Image[4][2];
+        for (int32 i = 0; i < 4; ++i)
+        {
+            UndistortPixel(Camera, Marker.Corners[i][0], Marker.Corners[i][1], Image[i][0], Image[i][1]);
+        }
+
+        double H[9];
+        if (!ComputeHomography(Object, Image, H))
+        {
+            return false;
+        }
+        double R1[3] = { H[0], H[3], H[6] };
+        double R2[3] = { H[1], H[4], H[7] };
+        double T[3] = { H[2], H[5], H[8] };
+        double Scale = 2.0 / (FMath::Sqrt(R1[0] * R1[0] + R1[1] * R1[1] + R1[2] * R1[2]) + FMath::Sqrt(R2[0] * R2[0] + R2[1] * R2[1] + R2[2] * R2[2]));
+        if (T[2] < 0.0)
+        {
+            Scale = -Scale;
+        }
+        for (int32 k = 0; k < 3; ++k)
+        {
+            R1[k] *= Scale;
+            R2[k] *= Scale;
+            T[k] *= Scale;
+        }
+
+        // Closest orthonormal pair: split the error symmetrically around the bisector
+        Normalize(R1);
+        Normalize(R2);
+        double Sum[3] = { R1[0] + R2[0], R1[1] + R2[1], R1[2] + R2[2] };
+        double Difference[3] = { R1[0] - R2[0], R1[1] - R2[1], R1[2] - R2[2] };
+        Normalize(Sum);
+        Normalize(Difference);
+        for (int32 k = 0; k < 3; ++k)
+        {
+            R1[k] = (Sum[k] + Difference[k]) * UE_INV_SQRT_2;
+            R2[k] = (Sum[k] - Difference[k]) * UE_INV_SQRT_2;
+        }
+        double R3[3];
+        Cross(R1, R2, R3);
+        double R[9] = { R1[0], R2[0], R3[0], R1[1], R2[1], R3[1], R1[2], R2[2], R3[2] };
+
+        for (int32 Iteration = 0; Iteration < 20; ++Iteration)
+        {
+            double JtJ[36] = {};
+            double JtR[6] = {};
+            for (int32 i = 0; i < 4; ++i)
+            {
+                const double Rotated[3] = {
+                    R[0] * Object[i][0] + R[1] * Object[i][1],
+                    R[3] * Object[i][0] + R[4] * Object[i][1],
+                    R[6] * Object[i][0] + R[7] * Object[i][1] };
+                const double P[3] = { Rotated[0] + T[0], Rotated[1] + T[1], Rotated[2] + T[2] };
+                if (P[2] <= 1.0e-9)
+                {
+                    return false;
+                }
+                const double InvZ = 1.0 / P[2];
+                const double Residual[2] = { P[0] * InvZ - Image[i][0], P[1] * InvZ - Image[i][1] };
+
+                // d(projection)/dP, then dP/d(rotation) = -[RX]x for R <- exp(w) R, dP/dT = I
+                const double Dp[2][3] = { { InvZ, 0.0, -P[0] * InvZ * InvZ }, { 0.0, InvZ, -P[1] * InvZ * InvZ } };
+                const double Skew[9] = { 0.0, Rotated[2], -Rotated[1], -Rotated[2], 0.0, Rotated[0], Rotated[1], -Rotated[0], 0.0 };
+                for (int32 Axis = 0; Axis < 2; ++Axis)
+                {
+                    double J[6];
+                    for (int32 k = 0; k < 3; ++k)
+                    {
+                        J[k] = Dp[Axis][0] * Skew[k] + Dp[Axis][1] * Skew[3 + k] + Dp[Axis][2] * Skew[6 + k];
+                        J[3 + k] = Dp[Axis][k];
+                    }
+                    for (int32 Row = 0; Row < 6; ++Row)
+                    {
+                        JtR[Row] += J[Row] * Residual[Axis];
+                        for (int32 Column = 0; Column < 6; ++Column)
+                        {
+                            JtJ[Row * 6 + Column] += J[Row] * J[Column];
+                        }
+                    }
+                }
+            }
+            double Step[6];
+            for (int32 k = 0; k < 6; ++k)
+            {
+                JtJ[k * 6 + k] *= 1.0 + 1.0e-9;
+                Step[k] = -JtR[k];
+            }
+            if (!SolveLinear(JtJ, Step, 6))
+            {
+                break;
+            }
+
+            double Delta[9];
+            RotationFromVector(Step, Delta);
+            double Updated[9];
+            for (int32 Row = 0; Row < 3; ++Row)
+            {
+                for (int32 Column = 0; Column < 3; ++Column)
+                {
+                    Updated[Row * 3 + Column] = Delta[Row * 3] * R[Column] + Delta[Row * 3 + 1] * R[3 + Column] + Delta[Row * 3 + 2] * R[6 + Column];
+                }
+            }
+            FMemory::Memcpy(R, Updated, sizeof(R));
+            T[0] += Step[3];
+            T[1] += Step[4];
+            T[2] += Step[5];
+
+            double StepSize = 0.0;
+            for (int32 k = 0; k < 6; ++k)
+            {
+                StepSize += Step[k] * Step[k];
+            }
+            if (StepSize < 1.0e-20)
+            {
+                break;
+            }
+        }
+        if (T[2] <= 0.0)
+        {
+            return false;
+        }
+
+        double SquaredError = 0.0;
+        for (int32 i = 0; i < 4; ++i)
+        {
+            const double P[3] = {
+                R[0] * Object[i][0] + R[1] * Object[i][1] + T[0],
+                R[3] * Object[i][0] + R[4] * Object[i][1] + T[1],
+                R[6] * Object[i][0] + R[7] * Object[i][1] + T[2] };
+            double X;
+            double Y;
+            ProjectPoint(Camera, P, X, Y);
+            SquaredError += (X - Marker.Corners[i][0]) * (X - Marker.Corners[i][0]) + (Y - Marker.Corners[i][1]) * (Y - Marker.Corners[i][1]);
+        }
+        FMemory::Memcpy(Marker.Rotation, R, sizeof(R));
+        FMemory::Memcpy(Marker.Translation, T, sizeof(T));
+        Marker.ReprojectionErrorPx = FMath::Sqrt(SquaredError / 4.0);
+        Marker.bPoseValid = true;
+        return true;
+    }
+
+    int32 DetectMarkers(const uint8* Y, int32 Width, int32 Height, const FCamera2MarkerConfig& Config,
+        const FDictionary& Dictionary, const FCameraModel& Camera, double MarkerSize, FDetectorScratch& Scratch,
+        TArray<FMarkerDetection>& OutMarkers)
+    {
+        OutMarkers.Reset();
+        if (!Dictionary.IsValid() || Width < 16 || Height < 16)
+        {
+            return 0;
+        }
+
+        // Decimate with the same 2x2 box filter as the keypoint pyramid
+        const int32 Decimation = Config.Decimation >= 4 ? 4 : (Config.Decimation >= 2 ? 2 : 1);
+        const uint8* Image = Y;
+        int32 LevelWidth = Width;
+        int32 LevelHeight = Height;
+        for (int32 Level = 0; (1 << Level) < Decimation; ++Level)
+        {
+            TArray<uint8>& Dst = Scratch.Levels[Level];
+            Dst.SetNumUninitialized((LevelWidth / 2) * (LevelHeight / 2));
+            Camera2Features::DownsampleHalf(Image, LevelWidth, LevelHeight, LevelWidth, Dst.GetData());
+            Image = Dst.GetData();
+            LevelWidth /= 2;
+            LevelHeight /= 2;
+        }
+
+        const int32 NumThreads = FMath::Clamp(Config.Threads, 1, 4);
+        const int32 MinContrast = FMath::Max(Config.MinContrast, 1);
+        Threshold(Image, LevelWidth, LevelHeight, MinContrast, NumThreads, Scratch);
+        const int32 NumComponents = LabelComponents(LevelWidth, LevelHeight, Scratch);
+        const int32 MinSide = FMath::Max(FMath::Max(Config.MinMarkerPixels, 8) / Decimation, 4);
+        CollectCandidates(LevelWidth, LevelHeight, NumComponents, MinSide, Scratch);
+
+        const int32 NumCandidates = Scratch.Candidates.Num();
+        Scratch.Results.Reset();
+        Scratch.Results.SetNum(NumCandidates);
+        const double Scale = Decimation;
+        const double Center = (Scale - 1.0) * 0.5;
+        RunBands(NumCandidates, NumThreads, [&](int32 Begin, int32 End)
+        {
+            for (int32 Candidate = Begin; Candidate < End; ++Candidate)
+            {
+                FMarkerDetection& Marker = Scratch.Results[Candidate];
+                Marker = FMarkerDetection();
+                const int32 First = Scratch.BoundaryOffsets[Candidate];
+                double Corners[4][2];
+                if (!FitQuad(Scratch.Boundary.GetData() + First, Scratch.BoundaryOffsets[Candidate + 1] - First, LevelWidth, MinSide, Corners))
+                {
+                    continue;
+                }
+                // Decimated pixel x covers full-resolution pixels [x * D, (x + 1) * D)
+                for (int32 i = 0; i < 4; ++i)
+                {
+                    Marker.Corners[i][0] = Corners[i][0] * Scale + Center;
+                    Marker.Corners[i][1] = Corners[i][1] * Scale + Center;
+                }
+                if (!RefineEdges(Y, Width, Height, Scale + 1.0, Marker.Corners)
+                    || !DecodeQuad(Y, Width, Height, Dictionary, MinContrast, FMath::Max(Config.MaxHammingDistance, 0), Marker))
+                {
+                    Marker.Id = INDEX_NONE;
+                    continue;
+                }
+                if (Camera.IsValid())
+                {
+                    EstimatePose(Camera, MarkerSize, Marker);
+                }
+            }
+        });
+
+        for (const FMarkerDetection& Marker : Scratch.Results)
+        {
+            if (Marker.Id == INDEX_NONE)
+            {
+                continue;
+            }
+            // A data cell can decode as its own marker only with a large Hamming budget; keep the better read
+            const double MarkerX = 0.25 * (Marker.Corners[0][0] + Marker.Corners[1][0] + Marker.Corners[2][0] + Marker.Corners[3][0]);
+            const double MarkerY = 0.25 * (Marker.Corners[0][1] + Marker.Corners[1][1] + Marker.Corners[2][1] + Marker.Corners[3][1]);
+            const double Side = FMath::Sqrt(FMath::Square(Marker.Corners[1][0] - Marker.Corners[0][0]) + FMath::Square(Marker.Corners[1][1] - Marker.Corners[0][1]));
+            FMarkerDetection* Duplicate = OutMarkers.FindByPredicate([&](const FMarkerDetection& Other)
+            {
+                const double OtherX = 0.25 * (Other.Corners[0][0] + Other.Corners[1][0] + Other.Corners[2][0] + Other.Corners[3][0]);
+                const double OtherY = 0.25 * (Other.Corners[0][1] + Other.Corners[1][1] + Other.Corners[2][1] + Other.Corners[3][1]);
+                return FMath::Square(OtherX - MarkerX) + FMath::Square(OtherY - MarkerY) < FMath::Square(0.5 * Side);
+            });
+            if (!Duplicate)
+            {
+                OutMarkers.Add(Marker);
+            }
+            else if (Marker.HammingDistance < Duplicate->HammingDistance)
+            {
+                *Duplicate = Marker;
+            }
+        }
+        OutMarkers.Sort([](const FMarkerDetection& A, const FMarkerDetection& B) { return A.Id < B.Id; });
+        return NumCandidates;
+    }
+}
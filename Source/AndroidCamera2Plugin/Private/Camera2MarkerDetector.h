@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera2Types.h"
+
+/**
+ * Square fiducial detection (ArUco-style: a one-cell black border around Bits x Bits data cells) on 8-bit luma.
+ *
+ * The image is decimated, split into dark and light against the local min/max of 4x4 tiles, and dark components
+ * are fitted with quads from their boundary pixels. Quad edges are then re-fitted on the full-resolution
+ * gradient, the cells are sampled through the quad's homography and the code is matched against the
+ * dictionary in all four rotations. The pose comes from the homography of the undistorted corners and is
+ * refined with Gauss-Newton on the corner reprojection error.
+ */
+namespace Camera2Markers
+{
+    /** Pinhole intrinsics of the analysed stream plus the Brown-Conrady model of LENS_DISTORTION */
+    struct FCameraModel
+    {
+        double Fx = 0.0;
+        double Fy = 0.0;
+        double Cx = 0.0;
+        double Cy = 0.0;
+        double Skew = 0.0;
+        double K[3] = { 0.0, 0.0, 0.0 };
+        double P[2] = { 0.0, 0.0 };
+
+        bool IsValid() const { return Fx > 0.0 && Fy > 0.0; }
+    };
+
+    struct FDictionary
+    {
+        // Data cells per side; the marker is Bits + 2 cells wide including the border
+        int32 Bits = 0;
+        // Row-major, first cell in the most significant used bit, 1 = white
+        TArray<uint64> Codes;
+
+        bool IsValid() const { return Bits >= 3 && Bits <= 8 && Codes.Num() > 0; }
+    };
+
+    /** Original ArUco dictionary: 5x5, 1024 ids, each row one of four 5-bit words carrying 2 bits of the id */
+    FDictionary MakeArucoOriginalDictionary();
+
+    struct FMarkerDetection
+    {
+        int32 Id = INDEX_NONE;
+        int32 HammingDistance = 0;
+        // Top-left, top-right, bottom-right, bottom-left of the marker in full-resolution pixels
+        double Corners[4][2] = {};
+        bool bPoseValid = false;
+        // Marker to camera, row-major, camera axes x right / y down / z forward, marker axes x right / y up /
+        // z out of the face; Translation is the marker center in the unit of the marker size
+        double Rotation[9] = {};
+        double Translation[3] = {};
+        double ReprojectionErrorPx = 0.0;
+    };
+
+    /** Reusable buffers; keep one per detecting thread so steady-state detection does not allocate */
+    struct FDetectorScratch
+    {
+        TArray<uint8> Levels[2];
+        TArray<uint8> TileMin;
+        TArray<uint8> TileMax;
+        TArray<uint8> TileMinDilated;
+        TArray<uint8> TileMaxDilated;
+        TArray<uint8> Classes;
+        TArray<int32> Labels;
+        TArray<int32> Parent;
+        TArray<int32> RootComponent;
+        TArray<int32> ComponentStats;
+        TArray<int32> BoundaryOffsets;
+        TArray<int32> BoundaryCursor;
+        TArray<int32> Boundary;
+        TArray<int32> Candidates;
+        TArray<FMarkerDetection> Results;
+    };
+
+    /**
+     * @param MarkerSize edge of the black square in the unit wanted for Translation
+     * @return number of quads that were decoded
+     */
+    int32 DetectMarkers(const uint8* Y, int32 Width, int32 Height, const FCamera2MarkerConfig& Config,
+        const FDictionary& Dictionary, const FCameraModel& Camera, double MarkerSize, FDetectorScratch& Scratch,
+        TArray<FMarkerDetection>& OutMarkers);
+
+    /** Normalized, undistorted camera coordinates of a stream pixel */
+    void UndistortPixel(const FCameraModel& Camera, double X, double Y, double& OutX, double& OutY);
+
+    /** Stream pixel of a camera-space point (z > 0) */
+    void ProjectPoint(const FCameraModel& Camera, const double Point[3], double& OutX, double& OutY);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "Camera2Types.h"
+
+/**
+ * Fixed-size ring of recent capture results, looked up by SENSOR_TIMESTAMP when a frame arrives.
+ * Storage is preallocated; Push/Find never allocate. Results and frames are both delivered on the
+ * Camera2Helper background thread, so the ring is not synchronized.
+ */
+class FCamera2MetadataRing
+{
+public:
+    static constexpr int32 Capacity = 32;
+
+    void Reset()
+    {
+        Head = 0;
+        Count = 0;
+    }
+
+    void Push(const FCamera2FrameMetadata& Metadata)
+    {
+        Entries[Head] = Metadata;
+        Head = (Head + 1) % Capacity;
+        Count = FMath::Min(Count + 1, Capacity);
+    }
+
+    /** Find the result for a frame; searches newest first since the match is almost always recent */
+    bool Find(int64 SensorTimestampNs, FCamera2FrameMetadata& OutMetadata) const
+    {
+        for (int32 i = 1; i <= Count; ++i)
+        {
+            const FCamera2FrameMetadata& Entry = Entries[(Head - i + Capacity) % Capacity];
+            if (Entry.SensorTimestampNs == SensorTimestampNs)
+            {
+                OutMetadata = Entry;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    TStaticArray<FCamera2FrameMetadata, Capacity> Entries;
+    int32 Head = 0;
+    int32 Count = 0;
+};
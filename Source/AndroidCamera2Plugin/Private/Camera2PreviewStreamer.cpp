@@ -0,0 +1,372 @@
+#include "Camera2PreviewStreamer.h"
+#include "Camera2Trace.h"
+#include "SimpleCamera2Test.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Interfaces/IPv4/IPv4Address.h"
+
+// A viewer that accepts no data for this long is dropped
+static constexpr double ViewerStallSeconds = 5.0;
+static constexpr int32 ViewerSendBufferBytes = 1 << 20;
+
+FCamera2PreviewStreamer::~FCamera2PreviewStreamer()
+{
+    Shutdown();
+}
+
+bool FCamera2PreviewStreamer::Start(const FCamera2StreamingConfig& InConfig)
+{
+    Shutdown();
+
+#if UE_BUILD_SHIPPING
+    // Development tool: shipping builds never open a port serving the camera feed
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("Preview streaming is not available in shipping builds"));
+    return false;
+#endif
+
+    Config = InConfig;
+    Config.Port = FMath::Clamp(InConfig.Port, 1, 65535);
+    Config.MaxFps = FMath::Clamp(InConfig.MaxFps, 0.5f, 120.0f);
+    Config.MaxKilobytesPerSecond = FMath::Max(InConfig.MaxKilobytesPerSecond, 0);
+
+    Camera2Stream::FEncoderConfig EncoderConfig;
+    EncoderConfig.TileSize = Config.TileSize;
+    EncoderConfig.ChangeThreshold = Config.ChangeThreshold;
+    EncoderConfig.QuantizationBits = Config.QuantizationBits;
+    EncoderConfig.KeyframeInterval = Config.KeyframeInterval;
+    Encoder.SetConfig(EncoderConfig);
+
+    // Loopback is all adb forward needs; other interfaces only when remote viewers are explicitly allowed
+    const FIPv4Address ListenAddress = Config.bAllowRemoteViewers ? FIPv4Address::Any : FIPv4Address::InternalLoopback;
+    ListenSocket = FTcpSocketBuilder(TEXT("Camera2PreviewListen"))
+        .AsReusable()
+        .BoundToAddress(ListenAddress)
+        .BoundToPort(Config.Port)
+        .Listening(1)
+        .Build();
+    if (!ListenSocket)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("Preview streaming: could not listen on %s:%d"), *ListenAddress.ToString(), Config.Port);
+        return false;
+    }
+
+    bStopping = false;
+    StagingState.store(EStagingState::Free);
+    NextFrameSeconds.store(0.0);
+    bViewerConnected = false;
+    FramesSent = 0;
+    KeyframesSent = 0;
+    FramesSkippedBusy = 0;
+    BytesSent = 0;
+    SentFps = 0.0f;
+    KilobytesPerSecond = 0.0f;
+    CompressionRatio = 0.0f;
+    ChangedTilesPercent = 0.0f;
+    EncodeMs = 0.0f;
+    SendMs = 0.0f;
+
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("Camera2PreviewStreamer"), 0, TPri_BelowNormal);
+    if (!Thread)
+    {
+        Shutdown();
+        return false;
+    }
+    if (Config.bAllowRemoteViewers)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("Preview streaming: listening on all interfaces, port %d; anyone on the network can watch the camera"), Config.Port);
+    }
+    else
+    {
+        UE_LOG(LogSimpleCamera2, Log, TEXT("Preview streaming: listening on port %d (loopback, use adb forward)"), Config.Port);
+    }
+    return true;
+}
+
+void FCamera2PreviewStreamer::Shutdown()
+{
+    if (Thread)
+    {
+        // Kill calls Stop and waits for Run to return; Run closes the viewer socket
+        Thread->Kill(true);
+        delete Thread;
+        Thread = nullptr;
+    }
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+    if (ListenSocket)
+    {
+        ListenSocket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+        ListenSocket = nullptr;
+    }
+}
+
+void FCamera2PreviewStreamer::Stop()
+{
+    bStopping = true;
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+void FCamera2PreviewStreamer::OnFrame(const FCamera2FrameView& Frame)
+{
+    if (!bViewerConnected.load(std::memory_order_relaxed) || !Frame.Y)
+    {
+        return;
+    }
+    const double Now = FPlatformTime::Seconds();
+    if (Now < NextFrameSeconds.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    EStagingState Expected = EStagingState::Free;
+    if (!StagingState.compare_exchange_strong(Expected, EStagingState::Filling, std::memory_order_acquire))
+    {
+        FramesSkippedBusy.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    NextFrameSeconds.store(Now + 1.0 / Config.MaxFps, std::memory_order_relaxed);
+
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 StreamStage"));
+    const int32 LumaSize = Frame.Width * Frame.Height;
+    const int32 ChromaSize = ((Frame.Width + 1) / 2) * ((Frame.Height + 1) / 2);
+    const bool bChroma = !Config.bLumaOnly && Frame.U && Frame.V;
+    if (!bChroma)
+    {
+        StagedU.Free();
+        StagedV.Free();
+    }
+    // Encoder: reference planes, tile data of up to every tile, and the compressed message
+    const int64 EncoderBytes = 3 * (static_cast<int64>(LumaSize) + (bChroma ? 2 * ChromaSize : 0));
+    if (!StagedY.Allocate(Camera2Memory::EPool::Streaming, LumaSize)
+        || (bChroma && (!StagedU.Allocate(Camera2Memory::EPool::Streaming, ChromaSize) || !StagedV.Allocate(Camera2Memory::EPool::Streaming, ChromaSize)))
+        || (EncoderReservation.GetBytes() != EncoderBytes && !EncoderReservation.Reserve(Camera2Memory::EPool::Streaming, EncoderBytes)))
+    {
+        Camera2Memory::NoteBudgetDrop();
+        StagingState.store(EStagingState::Free, std::memory_order_release);
+        return;
+    }
+    StagedWidth = Frame.Width;
+    StagedHeight = Frame.Height;
+    bStagedChroma = bChroma;
+    StagedTimestampNs = Frame.Metadata ? Frame.Metadata->SensorTimestampNs : 0;
+    FMemory::Memcpy(StagedY.GetData(), Frame.Y, LumaSize);
+    if (bStagedChroma)
+    {
+        FMemory::Memcpy(StagedU.GetData(), Frame.U, ChromaSize);
+        FMemory::Memcpy(StagedV.GetData(), Frame.V, ChromaSize);
+    }
+    StagingState.store(EStagingState::Full, std::memory_order_release);
+    WakeEvent->Trigger();
+}
+
+void FCamera2PreviewStreamer::SetStatsText(const FString& Text)
+{
+    FScopeLock Lock(&StatsTextLock);
+    StatsText = Text;
+}
+
+void FCamera2PreviewStreamer::FillStats(FCamera2StreamingStats& OutStats) const
+{
+    OutStats.bListening = ListenSocket != nullptr;
+    OutStats.bViewerConnected = bViewerConnected.load(std::memory_order_relaxed);
+    OutStats.FramesSent = FramesSent.load(std::memory_order_relaxed);
+    OutStats.KeyframesSent = KeyframesSent.load(std::memory_order_relaxed);
+    OutStats.FramesSkippedBusy = FramesSkippedBusy.load(std::memory_order_relaxed);
+    OutStats.BytesSent = BytesSent.load(std::memory_order_relaxed);
+    OutStats.SentFps = SentFps.load(std::memory_order_relaxed);
+    OutStats.KilobytesPerSecond = KilobytesPerSecond.load(std::memory_order_relaxed);
+    OutStats.CompressionRatio = CompressionRatio.load(std::memory_order_relaxed);
+    OutStats.ChangedTilesPercent = ChangedTilesPercent.load(std::memory_order_relaxed);
+    OutStats.EncodeMs = EncodeMs.load(std::memory_order_relaxed);
+    OutStats.SendMs = SendMs.load(std::memory_order_relaxed);
+}
+
+uint32 FCamera2PreviewStreamer::Run()
+{
+    while (!bStopping)
+    {
+        if (!ViewerSocket)
+        {
+            AcceptViewer();
+            continue;
+        }
+
+        WakeEvent->Wait(100);
+        if (bStopping)
+        {
+            break;
+        }
+        if (ViewerSocket->GetConnectionState() == SCS_ConnectionError)
+        {
+            UE_LOG(LogSimpleCamera2, Log, TEXT("Preview streaming: viewer disconnected"));
+            CloseViewer();
+            continue;
+        }
+        if (StagingState.load(std::memory_order_acquire) == EStagingState::Full)
+        {
+            SendStagedFrame();
+        }
+        if (ViewerSocket && Config.StatsIntervalSeconds > 0.0f && FPlatformTime::Seconds() - LastStatsSeconds >= Config.StatsIntervalSeconds)
+        {
+            SendStats();
+        }
+    }
+    CloseViewer();
+    return 0;
+}
+
+bool FCamera2PreviewStreamer::AcceptViewer()
+{
+    bool bPending = false;
+    if (!ListenSocket->WaitForPendingConnection(bPending, FTimespan::FromMilliseconds(100)) || !bPending)
+    {
+        return false;
+    }
+    FSocket* Socket = ListenSocket->Accept(TEXT("Camera2PreviewViewer"));
+    if (!Socket)
+    {
+        return false;
+    }
+    int32 ActualBufferSize = 0;
+    Socket->SetNonBlocking(true);
+    Socket->SetNoDelay(true);
+    Socket->SetSendBufferSize(ViewerSendBufferBytes, ActualBufferSize);
+
+    // A new viewer has no reference image; whatever is staged goes out as its first keyframe
+    ViewerSocket = Socket;
+    Encoder.RequestKeyframe();
+    NextFrameSeconds.store(0.0, std::memory_order_relaxed);
+    LastStatsSeconds = 0.0;
+    LastSentSeconds = 0.0;
+    bViewerConnected = true;
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Preview streaming: viewer connected"));
+    return true;
+}
+
+void FCamera2PreviewStreamer::CloseViewer()
+{
+    bViewerConnected = false;
+    if (ViewerSocket)
+    {
+        ViewerSocket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ViewerSocket);
+        ViewerSocket = nullptr;
+    }
+}
+
+bool FCamera2PreviewStreamer::SendAll(const uint8* Data, int32 Size)
+{
+    double LastProgressSeconds = FPlatformTime::Seconds();
+    while (Size > 0 && !bStopping)
+    {
+        int32 Sent = 0;
+        if (ViewerSocket->Send(Data, Size, Sent) && Sent > 0)
+        {
+            Data += Sent;
+            Size -= Sent;
+            LastProgressSeconds = FPlatformTime::Seconds();
+            continue;
+        }
+        const ESocketErrors Error = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+        if ((Error != SE_EWOULDBLOCK && Error != SE_NO_ERROR) || FPlatformTime::Seconds() - LastProgressSeconds > ViewerStallSeconds)
+        {
+            return false;
+        }
+        ViewerSocket->Wait(ESocketWaitConditions::WaitForWrite, FTimespan::FromMilliseconds(50));
+    }
+    return Size == 0;
+}
+
+void FCamera2PreviewStreamer::SendStagedFrame()
+{
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 StreamSend"));
+    const double StartSeconds = FPlatformTime::Seconds();
+    Camera2Stream::FPlanes Planes;
+    Planes.Y = StagedY.GetData();
+    Planes.U = bStagedChroma ? StagedU.GetData() : nullptr;
+    Planes.V = bStagedChroma ? StagedV.GetData() : nullptr;
+    Planes.Width = StagedWidth;
+    Planes.Height = StagedHeight;
+    const int32 PlaneBytes = static_cast<int32>(StagedY.Num() + (bStagedChroma ? StagedU.Num() + StagedV.Num() : 0));
+    Camera2Stream::FEncodeStats EncodeStats;
+    bool bEncoded;
+    {
+        LLM_SCOPE_BYTAG(Camera2_Streaming);
+        bEncoded = Encoder.Encode(Planes, StagedTimestampNs, Message, &EncodeStats);
+    }
+    StagingState.store(EStagingState::Free, std::memory_order_release);
+    if (!bEncoded)
+    {
+        return;
+    }
+
+    const double EncodedSeconds = FPlatformTime::Seconds();
+    if (!SendAll(Message.data(), static_cast<int32>(Message.size())))
+    {
+        UE_LOG(LogSimpleCamera2, Log, TEXT("Preview streaming: viewer disconnected or stalled"));
+        CloseViewer();
+        return;
+    }
+    const double SentSeconds = FPlatformTime::Seconds();
+
+    // Byte budget: the next frame is not staged before this one is paid for
+    const int32 MessageBytes = static_cast<int32>(Message.size());
+    if (Config.MaxKilobytesPerSecond > 0)
+    {
+        const double BudgetSeconds = StartSeconds + MessageBytes / (Config.MaxKilobytesPerSecond * 1024.0);
+        NextFrameSeconds.store(FMath::Max(NextFrameSeconds.load(std::memory_order_relaxed), BudgetSeconds), std::memory_order_relaxed);
+    }
+
+    auto Smooth = [](std::atomic<float>& Average, float Value)
+    {
+        const float Previous = Average.load(std::memory_order_relaxed);
+        Average.store(Previous > 0.0f ? FMath::Lerp(Previous, Value, 0.1f) : Value, std::memory_order_relaxed);
+    };
+    FramesSent.fetch_add(1, std::memory_order_relaxed);
+    KeyframesSent.fetch_add(EncodeStats.bKeyframe ? 1 : 0, std::memory_order_relaxed);
+    BytesSent.fetch_add(MessageBytes, std::memory_order_relaxed);
+    Smooth(EncodeMs, static_cast<float>((EncodedSeconds - StartSeconds) * 1000.0));
+    Smooth(SendMs, static_cast<float>((SentSeconds - EncodedSeconds) * 1000.0));
+    Smooth(CompressionRatio, static_cast<float>(PlaneBytes) / MessageBytes);
+    Smooth(ChangedTilesPercent, EncodeStats.TotalTiles > 0 ? 100.0f * EncodeStats.ChangedTiles / EncodeStats.TotalTiles : 0.0f);
+    if (LastSentSeconds > 0.0 && SentSeconds > LastSentSeconds)
+    {
+        const double Interval = SentSeconds - LastSentSeconds;
+        Smooth(SentFps, static_cast<float>(1.0 / Interval));
+        Smooth(KilobytesPerSecond, static_cast<float>(MessageBytes / 1024.0 / Interval));
+    }
+    LastSentSeconds = SentSeconds;
+}
+
+void FCamera2PreviewStreamer::SendStats()
+{
+    LastStatsSeconds = FPlatformTime::Seconds();
+    FString Text;
+    {
+        FScopeLock Lock(&StatsTextLock);
+        Text = StatsText;
+    }
+    Text += FString::Printf(TEXT("stream_encode_ms=%.2f\nstream_send_ms=%.2f\nstream_skipped_busy=%lld\nstream_compression=%.1f\n"),
+        EncodeMs.load(std::memory_order_relaxed), SendMs.load(std::memory_order_relaxed),
+        FramesSkippedBusy.load(std::memory_order_relaxed), CompressionRatio.load(std::memory_order_relaxed));
+
+    const FTCHARToUTF8 Utf8(*Text);
+    Message.resize(Camera2Stream::MessageHeaderSize + Utf8.Length());
+    Camera2Stream::WriteMessageHeader(Message.data(), Camera2Stream::EMessageType::Stats, Utf8.Length());
+    FMemory::Memcpy(Message.data() + Camera2Stream::MessageHeaderSize, Utf8.Get(), Utf8.Length());
+    if (!SendAll(Message.data(), static_cast<int32>(Message.size())))
+    {
+        UE_LOG(LogSimpleCamera2, Log, TEXT("Preview streaming: viewer disconnected or stalled"));
+        CloseViewer();
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/CriticalSection.h"
+#include "Camera2Types.h"
+#include "Camera2StreamCodec.h"
+#include "Camera2FrameMemory.h"
+#include <atomic>
+
+class FSocket;
+class FRunnableThread;
+class FEvent;
+
+/**
+ * Development preview sink: serves one TCP viewer (Tools/Camera2Viewer) with a stream's frames and stats text.
+ *
+ * The stream consumer copies the planes into a single staging buffer only when a viewer is connected, the
+ * MaxFps interval and the byte budget have elapsed and the previous staged frame was encoded; otherwise it
+ * returns after a clock read. Encoding (Camera2Stream tile delta + LZ4), sending and accepting the viewer run
+ * on the streamer's own thread, so a slow viewer lowers the streamed frame rate, never the pipeline's.
+ * The staging buffers and an estimate of the encoder's working set count against the frame memory budget;
+ * a frame that does not fit is not staged.
+ */
+class FCamera2PreviewStreamer : public FRunnable
+{
+public:
+    virtual ~FCamera2PreviewStreamer();
+
+    /**
+     * Game thread: listen on Config.Port (loopback unless Config.bAllowRemoteViewers) and start the streamer thread;
+     * false if the port could not be bound, and always in shipping builds
+     */
+    bool Start(const FCamera2StreamingConfig& InConfig);
+
+    /** Game thread: disconnect the viewer and join the thread */
+    void Shutdown();
+
+    /** Stream consumer, called on a pipeline worker */
+    void OnFrame(const FCamera2FrameView& Frame);
+
+    /** Any thread: stats text sent to the viewer with the next stats message */
+    void SetStatsText(const FString& Text);
+
+    /** Any thread */
+    void FillStats(FCamera2StreamingStats& OutStats) const;
+
+    //~ FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    enum class EStagingState : uint8
+    {
+        Free,
+        Filling,
+        Full
+    };
+
+    bool AcceptViewer();
+    void CloseViewer();
+    bool SendAll(const uint8* Data, int32 Size);
+    void SendStagedFrame();
+    void SendStats();
+
+    FCamera2StreamingConfig Config;
+    FSocket* ListenSocket = nullptr;
+    FSocket* ViewerSocket = nullptr; // streamer thread only
+    FRunnableThread* Thread = nullptr;
+    FEvent* WakeEvent = nullptr;
+    std::atomic<bool> bStopping{false};
+
+    // One staged frame handed from the consumer to the streamer thread
+    std::atomic<EStagingState> StagingState{EStagingState::Free};
+    Camera2Memory::FBuffer StagedY;
+    Camera2Memory::FBuffer StagedU;
+    Camera2Memory::FBuffer StagedV;
+    // Reference planes, tile data and message of the encoder, sized from the staged planes
+    Camera2Memory::FReservation EncoderReservation;
+    int32 StagedWidth = 0;
+    int32 StagedHeight = 0;
+    bool bStagedChroma = false;
+    int64 StagedTimestampNs = 0;
+    // FPlatformTime::Seconds before which the consumer stages nothing (frame interval and byte budget)
+    std::atomic<double> NextFrameSeconds{0.0};
+
+    Camera2Stream::FFrameEncoder Encoder;
+    std::vector<uint8_t> Message;
+    double LastStatsSeconds = 0.0;
+    double LastSentSeconds = 0.0;
+
+    FString StatsText;
+    mutable FCriticalSection StatsTextLock;
+
+    std::atomic<bool> bViewerConnected{false};
+    std::atomic<int64> FramesSent{0};
+    std::atomic<int64> KeyframesSent{0};
+    std::atomic<int64> FramesSkippedBusy{0};
+    std::atomic<int64> BytesSent{0};
+    std::atomic<float> SentFps{0.0f};
+    std::atomic<float> KilobytesPerSecond{0.0f};
+    std::atomic<float> CompressionRatio{0.0f};
+    std::atomic<float> ChangedTilesPercent{0.0f};
+    std::atomic<float> EncodeMs{0.0f};
+    std::atomic<float> SendMs{0.0f};
+};
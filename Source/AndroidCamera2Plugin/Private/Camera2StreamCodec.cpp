@@ -0,0 +1,611 @@
+#include "Camera2StreamCodec.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace Camera2Stream
+{
+    // LZ4 block format limits: matches are at least 4 bytes, the last 5 bytes are always literals and the
+    // last match starts at least 12 bytes before the end of the block
+    static constexpr int32_t LZ4MinMatch = 4;
+    static constexpr int32_t LZ4LastLiterals = 5;
+    static constexpr int32_t LZ4MatchFindLimit = 12;
+    static constexpr int32_t LZ4MaxOffset = 65535;
+    static constexpr int32_t LZ4HashLog = 12;
+
+    enum EFrameFlags : uint8_t
+    {
+        FrameFlagKeyframe = 1,
+        FrameFlagChroma = 2
+    };
+
+    static void Put16(uint8_t* Out, uint32_t Value)
+    {
+        Out[0] = static_cast<uint8_t>(Value);
+        Out[1] = static_cast<uint8_t>(Value >> 8);
+    }
+
+    static void Put32(uint8_t* Out, uint32_t Value)
+    {
+        Put16(Out, Value & 0xFFFF);
+        Put16(Out + 2, Value >> 16);
+    }
+
+    static void Put64(uint8_t* Out, uint64_t Value)
+    {
+        Put32(Out, static_cast<uint32_t>(Value));
+        Put32(Out + 4, static_cast<uint32_t>(Value >> 32));
+    }
+
+    static uint32_t Get16(const uint8_t* In)
+    {
+        return In[0] | (static_cast<uint32_t>(In[1]) << 8);
+    }
+
+    static uint32_t Get32(const uint8_t* In)
+    {
+        return Get16(In) | (Get16(In + 2) << 16);
+    }
+
+    static uint64_t Get64(const uint8_t* In)
+    {
+        return Get32(In) | (static_cast<uint64_t>(Get32(In + 4)) << 32);
+    }
+
+    static uint32_t Read32(const uint8_t* In)
+    {
+        uint32_t Value;
+        memcpy(&Value, In, sizeof(Value));
+        return Value;
+    }
+
+    void WriteMessageHeader(uint8_t* Out, EMessageType Type, uint32_t PayloadSize)
+    {
+        Put32(Out, Magic);
+        Out[4] = static_cast<uint8_t>(Type);
+        Out[5] = Version;
+        Put16(Out + 6, 0);
+        Put32(Out + 8, PayloadSize);
+    }
+
+    bool ReadMessageHeader(const uint8_t* In, EMessageType& OutType, uint32_t& OutPayloadSize)
+    {
+        if (Get32(In) != Magic || In[5] != Version)
+        {
+            return false;
+        }
+        OutType = static_cast<EMessageType>(In[4]);
+        OutPayloadSize = Get32(In + 8);
+        return OutPayloadSize <= MaxPayloadSize;
+    }
+
+    int32_t LZ4CompressBound(int32_t SrcSize)
+    {
+        return SrcSize + SrcSize / 255 + 16;
+    }
+
+    static uint32_t LZ4Hash(uint32_t Sequence)
+    {
+        return (Sequence * 2654435761u) >> (32 - LZ4HashLog);
+    }
+
+    static uint8_t* WriteLength(uint8_t* Op, int32_t Length)
+    {
+        for (; Length >= 255; Length -= 255)
+        {
+            *Op++ = 255;
+        }
+        *Op++ = static_cast<uint8_t>(Length);
+        return Op;
+    }
+
+    int32_t LZ4Compress(const uint8_t* Src, int32_t SrcSize, uint8_t* Dst, int32_t DstCapacity, std::vector<uint32_t>& HashTable)
+    {
+        if (SrcSize < 0 || DstCapacity < LZ4CompressBound(SrcSize))
+        {
+            return -1;
+        }
+        HashTable.assign(static_cast<size_t>(1) << LZ4HashLog, 0);
+
+        const uint8_t* const End = Src + SrcSize;
+        const uint8_t* Anchor = Src;
+        uint8_t* Op = Dst;
+
+        auto EmitSequence = [&Op](const uint8_t* Literals, int32_t LiteralLength, int32_t Offset, int32_t MatchLength)
+        {
+            uint8_t* Token = Op++;
+            if (LiteralLength >= 15)
+            {
+                *Token = 15 << 4;
+                Op = WriteLength(Op, LiteralLength - 15);
+            }
+            else
+            {
+                *Token = static_cast<uint8_t>(LiteralLength << 4);
+            }
+            if (LiteralLength > 0)
+            {
+                memcpy(Op, Literals, LiteralLength);
+                Op += LiteralLength;
+            }
+            if (MatchLength == 0)
+            {
+                return;
+            }
+            Put16(Op, static_cast<uint32_t>(Offset));
+            Op += 2;
+            const int32_t ExtraLength = MatchLength - LZ4MinMatch;
+            if (ExtraLength >= 15)
+            {
+                *Token |= 15;
+                Op = WriteLength(Op, ExtraLength - 15);
+            }
+            else
+            {
+                *Token |= static_cast<uint8_t>(ExtraLength);
+            }
+        };
+
+        if (SrcSize > LZ4MatchFindLimit)
+        {
+            const uint8_t* const MatchLimit = End - LZ4LastLiterals;
+            const uint8_t* const SearchEnd = End - LZ4MatchFindLimit;
+            const uint8_t* Ip = Src;
+            uint32_t Misses = 0;
+            while (Ip <= SearchEnd)
+            {
+                const uint32_t Sequence = Read32(Ip);
+                uint32_t& Slot = HashTable[LZ4Hash(Sequence)];
+                const uint8_t* Ref = Src + Slot;
+                Slot = static_cast<uint32_t>(Ip - Src);
+                if (Ref >= Ip || Ip - Ref > LZ4MaxOffset || Read32(Ref) != Sequence)
+                {
+                    // Step further the longer nothing matched, so incompressible data is skipped quickly
+                    Ip += 1 + (Misses++ >> 6);
+                    continue;
+                }
+
+                while (Ip > Anchor && Ref > Src && Ip[-1] == Ref[-1])
+                {
+                    --Ip;
+                    --Ref;
+                }
+                const uint8_t* MatchEnd = Ip + LZ4MinMatch;
+                const uint8_t* RefEnd = Ref + LZ4MinMatch;
+                while (MatchEnd < MatchLimit && *MatchEnd == *RefEnd)
+                {
+                    ++MatchEnd;
+                    ++RefEnd;
+                }
+                EmitSequence(Anchor, static_cast<int32_t>(Ip - Anchor), static_cast<int32_t>(Ip - Ref), static_cast<int32_t>(MatchEnd - Ip));
+                Ip = MatchEnd;
+                Anchor = Ip;
+                Misses = 0;
+                // Seed the table just before the match end so runs continue into the next match
+                HashTable[LZ4Hash(Read32(Ip - 2))] = static_cast<uint32_t>(Ip - 2 - Src);
+            }
+        }
+        EmitSequence(Anchor, static_cast<int32_t>(End - Anchor), 0, 0);
+        return static_cast<int32_t>(Op - Dst);
+    }
+
+    int32_t LZ4Decompress(const uint8_t* Src, int32_t SrcSize, uint8_t* Dst, int32_t DstCapacity)
+    {
+        const uint8_t* Ip = Src;
+        const uint8_t* const InEnd = Src + SrcSize;
+        uint8_t* Op = Dst;
+        uint8_t* const OutEnd = Dst + DstCapacity;
+
+        auto ReadLength = [&Ip, InEnd](size_t& Length) -> bool
+        {
+            uint8_t Byte;
+            do
+            {
+                if (Ip >= InEnd)
+                {
+                    return false;
+                }
+                Byte = *Ip++;
+                Length += Byte;
+            }
+            while (Byte == 255);
+            return true;
+        };
+
+        while (Ip < InEnd)
+        {
+            const uint8_t Token = *Ip++;
+            size_t LiteralLength = Token >> 4;
+            if (LiteralLength == 15 && !ReadLength(LiteralLength))
+            {
+                return -1;
+            }
+            if (LiteralLength > static_cast<size_t>(InEnd - Ip) || LiteralLength > static_cast<size_t>(OutEnd - Op))
+            {
+                return -1;
+            }
+            memcpy(Op, Ip, LiteralLength);
+            Op += LiteralLength;
+            Ip += LiteralLength;
+            if (Ip == InEnd)
+            {
+                // The last sequence has literals only
+                break;
+            }
+
+            if (InEnd - Ip < 2)
+            {
+                return -1;
+            }
+            const size_t Offset = Get16(Ip);
+            Ip += 2;
+            size_t MatchLength = Token & 15;
+            if (MatchLength == 15 && !ReadLength(MatchLength))
+            {
+                return -1;
+            }
+            MatchLength += LZ4MinMatch;
+            if (Offset == 0 || Offset > static_cast<size_t>(Op - Dst) || MatchLength > static_cast<size_t>(OutEnd - Op))
+            {
+                return -1;
+            }
+            const uint8_t* Match = Op - Offset;
+            if (Offset >= MatchLength)
+            {
+                memcpy(Op, Match, MatchLength);
+                Op += MatchLength;
+            }
+            else
+            {
+                // Overlapping copy repeats the last Offset bytes
+                for (size_t i = 0; i < MatchLength; ++i)
+                {
+                    *Op++ = Match[i];
+                }
+            }
+        }
+        return static_cast<int32_t>(Op - Dst);
+    }
+
+    namespace
+    {
+        struct FPlaneLayout
+        {
+            int32_t Width = 0;
+            int32_t Height = 0;
+            int32_t Tile = 0;
+            int32_t TilesX = 0;
+            int32_t TilesY = 0;
+
+            int32_t NumTiles() const { return TilesX * TilesY; }
+            int32_t MaskBytes() const { return (NumTiles() + 7) / 8; }
+        };
+
+        int32_t GetPlaneLayouts(int32_t Width, int32_t Height, bool bChroma, int32_t TileSize, FPlaneLayout OutLayouts[3])
+        {
+            const int32_t NumPlanes = bChroma ? 3 : 1;
+            for (int32_t Plane = 0; Plane < NumPlanes; ++Plane)
+            {
+                FPlaneLayout& Layout = OutLayouts[Plane];
+                Layout.Width = Plane == 0 ? Width : (Width + 1) / 2;
+                Layout.Height = Plane == 0 ? Height : (Height + 1) / 2;
+                Layout.Tile = Plane == 0 ? TileSize : TileSize / 2;
+                Layout.TilesX = (Layout.Width + Layout.Tile - 1) / Layout.Tile;
+                Layout.TilesY = (Layout.Height + Layout.Tile - 1) / Layout.Tile;
+            }
+            return NumPlanes;
+        }
+
+        // Keyframe prediction inside a tile: left neighbour, first column from above, the tile origin from zero
+        inline uint8_t PredictSpatial(const uint8_t* Row, const uint8_t* RowAbove, int32_t X, int32_t X0)
+        {
+            return X > X0 ? Row[X - 1] : (RowAbove ? RowAbove[X] : 0);
+        }
+    }
+
+    void FFrameEncoder::SetConfig(const FEncoderConfig& InConfig)
+    {
+        Config = InConfig;
+        Config.TileSize = InConfig.TileSize < 8 ? 8 : (InConfig.TileSize > 64 ? 64 : InConfig.TileSize & ~7);
+        Config.QuantizationBits = InConfig.QuantizationBits < 0 ? 0 : (InConfig.QuantizationBits > 4 ? 4 : InConfig.QuantizationBits);
+        Config.ChangeThreshold = InConfig.ChangeThreshold < 0.0f ? 0.0f : InConfig.ChangeThreshold;
+        Config.KeyframeInterval = InConfig.KeyframeInterval < 0 ? 0 : InConfig.KeyframeInterval;
+        bKeyframeRequested = true;
+    }
+
+    bool FFrameEncoder::Encode(const FPlanes& Frame, int64_t TimestampNs, std::vector<uint8_t>& OutMessage, FEncodeStats* OutStats)
+    {
+        if (!Frame.Y || Frame.Width <= 0 || Frame.Height <= 0 || Frame.Width > 0xFFFF || Frame.Height > 0xFFFF)
+        {
+            return false;
+        }
+        const bool bFrameChroma = Frame.U && Frame.V;
+        if (Frame.Width != Width || Frame.Height != Height || bFrameChroma != bChroma)
+        {
+            Width = Frame.Width;
+            Height = Frame.Height;
+            bChroma = bFrameChroma;
+            bKeyframeRequested = true;
+        }
+        const bool bKeyframe = bKeyframeRequested || (Config.KeyframeInterval > 0 && FramesSinceKeyframe >= Config.KeyframeInterval);
+        if (bKeyframe)
+        {
+            // Tile size and quantization only change on keyframes so the decoder's reference stays consistent
+            ActiveConfig = Config;
+            bKeyframeRequested = false;
+            FramesSinceKeyframe = 0;
+        }
+        ++FramesSinceKeyframe;
+
+        FPlaneLayout Layouts[3];
+        const int32_t NumPlanes = GetPlaneLayouts(Width, Height, bChroma, ActiveConfig.TileSize, Layouts);
+        const uint8_t* Sources[3] = { Frame.Y, Frame.U, Frame.V };
+
+        size_t MaxRawSize = 0;
+        for (int32_t Plane = 0; Plane < NumPlanes; ++Plane)
+        {
+            MaxRawSize += Layouts[Plane].MaskBytes() + static_cast<size_t>(Layouts[Plane].Width) * Layouts[Plane].Height;
+            Reference[Plane].resize(static_cast<size_t>(Layouts[Plane].Width) * Layouts[Plane].Height);
+        }
+        Raw.resize(MaxRawSize);
+
+        uint8_t* Mask = Raw.data();
+        size_t DataOffset = 0;
+        for (int32_t Plane = 0; Plane < NumPlanes; ++Plane)
+        {
+            DataOffset += Layouts[Plane].MaskBytes();
+        }
+        memset(Raw.data(), 0, DataOffset);
+        uint8_t* Data = Raw.data() + DataOffset;
+
+        const int32_t Shift = ActiveConfig.QuantizationBits;
+        int32_t ChangedTiles = 0;
+        int32_t TotalTiles = 0;
+        for (int32_t Plane = 0; Plane < NumPlanes; ++Plane)
+        {
+            const FPlaneLayout& Layout = Layouts[Plane];
+            const uint8_t* Source = Sources[Plane];
+            uint8_t* Ref = Reference[Plane].data();
+            int32_t TileIndex = 0;
+            for (int32_t TileY = 0; TileY < Layout.TilesY; ++TileY)
+            {
+                const int32_t Y0 = TileY * Layout.Tile;
+                const int32_t Y1 = Y0 + Layout.Tile < Layout.Height ? Y0 + Layout.Tile : Layout.Height;
+                for (int32_t TileX = 0; TileX < Layout.TilesX; ++TileX, ++TileIndex)
+                {
+                    const int32_t X0 = TileX * Layout.Tile;
+                    const int32_t X1 = X0 + Layout.Tile < Layout.Width ? X0 + Layout.Tile : Layout.Width;
+
+                    if (!bKeyframe)
+                    {
+                        uint32_t Sad = 0;
+                        for (int32_t Y = Y0; Y < Y1; ++Y)
+                        {
+                            const uint8_t* Row = Source + static_cast<size_t>(Y) * Layout.Width;
+                            const uint8_t* RefRow = Ref + static_cast<size_t>(Y) * Layout.Width;
+                            for (int32_t X = X0; X < X1; ++X)
+                            {
+                                Sad += static_cast<uint32_t>(abs((Row[X] >> Shift) - RefRow[X]));
+                            }
+                        }
+                        const float MeanDifference = static_cast<float>(Sad << Shift) / static_cast<float>((X1 - X0) * (Y1 - Y0));
+                        if (Sad == 0 || MeanDifference <= ActiveConfig.ChangeThreshold)
+                        {
+                            continue;
+                        }
+                    }
+
+                    Mask[TileIndex >> 3] |= static_cast<uint8_t>(1 << (TileIndex & 7));
+                    ++ChangedTiles;
+                    for (int32_t Y = Y0; Y < Y1; ++Y)
+                    {
+                        const uint8_t* Row = Source + static_cast<size_t>(Y) * Layout.Width;
+                        uint8_t* RefRow = Ref + static_cast<size_t>(Y) * Layout.Width;
+                        if (bKeyframe)
+                        {
+                            const uint8_t* RefAbove = Y > Y0 ? RefRow - Layout.Width : nullptr;
+                            for (int32_t X = X0; X < X1; ++X)
+                            {
+                                RefRow[X] = static_cast<uint8_t>(Row[X] >> Shift);
+                                *Data++ = static_cast<uint8_t>(RefRow[X] - PredictSpatial(RefRow, RefAbove, X, X0));
+                            }
+                        }
+                        else
+                        {
+                            for (int32_t X = X0; X < X1; ++X)
+                            {
+                                const uint8_t Value = static_cast<uint8_t>(Row[X] >> Shift);
+                                *Data++ = static_cast<uint8_t>(Value - RefRow[X]);
+                                RefRow[X] = Value;
+                            }
+                        }
+                    }
+                }
+            }
+            Mask += Layout.MaskBytes();
+            TotalTiles += Layout.NumTiles();
+        }
+
+        const int32_t RawSize = static_cast<int32_t>(Data - Raw.data());
+        OutMessage.resize(MessageHeaderSize + FrameHeaderSize + LZ4CompressBound(RawSize));
+        uint8_t* Header = OutMessage.data() + MessageHeaderSize;
+        const int32_t CompressedSize = LZ4Compress(Raw.data(), RawSize, Header + FrameHeaderSize,
+            static_cast<int32_t>(OutMessage.size()) - MessageHeaderSize - FrameHeaderSize, HashTable);
+        OutMessage.resize(MessageHeaderSize + FrameHeaderSize + CompressedSize);
+
+        WriteMessageHeader(OutMessage.data(), EMessageType::Frame, FrameHeaderSize + CompressedSize);
+        Put32(Header, FrameIndex++);
+        Put64(Header + 4, static_cast<uint64_t>(TimestampNs));
+        Put16(Header + 12, static_cast<uint32_t>(Width));
+        Put16(Header + 14, static_cast<uint32_t>(Height));
+        Header[16] = static_cast<uint8_t>((bKeyframe ? FrameFlagKeyframe : 0) | (bChroma ? FrameFlagChroma : 0));
+        Header[17] = static_cast<uint8_t>(ActiveConfig.TileSize);
+        Header[18] = static_cast<uint8_t>(Shift);
+        Header[19] = 0;
+        Put32(Header + 20, static_cast<uint32_t>(RawSize));
+        Put32(Header + 24, static_cast<uint32_t>(ChangedTiles));
+        Put32(Header + 28, static_cast<uint32_t>(TotalTiles));
+
+        if (OutStats)
+        {
+            OutStats->bKeyframe = bKeyframe;
+            OutStats->ChangedTiles = ChangedTiles;
+            OutStats->TotalTiles = TotalTiles;
+            OutStats->RawBytes = RawSize;
+            OutStats->CompressedBytes = CompressedSize;
+        }
+        return true;
+    }
+
+    bool FFrameDecoder::Decode(const uint8_t* Payload, int32_t PayloadSize)
+    {
+        if (PayloadSize < FrameHeaderSize)
+        {
+            return false;
+        }
+        const uint32_t NewFrameIndex = Get32(Payload);
+        const int64_t NewTimestampNs = static_cast<int64_t>(Get64(Payload + 4));
+        const int32_t NewWidth = static_cast<int32_t>(Get16(Payload + 12));
+        const int32_t NewHeight = static_cast<int32_t>(Get16(Payload + 14));
+        const uint8_t Flags = Payload[16];
+        const int32_t NewTileSize = Payload[17];
+        const int32_t NewQuantizationBits = Payload[18];
+        const uint32_t RawSize = Get32(Payload + 20);
+        const bool bNewKeyframe = (Flags & FrameFlagKeyframe) != 0;
+        const bool bNewChroma = (Flags & FrameFlagChroma) != 0;
+        if (NewWidth == 0 || NewHeight == 0 || NewTileSize < 8 || NewTileSize > 64 || (NewTileSize & 7) != 0 || NewQuantizationBits > 4)
+        {
+            return false;
+        }
+        if (!bNewKeyframe && (!bHasKeyframe || NewWidth != Width || NewHeight != Height || bNewChroma != bChroma
+            || NewTileSize != TileSize || NewQuantizationBits != QuantizationBits))
+        {
+            return false;
+        }
+
+        FPlaneLayout Layouts[3];
+        const int32_t NumPlanes = GetPlaneLayouts(NewWidth, NewHeight, bNewChroma, NewTileSize, Layouts);
+        size_t MaskSize = 0;
+        size_t MaxRawSize = 0;
+        for (int32_t Plane = 0; Plane < NumPlanes; ++Plane)
+        {
+            MaskSize += Layouts[Plane].MaskBytes();
+            MaxRawSize += Layouts[Plane].MaskBytes() + static_cast<size_t>(Layouts[Plane].Width) * Layouts[Plane].Height;
+        }
+        if (RawSize < MaskSize || RawSize > MaxRawSize)
+        {
+            return false;
+        }
+        Raw.resize(RawSize);
+        if (LZ4Decompress(Payload + FrameHeaderSize, PayloadSize - FrameHeaderSize, Raw.data(), static_cast<int32_t>(RawSize))
+            != static_cast<int32_t>(RawSize))
+        {
+            return false;
+        }
+
+        // Validate the masks against the data size before touching the reference
+        const uint8_t* Mask = Raw.data();
+        size_t DataSize = 0;
+        int32_t NewChangedTiles = 0;
+        int32_t NewTotalTiles = 0;
+        for (int32_t Plane = 0; Plane < NumPlanes; ++Plane)
+        {
+            const FPlaneLayout& Layout = Layouts[Plane];
+            for (int32_t TileIndex = 0; TileIndex < Layout.NumTiles(); ++TileIndex)
+            {
+                if (Mask[TileIndex >> 3] & (1 << (TileIndex & 7)))
+                {
+                    const int32_t TileX = TileIndex % Layout.TilesX;
+                    const int32_t TileY = TileIndex / Layout.TilesX;
+                    const int32_t TileWidth = (TileX + 1) * Layout.Tile < Layout.Width ? Layout.Tile : Layout.Width - TileX * Layout.Tile;
+                    const int32_t TileHeight = (TileY + 1) * Layout.Tile < Layout.Height ? Layout.Tile : Layout.Height - TileY * Layout.Tile;
+                    DataSize += static_cast<size_t>(TileWidth) * TileHeight;
+                    ++NewChangedTiles;
+                }
+            }
+            Mask += Layout.MaskBytes();
+            NewTotalTiles += Layout.NumTiles();
+        }
+        if (MaskSize + DataSize != RawSize || (bNewKeyframe && NewChangedTiles != NewTotalTiles))
+        {
+            return false;
+        }
+
+        Width = NewWidth;
+        Height = NewHeight;
+        bChroma = bNewChroma;
+        TileSize = NewTileSize;
+        QuantizationBits = NewQuantizationBits;
+        bKeyframe = bNewKeyframe;
+        bHasKeyframe = true;
+        FrameIndex = NewFrameIndex;
+        TimestampNs = NewTimestampNs;
+        ChangedTiles = NewChangedTiles;
+        TotalTiles = NewTotalTiles;
+
+        Mask = Raw.data();
+        const uint8_t* Data = Raw.data() + MaskSize;
+        for (int32_t Plane = 0; Plane < NumPlanes; ++Plane)
+        {
+            const FPlaneLayout& Layout = Layouts[Plane];
+            Quantized[Plane].resize(static_cast<size_t>(Layout.Width) * Layout.Height);
+            uint8_t* Ref = Quantized[Plane].data();
+            int32_t TileIndex = 0;
+            for (int32_t TileY = 0; TileY < Layout.TilesY; ++TileY)
+            {
+                const int32_t Y0 = TileY * Layout.Tile;
+                const int32_t Y1 = Y0 + Layout.Tile < Layout.Height ? Y0 + Layout.Tile : Layout.Height;
+                for (int32_t TileX = 0; TileX < Layout.TilesX; ++TileX, ++TileIndex)
+                {
+                    if (!(Mask[TileIndex >> 3] & (1 << (TileIndex & 7))))
+                    {
+                        continue;
+                    }
+                    const int32_t X0 = TileX * Layout.Tile;
+                    const int32_t X1 = X0 + Layout.Tile < Layout.Width ? X0 + Layout.Tile : Layout.Width;
+                    for (int32_t Y = Y0; Y < Y1; ++Y)
+                    {
+                        uint8_t* RefRow = Ref + static_cast<size_t>(Y) * Layout.Width;
+                        if (bKeyframe)
+                        {
+                            const uint8_t* RefAbove = Y > Y0 ? RefRow - Layout.Width : nullptr;
+                            for (int32_t X = X0; X < X1; ++X)
+                            {
+                                RefRow[X] = static_cast<uint8_t>(*Data++ + PredictSpatial(RefRow, RefAbove, X, X0));
+                            }
+                        }
+                        else
+                        {
+                            for (int32_t X = X0; X < X1; ++X)
+                            {
+                                RefRow[X] = static_cast<uint8_t>(RefRow[X] + *Data++);
+                            }
+                        }
+                    }
+                }
+            }
+            Mask += Layout.MaskBytes();
+
+            // Dequantize to the middle of each bucket
+            if (QuantizationBits > 0)
+            {
+                const uint8_t Half = static_cast<uint8_t>(1 << (QuantizationBits - 1));
+                Output[Plane].resize(Quantized[Plane].size());
+                for (size_t i = 0; i < Quantized[Plane].size(); ++i)
+                {
+                    Output[Plane][i] = static_cast<uint8_t>((Ref[i] << QuantizationBits) | Half);
+                }
+            }
+        }
+        return true;
+    }
+
+    const uint8_t* FFrameDecoder::GetPlane(int32_t Plane) const
+    {
+        if (Plane < 0 || Plane > 2 || (Plane > 0 && !bChroma) || Quantized[Plane].empty())
+        {
+            return nullptr;
+        }
+        return QuantizationBits > 0 ? Output[Plane].data() : Quantized[Plane].data();
+    }
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Wire format and codec of the preview stream (Camera2PreviewStreamer on the device, Tools/Camera2Viewer on a
+ * desktop). Engine independent so the viewer builds it with a plain C++ compiler.
+ *
+ * Every message is a 12 byte header (magic, type, version, payload size; little endian) followed by its payload.
+ * A frame carries the Y plane and optionally U and V at half resolution, each cut into square tiles (chroma tiles
+ * are half the luma tile edge, so both grids line up). The encoder keeps the image the decoder reconstructs:
+ * a keyframe sends every tile predicted from its left (or upper) neighbour, a delta frame only the tiles whose
+ * mean absolute difference to that reference exceeds a threshold, as the per-pixel difference. Optionally the
+ * low bits of every sample are dropped first. Tile masks and tile data are compressed together as one LZ4 block.
+ */
+namespace Camera2Stream
+{
+    static constexpr uint32_t Magic = 0x56503243; // "C2PV"
+    static constexpr uint8_t Version = 1;
+    static constexpr int32_t MessageHeaderSize = 12;
+    static constexpr int32_t FrameHeaderSize = 32;
+    static constexpr uint32_t MaxPayloadSize = 64u << 20;
+    static constexpr uint16_t DefaultPort = 8555;
+
+    enum class EMessageType : uint8_t
+    {
+        // Frame header followed by the LZ4 block of tile masks and tile data
+        Frame = 1,
+        // UTF-8 "key=value" lines describing the sender's pipeline
+        Stats = 2
+    };
+
+    void WriteMessageHeader(uint8_t* Out, EMessageType Type, uint32_t PayloadSize);
+
+    /** @return false if the bytes are not a message header of this version or the payload is implausibly large */
+    bool ReadMessageHeader(const uint8_t* In, EMessageType& OutType, uint32_t& OutPayloadSize);
+
+    /** Largest LZ4 block SrcSize bytes can compress to */
+    int32_t LZ4CompressBound(int32_t SrcSize);
+
+    /**
+     * Greedy single-probe LZ4 block compression (the format of LZ4_compress_default)
+     * @param HashTable reused between calls to avoid allocations
+     * @return compressed size, or -1 if DstCapacity is below LZ4CompressBound(SrcSize)
+     */
+    int32_t LZ4Compress(const uint8_t* Src, int32_t SrcSize, uint8_t* Dst, int32_t DstCapacity, std::vector<uint32_t>& HashTable);
+
+    /** @return decompressed size, or -1 on malformed input or if the block does not fit in DstCapacity */
+    int32_t LZ4Decompress(const uint8_t* Src, int32_t SrcSize, uint8_t* Dst, int32_t DstCapacity);
+
+    /** Tightly packed 8-bit planes; U and V are (Width + 1) / 2 x (Height + 1) / 2 and both null for luma only */
+    struct FPlanes
+    {
+        const uint8_t* Y = nullptr;
+        const uint8_t* U = nullptr;
+        const uint8_t* V = nullptr;
+        int32_t Width = 0;
+        int32_t Height = 0;
+    };
+
+    struct FEncoderConfig
+    {
+        // Luma tile edge in pixels (8-64, multiple of 8)
+        int32_t TileSize = 16;
+        // A tile is resent when its mean absolute difference to the decoder's image exceeds this (8-bit levels)
+        float ChangeThreshold = 2.0f;
+        // Low bits dropped from every sample (0-4); trades precision for fewer changed tiles and smaller tiles
+        int32_t QuantizationBits = 0;
+        // Frames between forced keyframes (0 = only on the first frame, size changes and RequestKeyframe)
+        int32_t KeyframeInterval = 120;
+    };
+
+    struct FEncodeStats
+    {
+        bool bKeyframe = false;
+        int32_t ChangedTiles = 0;
+        int32_t TotalTiles = 0;
+        int32_t RawBytes = 0;
+        int32_t CompressedBytes = 0;
+    };
+
+    class FFrameEncoder
+    {
+    public:
+        /** Takes effect with the next keyframe, which it requests */
+        void SetConfig(const FEncoderConfig& InConfig);
+        const FEncoderConfig& GetConfig() const { return Config; }
+
+        /** Next frame is a keyframe (a new receiver has no reference yet) */
+        void RequestKeyframe() { bKeyframeRequested = true; }
+
+        /**
+         * Encode a frame into a complete Frame message (header included)
+         * @return false if the planes are missing or larger than 65535 pixels on a side
+         */
+        bool Encode(const FPlanes& Frame, int64_t TimestampNs, std::vector<uint8_t>& OutMessage, FEncodeStats* OutStats = nullptr);
+
+    private:
+        FEncoderConfig Config;
+        FEncoderConfig ActiveConfig;
+        // Quantized samples the decoder holds after the last encoded frame
+        std::vector<uint8_t> Reference[3];
+        std::vector<uint8_t> Raw;
+        std::vector<uint32_t> HashTable;
+        int32_t Width = 0;
+        int32_t Height = 0;
+        bool bChroma = false;
+        bool bKeyframeRequested = true;
+        int32_t FramesSinceKeyframe = 0;
+        uint32_t FrameIndex = 0;
+    };
+
+    class FFrameDecoder
+    {
+    public:
+        /**
+         * Decode the payload of a Frame message
+         * @return false on a malformed frame or a delta frame without the keyframe it builds on
+         */
+        bool Decode(const uint8_t* Payload, int32_t PayloadSize);
+
+        /** Forget the reference; the next frame has to be a keyframe */
+        void Reset() { bHasKeyframe = false; }
+
+        int32_t GetWidth() const { return Width; }
+        int32_t GetHeight() const { return Height; }
+        bool HasChroma() const { return bChroma; }
+        bool IsKeyframe() const { return bKeyframe; }
+        uint32_t GetFrameIndex() const { return FrameIndex; }
+        int64_t GetTimestampNs() const { return TimestampNs; }
+        int32_t GetChangedTiles() const { return ChangedTiles; }
+        int32_t GetTotalTiles() const { return TotalTiles; }
+
+        /** 0 = Y, 1 = U, 2 = V (null without chroma); valid until the next Decode */
+        const uint8_t* GetPlane(int32_t Plane) const;
+
+    private:
+        std::vector<uint8_t> Quantized[3];
+        std::vector<uint8_t> Output[3];
+        std::vector<uint8_t> Raw;
+        int32_t Width = 0;
+        int32_t Height = 0;
+        int32_t TileSize = 0;
+        int32_t QuantizationBits = 0;
+        bool bChroma = false;
+        bool bKeyframe = false;
+        bool bHasKeyframe = false;
+        uint32_t FrameIndex = 0;
+        int64_t TimestampNs = 0;
+        int32_t ChangedTiles = 0;
+        int32_t TotalTiles = 0;
+    };
+}
@@ -0,0 +1,80 @@
+#include "Camera2Trace.h"
+#include "Camera2FramePipeline.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(Camera2Channel)
+
+#if COUNTERSTRACE_ENABLED
+namespace
+{
+    static_assert(FCamera2FramePipeline::MaxStreams == 4, "One trace counter per stream");
+
+    // Counter names must outlive the counters, so they are spelled out per stream
+    FCountersTrace::FCounterInt GQueueDepthCounters[] =
+    {
+        FCountersTrace::FCounterInt(TEXT("Camera2/Stream 0/Queue Depth"), TraceCounterDisplayHint_None),
+        FCountersTrace::FCounterInt(TEXT("Camera2/Stream 1/Queue Depth"), TraceCounterDisplayHint_None),
+        FCountersTrace::FCounterInt(TEXT("Camera2/Stream 2/Queue Depth"), TraceCounterDisplayHint_None),
+        FCountersTrace::FCounterInt(TEXT("Camera2/Stream 3/Queue Depth"), TraceCounterDisplayHint_None),
+    };
+    FCountersTrace::FCounterInt GPipelineDropCounters[] =
+    {
+        FCountersTrace::FCounterInt(TEXT("Camera2/Stream 0/Pipeline Drops"), TraceCounterDisplayHint_None),
+        FCountersTrace::FCounterInt(TEXT("Camera2/Stream 1/Pipeline Drops"), TraceCounterDisplayHint_None),
+        FCountersTrace::FCounterInt(TEXT("Camera2/Stream 2/Pipeline Drops"), TraceCounterDisplayHint_None),
+        FCountersTrace::FCounterInt(TEXT("Camera2/Stream 3/Pipeline Drops"), TraceCounterDisplayHint_None),
+    };
+    FCountersTrace::FCounterFloat GHandoffLatencyCounters[] =
+    {
+        FCountersTrace::FCounterFloat(TEXT("Camera2/Stream 0/Handoff Latency (ms)"), TraceCounterDisplayHint_None),
+        FCountersTrace::FCounterFloat(TEXT("Camera2/Stream 1/Handoff Latency (ms)"), TraceCounterDisplayHint_None),
+        FCountersTrace::FCounterFloat(TEXT("Camera2/Stream 2/Handoff Latency (ms)"), TraceCounterDisplayHint_None),
+        FCountersTrace::FCounterFloat(TEXT("Camera2/Stream 3/Handoff Latency (ms)"), TraceCounterDisplayHint_None),
+    };
+    FCountersTrace::FCounterInt GQueueDropsCounter(TEXT("Camera2/Capture/Queue Drops"), TraceCounterDisplayHint_None);
+    FCountersTrace::FCounterInt GSensorDropsCounter(TEXT("Camera2/Capture/Sensor Drops"), TraceCounterDisplayHint_None);
+    FCountersTrace::FCounterInt GBuffersLostCounter(TEXT("Camera2/Capture/Buffers Lost"), TraceCounterDisplayHint_None);
+}
+#endif
+
+void Camera2Trace::SetQueueDepth(int32 StreamId, int64 SlotsInUse)
+{
+#if COUNTERSTRACE_ENABLED
+    if (CAMERA2_TRACE_ENABLED() && StreamId >= 0 && StreamId < FCamera2FramePipeline::MaxStreams)
+    {
+        GQueueDepthCounters[StreamId].Set(SlotsInUse);
+    }
+#endif
+}
+
+void Camera2Trace::SetPipelineDrops(int32 StreamId, int64 Drops)
+{
+#if COUNTERSTRACE_ENABLED
+    if (CAMERA2_TRACE_ENABLED() && StreamId >= 0 && StreamId < FCamera2FramePipeline::MaxStreams)
+    {
+        GPipelineDropCounters[StreamId].Set(Drops);
+    }
+#endif
+}
+
+void Camera2Trace::SetHandoffLatency(int32 StreamId, double LatencyMs)
+{
+#if COUNTERSTRACE_ENABLED
+    if (CAMERA2_TRACE_ENABLED() && StreamId >= 0 && StreamId < FCamera2FramePipeline::MaxStreams)
+    {
+        GHandoffLatencyCounters[StreamId].Set(LatencyMs);
+    }
+#endif
+}
+
+void Camera2Trace::SetCaptureDrops(int64 QueueDrops, int64 SensorDrops, int64 BuffersLost)
+{
+#if COUNTERSTRACE_ENABLED
+    if (CAMERA2_TRACE_ENABLED())
+    {
+        GQueueDropsCounter.Set(QueueDrops);
+        GSensorDropsCounter.Set(SensorDrops);
+        GBuffersLostCounter.Set(BuffersLost);
+    }
+#endif
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * "Camera2" trace channel for Unreal Insights: run with -trace=default,camera2 or enable it at runtime with
+ * `Trace.Enable Camera2`. Every pipeline stage is a scoped CPU event on the channel, and per-stream queue depth,
+ * drops and handoff latency are trace counters. With the channel off a scope costs one branch on the channel
+ * state and no counter is touched; with tracing compiled out (shipping) everything expands to nothing.
+ */
+UE_TRACE_CHANNEL_EXTERN(Camera2Channel)
+
+#define CAMERA2_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, Camera2Channel)
+#define CAMERA2_TRACE_ENABLED() UE_TRACE_CHANNELEXPR_IS_ENABLED(Camera2Channel)
+
+namespace Camera2Trace
+{
+    /** Ring slots in use after a frame was submitted to a stream's pipeline */
+    void SetQueueDepth(int32 StreamId, int64 SlotsInUse);
+
+    /** Frames the stream's pipeline dropped so far (no free slot or mismatched size) */
+    void SetPipelineDrops(int32 StreamId, int64 Drops);
+
+    /** Sensor timestamp (mapped to engine time) until the frame reached native code */
+    void SetHandoffLatency(int32 StreamId, double LatencyMs);
+
+    /** Session-wide Camera2Helper drop accounting */
+    void SetCaptureDrops(int64 QueueDrops, int64 SensorDrops, int64 BuffersLost);
+}
@@ -0,0 +1,638 @@
+#include "Camera2YuvConvert.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#define CAMERA2_YUV_NEON 1
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#define CAMERA2_YUV_SSE2 1
+#endif
+
+namespace Camera2Yuv
+{
+    static FORCEINLINE uint8 Clamp255(int32 Value)
+    {
+        return static_cast<uint8>(Value < 0 ? 0 : (Value > 255 ? 255 : Value));
+    }
+
+    static FORCEINLINE uint16 PackRGB565(int32 R, int32 G, int32 B)
+    {
+        return static_cast<uint16>(((R >> 3) << 11) | ((G >> 2) << 5) | (B >> 3));
+    }
+
+    FOutputLayout GetOutputLayout(ECamera2OutputFormat Format, int32 Width, int32 Height)
+    {
+        FOutputLayout Layout;
+        Layout.TextureWidth = Width;
+        Layout.TextureHeight = Height;
+        switch (Format)
+        {
+        case ECamera2OutputFormat::Luma:
+            Layout.PixelFormat = PF_G8;
+            Layout.Pitch = Width;
+            break;
+        case ECamera2OutputFormat::RGB565:
+            Layout.PixelFormat = PF_B5G6R5_UNORM;
+            Layout.Pitch = Width * 2;
+            break;
+        case ECamera2OutputFormat::NV12:
+            // Chroma rows hold ChromaWidth UV pairs, so odd widths get one padding column
+            Layout.PixelFormat = PF_G8;
+            Layout.TextureWidth = (Width + 1) & ~1;
+            Layout.TextureHeight = Height + (Height + 1) / 2;
+            Layout.Pitch = Layout.TextureWidth;
+            break;
+        default:
+            Layout.PixelFormat = PF_B8G8R8A8;
+            Layout.Pitch = Width * 4;
+            break;
+        }
+        return Layout;
+    }
+
+    void ClearToGray(ECamera2OutputFormat Format, int32 Width, int32 Height, uint8* Dst)
+    {
+        const FOutputLayout Layout = GetOutputLayout(Format, Width, Height);
+        if (Format == ECamera2OutputFormat::RGB565)
+        {
+            const uint16 Gray = PackRGB565(64, 64, 64);
+            uint16* Out = reinterpret_cast<uint16*>(Dst);
+            for (int32 i = 0; i < Layout.GetSizeBytes() / 2; ++i)
+            {
+                Out[i] = Gray;
+            }
+        }
+        else if (Format == ECamera2OutputFormat::NV12)
+        {
+            FMemory::Memset(Dst, 64, Height * Layout.Pitch);
+            FMemory::Memset(Dst + Height * Layout.Pitch, 128, (Layout.TextureHeight - Height) * Layout.Pitch);
+        }
+        else
+        {
+            FMemory::Memset(Dst, 64, Layout.GetSizeBytes());
+        }
+    }
+
+    // Pixels converted per stack chunk when RGB565 packing follows the matrix
+    static constexpr int32 ChunkPixels = 256;
+
+    /**
+     * Tetrahedral interpolation of one pixel in place: the lattice cell is split into six tetrahedra along its
+     * main diagonal. The walk from the near to the far corner steps along the axis of the largest fraction first
+     * and the axis of the smallest last; weights come from the sorted fractions. Written without branches since
+     * the tetrahedron changes unpredictably between neighbouring pixels; on ties the affected weight is 0.
+     */
+    static FORCEINLINE void ApplyColorLutPixel(const FColorLut& Lut, uint8* P)
+    {
+        const uint32* Entries = Lut.Entries.GetData();
+        const int32 StepR = 1;
+        const int32 StepG = Lut.Size;
+        const int32 StepB = Lut.Size * Lut.Size;
+        const int32 FractionMask = (1 << FColorLut::FractionBits) - 1;
+
+        const int32 LookupR = Lut.Lookup[0][P[2]];
+        const int32 LookupG = Lut.Lookup[1][P[1]];
+        const int32 LookupB = Lut.Lookup[2][P[0]];
+        const int32 X = LookupR & FractionMask;
+        const int32 Y = LookupG & FractionMask;
+        const int32 Z = LookupB & FractionMask;
+        const int32 Base = (LookupR >> FColorLut::FractionBits) + (LookupG >> FColorLut::FractionBits) + (LookupB >> FColorLut::FractionBits);
+
+        const int32 Max = FMath::Max(X, FMath::Max(Y, Z));
+        const int32 Min = FMath::Min(X, FMath::Min(Y, Z));
+        const int32 Mid = X + Y + Z - Max - Min;
+        const int32 XIsMax = -static_cast<int32>(X == Max);
+        const int32 YIsMax = -static_cast<int32>(Y == Max) & ~XIsMax;
+        const int32 ZIsMin = -static_cast<int32>(Z == Min);
+        const int32 YIsMin = -static_cast<int32>(Y == Min) & ~ZIsMin;
+        const int32 StepMax = (StepR & XIsMax) | (StepG & YIsMax) | (StepB & ~(XIsMax | YIsMax));
+        const int32 StepMin = (StepB & ZIsMin) | (StepG & YIsMin) | (StepR & ~(ZIsMin | YIsMin));
+        const int32 W0 = 256 - Max;
+        const int32 W1 = Max - Mid;
+        const int32 W2 = Mid - Min;
+        const int32 W3 = Min;
+
+        const uint32 C0 = Entries[Base];
+        const uint32 C1 = Entries[Base + StepMax];
+        const uint32 C2 = Entries[Base + StepR + StepG + StepB - StepMin];
+        const uint32 C3 = Entries[Base + StepR + StepG + StepB];
+        for (int32 Channel = 0; Channel < 4; ++Channel)
+        {
+            const int32 Shift = Channel * 8;
+            const int32 Value = W0 * ((C0 >> Shift) & 0xFF) + W1 * ((C1 >> Shift) & 0xFF)
+                + W2 * ((C2 >> Shift) & 0xFF) + W3 * ((C3 >> Shift) & 0xFF);
+            P[Channel] = static_cast<uint8>((Value + 128) >> 8);
+        }
+    }
+
+    // The SIMD LUT kernels take 8 pixels as 16-bit B, G, R lanes, so the conversion loops hand over their
+    // registers instead of storing and reloading the pixels. Cell and fraction are computed rather than read
+    // from the per-axis lookup tables: (V * (Size - 1) * 256 + 127) / 255 equals N + (N + 127) / 255 with
+    // N = V * (Size - 1), and x / 255 equals (x + 1 + (x >> 8)) >> 8 for every x up to 255 * 64 + 127.
+    // Clamping the cell to Size - 2 turns the last lattice point's fraction into 256, as in BuildColorLut.
+    // Only the four corner loads per pixel stay scalar; weights sum to 256, so 16-bit accumulators suffice.
+#if CAMERA2_YUV_NEON
+    struct FLutVectors
+    {
+        explicit FLutVectors(const FColorLut& Lut)
+            : Entries(Lut.Entries.GetData())
+            , Size(static_cast<uint16>(Lut.Size))
+            , SizeSquared(static_cast<uint16>(Lut.Size * Lut.Size))
+            , Diagonal(1 + Lut.Size + Lut.Size * Lut.Size)
+            , SizeMinusOne(vdupq_n_u16(static_cast<uint16>(Lut.Size - 1)))
+            , LastCell(vdupq_n_u16(static_cast<uint16>(Lut.Size - 2)))
+            , StepR(vdupq_n_u16(1))
+            , StepG(vdupq_n_u16(Size))
+            , StepB(vdupq_n_u16(SizeSquared))
+            , DiagonalStep(vdupq_n_u16(static_cast<uint16>(Diagonal)))
+        {
+        }
+
+        const uint32* Entries;
+        uint16 Size;
+        uint16 SizeSquared;
+        int32 Diagonal;
+        uint16x8_t SizeMinusOne;
+        uint16x8_t LastCell;
+        uint16x8_t StepR;
+        uint16x8_t StepG;
+        uint16x8_t StepB;
+        uint16x8_t DiagonalStep;
+    };
+
+    static FORCEINLINE void LatticePosition(const FLutVectors& L, uint16x8_t Value, uint16x8_t& OutCell, uint16x8_t& OutFraction)
+    {
+        const uint16x8_t N = vmulq_u16(Value, L.SizeMinusOne);
+        const uint16x8_t X = vaddq_u16(N, vdupq_n_u16(127));
+        const uint16x8_t Position = vaddq_u16(N, vshrq_n_u16(vaddq_u16(vaddq_u16(X, vdupq_n_u16(1)), vshrq_n_u16(X, 8)), 8));
+        OutCell = vminq_u16(vshrq_n_u16(Position, 8), L.LastCell);
+        OutFraction = vsubq_u16(Position, vshlq_n_u16(OutCell, 8));
+    }
+
+    /** LUT of 8 pixels given as 16-bit channels, written to Out as BGRA8 */
+    static FORCEINLINE void ApplyColorLut8(const FLutVectors& L, uint16x8_t B, uint16x8_t G, uint16x8_t R, uint8* Out)
+    {
+        uint16x8_t CellR, CellG, CellB, X, Y, Z;
+        LatticePosition(L, R, CellR, X);
+        LatticePosition(L, G, CellG, Y);
+        LatticePosition(L, B, CellB, Z);
+
+        const uint16x8_t Max = vmaxq_u16(X, vmaxq_u16(Y, Z));
+        const uint16x8_t Min = vminq_u16(X, vminq_u16(Y, Z));
+        const uint16x8_t Mid = vsubq_u16(vaddq_u16(vaddq_u16(X, Y), Z), vaddq_u16(Max, Min));
+        const uint16x8_t XIsMax = vceqq_u16(X, Max);
+        const uint16x8_t YIsMax = vbicq_u16(vceqq_u16(Y, Max), XIsMax);
+        const uint16x8_t ZIsMin = vceqq_u16(Z, Min);
+        const uint16x8_t YIsMin = vbicq_u16(vceqq_u16(Y, Min), ZIsMin);
+        const uint16x8_t StepMax = vorrq_u16(vorrq_u16(vandq_u16(L.StepR, XIsMax), vandq_u16(L.StepG, YIsMax)),
+            vbicq_u16(L.StepB, vorrq_u16(XIsMax, YIsMax)));
+        const uint16x8_t StepMin = vorrq_u16(vorrq_u16(vandq_u16(L.StepB, ZIsMin), vandq_u16(L.StepG, YIsMin)),
+            vbicq_u16(L.StepR, vorrq_u16(ZIsMin, YIsMin)));
+        const uint16x8_t FarStep = vsubq_u16(L.DiagonalStep, StepMin);
+
+        // Lattice offsets pass 16 bits from 41^3 up
+        const uint32x4_t BaseLo = vmlal_n_u16(vmlal_n_u16(vmovl_u16(vget_low_u16(CellR)), vget_low_u16(CellG), L.Size), vget_low_u16(CellB), L.SizeSquared);
+        const uint32x4_t BaseHi = vmlal_n_u16(vmlal_n_u16(vmovl_u16(vget_high_u16(CellR)), vget_high_u16(CellG), L.Size), vget_high_u16(CellB), L.SizeSquared);
+        uint32 Base[8];
+        uint32 Index1[8];
+        uint32 Index2[8];
+        vst1q_u32(Base, BaseLo);
+        vst1q_u32(Base + 4, BaseHi);
+        vst1q_u32(Index1, vaddw_u16(BaseLo, vget_low_u16(StepMax)));
+        vst1q_u32(Index1 + 4, vaddw_u16(BaseHi, vget_high_u16(StepMax)));
+        vst1q_u32(Index2, vaddw_u16(BaseLo, vget_low_u16(FarStep)));
+        vst1q_u32(Index2 + 4, vaddw_u16(BaseHi, vget_high_u16(FarStep)));
+
+        uint32 Corners[4][8];
+        for (int32 Pixel = 0; Pixel < 8; ++Pixel)
+        {
+            Corners[0][Pixel] = L.Entries[Base[Pixel]];
+            Corners[1][Pixel] = L.Entries[Index1[Pixel]];
+            Corners[2][Pixel] = L.Entries[Index2[Pixel]];
+            Corners[3][Pixel] = L.Entries[Base[Pixel] + L.Diagonal];
+        }
+
+        const uint16x8_t Weights[4] = { vsubq_u16(vdupq_n_u16(256), Max), vsubq_u16(Max, Mid), vsubq_u16(Mid, Min), Min };
+        uint16x8_t Sums[4] = { vdupq_n_u16(0), vdupq_n_u16(0), vdupq_n_u16(0), vdupq_n_u16(0) };
+        for (int32 Corner = 0; Corner < 4; ++Corner)
+        {
+            const uint8x8x4_t Channels = vld4_u8(reinterpret_cast<const uint8*>(Corners[Corner]));
+            for (int32 Channel = 0; Channel < 4; ++Channel)
+            {
+                Sums[Channel] = vmlaq_u16(Sums[Channel], vmovl_u8(Channels.val[Channel]), Weights[Corner]);
+            }
+        }
+        uint8x8x4_t Result;
+        for (int32 Channel = 0; Channel < 4; ++Channel)
+        {
+            Result.val[Channel] = vrshrn_n_u16(Sums[Channel], 8);
+        }
+        vst4_u8(Out, Result);
+    }
+#elif CAMERA2_YUV_SSE2
+    struct FLutVectors
+    {
+        explicit FLutVectors(const FColorLut& Lut)
+            : Entries(Lut.Entries.GetData())
+            , Diagonal(1 + Lut.Size + Lut.Size * Lut.Size)
+            , SizeMinusOne(_mm_set1_epi16(static_cast<int16>(Lut.Size - 1)))
+            , LastCell(_mm_set1_epi16(static_cast<int16>(Lut.Size - 2)))
+            , StepR(_mm_set1_epi16(1))
+            , StepG(_mm_set1_epi16(static_cast<int16>(Lut.Size)))
+            , StepB(_mm_set1_epi16(static_cast<int16>(Lut.Size * Lut.Size)))
+            , StepGB(_mm_set1_epi32(Lut.Size | (Lut.Size * Lut.Size) << 16))
+            , DiagonalStep(_mm_set1_epi16(static_cast<int16>(Diagonal)))
+        {
+        }
+
+        const uint32* Entries;
+        int32 Diagonal;
+        __m128i SizeMinusOne;
+        __m128i LastCell;
+        __m128i StepR;
+        __m128i StepG;
+        __m128i StepB;
+        // (Size, Size^2) pairs for madd on interleaved (CellG, CellB)
+        __m128i StepGB;
+        __m128i DiagonalStep;
+    };
+
+    static FORCEINLINE void LatticePosition(const FLutVectors& L, __m128i Value, __m128i& OutCell, __m128i& OutFraction)
+    {
+        const __m128i N = _mm_mullo_epi16(Value, L.SizeMinusOne);
+        const __m128i X = _mm_add_epi16(N, _mm_set1_epi16(127));
+        const __m128i Position = _mm_add_epi16(N, _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(X, _mm_set1_epi16(1)), _mm_srli_epi16(X, 8)), 8));
+        OutCell = _mm_min_epi16(_mm_srli_epi16(Position, 8), L.LastCell);
+        OutFraction = _mm_sub_epi16(Position, _mm_slli_epi16(OutCell, 8));
+    }
+
+    /** LUT of 8 pixels given as 16-bit channels, written to Out as BGRA8 */
+    static FORCEINLINE void ApplyColorLut8(const FLutVectors& L, __m128i B, __m128i G, __m128i R, uint8* Out)
+    {
+        __m128i CellR, CellG, CellB, X, Y, Z;
+        LatticePosition(L, R, CellR, X);
+        LatticePosition(L, G, CellG, Y);
+        LatticePosition(L, B, CellB, Z);
+
+        const __m128i Max = _mm_max_epi16(X, _mm_max_epi16(Y, Z));
+        const __m128i Min = _mm_min_epi16(X, _mm_min_epi16(Y, Z));
+        const __m128i Mid = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(X, Y), Z), _mm_add_epi16(Max, Min));
+        const __m128i XIsMax = _mm_cmpeq_epi16(X, Max);
+        const __m128i YIsMax = _mm_andnot_si128(XIsMax, _mm_cmpeq_epi16(Y, Max));
+        const __m128i ZIsMin = _mm_cmpeq_epi16(Z, Min);
+        const __m128i YIsMin = _mm_andnot_si128(ZIsMin, _mm_cmpeq_epi16(Y, Min));
+        const __m128i StepMax = _mm_or_si128(_mm_or_si128(_mm_and_si128(L.StepR, XIsMax), _mm_and_si128(L.StepG, YIsMax)),
+            _mm_andnot_si128(_mm_or_si128(XIsMax, YIsMax), L.StepB));
+        const __m128i StepMin = _mm_or_si128(_mm_or_si128(_mm_and_si128(L.StepB, ZIsMin), _mm_and_si128(L.StepG, YIsMin)),
+            _mm_andnot_si128(_mm_or_si128(ZIsMin, YIsMin), L.StepR));
+        const __m128i FarStep = _mm_sub_epi16(L.DiagonalStep, StepMin);
+
+        // Lattice offsets pass 16 bits from 41^3 up
+        const __m128i Zero = _mm_setzero_si128();
+        const __m128i BaseLo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(CellG, CellB), L.StepGB), _mm_unpacklo_epi16(CellR, Zero));
+        const __m128i BaseHi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(CellG, CellB), L.StepGB), _mm_unpackhi_epi16(CellR, Zero));
+        alignas(16) int32 Base[8];
+        alignas(16) int32 Index1[8];
+        alignas(16) int32 Index2[8];
+        _mm_store_si128(reinterpret_cast<__m128i*>(Base), BaseLo);
+        _mm_store_si128(reinterpret_cast<__m128i*>(Base + 4), BaseHi);
+        _mm_store_si128(reinterpret_cast<__m128i*>(Index1), _mm_add_epi32(BaseLo, _mm_unpacklo_epi16(StepMax, Zero)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(Index1 + 4), _mm_add_epi32(BaseHi, _mm_unpackhi_epi16(StepMax, Zero)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(Index2), _mm_add_epi32(BaseLo, _mm_unpacklo_epi16(FarStep, Zero)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(Index2 + 4), _mm_add_epi32(BaseHi, _mm_unpackhi_epi16(FarStep, Zero)));
+
+        const __m128i Weights[4] = { _mm_sub_epi16(_mm_set1_epi16(256), Max), _mm_sub_epi16(Max, Mid), _mm_sub_epi16(Mid, Min), Min };
+        const __m128i Round = _mm_set1_epi16(128);
+        for (int32 Half = 0; Half < 2; ++Half)
+        {
+            // Four pixels per half; each pixel's weight is spread over its four channels
+            auto Gather = [&L, Half](const int32* Index, int32 Offset) -> __m128i
+            {
+                const int32* I = Index + Half * 4;
+                return _mm_set_epi32(static_cast<int32>(L.Entries[I[3] + Offset]), static_cast<int32>(L.Entries[I[2] + Offset]),
+                    static_cast<int32>(L.Entries[I[1] + Offset]), static_cast<int32>(L.Entries[I[0] + Offset]));
+            };
+            const __m128i Corners[4] = { Gather(Base, 0), Gather(Index1, 0), Gather(Index2, 0), Gather(Base, L.Diagonal) };
+            __m128i SumLo = Zero;
+            __m128i SumHi = Zero;
+            for (int32 Corner = 0; Corner < 4; ++Corner)
+            {
+                const __m128i Pairs = Half == 0 ? _mm_unpacklo_epi16(Weights[Corner], Weights[Corner]) : _mm_unpackhi_epi16(Weights[Corner], Weights[Corner]);
+                SumLo = _mm_add_epi16(SumLo, _mm_mullo_epi16(_mm_unpacklo_epi8(Corners[Corner], Zero), _mm_unpacklo_epi32(Pairs, Pairs)));
+                SumHi = _mm_add_epi16(SumHi, _mm_mullo_epi16(_mm_unpackhi_epi8(Corners[Corner], Zero), _mm_unpackhi_epi32(Pairs, Pairs)));
+            }
+            SumLo = _mm_srli_epi16(_mm_add_epi16(SumLo, Round), 8);
+            SumHi = _mm_srli_epi16(_mm_add_epi16(SumHi, Round), 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Half * 16), _mm_packus_epi16(SumLo, SumHi));
+        }
+    }
+#endif
+
+    void ApplyColorLut(const FColorLut& Lut, uint8* Bgra, int32 NumPixels)
+    {
+        int32 Pixel = 0;
+
+#if CAMERA2_YUV_NEON
+        const FLutVectors L(Lut);
+        for (; Pixel + 8 <= NumPixels; Pixel += 8)
+        {
+            const uint8x8x4_t Pixels = vld4_u8(Bgra + Pixel * 4);
+            ApplyColorLut8(L, vmovl_u8(Pixels.val[0]), vmovl_u8(Pixels.val[1]), vmovl_u8(Pixels.val[2]), Bgra + Pixel * 4);
+        }
+#elif CAMERA2_YUV_SSE2
+        const FLutVectors L(Lut);
+        const __m128i Mask = _mm_set1_epi32(0xFF);
+        for (; Pixel + 8 <= NumPixels; Pixel += 8)
+        {
+            const __m128i Lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Bgra + Pixel * 4));
+            const __m128i Hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Bgra + Pixel * 4 + 16));
+            auto Channel = [&](int32 Shift) -> __m128i
+            {
+                return _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(Lo, Shift), Mask), _mm_and_si128(_mm_srli_epi32(Hi, Shift), Mask));
+            };
+            ApplyColorLut8(L, Channel(0), Channel(8), Channel(16), Bgra + Pixel * 4);
+        }
+#endif
+
+        for (; Pixel < NumPixels; ++Pixel)
+        {
+            ApplyColorLutPixel(Lut, Bgra + Pixel * 4);
+        }
+    }
+
+    /**
+     * Color transform of Count pixels of one row starting at an even column. SIMD paths keep the matrix
+     * products in 32 bits and round like the scalar (x + Round) >> MatrixShift; with a LUT each block of
+     * converted pixels goes through ApplyColorLut8 in registers before it is stored.
+     */
+    static void ConvertRowToBGRA(const FColorTransform& Color, const uint8* YRow, const uint8* URow, const uint8* VRow,
+        int32 Count, uint8* Out)
+    {
+        const FYuvMatrix& M = Color.Matrix;
+        const bool bLut = Color.Lut.IsValid();
+        const int32 Round = 1 << (MatrixShift - 1);
+        int32 Col = 0;
+
+#if CAMERA2_YUV_NEON
+        // 16 pixels / 8 chroma samples per iteration; vqrshrn rounds and saturates in one step
+        const int16x8_t Bias = vdupq_n_s16(128);
+        const int16x8_t YOffset = vdupq_n_s16(static_cast<int16>(M.YOffset));
+        const uint8x16_t Alpha = vdupq_n_u8(255);
+        const FLutVectors L(Color.Lut);
+        for (; Col + 16 <= Count; Col += 16)
+        {
+            const uint8x16_t Y8 = vld1q_u8(YRow + Col);
+            const int16x8_t YLo = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(Y8))), YOffset);
+            const int16x8_t YHi = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(Y8))), YOffset);
+            const int16x8_t U = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(URow + Col / 2))), Bias);
+            const int16x8_t V = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(VRow + Col / 2))), Bias);
+
+            const int32x4_t YTerm[4] = {
+                vmull_n_s16(vget_low_s16(YLo), static_cast<int16>(M.YScale)),
+                vmull_n_s16(vget_high_s16(YLo), static_cast<int16>(M.YScale)),
+                vmull_n_s16(vget_low_s16(YHi), static_cast<int16>(M.YScale)),
+                vmull_n_s16(vget_high_s16(YHi), static_cast<int16>(M.YScale)) };
+
+            // Each chroma sample covers two pixels
+            auto Channel = [&YTerm](int32x4_t ChromaLo, int32x4_t ChromaHi) -> uint8x16_t
+            {
+                const int32x4x2_t Lo = vzipq_s32(ChromaLo, ChromaLo);
+                const int32x4x2_t Hi = vzipq_s32(ChromaHi, ChromaHi);
+                const int16x8_t First = vcombine_s16(
+                    vqrshrn_n_s32(vaddq_s32(YTerm[0], Lo.val[0]), MatrixShift),
+                    vqrshrn_n_s32(vaddq_s32(YTerm[1], Lo.val[1]), MatrixShift));
+                const int16x8_t Second = vcombine_s16(
+                    vqrshrn_n_s32(vaddq_s32(YTerm[2], Hi.val[0]), MatrixShift),
+                    vqrshrn_n_s32(vaddq_s32(YTerm[3], Hi.val[1]), MatrixShift));
+                return vcombine_u8(vqmovun_s16(First), vqmovun_s16(Second));
+            };
+
+            uint8x16x4_t Pixels;
+            Pixels.val[0] = Channel(vmull_n_s16(vget_low_s16(U), static_cast<int16>(M.BU)),
+                                    vmull_n_s16(vget_high_s16(U), static_cast<int16>(M.BU)));
+            Pixels.val[1] = Channel(vmlal_n_s16(vmull_n_s16(vget_low_s16(U), static_cast<int16>(M.GU)), vget_low_s16(V), static_cast<int16>(M.GV)),
+                                    vmlal_n_s16(vmull_n_s16(vget_high_s16(U), static_cast<int16>(M.GU)), vget_high_s16(V), static_cast<int16>(M.GV)));
+            Pixels.val[2] = Channel(vmull_n_s16(vget_low_s16(V), static_cast<int16>(M.RV)),
+                                    vmull_n_s16(vget_high_s16(V), static_cast<int16>(M.RV)));
+            if (bLut)
+            {
+                ApplyColorLut8(L, vmovl_u8(vget_low_u8(Pixels.val[0])), vmovl_u8(vget_low_u8(Pixels.val[1])),
+                    vmovl_u8(vget_low_u8(Pixels.val[2])), Out + Col * 4);
+                ApplyColorLut8(L, vmovl_u8(vget_high_u8(Pixels.val[0])), vmovl_u8(vget_high_u8(Pixels.val[1])),
+                    vmovl_u8(vget_high_u8(Pixels.val[2])), Out + Col * 4 + 32);
+                continue;
+            }
+            Pixels.val[3] = Alpha;
+            vst4q_u8(Out + Col * 4, Pixels);
+        }
+#elif CAMERA2_YUV_SSE2
+        // 8 pixels / 4 chroma samples per iteration; madd on (value, coefficient) pairs gives exact 32-bit sums
+        const __m128i Zero = _mm_setzero_si128();
+        const __m128i One = _mm_set1_epi16(1);
+        const __m128i Bias = _mm_set1_epi16(128);
+        const __m128i YOffset = _mm_set1_epi16(static_cast<int16>(M.YOffset));
+        const __m128i YCoeff = _mm_set_epi16(Round, M.YScale, Round, M.YScale, Round, M.YScale, Round, M.YScale);
+        const __m128i CoeffB = _mm_set_epi16(0, M.BU, 0, M.BU, 0, M.BU, 0, M.BU);
+        const __m128i CoeffG = _mm_set_epi16(M.GV, M.GU, M.GV, M.GU, M.GV, M.GU, M.GV, M.GU);
+        const __m128i CoeffR = _mm_set_epi16(M.RV, 0, M.RV, 0, M.RV, 0, M.RV, 0);
+        const __m128i Alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+        const FLutVectors L(Color.Lut);
+        for (; Col + 8 <= Count; Col += 8)
+        {
+            int32 U4, V4;
+            FMemory::Memcpy(&U4, URow + Col / 2, 4);
+            FMemory::Memcpy(&V4, VRow + Col / 2, 4);
+            const __m128i UV = _mm_sub_epi16(
+                _mm_unpacklo_epi8(_mm_unpacklo_epi8(_mm_cvtsi32_si128(U4), _mm_cvtsi32_si128(V4)), Zero), Bias);
+
+            const __m128i Y = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(YRow + Col)), Zero), YOffset);
+            const __m128i YTermLo = _mm_madd_epi16(_mm_unpacklo_epi16(Y, One), YCoeff);
+            const __m128i YTermHi = _mm_madd_epi16(_mm_unpackhi_epi16(Y, One), YCoeff);
+
+            // Each chroma sample covers two pixels
+            auto Channel = [&](const __m128i& Coeff) -> __m128i
+            {
+                const __m128i Chroma = _mm_madd_epi16(UV, Coeff);
+                const __m128i Lo = _mm_srai_epi32(_mm_add_epi32(YTermLo, _mm_unpacklo_epi32(Chroma, Chroma)), MatrixShift);
+                const __m128i Hi = _mm_srai_epi32(_mm_add_epi32(YTermHi, _mm_unpackhi_epi32(Chroma, Chroma)), MatrixShift);
+                const __m128i Packed = _mm_packs_epi32(Lo, Hi);
+                return _mm_packus_epi16(Packed, Packed);
+            };
+
+            const __m128i B = Channel(CoeffB);
+            const __m128i G = Channel(CoeffG);
+            const __m128i R = Channel(CoeffR);
+            if (bLut)
+            {
+                ApplyColorLut8(L, _mm_unpacklo_epi8(B, Zero), _mm_unpacklo_epi8(G, Zero), _mm_unpacklo_epi8(R, Zero), Out + Col * 4);
+                continue;
+            }
+            const __m128i BG = _mm_unpacklo_epi8(B, G);
+            const __m128i RA = _mm_unpacklo_epi8(R, Alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Col * 4), _mm_unpacklo_epi16(BG, RA));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Col * 4 + 16), _mm_unpackhi_epi16(BG, RA));
+        }
+#endif
+
+        for (; Col < Count; ++Col)
+        {
+            const int32 YTerm = M.YScale * (YRow[Col] - M.YOffset) + Round;
+            const int32 U = URow[Col / 2] - 128;
+            const int32 V = VRow[Col / 2] - 128;
+
+            uint8* P = Out + Col * 4;
+            P[0] = Clamp255((YTerm + M.BU * U) >> MatrixShift);
+            P[1] = Clamp255((YTerm + M.GU * U + M.GV * V) >> MatrixShift);
+            P[2] = Clamp255((YTerm + M.RV * V) >> MatrixShift);
+            P[3] = 255;
+            if (bLut)
+            {
+                ApplyColorLutPixel(Color.Lut, P);
+            }
+        }
+    }
+
+    static void PackBGRAToRGB565(const uint8* Bgra, int32 Count, uint16* Out)
+    {
+        int32 Col = 0;
+
+#if CAMERA2_YUV_NEON
+        for (; Col + 8 <= Count; Col += 8)
+        {
+            const uint8x8x4_t Pixels = vld4_u8(Bgra + Col * 4);
+            uint16x8_t Packed = vshll_n_u8(Pixels.val[2], 8);
+            Packed = vsriq_n_u16(Packed, vshll_n_u8(Pixels.val[1], 8), 5);
+            Packed = vsriq_n_u16(Packed, vshll_n_u8(Pixels.val[0], 8), 11);
+            vst1q_u16(Out + Col, Packed);
+        }
+#elif CAMERA2_YUV_SSE2
+        const __m128i MaskR = _mm_set1_epi32(0xF800);
+        const __m128i MaskG = _mm_set1_epi32(0x07E0);
+        const __m128i MaskB = _mm_set1_epi32(0x001F);
+        auto Pack4 = [&](const __m128i& Pixels) -> __m128i
+        {
+            const __m128i Packed = _mm_or_si128(_mm_or_si128(
+                _mm_and_si128(_mm_srli_epi32(Pixels, 8), MaskR),
+                _mm_and_si128(_mm_srli_epi32(Pixels, 5), MaskG)),
+                _mm_and_si128(_mm_srli_epi32(Pixels, 3), MaskB));
+            // Sign-extend so the signed 32 -> 16 pack keeps the bit pattern
+            return _mm_srai_epi32(_mm_slli_epi32(Packed, 16), 16);
+        };
+        for (; Col + 8 <= Count; Col += 8)
+        {
+            const __m128i Lo = Pack4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Bgra + Col * 4)));
+            const __m128i Hi = Pack4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Bgra + Col * 4 + 16)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Col), _mm_packs_epi32(Lo, Hi));
+        }
+#endif
+
+        for (; Col < Count; ++Col)
+        {
+            const uint8* P = Bgra + Col * 4;
+            Out[Col] = PackRGB565(P[2], P[1], P[0]);
+        }
+    }
+
+    void ConvertI420ToBGRA(const FI420View& Src, const FColorTransform& Color, uint8* Dst, int32 DstPitch, int32 RowBegin, int32 RowEnd)
+    {
+        const int32 ChromaWidth = (Src.Width + 1) / 2;
+
+        for (int32 Row = RowBegin; Row < RowEnd; ++Row)
+        {
+            const uint8* YRow = Src.Y + Row * Src.Width;
+            const uint8* URow = Src.U + (Row / 2) * ChromaWidth;
+            const uint8* VRow = Src.V + (Row / 2) * ChromaWidth;
+            ConvertRowToBGRA(Color, YRow, URow, VRow, Src.Width, Dst + Row * DstPitch);
+        }
+    }
+
+    void ConvertI420ToRGB565(const FI420View& Src, const FColorTransform& Color, uint8* Dst, int32 DstPitch, int32 RowBegin, int32 RowEnd)
+    {
+        const int32 ChromaWidth = (Src.Width + 1) / 2;
+        alignas(16) uint8 Chunk[ChunkPixels * 4];
+
+        for (int32 Row = RowBegin; Row < RowEnd; ++Row)
+        {
+            const uint8* YRow = Src.Y + Row * Src.Width;
+            const uint8* URow = Src.U + (Row / 2) * ChromaWidth;
+            const uint8* VRow = Src.V + (Row / 2) * ChromaWidth;
+            uint16* Out = reinterpret_cast<uint16*>(Dst + Row * DstPitch);
+
+            for (int32 Col = 0; Col < Src.Width; Col += ChunkPixels)
+            {
+                const int32 Count = FMath::Min(ChunkPixels, Src.Width - Col);
+                ConvertRowToBGRA(Color, YRow + Col, URow + Col / 2, VRow + Col / 2, Count, Chunk);
+                PackBGRAToRGB565(Chunk, Count, Out + Col);
+            }
+        }
+    }
+
+    void PackI420ToNV12(const FI420View& Src, uint8* Dst, int32 DstPitch, int32 RowBegin, int32 RowEnd)
+    {
+        const int32 ChromaWidth = (Src.Width + 1) / 2;
+
+        for (int32 Row = RowBegin; Row < RowEnd; ++Row)
+        {
+            uint8* LumaRow = Dst + Row * DstPitch;
+            FMemory::Memcpy(LumaRow, Src.Y + Row * Src.Width, Src.Width);
+            // Odd widths pad each luma row to the chroma pair width; repeat the edge pixel so sampling past it stays clean
+            if (Src.Width & 1)
+            {
+                LumaRow[Src.Width] = LumaRow[Src.Width - 1];
+            }
+            if (Row & 1)
+            {
+                continue;
+            }
+
+            const uint8* URow = Src.U + (Row / 2) * ChromaWidth;
+            const uint8* VRow = Src.V + (Row / 2) * ChromaWidth;
+            uint8* Out = Dst + (Src.Height + Row / 2) * DstPitch;
+            int32 Col = 0;
+
+#if CAMERA2_YUV_NEON
+            for (; Col + 16 <= ChromaWidth; Col += 16)
+            {
+                uint8x16x2_t UV;
+                UV.val[0] = vld1q_u8(URow + Col);
+                UV.val[1] = vld1q_u8(VRow + Col);
+                vst2q_u8(Out + Col * 2, UV);
+            }
+#elif CAMERA2_YUV_SSE2
+            for (; Col + 16 <= ChromaWidth; Col += 16)
+            {
+                const __m128i U = _mm_loadu_si128(reinterpret_cast<const __m128i*>(URow + Col));
+                const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(VRow + Col));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Col * 2), _mm_unpacklo_epi8(U, V));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Col * 2 + 16), _mm_unpackhi_epi8(U, V));
+            }
+#endif
+
+            for (; Col < ChromaWidth; ++Col)
+            {
+                Out[Col * 2] = URow[Col];
+                Out[Col * 2 + 1] = VRow[Col];
+            }
+        }
+    }
+
+    void CopyPlane(const uint8* Src, int32 RowStride, int32 PixelStride, int32 Width, int32 Height, uint8* Dst)
+    {
+        for (int32 Row = 0; Row < Height; ++Row)
+        {
+            const uint8* SrcRow = Src + Row * RowStride;
+            uint8* DstRow = Dst + Row * Width;
+            if (PixelStride == 1)
+            {
+                FMemory::Memcpy(DstRow, SrcRow, Width);
+            }
+            else
+            {
+                for (int32 Col = 0; Col < Width; ++Col)
+                {
+                    DstRow[Col] = SrcRow[Col * PixelStride];
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera2Types.h"
+#include "Camera2ColorTransform.h"
+
+/**
+ * YUV_420_888 conversion kernels used by the native frame pipeline.
+ * Sources are tightly packed I420 planes (chroma at half resolution in both directions).
+ * Kernels have NEON (arm64) and SSE2 (x64) paths with a scalar tail; all paths produce bit-identical output.
+ */
+namespace Camera2Yuv
+{
+    struct FI420View
+    {
+        const uint8* Y = nullptr;
+        const uint8* U = nullptr;
+        const uint8* V = nullptr;
+        int32 Width = 0;
+        int32 Height = 0;
+    };
+
+    /** Texture allocation and upload layout for an output format */
+    struct FOutputLayout
+    {
+        EPixelFormat PixelFormat = PF_B8G8R8A8;
+        int32 TextureWidth = 0;
+        int32 TextureHeight = 0;
+        int32 Pitch = 0;
+
+        int32 GetSizeBytes() const { return Pitch * TextureHeight; }
+    };
+
+    FOutputLayout GetOutputLayout(ECamera2OutputFormat Format, int32 Width, int32 Height);
+
+    /** Fill a whole output buffer (GetOutputLayout size) with dark gray in the given format */
+    void ClearToGray(ECamera2OutputFormat Format, int32 Width, int32 Height, uint8* Dst);
+
+    /** YUV -> BGRA8 through the color transform for rows [RowBegin, RowEnd); Dst points at the first output row of the image */
+    void ConvertI420ToBGRA(const FI420View& Src, const FColorTransform& Color, uint8* Dst, int32 DstPitch, int32 RowBegin, int32 RowEnd);
+
+    /** YUV -> RGB565 (R in the high bits) through the color transform for rows [RowBegin, RowEnd) */
+    void ConvertI420ToRGB565(const FI420View& Src, const FColorTransform& Color, uint8* Dst, int32 DstPitch, int32 RowBegin, int32 RowEnd);
+
+    /** Apply the LUT in place to BGRA8 pixels (alpha is preserved as 255); the conversions above apply it themselves */
+    void ApplyColorLut(const FColorLut& Lut, uint8* Bgra, int32 NumPixels);
+
+    /**
+     * I420 -> NV12 for rows [RowBegin, RowEnd) (RowBegin even). Luma rows go to the top of Dst, the
+     * interleaved chroma row of each even row goes below the Height luma rows. With an odd Width the luma
+     * padding byte repeats the last pixel.
+     */
+    void PackI420ToNV12(const FI420View& Src, uint8* Dst, int32 DstPitch, int32 RowBegin, int32 RowEnd);
+
+    /**
+     * Copy one plane out of an ImageReader buffer into a tight destination.
+     * PixelStride 2 gathers every other byte (semi-planar chroma).
+     */
+    void CopyPlane(const uint8* Src, int32 RowStride, int32 PixelStride, int32 Width, int32 Height, uint8* Dst);
+}
@@ -7,6 +7,22 @@
 #include "RHI.h"
 #include "RHICommandList.h"
 #include "Rendering/Texture2DResource.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/CoreDelegates.h"
+#include "Containers/Ticker.h"
+#include "Camera2MetadataRing.h"
+#include "Camera2FramePipeline.h"
+#include "Camera2YuvConvert.h"
+#include "Camera2ClockMapper.h"
+#include "Camera2FeatureDetector.h"
+#include "Camera2MarkerDetector.h"
+#include "Camera2Calibration.h"
+#include "Camera2PreviewStreamer.h"
+#include "Camera2FrameMemory.h"
+#include "Camera2Trace.h"
+#include <atomic>
 
 DEFINE_LOG_CATEGORY(LogSimpleCamera2);
 
@@ -20,9 +36,22 @@ DEFINE_LOG_CATEGORY(LogSimpleCamera2);
 
 
 // Static variables for camera preview
-static UTexture2D* CameraTexture = nullptr;
+static UTexture2D* CameraTexture = nullptr;   // latest uploaded texture of the set
 static bool bCameraPreviewActive = false;
 
+// Camera texture set rotated per upload, and material parameters following the latest one
+static int32 GCameraTextureBufferCount = 1;
+static ECamera2OutputFormat GOutputFormat = ECamera2OutputFormat::BGRA8;
+static TArray<UTexture2D*> GCameraTextures;
+// Budget held for each texture of the set (texel data by layout), released with the textures
+static TArray<Camera2Memory::FReservation> GCameraTextureReservations;
+struct FCameraTextureBinding
+{
+    TWeakObjectPtr<UMaterialInstanceDynamic> Material;
+    FName ParameterName;
+};
+static TArray<FCameraTextureBinding> GCameraTextureBindings;
+
 // Intrinsics storage (pixels)
 static float GCameraFx = 0.0f;
 static float GCameraFy = 0.0f;
@@ -40,10 +69,156 @@ static int32 GLensDistortionLength = 0;
 static int32 GOriginalResolutionWidth = 0;
 static int32 GOriginalResolutionHeight = 0;
 
+// SENSOR_INFO_ACTIVE_ARRAY_SIZE and SENSOR_INFO_PRE_CORRECTION_ACTIVE_ARRAY_SIZE (pixel array coordinates)
+static FIntRect GActiveArray;
+static FIntRect GPreCorrectionArray;
+
+// Per-pixel ray tables, built on first request for a stream's current intrinsics (the table's source)
+static FCriticalSection GRayTableLock;
+static TSharedPtr<const FCamera2RayTable, ESPMode::ThreadSafe> GRayTables[FCamera2FramePipeline::MaxStreams];
+static TSharedPtr<const FCamera2StreamIntrinsics, ESPMode::ThreadSafe> GRayTableSources[FCamera2FramePipeline::MaxStreams];
+
 // JSON dump of full CameraCharacteristics
 static FString GCameraCharacteristicsJson;
 static FString GCameraCharacteristicsJsonPath;
 
+// ImageReader queue configuration (applied on the next StartCameraPreview)
+static int32 GImageQueueMaxImages = 2;
+static ECamera2FrameConsumption GImageQueueConsumption = ECamera2FrameConsumption::LatestOnly;
+
+// Pipeline counters pushed from Camera2Helper on its background thread
+static std::atomic<int64> GStatCapturesCompleted{0};
+static std::atomic<int64> GStatFramesDelivered{0};
+static std::atomic<int64> GStatQueueDrops{0};
+static std::atomic<int64> GStatSensorDrops{0};
+static std::atomic<int64> GStatBuffersLost{0};
+static std::atomic<int32> GStatMaxImages{0};
+static std::atomic<bool> GStatInOrder{false};
+
+// Stream size selected by Camera2Helper
+static int32 GStreamWidth = 1280;
+static int32 GStreamHeight = 960;
+
+// High-speed session request and what the session actually runs at
+static bool bHighSpeedRequested = false;
+static int32 GHighSpeedTargetFps = 120;
+static std::atomic<bool> GStatHighSpeedSession{false};
+static std::atomic<int32> GStatTargetFps{0};
+static std::atomic<bool> GStatSessionFailed{false};
+
+// Extra analysis outputs requested for the session (stream id = index + 1)
+struct FAnalysisStreamRequest
+{
+    FIntPoint Size;
+    bool bLumaOnly;
+};
+static TArray<FAnalysisStreamRequest> GAnalysisStreamRequests;
+
+// Color stage of the display conversion; the DataSpace is reported by Camera2Helper per session
+static FCamera2ColorConfig GColorConfig;
+static std::atomic<int32> GStreamDataSpace{0};
+static FString GLoadedLutPath;
+static Camera2Yuv::FColorLut GLoadedLut;
+static void ApplyColorConfig();
+
+// Manual capture controls (pushed to Java on change and on every start)
+static FCamera2CaptureControls GCaptureControls;
+
+// Recent capture results (Camera2Helper background thread only)
+static FCamera2MetadataRing GMetadataRing;
+
+// Sensor clock -> engine clock estimate fed by onCaptureStarted (Camera2Helper background thread)
+static FCamera2ClockMapper GClockMapper;
+static std::atomic<int32> GSensorTimestampSource{-1};
+
+// Optional FAST keypoint stage registered as a consumer of one stream. The config, scratch buffers and work
+// result belong to the detecting worker; SetFeatureDetection only changes them while the consumer is removed
+// (RemoveConsumer waits for a running detection). GFeatureLock guards the published result only.
+static FCamera2FeatureConfig GFeatureConfig;
+static int32 GFeatureStreamId = INDEX_NONE;
+static FDelegateHandle GFeatureConsumerHandle;
+static Camera2Features::FDetectorScratch GFeatureScratch;
+static FCamera2KeypointFrame GFeatureWorkResult;
+static FCriticalSection GFeatureLock;
+static FCamera2KeypointFrame GLatestKeypoints;
+static FOnCamera2Keypoints GOnKeypoints;
+
+// Optional fiducial marker stage, owned like the keypoint stage. GMarkerLock guards the published result only.
+static FCamera2MarkerConfig GMarkerConfig;
+static int32 GMarkerStreamId = INDEX_NONE;
+static FDelegateHandle GMarkerConsumerHandle;
+static Camera2Markers::FDictionary GMarkerDictionary;
+static Camera2Markers::FDetectorScratch GMarkerScratch;
+static TArray<Camera2Markers::FMarkerDetection> GMarkerDetections;
+static int64 GMarkerFrameCount = 0;
+static FCamera2MarkerFrame GMarkerWorkResult;
+static FCriticalSection GMarkerLock;
+static FCamera2MarkerFrame GLatestMarkers;
+static FOnCamera2Markers GOnMarkers;
+
+// Optional preview streamer, a consumer of one stream; its stats text is refreshed by a core ticker (game thread)
+static TUniquePtr<FCamera2PreviewStreamer> GPreviewStreamer;
+static int32 GStreamingStreamId = INDEX_NONE;
+static FDelegateHandle GStreamingConsumerHandle;
+static FTSTicker::FDelegateHandle GStreamingStatsTicker;
+
+// Full-resolution still output, declared on every start like the analysis streams. A request completes once
+// both its image (still reader thread) and its capture result (Camera2Helper background thread) arrived;
+// GStillLock guards the pending requests and the latest still.
+struct FPendingStill
+{
+    int32 RequestId = INDEX_NONE;
+    ECamera2StillFormat Format = ECamera2StillFormat::Jpeg;
+    double RequestSeconds = 0.0;
+    bool bHasResult = false;
+    FCamera2FrameMetadata Metadata;
+    TSharedPtr<FCamera2StillImage, ESPMode::ThreadSafe> Image;
+    // Budget held for Image's data, passed on to GLatestStillReservation
+    Camera2Memory::FReservation Reservation;
+};
+// Matches the still ImageReader depth
+static constexpr int32 MaxPendingStills = 2;
+static bool GStillRequested = false;
+static FCamera2StillConfig GStillConfig;
+static FIntPoint GStillSize = FIntPoint::ZeroValue; // accepted for the running session, game thread only
+static FCriticalSection GStillLock;
+static TArray<FPendingStill, TInlineAllocator<MaxPendingStills>> GPendingStills;
+static int32 GNextStillRequestId = 1;
+static TSharedPtr<FCamera2StillImage, ESPMode::ThreadSafe> GLatestStill;
+static Camera2Memory::FReservation GLatestStillReservation; // released when TakeLatestStill hands the data out
+static FCamera2StreamIntrinsics GStillIntrinsics;
+static FOnCamera2StillCaptured GOnStillCaptured;
+static void CompleteStill(FPendingStill&& Pending, bool bSuccess);
+
+// Metadata of the last frame enqueued to the texture (game thread only)
+static FCamera2FrameMetadata GLatestFrameMetadata;
+static FOnCamera2FrameReady GOnFrameReady;
+
+// Pause/resume state and time to first frame of the last start or resume (game thread only)
+static bool bPreviewPaused = false;
+static bool bPauseOnBackground = true;
+static bool bPausedForBackground = false;
+static bool bLifecycleHooksRegistered = false;
+static ECamera2ResumeMode GLastStartMode = ECamera2ResumeMode::ColdStart;
+static double GStartRequestSeconds = 0.0;
+static bool bAwaitingFirstFrame = false;
+static float GTimeToFirstFrameMs = 0.0f;
+
+static void BeginFirstFrameTiming(ECamera2ResumeMode Mode, double RequestSeconds)
+{
+    GLastStartMode = Mode;
+    GStartRequestSeconds = RequestSeconds;
+    GTimeToFirstFrameMs = 0.0f;
+    bAwaitingFirstFrame = true;
+}
+
+static void RegisterLifecycleHooks();
+
+// Camera2Helper.resumeCamera results
+static constexpr int32 JavaResumeFailed = 0;
+static constexpr int32 JavaResumeWarmSession = 1;
+static constexpr int32 JavaResumeReopen = 2;
+
 #if PLATFORM_ANDROID
 static jobject Camera2HelperInstance = nullptr;
 
@@ -170,23 +345,151 @@ static bool EnsureCamera2HelperInstance(JNIEnv* Env)
 
 	return bSuccess;
 }
+
+// CaptureRequest mode constant for NOISE_REDUCTION_MODE / EDGE_MODE, -1 keeps the template default
+static jint ToCamera2ProcessingMode(ECamera2ProcessingMode Mode)
+{
+	switch (Mode)
+	{
+	case ECamera2ProcessingMode::Off:         return 0; // *_MODE_OFF
+	case ECamera2ProcessingMode::Fast:        return 1; // *_MODE_FAST
+	case ECamera2ProcessingMode::HighQuality: return 2; // *_MODE_HIGH_QUALITY
+	default:                                  return -1;
+	}
+}
+
+static void PushCaptureControls(JNIEnv* Env)
+{
+	if (!Env || !Camera2HelperInstance)
+	{
+		return;
+	}
+
+	jclass HelperClass = Env->GetObjectClass(Camera2HelperInstance);
+	if (!HelperClass)
+	{
+		return;
+	}
+
+	jmethodID SetControlsMethod = Env->GetMethodID(HelperClass, "setCaptureControls", "(ZZZZJIJIIII)V");
+	if (SetControlsMethod)
+	{
+		const FCamera2CaptureControls& C = GCaptureControls;
+		Env->CallVoidMethod(Camera2HelperInstance, SetControlsMethod,
+			C.bAeLock ? JNI_TRUE : JNI_FALSE,
+			C.bAfLock ? JNI_TRUE : JNI_FALSE,
+			C.bAwbLock ? JNI_TRUE : JNI_FALSE,
+			C.bManualExposure ? JNI_TRUE : JNI_FALSE,
+			(jlong)C.ExposureTimeNs,
+			(jint)C.Sensitivity,
+			(jlong)C.FrameDurationNs,
+			ToCamera2ProcessingMode(C.NoiseReduction),
+			ToCamera2ProcessingMode(C.EdgeEnhancement),
+			(jint)C.FpsRangeMin,
+			(jint)C.FpsRangeMax);
+	}
+
+	if (Env->ExceptionCheck())
+	{
+		Env->ExceptionDescribe();
+		Env->ExceptionClear();
+	}
+	Env->DeleteLocalRef(HelperClass);
+}
 #endif
 
 
 
 // JNI callback for real Camera2 frames
 #if PLATFORM_ANDROID
+// RGBA copies of the grayscale fallback queued for the game and render threads
+static constexpr int32 MaxLegacyFramesInFlight = 2;
+static Camera2Memory::FInFlightBuffers GLegacyFrames(Camera2Memory::EPool::Uploads, MaxLegacyFramesInFlight);
+
+static void FreeLegacyFrame(uint8* Data, int32 DataSize)
+{
+    GLegacyFrames.Free(Data, DataSize);
+}
+
+// A grayscale frame copied before its capture result arrived, held until the result does (Camera2Helper
+// background thread; the game thread frees it only once that thread has stopped)
+struct FLegacyWaitingFrame
+{
+    uint8* Data = nullptr;
+    int32 Width = 0;
+    int32 Height = 0;
+    FCamera2FrameMetadata Metadata;
+};
+static FLegacyWaitingFrame GLegacyWaitingFrame;
+
+// Queue a frame copy for the game and render threads, which take ownership of it
+static void DispatchLegacyFrame(uint8* FrameDataCopy, int32 width, int32 height, const FCamera2FrameMetadata& Metadata)
+{
+    static bool bLoggedFirstUpload = false;
+    const int32 DataSize = width * height * 4;
+
+    // Helper: enqueue render-thread texture update taking ownership of buffer
+    auto EnqueueTextureUpdateOwned = [](UTexture2D* Texture, uint8* OwnedBuffer, int32 W, int32 H)
+    {
+        if (!Texture || !Texture->GetResource())
+        {
+            FreeLegacyFrame(OwnedBuffer, W * H * 4);
+            return;
+        }
+        FTexture2DResource* TextureResource = static_cast<FTexture2DResource*>(Texture->GetResource());
+        const uint32 SrcPitch = static_cast<uint32>(W) * 4u;
+        FUpdateTextureRegion2D Region(0, 0, 0, 0, static_cast<uint32>(W), static_cast<uint32>(H));
+        ENQUEUE_RENDER_COMMAND(UpdateCameraTexture2D)(
+            [TextureResource, Region, OwnedBuffer, SrcPitch](FRHICommandListImmediate& RHICmdList)
+            {
+                RHICmdList.UpdateTexture2D(TextureResource->GetTexture2DRHI(), 0, Region, SrcPitch, OwnedBuffer);
+                FreeLegacyFrame(OwnedBuffer, static_cast<int32>(SrcPitch) * static_cast<int32>(Region.Height));
+            });
+    };
+
+    // Update texture on game thread, then enqueue render update
+    AsyncTask(ENamedThreads::Type::GameThread, [FrameDataCopy, width, height, DataSize, EnqueueTextureUpdateOwned, Metadata]()
+    {
+        if (CameraTexture)
+        {
+            EnqueueTextureUpdateOwned(CameraTexture, FrameDataCopy, width, height);
+            GLatestFrameMetadata = Metadata;
+            GOnFrameReady.Broadcast(Metadata);
+            if (!bLoggedFirstUpload)
+            {
+                UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera2 frame enqueued to render thread: %dx%d, DataSize: %d"), width, height, DataSize);
+            }
+        }
+        else
+        {
+            FreeLegacyFrame(FrameDataCopy, DataSize);
+        }
+        bLoggedFirstUpload = true;
+    });
+}
+
+// Hand over the waiting frame (if any) with whatever metadata it has
+static void DispatchLegacyWaitingFrame()
+{
+    if (GLegacyWaitingFrame.Data)
+    {
+        DispatchLegacyFrame(GLegacyWaitingFrame.Data, GLegacyWaitingFrame.Width, GLegacyWaitingFrame.Height, GLegacyWaitingFrame.Metadata);
+        GLegacyWaitingFrame = FLegacyWaitingFrame();
+    }
+}
+
 extern "C" JNIEXPORT void JNICALL
 Java_com_epicgames_ue4_Camera2Helper_onFrameAvailable(JNIEnv* env, jclass clazz, 
-    jbyteArray data, jint width, jint height)
+    jbyteArray data, jint width, jint height, jlong timestampNs)
 {
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 JNI Handoff"));
     static bool bCamera2LogsOnce = false;
     if (!bCamera2LogsOnce)
     {
         UE_LOG(LogSimpleCamera2, Log, TEXT("Camera2 frame received: %dx%d"), width, height);
     }
     
-    if (!CameraTexture || !data)
+    if (!CameraTexture || !data || CameraTexture->GetPixelFormat() != PF_B8G8R8A8)
     {
         if (!bCamera2LogsOnce)
         {
@@ -208,9 +511,15 @@ Java_com_epicgames_ue4_Camera2Helper_onFrameAvailable(JNIEnv* env, jclass clazz,
         return;
     }
     
-    // Copy frame data to avoid issues with async access
+    // Copy frame data to avoid issues with async access. The copy lives until its render command ran; beyond
+    // MaxLegacyFramesInFlight copies or the frame memory budget the frame is dropped instead of queued.
     int32 DataSize = width * height * 4;
-    uint8* FrameDataCopy = new uint8[DataSize];
+    uint8* FrameDataCopy = GLegacyFrames.TryAllocate(DataSize);
+    if (!FrameDataCopy)
+    {
+        env->ReleaseByteArrayElements(data, frameData, JNI_ABORT);
+        return;
+    }
     FMemory::Memcpy(FrameDataCopy, frameData, DataSize);
     
     // Check first few bytes of frame data
@@ -223,43 +532,26 @@ Java_com_epicgames_ue4_Camera2Helper_onFrameAvailable(JNIEnv* env, jclass clazz,
     
     // Release Java array immediately
     env->ReleaseByteArrayElements(data, frameData, JNI_ABORT);
-        
-    // Helper: enqueue render-thread texture update taking ownership of buffer
-    auto EnqueueTextureUpdateOwned = [](UTexture2D* Texture, uint8* OwnedBuffer, int32 W, int32 H)
-    {
-        if (!Texture || !Texture->GetResource())
-        {
-            if (OwnedBuffer) { delete[] OwnedBuffer; }
-            return;
-        }
-        FTexture2DResource* TextureResource = static_cast<FTexture2DResource*>(Texture->GetResource());
-        const uint32 SrcPitch = static_cast<uint32>(W) * 4u;
-        FUpdateTextureRegion2D Region(0, 0, 0, 0, static_cast<uint32>(W), static_cast<uint32>(H));
-        ENQUEUE_RENDER_COMMAND(UpdateCameraTexture2D)(
-            [TextureResource, Region, OwnedBuffer, SrcPitch](FRHICommandListImmediate& RHICmdList)
-            {
-                RHICmdList.UpdateTexture2D(TextureResource->GetTexture2DRHI(), 0, Region, SrcPitch, OwnedBuffer);
-                delete[] OwnedBuffer;
-            });
-    };
 
-    // Update texture on game thread, then enqueue render update
-    AsyncTask(ENamedThreads::Type::GameThread, [FrameDataCopy, width, height, DataSize, EnqueueTextureUpdateOwned]()
+    // A frame still waiting for its result is older than this one; it goes on without it
+    DispatchLegacyWaitingFrame();
+
+    // Match the capture result for this frame (copied by value, no allocation)
+    FCamera2FrameMetadata Metadata;
+    if (!GMetadataRing.Find(timestampNs, Metadata))
     {
-        if (CameraTexture)
-        {
-            EnqueueTextureUpdateOwned(CameraTexture, FrameDataCopy, width, height);
-            if (!bCamera2LogsOnce)
-            {
-                UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera2 frame enqueued to render thread: %dx%d, DataSize: %d"), width, height, DataSize);
-            }
-        }
-        else
-        {
-            delete[] FrameDataCopy;
-        }
+        // The result usually follows the image shortly; onCaptureMetadataAvailable hands the frame over
+        Metadata.SensorTimestampNs = timestampNs;
+        GLegacyWaitingFrame.Data = FrameDataCopy;
+        GLegacyWaitingFrame.Width = width;
+        GLegacyWaitingFrame.Height = height;
+        GLegacyWaitingFrame.Metadata = Metadata;
         bCamera2LogsOnce = true;
-    });
+        return;
+    }
+
+    DispatchLegacyFrame(FrameDataCopy, width, height, Metadata);
+    bCamera2LogsOnce = true;
 }
 #endif
 
@@ -378,12 +670,18 @@ Java_com_epicgames_ue4_Camera2Helper_onPixelArraySizeAvailable(JNIEnv* env, jcla
     }
 }
 
-// JNI callback for SENSOR_INFO_ACTIVE_ARRAY_SIZE
+// JNI callback for SENSOR_INFO_ACTIVE_ARRAY_SIZE and SENSOR_INFO_PRE_CORRECTION_ACTIVE_ARRAY_SIZE (the
+// coordinate system of LENS_INTRINSIC_CALIBRATION), both relative to the pixel array
 extern "C" JNIEXPORT void JNICALL
 Java_com_epicgames_ue4_Camera2Helper_onActiveArraySizeAvailable(JNIEnv* env, jclass clazz,
-    jint width, jint height)
+    jint left, jint top, jint width, jint height, jint preCorrectionLeft, jint preCorrectionTop,
+    jint preCorrectionWidth, jint preCorrectionHeight)
 {
-    UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera2 active array size: %dx%d"), width, height);
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera2 active array: %dx%d at (%d,%d), pre-correction %dx%d at (%d,%d)"),
+        width, height, left, top, preCorrectionWidth, preCorrectionHeight, preCorrectionLeft, preCorrectionTop);
+    GActiveArray = FIntRect(left, top, left + width, top + height);
+    GPreCorrectionArray = FIntRect(preCorrectionLeft, preCorrectionTop,
+        preCorrectionLeft + preCorrectionWidth, preCorrectionTop + preCorrectionHeight);
     if (GEngine)
     {
         GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Silver,
@@ -459,157 +757,993 @@ Java_com_epicgames_ue4_Camera2Helper_onOriginalResolutionAvailable(JNIEnv* env,
             FString::Printf(TEXT("Original Resolution: %dx%d"), width, height));
     }
 }
-#endif
 
-bool USimpleCamera2Test::StartCameraPreview()
+// JNI callback for YUV_420_888 / Y8 images of any stream; plane buffers are direct ByteBuffers read in place.
+// uBuffer/vBuffer are null for luma-only analysis streams.
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onYuvFrameAvailable(JNIEnv* env, jclass clazz,
+    jint streamId, jobject yBuffer, jobject uBuffer, jobject vBuffer, jint width, jint height,
+    jint yRowStride, jint uvRowStride, jint uvPixelStride, jlong timestampNs)
 {
-    UE_LOG(LogSimpleCamera2, Warning, TEXT("=== StartCameraPreview CALLED FROM BLUEPRINT ==="));
-    
-    if (GEngine)
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 JNI Handoff"));
+    if (streamId < 0 || streamId >= FCamera2FramePipeline::MaxStreams)
     {
-        GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red, TEXT("StartCameraPreview CALLED"));
+        return;
     }
-    
-#if PLATFORM_ANDROID
-    UE_LOG(LogSimpleCamera2, Warning, TEXT("Starting real Camera2 preview on Android"));
-    
-    // Auto-request camera permissions if not granted
-    JNIEnv* Env = FAndroidApplication::GetJavaEnv();
-    if (Env)
+    if (streamId == FCamera2FramePipeline::DisplayStreamId && !CameraTexture)
     {
-        // Check and request permissions
-        jobject Activity = FAndroidApplication::GetGameActivityThis();
-        if (Activity)
-        {
-            UE_LOG(LogSimpleCamera2, Warning, TEXT("Checking camera permissions..."));
-            
-            // Get the Activity class and checkSelfPermission method
-            jclass ActivityClass = Env->GetObjectClass(Activity);
-            jmethodID CheckPermMethod = Env->GetMethodID(ActivityClass, 
-                "checkSelfPermission", "(Ljava/lang/String;)I");
-            jmethodID RequestPermMethod = Env->GetMethodID(ActivityClass,
-                "requestPermissions", "([Ljava/lang/String;I)V");
-            
-            if (CheckPermMethod && RequestPermMethod)
-            {
-                // Check CAMERA permission
-                jstring CameraPermStr = Env->NewStringUTF("android.permission.CAMERA");
-                jint CameraPermResult = Env->CallIntMethod(Activity, CheckPermMethod, CameraPermStr);
-                
-                // PackageManager.PERMISSION_GRANTED = 0
-                if (CameraPermResult != 0)
-                {
-                    UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera permission not granted, requesting..."));
-                    
-                    // Create permission array
-                    jobjectArray PermArray = Env->NewObjectArray(3, 
-                        Env->FindClass("java/lang/String"), nullptr);
-                    
-                    jstring Perm1 = Env->NewStringUTF("android.permission.CAMERA");
-                    jstring Perm2 = Env->NewStringUTF("horizonos.permission.HEADSET_CAMERA");
-                    jstring Perm3 = Env->NewStringUTF("horizonos.permission.AVATAR_CAMERA");
-                    
-                    Env->SetObjectArrayElement(PermArray, 0, Perm1);
-                    Env->SetObjectArrayElement(PermArray, 1, Perm2);
-                    Env->SetObjectArrayElement(PermArray, 2, Perm3);
-                    
-                    // Request permissions (request code = 1001)
-                    Env->CallVoidMethod(Activity, RequestPermMethod, PermArray, 1001);
-                    
-                    // Clean up
-                    Env->DeleteLocalRef(Perm1);
-                    Env->DeleteLocalRef(Perm2);
-                    Env->DeleteLocalRef(Perm3);
-                    Env->DeleteLocalRef(PermArray);
-                    
-                    UE_LOG(LogSimpleCamera2, Warning, TEXT("Permission request sent. User must grant permission and retry."));
-                    if (GEngine)
-                    {
-                        GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, 
-                            TEXT("Please grant camera permission and try again"));
-                    }
-                    
-                    Env->DeleteLocalRef(CameraPermStr);
-                    return false; // Return false, user needs to grant permission first
-                }
-                else
-                {
-                    UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera permission already granted"));
-                }
-                
-                Env->DeleteLocalRef(CameraPermStr);
-            }
-        }
+        return;
     }
-    
-    if (bCameraPreviewActive)
+
+    const uint8* YData = static_cast<const uint8*>(env->GetDirectBufferAddress(yBuffer));
+    const uint8* UData = uBuffer ? static_cast<const uint8*>(env->GetDirectBufferAddress(uBuffer)) : nullptr;
+    const uint8* VData = vBuffer ? static_cast<const uint8*>(env->GetDirectBufferAddress(vBuffer)) : nullptr;
+    if (!YData)
     {
-        UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera preview already active"));
-        return true;
+        return;
     }
-    
-    // Create texture for camera feed if not already created
-    UE_LOG(LogSimpleCamera2, Warning, TEXT("=== CHECKING CAMERA TEXTURE ==="));
-    if (!CameraTexture)
+
+    // Last row of a plane may be shorter than the row stride
+    const int64 YRequired = static_cast<int64>(yRowStride) * (height - 1) + width;
+    const int64 UVRequired = static_cast<int64>(uvRowStride) * ((height + 1) / 2 - 1) + static_cast<int64>(uvPixelStride) * ((width + 1) / 2 - 1) + 1;
+    if (env->GetDirectBufferCapacity(yBuffer) < YRequired
+        || (UData && env->GetDirectBufferCapacity(uBuffer) < UVRequired)
+        || (VData && env->GetDirectBufferCapacity(vBuffer) < UVRequired))
     {
-        UE_LOG(LogSimpleCamera2, Warning, TEXT("Creating new camera texture 1280x960"));
-        CameraTexture = UTexture2D::CreateTransient(1280, 960, PF_B8G8R8A8);
-        if (CameraTexture)
-        {
-            UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera texture created successfully"));
-            CameraTexture->AddToRoot(); // Prevent garbage collection
+        return;
+    }
 
-            // Initialize with dark pattern asynchronously
-            const int32 InitW = 1280;
-            const int32 InitH = 960;
-            const int32 InitSize = InitW * InitH * 4;
-            uint8* InitData = new uint8[InitSize];
-            FMemory::Memset(InitData, 64, InitSize); // Dark gray
+    // All streams share one capture result per frame
+    FCamera2FrameMetadata Metadata;
+    if (!GMetadataRing.Find(timestampNs, Metadata))
+    {
+        Metadata.SensorTimestampNs = timestampNs;
+    }
 
-            // Ensure resource is created before update
-            CameraTexture->UpdateResource();
-            AsyncTask(ENamedThreads::Type::GameThread, [InitData, InitW, InitH]()
-            {
-                if (CameraTexture)
-                {
-                    FTexture2DResource* TextureResource = static_cast<FTexture2DResource*>(CameraTexture->GetResource());
-                    if (TextureResource)
-                    {
-                        const uint32 Pitch = static_cast<uint32>(InitW) * 4u;
-                        FUpdateTextureRegion2D Region(0, 0, 0, 0, static_cast<uint32>(InitW), static_cast<uint32>(InitH));
-                        ENQUEUE_RENDER_COMMAND(InitCameraTexture2D)(
-                            [TextureResource, Region, InitData, Pitch](FRHICommandListImmediate& RHICmdList)
-                            {
-                                RHICmdList.UpdateTexture2D(TextureResource->GetTexture2DRHI(), 0, Region, Pitch, InitData);
-                                delete[] InitData;
-                            });
-                    }
-                    else
-                    {
-                        delete[] InitData;
-                    }
-                }
-                else
-                {
-                    delete[] InitData;
-                }
-            });
-        }
+    double SensorEngineSeconds, ErrorSeconds;
+    if (CAMERA2_TRACE_ENABLED() && GClockMapper.MapToEngineSeconds(timestampNs, SensorEngineSeconds, ErrorSeconds))
+    {
+        Camera2Trace::SetHandoffLatency(streamId, (FPlatformTime::Seconds() - SensorEngineSeconds) * 1000.0);
     }
-    
-    // Start real Camera2 using Camera2Helper
-    UE_LOG(LogSimpleCamera2, Warning, TEXT("=== STARTING JNI CAMERA2HELPER ACCESS ==="));
-    // Env already defined above, reuse it
-    if (Env)
+
+    FCamera2FramePipeline::Get(streamId).SubmitYuvFrame(YData, yRowStride, UData, VData, uvRowStride, uvPixelStride,
+        width, height, Metadata);
+}
+
+// JNI callback from startCamera (game thread) with the still output Camera2Helper added to the session, or
+// with accepted=false on its background thread when a rejected session drops it
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onStillCaptureConfigured(JNIEnv* env, jclass clazz,
+    jboolean accepted, jint format, jint width, jint height)
+{
+    if (accepted != JNI_TRUE)
     {
-        UE_LOG(LogSimpleCamera2, Warning, TEXT("JNI Environment obtained"));
-        jobject Activity = FAndroidApplication::GetGameActivityThis();
-        
-        if (Activity)
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("Still output rejected: not a guaranteed stream combination with the preview streams"));
+        GStillSize = FIntPoint::ZeroValue;
+        return;
+    }
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Still output configured: %dx%d %s"), width, height, format == 1 ? TEXT("YUV") : TEXT("JPEG"));
+    GStillSize = FIntPoint(width, height);
+}
+
+// JNI callback (Camera2Helper background thread) with the capture result of a still request; the result is
+// already in the metadata ring, which is only read on this thread
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onStillCaptureCompleted(JNIEnv* env, jclass clazz,
+    jint requestId, jlong sensorTimestampNs)
+{
+    FCamera2FrameMetadata Metadata;
+    if (!GMetadataRing.Find(sensorTimestampNs, Metadata))
+    {
+        Metadata.SensorTimestampNs = sensorTimestampNs;
+    }
+
+    FPendingStill Ready;
+    {
+        FScopeLock Lock(&GStillLock);
+        const int32 Index = GPendingStills.IndexOfByPredicate([requestId](const FPendingStill& Pending) { return Pending.RequestId == requestId; });
+        if (Index == INDEX_NONE)
         {
-            UE_LOG(LogSimpleCamera2, Warning, TEXT("Game Activity obtained"));
+            return;
         }
-        else
+        GPendingStills[Index].bHasResult = true;
+        GPendingStills[Index].Metadata = Metadata;
+        if (!GPendingStills[Index].Image.IsValid())
+        {
+            return;
+        }
+        Ready = MoveTemp(GPendingStills[Index]);
+        GPendingStills.RemoveAt(Index);
+    }
+    CompleteStill(MoveTemp(Ready), true);
+}
+
+// JNI callback (Camera2Helper background thread) when a still request failed or lost its still buffer
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onStillCaptureFailed(JNIEnv* env, jclass clazz, jint requestId)
+{
+    FPendingStill Failed;
+    {
+        FScopeLock Lock(&GStillLock);
+        const int32 Index = GPendingStills.IndexOfByPredicate([requestId](const FPendingStill& Pending) { return Pending.RequestId == requestId; });
+        if (Index == INDEX_NONE)
+        {
+            return;
+        }
+        Failed = MoveTemp(GPendingStills[Index]);
+        GPendingStills.RemoveAt(Index);
+    }
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("Still capture %d failed"), requestId);
+    CompleteStill(MoveTemp(Failed), false);
+}
+
+// Pending request a still image belongs to; requestId is -1 if the capture start was not seen yet and the oldest
+// request without an image is used then. GStillLock must be held.
+static int32 FindPendingStillForImage(int32 RequestId)
+{
+    int32 Index = GPendingStills.IndexOfByPredicate([RequestId](const FPendingStill& Pending) { return Pending.RequestId == RequestId; });
+    if (Index == INDEX_NONE && RequestId < 0)
+    {
+        Index = GPendingStills.IndexOfByPredicate([](const FPendingStill& Pending) { return !Pending.Image.IsValid(); });
+    }
+    return Index;
+}
+
+// A still image that cannot be copied fails its request right away instead of leaving it pending until stop
+static void FailStillImage(int32 RequestId, const TCHAR* Reason)
+{
+    FPendingStill Failed;
+    {
+        FScopeLock Lock(&GStillLock);
+        const int32 Index = FindPendingStillForImage(RequestId);
+        if (Index == INDEX_NONE)
+        {
+            return;
+        }
+        Failed = MoveTemp(GPendingStills[Index]);
+        GPendingStills.RemoveAt(Index);
+    }
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("Still capture %d failed: %s"), Failed.RequestId, Reason);
+    CompleteStill(MoveTemp(Failed), false);
+}
+
+// JNI callback on the still reader thread: copies the JPEG bytes or the YUV planes before Camera2Helper closes
+// the image
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onStillImageAvailable(JNIEnv* env, jclass clazz,
+    jint requestId, jint format, jobject yBuffer, jobject uBuffer, jobject vBuffer, jint dataOffset, jint dataLength,
+    jint width, jint height, jint yRowStride, jint uvRowStride, jint uvPixelStride, jlong timestampNs)
+{
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 Still Copy"));
+    const uint8* YData = static_cast<const uint8*>(env->GetDirectBufferAddress(yBuffer));
+    if (!YData || width <= 0 || height <= 0)
+    {
+        FailStillImage(requestId, TEXT("no image data"));
+        return;
+    }
+
+    // A still that does not fit in the frame memory budget completes as failed with empty Data
+    LLM_SCOPE_BYTAG(Camera2_Stills);
+    TSharedPtr<FCamera2StillImage, ESPMode::ThreadSafe> Image = MakeShared<FCamera2StillImage, ESPMode::ThreadSafe>();
+    Camera2Memory::FReservation Reservation;
+    Image->Size = FIntPoint(width, height);
+    if (format == 0)
+    {
+        if (dataOffset < 0 || dataLength <= 0 || env->GetDirectBufferCapacity(yBuffer) < static_cast<int64>(dataOffset) + dataLength)
+        {
+            FailStillImage(requestId, TEXT("JPEG range outside its buffer"));
+            return;
+        }
+        Image->Format = ECamera2StillFormat::Jpeg;
+        if (Reservation.Reserve(Camera2Memory::EPool::Stills, dataLength))
+        {
+            Image->Data.SetNumUninitialized(dataLength);
+            FMemory::Memcpy(Image->Data.GetData(), YData + dataOffset, dataLength);
+        }
+    }
+    else
+    {
+        const uint8* UData = uBuffer ? static_cast<const uint8*>(env->GetDirectBufferAddress(uBuffer)) : nullptr;
+        const uint8* VData = vBuffer ? static_cast<const uint8*>(env->GetDirectBufferAddress(vBuffer)) : nullptr;
+        const int32 ChromaWidth = (width + 1) / 2;
+        const int32 ChromaHeight = (height + 1) / 2;
+        const int64 YRequired = static_cast<int64>(yRowStride) * (height - 1) + width;
+        const int64 UVRequired = static_cast<int64>(uvRowStride) * (ChromaHeight - 1) + static_cast<int64>(uvPixelStride) * (ChromaWidth - 1) + 1;
+        if (!UData || !VData || env->GetDirectBufferCapacity(yBuffer) < YRequired
+            || env->GetDirectBufferCapacity(uBuffer) < UVRequired || env->GetDirectBufferCapacity(vBuffer) < UVRequired)
+        {
+            FailStillImage(requestId, TEXT("YUV planes smaller than their strides"));
+            return;
+        }
+        const int32 LumaSize = width * height;
+        const int32 ChromaSize = ChromaWidth * ChromaHeight;
+        Image->Format = ECamera2StillFormat::Yuv;
+        if (Reservation.Reserve(Camera2Memory::EPool::Stills, LumaSize + 2 * ChromaSize))
+        {
+            Image->Data.SetNumUninitialized(LumaSize + 2 * ChromaSize);
+            Camera2Yuv::CopyPlane(YData, yRowStride, 1, width, height, Image->Data.GetData());
+            Camera2Yuv::CopyPlane(UData, uvRowStride, uvPixelStride, ChromaWidth, ChromaHeight, Image->Data.GetData() + LumaSize);
+            Camera2Yuv::CopyPlane(VData, uvRowStride, uvPixelStride, ChromaWidth, ChromaHeight, Image->Data.GetData() + LumaSize + ChromaSize);
+        }
+    }
+    if (!Reservation.IsValid())
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("Still %d dropped: %dx%d does not fit in the frame memory budget"), requestId, width, height);
+        Camera2Memory::NoteBudgetDrop();
+    }
+
+    FPendingStill Ready;
+    {
+        FScopeLock Lock(&GStillLock);
+        const int32 Index = FindPendingStillForImage(requestId);
+        if (Index == INDEX_NONE)
+        {
+            return;
+        }
+        GPendingStills[Index].Image = MoveTemp(Image);
+        GPendingStills[Index].Reservation = MoveTemp(Reservation);
+        if (!GPendingStills[Index].bHasResult)
+        {
+            return;
+        }
+        Ready = MoveTemp(GPendingStills[Index]);
+        GPendingStills.RemoveAt(Index);
+    }
+    CompleteStill(MoveTemp(Ready), true);
+}
+
+// JNI callback when the display stream's Image DataSpace changes (first frame of a session at the latest)
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onStreamDataSpaceChanged(JNIEnv* env, jclass clazz,
+    jint streamId, jint dataSpace)
+{
+    if (streamId != FCamera2FramePipeline::DisplayStreamId || GStreamDataSpace.exchange(dataSpace) == dataSpace)
+    {
+        return;
+    }
+
+    AsyncTask(ENamedThreads::GameThread, []()
+    {
+        ApplyColorConfig();
+    });
+}
+
+// JNI callback from startCamera (game thread) for each analysis stream after validation against the
+// device's guaranteed stream combinations; the size may differ from the request (nearest supported).
+// Also called with accepted=false on the Camera2Helper background thread when the HAL rejects the session
+// and the stream is dropped to retry with the display stream alone.
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onAnalysisStreamConfigured(JNIEnv* env, jclass clazz,
+    jint streamId, jint width, jint height, jboolean lumaOnly, jboolean accepted)
+{
+    if (streamId <= FCamera2FramePipeline::DisplayStreamId || streamId >= FCamera2FramePipeline::MaxStreams)
+    {
+        return;
+    }
+
+    FCamera2FramePipeline& Pipeline = FCamera2FramePipeline::Get(streamId);
+    if (accepted != JNI_TRUE)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("Analysis stream %d (%dx%d) rejected: not a guaranteed stream combination on this device"),
+            streamId, width, height);
+        Pipeline.Shutdown();
+        return;
+    }
+
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Analysis stream %d configured: %dx%d%s"), streamId, width, height,
+        lumaOnly ? TEXT(" luma-only") : TEXT(""));
+    FCamera2FramePipeline::FConfig Config;
+    Config.bUploadToTexture = false;
+    Config.bLumaOnly = (lumaOnly == JNI_TRUE);
+    Pipeline.Configure(width, height, Config);
+    Pipeline.ResetStats();
+}
+
+// JNI callback from startCamera (game thread) with the stream size the ImageReader will use
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onStreamSizeSelected(JNIEnv* env, jclass clazz,
+    jint width, jint height, jint targetFps)
+{
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Camera2 stream size selected: %dx%d @ %d fps"), width, height, targetFps);
+    GStreamWidth = width;
+    GStreamHeight = height;
+    GStatSessionFailed.store(false, std::memory_order_relaxed);
+
+    // Deeper ring and parallel conversion once frames arrive faster than ~60 fps
+    FCamera2FramePipeline::FConfig Config;
+    Config.RingDepth = (targetFps > 60) ? 5 : 3;
+    Config.ConversionThreads = (targetFps > 60) ? 2 : 1;
+    Config.OutputFormat = GOutputFormat;
+    Config.bLumaOnly = (GOutputFormat == ECamera2OutputFormat::Luma);
+    FCamera2FramePipeline::Get().Configure(width, height, Config);
+}
+
+// JNI callback when the capture session is configured (regular or constrained high-speed)
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onSessionConfigured(JNIEnv* env, jclass clazz,
+    jboolean highSpeed, jint targetFps)
+{
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Camera2 session configured: %s, target %d fps"),
+        highSpeed ? TEXT("constrained high-speed") : TEXT("regular"), targetFps);
+    GStatHighSpeedSession.store(highSpeed == JNI_TRUE, std::memory_order_relaxed);
+    GStatTargetFps.store(targetFps, std::memory_order_relaxed);
+}
+
+// JNI callback (Camera2Helper background thread) when not even a display-only session could be configured
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onSessionConfigureFailed(JNIEnv* env, jclass clazz)
+{
+    UE_LOG(LogSimpleCamera2, Error, TEXT("Camera2 capture session rejected, even with the display stream alone: no frames will arrive until the preview is restarted"));
+    GStatSessionFailed.store(true, std::memory_order_relaxed);
+}
+
+// JNI callback for per-frame capture results (primitives only, stored in the preallocated ring)
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onCaptureMetadataAvailable(JNIEnv* env, jclass clazz,
+    jlong frameNumber, jlong sensorTimestampNs, jlong exposureTimeNs, jint sensitivity,
+    jlong frameDurationNs, jint aeState, jint afState, jfloat focusDistance, jlong rollingShutterSkewNs)
+{
+    FCamera2FrameMetadata Metadata;
+    Metadata.bValid = true;
+    Metadata.FrameNumber = frameNumber;
+    Metadata.SensorTimestampNs = sensorTimestampNs;
+    Metadata.ExposureTimeNs = exposureTimeNs;
+    Metadata.Sensitivity = sensitivity;
+    Metadata.FrameDurationNs = frameDurationNs;
+    Metadata.AeState = aeState;
+    Metadata.AfState = afState;
+    Metadata.LensFocusDistance = focusDistance;
+    Metadata.RollingShutterSkewNs = rollingShutterSkewNs;
+    GMetadataRing.Push(Metadata);
+
+    // Frames delivered before their result were held back for it
+    for (int32 StreamId = 0; StreamId < FCamera2FramePipeline::MaxStreams; ++StreamId)
+    {
+        FCamera2FramePipeline::Get(StreamId).ResolveMetadata(Metadata);
+    }
+    if (GLegacyWaitingFrame.Data && GLegacyWaitingFrame.Metadata.SensorTimestampNs <= sensorTimestampNs)
+    {
+        if (GLegacyWaitingFrame.Metadata.SensorTimestampNs == sensorTimestampNs)
+        {
+            GLegacyWaitingFrame.Metadata = Metadata;
+        }
+        DispatchLegacyWaitingFrame();
+    }
+}
+
+// JNI callback at the start of each exposure; pairs SENSOR_TIMESTAMP with the engine clock as early as possible
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onSensorClockSample(JNIEnv* env, jclass clazz, jlong sensorTimestampNs)
+{
+    GClockMapper.AddSample(sensorTimestampNs, FPlatformTime::Seconds());
+}
+
+// JNI callback from startCamera (game thread) with SENSOR_INFO_TIMESTAMP_SOURCE of the selected camera
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onSensorTimestampSourceAvailable(JNIEnv* env, jclass clazz, jint source)
+{
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Camera2 sensor timestamp source: %s"),
+        source == 1 ? TEXT("REALTIME") : TEXT("UNKNOWN"));
+    GSensorTimestampSource.store(source, std::memory_order_relaxed);
+}
+
+// JNI callback for frame delivery/drop counters (called once per delivered frame, primitives only)
+extern "C" JNIEXPORT void JNICALL
+Java_com_epicgames_ue4_Camera2Helper_onFrameStatsAvailable(JNIEnv* env, jclass clazz,
+    jlong capturesCompleted, jlong framesDelivered, jlong queueDrops, jlong sensorDrops,
+    jlong buffersLost, jint maxImages, jboolean inOrder)
+{
+    GStatCapturesCompleted.store(capturesCompleted, std::memory_order_relaxed);
+    GStatFramesDelivered.store(framesDelivered, std::memory_order_relaxed);
+    GStatQueueDrops.store(queueDrops, std::memory_order_relaxed);
+    GStatSensorDrops.store(sensorDrops, std::memory_order_relaxed);
+    GStatBuffersLost.store(buffersLost, std::memory_order_relaxed);
+    GStatMaxImages.store(maxImages, std::memory_order_relaxed);
+    GStatInOrder.store(inOrder == JNI_TRUE, std::memory_order_relaxed);
+    Camera2Trace::SetCaptureDrops(queueDrops, sensorDrops, buffersLost);
+}
+#endif
+
+// Point every bound material parameter at the latest camera texture (game thread)
+static void ApplyCameraTextureBindings()
+{
+    for (int32 i = GCameraTextureBindings.Num() - 1; i >= 0; --i)
+    {
+        UMaterialInstanceDynamic* Material = GCameraTextureBindings[i].Material.Get();
+        if (!Material)
+        {
+            GCameraTextureBindings.RemoveAtSwap(i);
+            continue;
+        }
+        Material->SetTextureParameterValue(GCameraTextureBindings[i].ParameterName, CameraTexture);
+    }
+}
+
+// Create a transient camera texture in the output format's layout and clear it to dark gray
+static UTexture2D* CreateClearedCameraTexture(int32 Width, int32 Height)
+{
+    const Camera2Yuv::FOutputLayout Layout = Camera2Yuv::GetOutputLayout(GOutputFormat, Width, Height);
+    UTexture2D* NewTexture = UTexture2D::CreateTransient(Layout.TextureWidth, Layout.TextureHeight, Layout.PixelFormat);
+    if (!NewTexture)
+    {
+        return nullptr;
+    }
+    NewTexture->AddToRoot(); // Prevent garbage collection
+
+    // Initialize with dark pattern asynchronously
+    const int32 InitW = Layout.TextureWidth;
+    const int32 InitH = Layout.TextureHeight;
+    const uint32 Pitch = static_cast<uint32>(Layout.Pitch);
+    // Skipped when the frame memory budget has no room; the first upload overwrites the texture anyway
+    const int64 InitSize = Layout.GetSizeBytes();
+    uint8* InitData = Camera2Memory::Allocate(Camera2Memory::EPool::Uploads, InitSize);
+    if (!InitData)
+    {
+        NewTexture->UpdateResource();
+        return NewTexture;
+    }
+    Camera2Yuv::ClearToGray(GOutputFormat, Width, Height, InitData); // Dark gray
+
+    // Ensure resource is created before update
+    NewTexture->UpdateResource();
+    AsyncTask(ENamedThreads::Type::GameThread, [InitData, InitSize, InitW, InitH, Pitch, NewTexture]()
+    {
+        FTexture2DResource* TextureResource = GCameraTextures.Contains(NewTexture)
+            ? static_cast<FTexture2DResource*>(NewTexture->GetResource()) : nullptr;
+        if (TextureResource)
+        {
+            FUpdateTextureRegion2D Region(0, 0, 0, 0, static_cast<uint32>(InitW), static_cast<uint32>(InitH));
+            ENQUEUE_RENDER_COMMAND(InitCameraTexture2D)(
+                [TextureResource, Region, InitData, InitSize, Pitch](FRHICommandListImmediate& RHICmdList)
+                {
+                    RHICmdList.UpdateTexture2D(TextureResource->GetTexture2DRHI(), 0, Region, Pitch, InitData);
+                    Camera2Memory::Free(Camera2Memory::EPool::Uploads, InitData, InitSize);
+                });
+        }
+        else
+        {
+            Camera2Memory::Free(Camera2Memory::EPool::Uploads, InitData, InitSize);
+        }
+    });
+    return NewTexture;
+}
+
+static void ReleaseCameraTextures()
+{
+    FCamera2FramePipeline::Get().SetTargetTextures(TArray<UTexture2D*>());
+    for (UTexture2D* Texture : GCameraTextures)
+    {
+        Texture->RemoveFromRoot();
+    }
+    GCameraTextures.Reset();
+    GCameraTextureReservations.Reset();
+    CameraTexture = nullptr;
+}
+
+// Parse an Adobe/Resolve .cube 3D LUT into RGB triples (red index fastest)
+static bool ParseCubeLut(const FString& Text, int32& OutSize, TArray<float>& OutRgb, FString& OutError)
+{
+    TArray<FString> Lines;
+    Text.ParseIntoArrayLines(Lines);
+
+    OutSize = 0;
+    OutRgb.Reset();
+    float DomainMin[3] = { 0.0f, 0.0f, 0.0f };
+    float DomainMax[3] = { 1.0f, 1.0f, 1.0f };
+    for (const FString& RawLine : Lines)
+    {
+        const FString Line = RawLine.TrimStartAndEnd();
+        if (Line.IsEmpty() || Line.StartsWith(TEXT("#")))
+        {
+            continue;
+        }
+
+        TArray<FString> Tokens;
+        Line.ParseIntoArrayWS(Tokens);
+        if (Tokens[0] == TEXT("LUT_3D_SIZE") && Tokens.Num() >= 2)
+        {
+            OutSize = FCString::Atoi(*Tokens[1]);
+            if (OutSize < 2 || OutSize > Camera2Yuv::MaxLutSize)
+            {
+                OutError = FString::Printf(TEXT("unsupported LUT_3D_SIZE %d"), OutSize);
+                return false;
+            }
+            OutRgb.Reserve(OutSize * OutSize * OutSize * 3);
+        }
+        else if ((Tokens[0] == TEXT("DOMAIN_MIN") || Tokens[0] == TEXT("DOMAIN_MAX")) && Tokens.Num() >= 4)
+        {
+            float* Domain = (Tokens[0] == TEXT("DOMAIN_MIN")) ? DomainMin : DomainMax;
+            for (int32 Channel = 0; Channel < 3; ++Channel)
+            {
+                Domain[Channel] = FCString::Atof(*Tokens[Channel + 1]);
+            }
+        }
+        else if (Tokens[0] == TEXT("LUT_1D_SIZE"))
+        {
+            OutError = TEXT("1D LUTs are not supported");
+            return false;
+        }
+        else if (!FChar::IsAlpha(Tokens[0][0]))
+        {
+            if (Tokens.Num() < 3)
+            {
+                OutError = FString::Printf(TEXT("malformed entry '%s'"), *Line);
+                return false;
+            }
+            for (int32 Channel = 0; Channel < 3; ++Channel)
+            {
+                const float Extent = FMath::Max(DomainMax[Channel] - DomainMin[Channel], KINDA_SMALL_NUMBER);
+                OutRgb.Add((FCString::Atof(*Tokens[Channel]) - DomainMin[Channel]) / Extent);
+            }
+        }
+        // TITLE and other keywords are ignored
+    }
+
+    if (OutSize == 0 || OutRgb.Num() != OutSize * OutSize * OutSize * 3)
+    {
+        OutError = FString::Printf(TEXT("expected %d entries, found %d"), OutSize * OutSize * OutSize, OutRgb.Num() / 3);
+        return false;
+    }
+    return true;
+}
+
+// Explicit LutFile (relative paths are under Saved/Camera2), else color_lut_<cameraId>.cube next to the characteristics dump
+static FString ResolveColorLutPath()
+{
+    if (!GColorConfig.LutFile.IsEmpty())
+    {
+        return FPaths::IsRelative(GColorConfig.LutFile)
+            ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Camera2"), GColorConfig.LutFile)
+            : GColorConfig.LutFile;
+    }
+    if (!GCameraCharacteristicsJsonPath.IsEmpty())
+    {
+        const FString BaseName = FPaths::GetBaseFilename(GCameraCharacteristicsJsonPath)
+            .Replace(TEXT("camera_characteristics_"), TEXT("color_lut_"));
+        return FPaths::Combine(FPaths::GetPath(GCameraCharacteristicsJsonPath), BaseName + TEXT(".cube"));
+    }
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Camera2"), TEXT("color_lut.cube"));
+}
+
+// Resolve matrix/range (config or stream DataSpace) and the LUT, then hand them to the display pipeline (game thread)
+static void ApplyColorConfig()
+{
+    TSharedPtr<Camera2Yuv::FColorTransform, ESPMode::ThreadSafe> Transform = MakeShared<Camera2Yuv::FColorTransform, ESPMode::ThreadSafe>();
+
+    ECamera2ColorStandard StreamStandard;
+    bool bStreamFullRange;
+    Camera2Yuv::ResolveDataSpace(GStreamDataSpace.load(), StreamStandard, bStreamFullRange);
+    Transform->Standard = (GColorConfig.Standard == ECamera2ColorStandard::Auto) ? StreamStandard : GColorConfig.Standard;
+    Transform->bFullRange = (GColorConfig.Range == ECamera2ColorRange::Auto) ? bStreamFullRange : (GColorConfig.Range == ECamera2ColorRange::Full);
+    Transform->Matrix = Camera2Yuv::MakeYuvMatrix(Transform->Standard, Transform->bFullRange);
+
+    if (GColorConfig.bUseLut)
+    {
+        // The parsed LUT is cached until the path changes or SetColorConfig is called again
+        const FString LutPath = ResolveColorLutPath();
+        if (LutPath != GLoadedLutPath)
+        {
+            GLoadedLutPath = LutPath;
+            GLoadedLut = Camera2Yuv::FColorLut();
+
+            FString Text;
+            if (FFileHelper::LoadFileToString(Text, *LutPath))
+            {
+                int32 Size = 0;
+                TArray<float> Rgb;
+                FString Error;
+                if (ParseCubeLut(Text, Size, Rgb, Error) && Camera2Yuv::BuildColorLut(Size, Rgb.GetData(), GLoadedLut))
+                {
+                    UE_LOG(LogSimpleCamera2, Log, TEXT("Color LUT loaded: %s (%d^3)"), *LutPath, Size);
+                }
+                else
+                {
+                    UE_LOG(LogSimpleCamera2, Warning, TEXT("Color LUT %s rejected: %s"), *LutPath, *Error);
+                }
+            }
+            else if (!GColorConfig.LutFile.IsEmpty())
+            {
+                UE_LOG(LogSimpleCamera2, Warning, TEXT("Color LUT %s not found"), *LutPath);
+            }
+        }
+        Transform->Lut = GLoadedLut;
+    }
+
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Color stage: standard=%d %s range, LUT %d^3 (DataSpace 0x%x)"),
+        static_cast<int32>(Transform->Standard), Transform->bFullRange ? TEXT("full") : TEXT("limited"),
+        Transform->Lut.Size, GStreamDataSpace.load());
+    FCamera2FramePipeline::Get().SetColorTransform(Transform);
+}
+
+// Calibration of the selected camera as reported by startCamera (game thread)
+static Camera2Calibration::FSensorCalibration GetSensorCalibration()
+{
+    Camera2Calibration::FSensorCalibration Sensor;
+    Sensor.Fx = GCameraFx;
+    Sensor.Fy = GCameraFy;
+    Sensor.Cx = GCameraCx;
+    Sensor.Cy = GCameraCy;
+    Sensor.Skew = GCameraSkew;
+    Sensor.ActiveArray = GActiveArray;
+    Sensor.PreCorrectionArray = GPreCorrectionArray;
+
+    // LENS_DISTORTION (5 floats) is [k1, k2, k3, p1, p2]; the deprecated LENS_RADIAL_DISTORTION (6 floats) is
+    // [kappa0 .. kappa5] with kappa0 = 1 in practice
+    const int32 N = FMath::Min(GLensDistortionLength, GLensDistortionCoeffs.Num());
+    const int32 First = N >= 6 ? 1 : 0;
+    if (N >= First + 5)
+    {
+        for (int32 i = 0; i < 3; ++i)
+        {
+            Sensor.K[i] = GLensDistortionCoeffs[First + i];
+        }
+        Sensor.P[0] = GLensDistortionCoeffs[First + 3];
+        Sensor.P[1] = GLensDistortionCoeffs[First + 4];
+    }
+    return Sensor;
+}
+
+// Recompute the intrinsics of every configured stream and the still output once startCamera reported the
+// calibration and the stream sizes; ray tables of the previous configuration are dropped
+static void UpdateStreamIntrinsics()
+{
+    const Camera2Calibration::FSensorCalibration Sensor = GetSensorCalibration();
+    for (int32 StreamId = 0; StreamId < FCamera2FramePipeline::MaxStreams; ++StreamId)
+    {
+        FCamera2FramePipeline& Pipeline = FCamera2FramePipeline::Get(StreamId);
+        TSharedPtr<FCamera2StreamIntrinsics, ESPMode::ThreadSafe> Intrinsics;
+        if (Pipeline.IsConfigured())
+        {
+            Intrinsics = MakeShared<FCamera2StreamIntrinsics, ESPMode::ThreadSafe>();
+            if (Camera2Calibration::ComputeStreamIntrinsics(Sensor, Pipeline.GetWidth(), Pipeline.GetHeight(), *Intrinsics))
+            {
+                UE_LOG(LogSimpleCamera2, Log, TEXT("Stream %d intrinsics %dx%d: fx=%.2f fy=%.2f cx=%.2f cy=%.2f, crop %.1fx%.1f at (%.1f,%.1f), fov %.1fx%.1f"),
+                    StreamId, Intrinsics->Size.X, Intrinsics->Size.Y, Intrinsics->Fx, Intrinsics->Fy, Intrinsics->Cx, Intrinsics->Cy,
+                    Intrinsics->CropSize.X, Intrinsics->CropSize.Y, Intrinsics->CropOrigin.X, Intrinsics->CropOrigin.Y,
+                    Intrinsics->HorizontalFovDegrees, Intrinsics->VerticalFovDegrees);
+            }
+            else
+            {
+                Intrinsics.Reset();
+            }
+        }
+        Pipeline.SetIntrinsics(Intrinsics);
+    }
+
+    {
+        FScopeLock Lock(&GRayTableLock);
+        for (int32 StreamId = 0; StreamId < FCamera2FramePipeline::MaxStreams; ++StreamId)
+        {
+            GRayTables[StreamId].Reset();
+            GRayTableSources[StreamId].Reset();
+        }
+    }
+
+    FScopeLock Lock(&GStillLock);
+    Camera2Calibration::ComputeStreamIntrinsics(Sensor, GStillSize.X, GStillSize.Y, GStillIntrinsics);
+}
+
+// Stream consumer of the keypoint stage (pipeline worker thread)
+static void DetectStreamKeypoints(const FCamera2FrameView& Frame)
+{
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 Keypoints"));
+    if (Frame.Stats && Frame.Stats->ChangeScore < GFeatureConfig.MinChangeScore)
+    {
+        return;
+    }
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    FCamera2KeypointFrame& Result = GFeatureWorkResult;
+    Result.StreamId = Frame.StreamId;
+    Result.FrameNumber = Frame.Metadata ? Frame.Metadata->FrameNumber : -1;
+    Result.SensorTimestampNs = Frame.Metadata ? Frame.Metadata->SensorTimestampNs : 0;
+    Result.StreamSize = FIntPoint(Frame.Width, Frame.Height);
+    Result.CornersDetected = Camera2Features::DetectKeypoints(Frame.Y, Frame.Width, Frame.Height, GFeatureConfig,
+        GFeatureScratch, Result.Keypoints);
+
+    if (Frame.Intrinsics)
+    {
+        const FCamera2StreamIntrinsics& K = *Frame.Intrinsics;
+        for (FCamera2Keypoint& Keypoint : Result.Keypoints)
+        {
+            const double NormalizedY = (Keypoint.Position.Y - K.Cy) / K.Fy;
+            Keypoint.Normalized = FVector2D((Keypoint.Position.X - K.Cx - K.Skew * NormalizedY) / K.Fx, NormalizedY);
+        }
+    }
+
+    Result.DetectMs = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+    {
+        // The copy reuses the published arrays, so the game thread waits at most for a memcpy
+        FScopeLock Lock(&GFeatureLock);
+        GLatestKeypoints = Result;
+    }
+    GOnKeypoints.Broadcast(Result);
+}
+
+// OpenCV-style camera axes (x right, y down, z forward) to UE camera axes (X forward, Y right, Z up)
+static FVector CameraToUnreal(double X, double Y, double Z)
+{
+    return FVector(Z, X, -Y);
+}
+
+// Stream consumer of the marker stage (pipeline worker thread)
+static void DetectStreamMarkers(const FCamera2FrameView& Frame)
+{
+    CAMERA2_TRACE_SCOPE(TEXT("Camera2 Markers"));
+    if (Frame.Stats && Frame.Stats->ChangeScore < GMarkerConfig.MinChangeScore)
+    {
+        return;
+    }
+    if (GMarkerFrameCount++ % GMarkerConfig.FrameInterval != 0)
+    {
+        return;
+    }
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    Camera2Markers::FCameraModel Camera;
+    if (Frame.Intrinsics)
+    {
+        const FCamera2StreamIntrinsics& K = *Frame.Intrinsics;
+        Camera.Fx = K.Fx;
+        Camera.Fy = K.Fy;
+        Camera.Cx = K.Cx;
+        Camera.Cy = K.Cy;
+        Camera.Skew = K.Skew;
+        Camera.K[0] = K.K1;
+        Camera.K[1] = K.K2;
+        Camera.K[2] = K.K3;
+        Camera.P[0] = K.P1;
+        Camera.P[1] = K.P2;
+    }
+
+    FCamera2MarkerFrame& Result = GMarkerWorkResult;
+    Result.StreamId = Frame.StreamId;
+    Result.FrameNumber = Frame.Metadata ? Frame.Metadata->FrameNumber : -1;
+    Result.SensorTimestampNs = Frame.Metadata ? Frame.Metadata->SensorTimestampNs : 0;
+    double ErrorSeconds = 0.0;
+    if (Result.SensorTimestampNs <= 0 || !GClockMapper.MapToEngineSeconds(Result.SensorTimestampNs, Result.EngineSeconds, ErrorSeconds))
+    {
+        Result.EngineSeconds = 0.0;
+    }
+    Result.Candidates = Camera2Markers::DetectMarkers(Frame.Y, Frame.Width, Frame.Height, GMarkerConfig, GMarkerDictionary,
+        Camera, GMarkerConfig.MarkerSizeCm, GMarkerScratch, GMarkerDetections);
+
+    Result.Markers.SetNum(GMarkerDetections.Num());
+    for (int32 i = 0; i < GMarkerDetections.Num(); ++i)
+    {
+        const Camera2Markers::FMarkerDetection& Detection = GMarkerDetections[i];
+        FCamera2Marker& Marker = Result.Markers[i];
+        Marker.Id = Detection.Id;
+        Marker.Corners.SetNum(4);
+        for (int32 Corner = 0; Corner < 4; ++Corner)
+        {
+            Marker.Corners[Corner] = FVector2D(Detection.Corners[Corner][0], Detection.Corners[Corner][1]);
+        }
+        Marker.bPoseValid = Detection.bPoseValid;
+        Marker.ReprojectionErrorPx = static_cast<float>(Detection.ReprojectionErrorPx);
+        Marker.Pose = FTransform::Identity;
+        if (Detection.bPoseValid)
+        {
+            // Marker X (into the face) / Y (right) / Z (up) are its OpenCV -z / x / y columns
+            const double* R = Detection.Rotation;
+            const double* T = Detection.Translation;
+            Marker.Pose = FTransform(FMatrix(
+                CameraToUnreal(-R[2], -R[5], -R[8]),
+                CameraToUnreal(R[0], R[3], R[6]),
+                CameraToUnreal(R[1], R[4], R[7]),
+                CameraToUnreal(T[0], T[1], T[2])));
+        }
+    }
+
+    Result.DetectMs = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+    {
+        FScopeLock Lock(&GMarkerLock);
+        GLatestMarkers = Result;
+    }
+    GOnMarkers.Broadcast(Result);
+}
+
+// Intrinsics, timing and the handlers run on a worker so neither Camera2Helper thread is held up
+static void CompleteStill(FPendingStill&& Pending, bool bSuccess)
+{
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Pending = MoveTemp(Pending), bSuccess]() mutable
+    {
+        CAMERA2_TRACE_SCOPE(TEXT("Camera2 Still Complete"));
+        TSharedPtr<FCamera2StillImage, ESPMode::ThreadSafe> Still = Pending.Image.IsValid()
+            ? Pending.Image : MakeShared<FCamera2StillImage, ESPMode::ThreadSafe>();
+        Still->RequestId = Pending.RequestId;
+        Still->Format = Pending.Format;
+        Still->bSuccess = bSuccess && Pending.Image.IsValid() && Pending.Reservation.IsValid();
+        if (!Still->bSuccess)
+        {
+            Still->Data.Empty();
+            Pending.Reservation.Reset();
+        }
+        Still->Metadata = Pending.Metadata;
+
+        double ErrorSeconds = 0.0;
+        if (Still->Metadata.SensorTimestampNs <= 0
+            || !GClockMapper.MapToEngineSeconds(Still->Metadata.SensorTimestampNs, Still->EngineSeconds, ErrorSeconds))
+        {
+            Still->EngineSeconds = 0.0;
+        }
+        FCamera2StreamIntrinsics Intrinsics;
+        {
+            FScopeLock Lock(&GStillLock);
+            Intrinsics = GStillIntrinsics;
+        }
+        Still->bIntrinsicsValid = Intrinsics.bValid && Intrinsics.Size == Still->Size;
+        if (Still->bIntrinsicsValid)
+        {
+            Still->Fx = Intrinsics.Fx;
+            Still->Fy = Intrinsics.Fy;
+            Still->Cx = Intrinsics.Cx;
+            Still->Cy = Intrinsics.Cy;
+            Still->Skew = Intrinsics.Skew;
+        }
+        Still->LatencyMs = static_cast<float>((FPlatformTime::Seconds() - Pending.RequestSeconds) * 1000.0);
+
+        GOnStillCaptured.Broadcast(*Still);
+        FScopeLock Lock(&GStillLock);
+        GLatestStill = Still;
+        GLatestStillReservation = MoveTemp(Pending.Reservation);
+    });
+}
+
+// Create (or recreate) the camera texture set
+static bool CameraTexturesMatch(int32 Width, int32 Height)
+{
+    const Camera2Yuv::FOutputLayout Layout = Camera2Yuv::GetOutputLayout(GOutputFormat, Width, Height);
+    return GCameraTextures.Num() == GCameraTextureBufferCount && CameraTexture
+        && CameraTexture->GetSizeX() == Layout.TextureWidth && CameraTexture->GetSizeY() == Layout.TextureHeight
+        && CameraTexture->GetPixelFormat() == Layout.PixelFormat;
+}
+
+static void CreateCameraTexture(int32 Width, int32 Height)
+{
+    ReleaseCameraTextures();
+
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("Creating new camera texture %dx%d x%d"), Width, Height, GCameraTextureBufferCount);
+    // The first texture is always created; further rotation buffers only within the frame memory budget
+    const int64 TextureBytes = Camera2Yuv::GetOutputLayout(GOutputFormat, Width, Height).GetSizeBytes();
+    for (int32 i = 0; i < GCameraTextureBufferCount; ++i)
+    {
+        Camera2Memory::FReservation Reservation;
+        if (!Reservation.Reserve(Camera2Memory::EPool::Textures, TextureBytes, GCameraTextures.Num() == 0))
+        {
+            UE_LOG(LogSimpleCamera2, Warning, TEXT("Frame memory budget allows %d of %d camera textures"), GCameraTextures.Num(), GCameraTextureBufferCount);
+            break;
+        }
+        if (UTexture2D* NewTexture = CreateClearedCameraTexture(Width, Height))
+        {
+            GCameraTextures.Add(NewTexture);
+            GCameraTextureReservations.Add(MoveTemp(Reservation));
+        }
+    }
+
+    if (GCameraTextures.Num() > 0)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera texture created successfully"));
+        CameraTexture = GCameraTextures[0];
+    }
+
+    FCamera2FramePipeline::Get().SetTargetTextures(GCameraTextures);
+    ApplyCameraTextureBindings();
+}
+
+bool USimpleCamera2Test::StartCameraPreview()
+{
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("=== StartCameraPreview CALLED FROM BLUEPRINT ==="));
+    
+    if (GEngine)
+    {
+        GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red, TEXT("StartCameraPreview CALLED"));
+    }
+    
+#if PLATFORM_ANDROID
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("Starting real Camera2 preview on Android"));
+    
+    // Auto-request camera permissions if not granted
+    JNIEnv* Env = FAndroidApplication::GetJavaEnv();
+    if (Env)
+    {
+        // Check and request permissions
+        jobject Activity = FAndroidApplication::GetGameActivityThis();
+        if (Activity)
+        {
+            UE_LOG(LogSimpleCamera2, Warning, TEXT("Checking camera permissions..."));
+            
+            // Get the Activity class and checkSelfPermission method
+            jclass ActivityClass = Env->GetObjectClass(Activity);
+            jmethodID CheckPermMethod = Env->GetMethodID(ActivityClass, 
+                "checkSelfPermission", "(Ljava/lang/String;)I");
+            jmethodID RequestPermMethod = Env->GetMethodID(ActivityClass,
+                "requestPermissions", "([Ljava/lang/String;I)V");
+            
+            if (CheckPermMethod && RequestPermMethod)
+            {
+                // Check CAMERA permission
+                jstring CameraPermStr = Env->NewStringUTF("android.permission.CAMERA");
+                jint CameraPermResult = Env->CallIntMethod(Activity, CheckPermMethod, CameraPermStr);
+                
+                // PackageManager.PERMISSION_GRANTED = 0
+                if (CameraPermResult != 0)
+                {
+                    UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera permission not granted, requesting..."));
+                    
+                    // Create permission array
+                    jobjectArray PermArray = Env->NewObjectArray(3, 
+                        Env->FindClass("java/lang/String"), nullptr);
+                    
+                    jstring Perm1 = Env->NewStringUTF("android.permission.CAMERA");
+                    jstring Perm2 = Env->NewStringUTF("horizonos.permission.HEADSET_CAMERA");
+                    jstring Perm3 = Env->NewStringUTF("horizonos.permission.AVATAR_CAMERA");
+                    
+                    Env->SetObjectArrayElement(PermArray, 0, Perm1);
+                    Env->SetObjectArrayElement(PermArray, 1, Perm2);
+                    Env->SetObjectArrayElement(PermArray, 2, Perm3);
+                    
+                    // Request permissions (request code = 1001)
+                    Env->CallVoidMethod(Activity, RequestPermMethod, PermArray, 1001);
+                    
+                    // Clean up
+                    Env->DeleteLocalRef(Perm1);
+                    Env->DeleteLocalRef(Perm2);
+                    Env->DeleteLocalRef(Perm3);
+                    Env->DeleteLocalRef(PermArray);
+                    
+                    UE_LOG(LogSimpleCamera2, Warning, TEXT("Permission request sent. User must grant permission and retry."));
+                    if (GEngine)
+                    {
+                        GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, 
+                            TEXT("Please grant camera permission and try again"));
+                    }
+                    
+                    Env->DeleteLocalRef(CameraPermStr);
+                    return false; // Return false, user needs to grant permission first
+                }
+                else
+                {
+                    UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera permission already granted"));
+                }
+                
+                Env->DeleteLocalRef(CameraPermStr);
+            }
+        }
+    }
+    
+    if (bPreviewPaused)
+    {
+        return ResumeCameraPreview();
+    }
+    if (bCameraPreviewActive)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera preview already active"));
+        return true;
+    }
+    BeginFirstFrameTiming(ECamera2ResumeMode::ColdStart, FPlatformTime::Seconds());
+    RegisterLifecycleHooks();
+    
+    // Create texture for camera feed if not already created
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("=== CHECKING CAMERA TEXTURE ==="));
+    if (!CameraTexturesMatch(GStreamWidth, GStreamHeight))
+    {
+        CreateCameraTexture(GStreamWidth, GStreamHeight);
+    }
+    
+    // Start real Camera2 using Camera2Helper
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("=== STARTING JNI CAMERA2HELPER ACCESS ==="));
+    // Env already defined above, reuse it
+    if (Env)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("JNI Environment obtained"));
+        jobject Activity = FAndroidApplication::GetGameActivityThis();
+        
+        if (Activity)
+        {
+            UE_LOG(LogSimpleCamera2, Warning, TEXT("Game Activity obtained"));
+        }
+        else
         {
             UE_LOG(LogSimpleCamera2, Error, TEXT("Failed to get Game Activity"));
         }
@@ -654,6 +1788,98 @@ bool USimpleCamera2Test::StartCameraPreview()
                     Camera2HelperInstance = Env->NewGlobalRef(LocalCamera);
                     UE_LOG(LogSimpleCamera2, Warning, TEXT("✓ Global reference created"));
                     
+                    // Push ImageReader queue configuration before the reader is created
+                    jmethodID ConfigureQueueMethod = Env->GetMethodID(Camera2Class,
+                        "configureImageQueue", "(IZ)V");
+                    if (ConfigureQueueMethod)
+                    {
+                        const bool bInOrder = (GImageQueueConsumption == ECamera2FrameConsumption::InOrder);
+                        Env->CallVoidMethod(Camera2HelperInstance, ConfigureQueueMethod,
+                            (jint)GImageQueueMaxImages, bInOrder ? JNI_TRUE : JNI_FALSE);
+                        UE_LOG(LogSimpleCamera2, Log, TEXT("ImageReader queue: maxImages=%d consumption=%s"),
+                            GImageQueueMaxImages, bInOrder ? TEXT("InOrder") : TEXT("LatestOnly"));
+                    }
+                    else
+                    {
+                        Env->ExceptionClear(); // NoSuchMethodError
+                        UE_LOG(LogSimpleCamera2, Warning, TEXT("configureImageQueue method not found, using Java defaults"));
+                    }
+
+                    PushCaptureControls(Env);
+
+                    jmethodID ConfigureHighSpeedMethod = Env->GetMethodID(Camera2Class,
+                        "configureHighSpeed", "(ZI)V");
+                    if (ConfigureHighSpeedMethod)
+                    {
+                        Env->CallVoidMethod(Camera2HelperInstance, ConfigureHighSpeedMethod,
+                            bHighSpeedRequested ? JNI_TRUE : JNI_FALSE, (jint)GHighSpeedTargetFps);
+                    }
+                    else
+                    {
+                        Env->ExceptionClear(); // NoSuchMethodError
+                    }
+
+                    // Analysis outputs are re-declared on every start; Java validates the combination
+                    jmethodID ClearStreamsMethod = Env->GetMethodID(Camera2Class, "clearAnalysisStreams", "()V");
+                    jmethodID AddStreamMethod = Env->GetMethodID(Camera2Class, "addAnalysisStream", "(IIIZ)V");
+                    if (ClearStreamsMethod && AddStreamMethod)
+                    {
+                        Env->CallVoidMethod(Camera2HelperInstance, ClearStreamsMethod);
+                        for (int32 i = 0; i < GAnalysisStreamRequests.Num(); ++i)
+                        {
+                            const FAnalysisStreamRequest& Request = GAnalysisStreamRequests[i];
+                            Env->CallVoidMethod(Camera2HelperInstance, AddStreamMethod, (jint)(i + 1),
+                                (jint)Request.Size.X, (jint)Request.Size.Y, Request.bLumaOnly ? JNI_TRUE : JNI_FALSE);
+                        }
+                    }
+                    else
+                    {
+                        Env->ExceptionClear(); // NoSuchMethodError
+                    }
+                    for (int32 StreamId = GAnalysisStreamRequests.Num() + 1; StreamId < FCamera2FramePipeline::MaxStreams; ++StreamId)
+                    {
+                        FCamera2FramePipeline::Get(StreamId).Shutdown();
+                    }
+
+                    // Still output; startCamera reports the accepted size through onStillCaptureConfigured
+                    GStillSize = FIntPoint::ZeroValue;
+                    jmethodID ConfigureStillMethod = Env->GetMethodID(Camera2Class, "configureStillCapture", "(ZIIII)V");
+                    if (ConfigureStillMethod)
+                    {
+                        Env->CallVoidMethod(Camera2HelperInstance, ConfigureStillMethod, GStillRequested ? JNI_TRUE : JNI_FALSE,
+                            (jint)GStillConfig.Format, (jint)GStillConfig.Size.X, (jint)GStillConfig.Size.Y, (jint)GStillConfig.JpegQuality);
+                    }
+                    else
+                    {
+                        Env->ExceptionClear(); // NoSuchMethodError
+                    }
+
+                    FCamera2FramePipeline& Pipeline = FCamera2FramePipeline::Get();
+                    Pipeline.ResetStats();
+                    Pipeline.SetOnFrameUploaded([](const FCamera2FrameMetadata& Metadata, UTexture2D* Texture)
+                    {
+                        if (Texture != CameraTexture)
+                        {
+                            CameraTexture = Texture;
+                            ApplyCameraTextureBindings();
+                        }
+                        GLatestFrameMetadata = Metadata;
+                        if (bAwaitingFirstFrame)
+                        {
+                            bAwaitingFirstFrame = false;
+                            GTimeToFirstFrameMs = static_cast<float>((FPlatformTime::Seconds() - GStartRequestSeconds) * 1000.0);
+                            UE_LOG(LogSimpleCamera2, Log, TEXT("First frame %.1f ms after %s"), GTimeToFirstFrameMs,
+                                GLastStartMode == ECamera2ResumeMode::ColdStart ? TEXT("start")
+                                : GLastStartMode == ECamera2ResumeMode::WarmSession ? TEXT("warm resume") : TEXT("resume with reopen"));
+                        }
+                        GOnFrameReady.Broadcast(Metadata);
+                    });
+
+                    // Camera is not running yet, so the background thread isn't touching the ring
+                    GMetadataRing.Reset();
+                    GClockMapper.Reset();
+                    GStreamDataSpace.store(0);
+
                     // Start camera
                     UE_LOG(LogSimpleCamera2, Warning, TEXT("Getting startCamera method..."));
                     jmethodID StartMethod = Env->GetMethodID(Camera2Class, 
@@ -667,6 +1893,19 @@ bool USimpleCamera2Test::StartCameraPreview()
                         UE_LOG(LogSimpleCamera2, Warning, TEXT("✓ startCamera method call completed"));
                         
                         bCameraPreviewActive = (result == JNI_TRUE);
+
+                        // startCamera reported the stream size synchronously; match the texture to it
+                        if (bCameraPreviewActive && !CameraTexturesMatch(GStreamWidth, GStreamHeight))
+                        {
+                            CreateCameraTexture(GStreamWidth, GStreamHeight);
+                        }
+
+                        // Characteristics (and with them the per-device LUT path and the calibration) are known now
+                        if (bCameraPreviewActive)
+                        {
+                            ApplyColorConfig();
+                            UpdateStreamIntrinsics();
+                        }
                         
                         if (bCameraPreviewActive)
                         {
@@ -766,20 +2005,179 @@ void USimpleCamera2Test::StopCameraPreview()
             Camera2HelperInstance = nullptr;
         }
     }
+
+    // stopCamera joined the background thread, so nothing resolves the waiting frame anymore
+    if (GLegacyWaitingFrame.Data)
+    {
+        FreeLegacyFrame(GLegacyWaitingFrame.Data, GLegacyWaitingFrame.Width * GLegacyWaitingFrame.Height * 4);
+        GLegacyWaitingFrame = FLegacyWaitingFrame();
+    }
+#endif
+
+    // Still requests in flight when the session closed never complete
+    TArray<FPendingStill, TInlineAllocator<MaxPendingStills>> AbandonedStills;
+    {
+        FScopeLock Lock(&GStillLock);
+        AbandonedStills = MoveTemp(GPendingStills);
+        GPendingStills.Reset();
+    }
+    for (FPendingStill& Pending : AbandonedStills)
+    {
+        CompleteStill(MoveTemp(Pending), false);
+    }
+    GStillSize = FIntPoint::ZeroValue;
+    
+    // Camera is stopped: let in-flight conversions and uploads finish before the textures go away, then return
+    // the ring memory to the budget; the next start configures every stream again
+    FCamera2FramePipeline::Get().SetTargetTextures(TArray<UTexture2D*>());
+    for (int32 StreamId = 0; StreamId < FCamera2FramePipeline::MaxStreams; ++StreamId)
+    {
+        FCamera2FramePipeline::Get(StreamId).Shutdown();
+    }
+
+    ReleaseCameraTextures();
+    
+    bCameraPreviewActive = false;
+    bPreviewPaused = false;
+    bPausedForBackground = false;
+    bAwaitingFirstFrame = false;
+    GLatestFrameMetadata = FCamera2FrameMetadata();
+    
+    if (GEngine)
+    {
+        GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Yellow, TEXT("Real Camera2: Stopped"));
+    }
+}
+
+#if PLATFORM_ANDROID
+// Call a no-argument Camera2Helper method returning int (0 on a missing method or exception)
+static jint CallHelperIntMethod(JNIEnv* Env, const char* Name)
+{
+    jint Result = 0;
+    jclass HelperClass = Env->GetObjectClass(Camera2HelperInstance);
+    jmethodID Method = HelperClass ? Env->GetMethodID(HelperClass, Name, "()I") : nullptr;
+    if (Method)
+    {
+        Result = Env->CallIntMethod(Camera2HelperInstance, Method);
+    }
+    if (Env->ExceptionCheck())
+    {
+        Env->ExceptionDescribe();
+        Env->ExceptionClear();
+        Result = 0;
+    }
+    if (HelperClass)
+    {
+        Env->DeleteLocalRef(HelperClass);
+    }
+    return Result;
+}
+#endif
+
+void USimpleCamera2Test::PauseCameraPreview()
+{
+#if PLATFORM_ANDROID
+    if (!bCameraPreviewActive || bPreviewPaused || !Camera2HelperInstance)
+    {
+        return;
+    }
+    JNIEnv* Env = FAndroidApplication::GetJavaEnv();
+    if (!Env)
+    {
+        return;
+    }
+
+    jboolean bPaused = JNI_FALSE;
+    jclass HelperClass = Env->GetObjectClass(Camera2HelperInstance);
+    jmethodID PauseMethod = HelperClass ? Env->GetMethodID(HelperClass, "pauseCamera", "()Z") : nullptr;
+    if (PauseMethod)
+    {
+        bPaused = Env->CallBooleanMethod(Camera2HelperInstance, PauseMethod);
+    }
+    if (Env->ExceptionCheck())
+    {
+        Env->ExceptionDescribe();
+        Env->ExceptionClear();
+        bPaused = JNI_FALSE;
+    }
+    if (HelperClass)
+    {
+        Env->DeleteLocalRef(HelperClass);
+    }
+
+    if (bPaused != JNI_TRUE)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("PauseCameraPreview: Camera2Helper could not pause, stopping instead"));
+        StopCameraPreview();
+        return;
+    }
+    // Session, readers, textures, rings and caches stay; frames already captured still arrive
+    bPreviewPaused = true;
+    bAwaitingFirstFrame = false;
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Camera preview paused"));
+#endif
+}
+
+bool USimpleCamera2Test::ResumeCameraPreview()
+{
+#if PLATFORM_ANDROID
+    if (!bPreviewPaused)
+    {
+        return bCameraPreviewActive;
+    }
+    const double RequestSeconds = FPlatformTime::Seconds();
+    bPreviewPaused = false;
+
+    JNIEnv* Env = FAndroidApplication::GetJavaEnv();
+    const int32 JavaResult = (Env && Camera2HelperInstance) ? CallHelperIntMethod(Env, "resumeCamera") : JavaResumeFailed;
+    if (JavaResult == JavaResumeWarmSession || JavaResult == JavaResumeReopen)
+    {
+        const ECamera2ResumeMode Mode = JavaResult == JavaResumeWarmSession ? ECamera2ResumeMode::WarmSession : ECamera2ResumeMode::Reopen;
+        BeginFirstFrameTiming(Mode, RequestSeconds);
+        UE_LOG(LogSimpleCamera2, Log, TEXT("Camera preview resumed (%s)"),
+            Mode == ECamera2ResumeMode::WarmSession ? TEXT("warm session") : TEXT("reopening the device"));
+        return true;
+    }
+
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("ResumeCameraPreview: nothing reusable, restarting the camera"));
+    StopCameraPreview();
+    const bool bStarted = StartCameraPreview();
+    GStartRequestSeconds = RequestSeconds;
+    return bStarted;
+#else
+    return false;
 #endif
-    
-    if (CameraTexture)
+}
+
+void USimpleCamera2Test::SetPauseOnBackground(bool bEnable)
+{
+    bPauseOnBackground = bEnable;
+}
+
+// Lifecycle delegates are broadcast on the game thread; only a preview paused here is resumed here
+static void RegisterLifecycleHooks()
+{
+    if (bLifecycleHooksRegistered)
     {
-        CameraTexture->RemoveFromRoot();
-        CameraTexture = nullptr;
+        return;
     }
-    
-    bCameraPreviewActive = false;
-    
-    if (GEngine)
+    bLifecycleHooksRegistered = true;
+    FCoreDelegates::ApplicationWillEnterBackgroundDelegate.AddLambda([]()
     {
-        GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Yellow, TEXT("Real Camera2: Stopped"));
-    }
+        if (bPauseOnBackground && bCameraPreviewActive && !bPreviewPaused)
+        {
+            USimpleCamera2Test::PauseCameraPreview();
+            bPausedForBackground = bPreviewPaused;
+        }
+    });
+    FCoreDelegates::ApplicationHasEnteredForegroundDelegate.AddLambda([]()
+    {
+        if (bPausedForBackground)
+        {
+            bPausedForBackground = false;
+            USimpleCamera2Test::ResumeCameraPreview();
+        }
+    });
 }
 
 UTexture2D* USimpleCamera2Test::GetCameraTexture()
@@ -871,6 +2269,48 @@ TArray<float> USimpleCamera2Test::GetLensDistortionUE()
     return Mapped;
 }
 
+bool USimpleCamera2Test::GetStreamIntrinsics(int32 StreamId, FCamera2StreamIntrinsics& OutIntrinsics)
+{
+    OutIntrinsics = FCamera2StreamIntrinsics();
+    if (StreamId < 0 || StreamId >= FCamera2FramePipeline::MaxStreams)
+    {
+        return false;
+    }
+    const TSharedPtr<const FCamera2StreamIntrinsics, ESPMode::ThreadSafe> Intrinsics = FCamera2FramePipeline::Get(StreamId).GetIntrinsics();
+    if (!Intrinsics.IsValid())
+    {
+        return false;
+    }
+    OutIntrinsics = *Intrinsics;
+    return true;
+}
+
+TSharedPtr<const FCamera2RayTable, ESPMode::ThreadSafe> USimpleCamera2Test::GetStreamRayTable(int32 StreamId)
+{
+    if (StreamId < 0 || StreamId >= FCamera2FramePipeline::MaxStreams)
+    {
+        return nullptr;
+    }
+    const TSharedPtr<const FCamera2StreamIntrinsics, ESPMode::ThreadSafe> Intrinsics = FCamera2FramePipeline::Get(StreamId).GetIntrinsics();
+    if (!Intrinsics.IsValid())
+    {
+        return nullptr;
+    }
+
+    // Held while building so concurrent callers share one table
+    FScopeLock Lock(&GRayTableLock);
+    TSharedPtr<const FCamera2RayTable, ESPMode::ThreadSafe>& Table = GRayTables[StreamId];
+    if (!Table.IsValid() || GRayTableSources[StreamId] != Intrinsics)
+    {
+        CAMERA2_TRACE_SCOPE(TEXT("Camera2 Ray Table"));
+        TSharedPtr<FCamera2RayTable, ESPMode::ThreadSafe> NewTable = MakeShared<FCamera2RayTable, ESPMode::ThreadSafe>();
+        Camera2Calibration::BuildRayTable(*Intrinsics, *NewTable);
+        Table = NewTable;
+        GRayTableSources[StreamId] = Intrinsics;
+    }
+    return Table;
+}
+
 void USimpleCamera2Test::GetCameraCharacteristics(bool bRedump, FString& OutJson, FString& OutFilePath)
 {
 	OutJson = GCameraCharacteristicsJson;
@@ -995,3 +2435,497 @@ void USimpleCamera2Test::GetCameraCharacteristics(bool bRedump, FString& OutJson
 	UE_LOG(LogSimpleCamera2, Warning, TEXT("Camera characteristics only available on Android"));
 #endif
 }
+
+void USimpleCamera2Test::SetImageQueueConfig(int32 MaxImages, ECamera2FrameConsumption Consumption)
+{
+    // acquireLatestImage needs at least two buffers to be able to skip anything
+    const int32 MinImages = (Consumption == ECamera2FrameConsumption::LatestOnly) ? 2 : 1;
+    GImageQueueMaxImages = FMath::Clamp(MaxImages, MinImages, 16);
+    GImageQueueConsumption = Consumption;
+
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Image queue config set: maxImages=%d consumption=%d%s"),
+        GImageQueueMaxImages, static_cast<int32>(Consumption),
+        bCameraPreviewActive ? TEXT(" (applies on next StartCameraPreview)") : TEXT(""));
+}
+
+void USimpleCamera2Test::SetHighSpeedMode(bool bEnable, int32 TargetFps)
+{
+    bHighSpeedRequested = bEnable;
+    GHighSpeedTargetFps = FMath::Clamp(TargetFps, 60, 240);
+    UE_LOG(LogSimpleCamera2, Log, TEXT("High-speed mode %s (target %d fps)%s"),
+        bEnable ? TEXT("enabled") : TEXT("disabled"), GHighSpeedTargetFps,
+        bCameraPreviewActive ? TEXT(", applies on next StartCameraPreview") : TEXT(""));
+}
+
+FCamera2PipelineStats USimpleCamera2Test::GetPipelineStats()
+{
+    FCamera2PipelineStats Stats;
+    Stats.CapturesCompleted = GStatCapturesCompleted.load(std::memory_order_relaxed);
+    Stats.FramesDelivered = GStatFramesDelivered.load(std::memory_order_relaxed);
+    Stats.QueueDrops = GStatQueueDrops.load(std::memory_order_relaxed);
+    Stats.SensorDrops = GStatSensorDrops.load(std::memory_order_relaxed);
+    Stats.BuffersLost = GStatBuffersLost.load(std::memory_order_relaxed);
+    Stats.MaxImages = GStatMaxImages.load(std::memory_order_relaxed);
+    Stats.Consumption = GStatInOrder.load(std::memory_order_relaxed)
+        ? ECamera2FrameConsumption::InOrder : ECamera2FrameConsumption::LatestOnly;
+    Stats.bHighSpeedSession = GStatHighSpeedSession.load(std::memory_order_relaxed);
+    Stats.TargetFps = GStatTargetFps.load(std::memory_order_relaxed);
+    Stats.bSessionFailed = GStatSessionFailed.load(std::memory_order_relaxed);
+    Stats.bPaused = bPreviewPaused;
+    Stats.LastStartMode = GLastStartMode;
+    Stats.TimeToFirstFrameMs = GTimeToFirstFrameMs;
+    FCamera2MemoryStats MemoryStats;
+    Camera2Memory::FillStats(MemoryStats);
+    Stats.FrameMemoryBytes = MemoryStats.LiveBytes;
+    Stats.FrameMemoryPeakBytes = MemoryStats.PeakBytes;
+    Stats.FrameMemoryBudgetBytes = MemoryStats.BudgetBytes;
+    Stats.BudgetDrops = MemoryStats.BudgetDrops;
+    FCamera2FramePipeline::Get().FillStats(Stats);
+    return Stats;
+}
+
+FCamera2FrameMetadata USimpleCamera2Test::GetLatestFrameMetadata()
+{
+    return GLatestFrameMetadata;
+}
+
+bool USimpleCamera2Test::GetFrameEngineTime(const FCamera2FrameMetadata& Frame, double& OutEngineSeconds, double& OutErrorSeconds)
+{
+    OutEngineSeconds = 0.0;
+    OutErrorSeconds = 0.0;
+    return Frame.SensorTimestampNs > 0 && GClockMapper.MapToEngineSeconds(Frame.SensorTimestampNs, OutEngineSeconds, OutErrorSeconds);
+}
+
+FCamera2ClockMapping USimpleCamera2Test::GetSensorClockMapping()
+{
+    FCamera2ClockMapping Mapping = GClockMapper.GetMapping();
+    Mapping.TimestampSource = GSensorTimestampSource.load(std::memory_order_relaxed);
+    return Mapping;
+}
+
+FOnCamera2FrameReady& USimpleCamera2Test::OnFrameReady()
+{
+    return GOnFrameReady;
+}
+
+void USimpleCamera2Test::SetCaptureControls(const FCamera2CaptureControls& Controls)
+{
+    GCaptureControls = Controls;
+
+#if PLATFORM_ANDROID
+    // Before the first start the values are pushed by StartCameraPreview
+    if (Camera2HelperInstance)
+    {
+        PushCaptureControls(FAndroidApplication::GetJavaEnv());
+    }
+#endif
+}
+
+FCamera2CaptureControls USimpleCamera2Test::GetCaptureControls()
+{
+    return GCaptureControls;
+}
+
+int32 USimpleCamera2Test::AddAnalysisStream(FIntPoint Size, bool bLumaOnly)
+{
+    if (GAnalysisStreamRequests.Num() >= FCamera2FramePipeline::MaxStreams - 1 || Size.X <= 0 || Size.Y <= 0)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("AddAnalysisStream(%dx%d) ignored: invalid size or too many streams"), Size.X, Size.Y);
+        return INDEX_NONE;
+    }
+
+    GAnalysisStreamRequests.Add({ Size, bLumaOnly });
+    const int32 StreamId = GAnalysisStreamRequests.Num();
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Analysis stream %d requested: %dx%d%s%s"), StreamId, Size.X, Size.Y,
+        bLumaOnly ? TEXT(" luma-only") : TEXT(""),
+        bCameraPreviewActive ? TEXT(" (applies on next StartCameraPreview)") : TEXT(""));
+    return StreamId;
+}
+
+void USimpleCamera2Test::ClearAnalysisStreams()
+{
+    GAnalysisStreamRequests.Reset();
+}
+
+FCamera2PipelineStats USimpleCamera2Test::GetStreamStats(int32 StreamId)
+{
+    FCamera2PipelineStats Stats;
+    if (StreamId >= 0 && StreamId < FCamera2FramePipeline::MaxStreams)
+    {
+        FCamera2FramePipeline::Get(StreamId).FillStats(Stats);
+    }
+    return Stats;
+}
+
+FDelegateHandle USimpleCamera2Test::AddStreamConsumer(int32 StreamId, FOnCamera2StreamFrame::FDelegate&& Consumer)
+{
+    if (StreamId < 0 || StreamId >= FCamera2FramePipeline::MaxStreams)
+    {
+        return FDelegateHandle();
+    }
+    return FCamera2FramePipeline::Get(StreamId).AddConsumer(MoveTemp(Consumer));
+}
+
+void USimpleCamera2Test::RemoveStreamConsumer(int32 StreamId, FDelegateHandle Handle)
+{
+    if (StreamId >= 0 && StreamId < FCamera2FramePipeline::MaxStreams)
+    {
+        FCamera2FramePipeline::Get(StreamId).RemoveConsumer(Handle);
+    }
+}
+
+void USimpleCamera2Test::SetCameraTextureBufferCount(int32 Count)
+{
+    GCameraTextureBufferCount = FMath::Clamp(Count, 1, FCamera2FramePipeline::MaxTextureBuffers);
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Camera texture buffers set to %d%s"), GCameraTextureBufferCount,
+        bCameraPreviewActive ? TEXT(" (applies on next StartCameraPreview)") : TEXT(""));
+}
+
+void USimpleCamera2Test::SetOutputFormat(ECamera2OutputFormat Format)
+{
+    GOutputFormat = Format;
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Camera output format set to %d%s"), static_cast<int32>(Format),
+        bCameraPreviewActive ? TEXT(" (applies on next StartCameraPreview)") : TEXT(""));
+}
+
+void USimpleCamera2Test::SetColorConfig(const FCamera2ColorConfig& Config)
+{
+    GColorConfig = Config;
+    GLoadedLutPath.Reset(); // re-read the LUT file
+    ApplyColorConfig();
+}
+
+FCamera2ColorConfig USimpleCamera2Test::GetColorConfig()
+{
+    return GColorConfig;
+}
+
+void USimpleCamera2Test::SetFeatureDetection(bool bEnable, const FCamera2FeatureConfig& Config)
+{
+    // Once removed, no worker is detecting and the stage state below can be changed without a lock
+    if (GFeatureStreamId != INDEX_NONE)
+    {
+        FCamera2FramePipeline::Get(GFeatureStreamId).RemoveConsumer(GFeatureConsumerHandle);
+        GFeatureStreamId = INDEX_NONE;
+        GFeatureConsumerHandle.Reset();
+    }
+    if (!bEnable)
+    {
+        return;
+    }
+    if (Config.StreamId < 0 || Config.StreamId >= FCamera2FramePipeline::MaxStreams)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("SetFeatureDetection: invalid stream id %d"), Config.StreamId);
+        return;
+    }
+
+    GFeatureConfig = Config;
+    GFeatureConfig.Threshold = FMath::Clamp(Config.Threshold, 1, 254);
+    GFeatureConfig.PyramidLevel = FMath::Clamp(Config.PyramidLevel, 0, Camera2Features::MaxPyramidLevel);
+    GFeatureConfig.MaxKeypoints = FMath::Max(Config.MaxKeypoints, 0);
+    {
+        FScopeLock Lock(&GFeatureLock);
+        GLatestKeypoints = FCamera2KeypointFrame();
+    }
+    GFeatureConsumerHandle = FCamera2FramePipeline::Get(Config.StreamId).AddConsumer(
+        FOnCamera2StreamFrame::FDelegate::CreateStatic(&DetectStreamKeypoints));
+    GFeatureStreamId = Config.StreamId;
+}
+
+FCamera2KeypointFrame USimpleCamera2Test::GetLatestKeypoints()
+{
+    FScopeLock Lock(&GFeatureLock);
+    return GLatestKeypoints;
+}
+
+FOnCamera2Keypoints& USimpleCamera2Test::OnKeypoints()
+{
+    return GOnKeypoints;
+}
+
+void USimpleCamera2Test::SetMarkerDetection(bool bEnable, const FCamera2MarkerConfig& Config)
+{
+    // Once removed, no worker is detecting and the stage state below can be changed without a lock
+    if (GMarkerStreamId != INDEX_NONE)
+    {
+        FCamera2FramePipeline::Get(GMarkerStreamId).RemoveConsumer(GMarkerConsumerHandle);
+        GMarkerStreamId = INDEX_NONE;
+        GMarkerConsumerHandle.Reset();
+    }
+    if (!bEnable)
+    {
+        return;
+    }
+    if (Config.StreamId < 0 || Config.StreamId >= FCamera2FramePipeline::MaxStreams)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("SetMarkerDetection: invalid stream id %d"), Config.StreamId);
+        return;
+    }
+
+    Camera2Markers::FDictionary Dictionary;
+    if (Config.DictionaryCodes.Num() > 0)
+    {
+        Dictionary.Bits = Config.DictionaryBits;
+        const uint64 Mask = Config.DictionaryBits > 0 && Config.DictionaryBits <= 8
+            ? (~0ull >> (64 - Config.DictionaryBits * Config.DictionaryBits)) : 0;
+        for (const int64 Code : Config.DictionaryCodes)
+        {
+            Dictionary.Codes.Add(static_cast<uint64>(Code) & Mask);
+        }
+        if (!Dictionary.IsValid())
+        {
+            UE_LOG(LogSimpleCamera2, Warning, TEXT("SetMarkerDetection: custom dictionary needs 3-8 bits per side (got %d)"), Config.DictionaryBits);
+            return;
+        }
+    }
+    else
+    {
+        Dictionary = Camera2Markers::MakeArucoOriginalDictionary();
+    }
+
+    GMarkerConfig = Config;
+    GMarkerConfig.MarkerSizeCm = Config.MarkerSizeCm > 0.0f ? Config.MarkerSizeCm : 10.0f;
+    GMarkerConfig.Threads = FMath::Clamp(Config.Threads, 1, 4);
+    GMarkerConfig.FrameInterval = FMath::Max(Config.FrameInterval, 1);
+    GMarkerDictionary = MoveTemp(Dictionary);
+    GMarkerFrameCount = 0;
+    {
+        FScopeLock Lock(&GMarkerLock);
+        GLatestMarkers = FCamera2MarkerFrame();
+    }
+    GMarkerConsumerHandle = FCamera2FramePipeline::Get(Config.StreamId).AddConsumer(
+        FOnCamera2StreamFrame::FDelegate::CreateStatic(&DetectStreamMarkers));
+    GMarkerStreamId = Config.StreamId;
+}
+
+FCamera2MarkerFrame USimpleCamera2Test::GetLatestMarkers()
+{
+    FScopeLock Lock(&GMarkerLock);
+    return GLatestMarkers;
+}
+
+FOnCamera2Markers& USimpleCamera2Test::OnMarkers()
+{
+    return GOnMarkers;
+}
+
+void USimpleCamera2Test::SetImageStats(bool bEnable, const FCamera2ImageStatsConfig& Config)
+{
+    if (Config.StreamId < 0 || Config.StreamId >= FCamera2FramePipeline::MaxStreams)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("SetImageStats: invalid stream id %d"), Config.StreamId);
+        return;
+    }
+    FCamera2FramePipeline::Get(Config.StreamId).SetImageStats(bEnable, Config);
+}
+
+bool USimpleCamera2Test::GetLatestImageStats(int32 StreamId, FCamera2ImageStats& OutStats)
+{
+    if (StreamId < 0 || StreamId >= FCamera2FramePipeline::MaxStreams)
+    {
+        return false;
+    }
+    return FCamera2FramePipeline::Get(StreamId).GetLatestImageStats(OutStats);
+}
+
+void USimpleCamera2Test::SetStillCapture(bool bEnable, const FCamera2StillConfig& Config)
+{
+    GStillRequested = bEnable;
+    GStillConfig = Config;
+    GStillConfig.Size = FIntPoint(FMath::Max(Config.Size.X, 0), FMath::Max(Config.Size.Y, 0));
+    GStillConfig.JpegQuality = FMath::Clamp(Config.JpegQuality, 1, 100);
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Still output %s: %dx%d %s%s"), bEnable ? TEXT("requested") : TEXT("disabled"),
+        GStillConfig.Size.X, GStillConfig.Size.Y, GStillConfig.Format == ECamera2StillFormat::Yuv ? TEXT("YUV") : TEXT("JPEG"),
+        bCameraPreviewActive ? TEXT(" (applies on next StartCameraPreview)") : TEXT(""));
+}
+
+int32 USimpleCamera2Test::CaptureStill()
+{
+#if PLATFORM_ANDROID
+    if (!bCameraPreviewActive || GStillSize.X <= 0 || !Camera2HelperInstance)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("CaptureStill: no still output in the running session (SetStillCapture before StartCameraPreview)"));
+        return INDEX_NONE;
+    }
+    JNIEnv* Env = FAndroidApplication::GetJavaEnv();
+    if (!Env)
+    {
+        return INDEX_NONE;
+    }
+
+    FPendingStill Pending;
+    Pending.Format = GStillConfig.Format;
+    Pending.RequestSeconds = FPlatformTime::Seconds();
+    int32 RequestId;
+    {
+        FScopeLock Lock(&GStillLock);
+        if (GPendingStills.Num() >= MaxPendingStills)
+        {
+            UE_LOG(LogSimpleCamera2, Warning, TEXT("CaptureStill: %d captures already in flight"), GPendingStills.Num());
+            return INDEX_NONE;
+        }
+        RequestId = GNextStillRequestId++;
+        Pending.RequestId = RequestId;
+        GPendingStills.Add(MoveTemp(Pending));
+    }
+
+    jboolean bSubmitted = JNI_FALSE;
+    jclass HelperClass = Env->GetObjectClass(Camera2HelperInstance);
+    jmethodID CaptureMethod = HelperClass ? Env->GetMethodID(HelperClass, "captureStill", "(I)Z") : nullptr;
+    if (CaptureMethod)
+    {
+        bSubmitted = Env->CallBooleanMethod(Camera2HelperInstance, CaptureMethod, (jint)RequestId);
+    }
+    if (Env->ExceptionCheck())
+    {
+        Env->ExceptionDescribe();
+        Env->ExceptionClear();
+        bSubmitted = JNI_FALSE;
+    }
+    if (HelperClass)
+    {
+        Env->DeleteLocalRef(HelperClass);
+    }
+
+    if (bSubmitted != JNI_TRUE)
+    {
+        FScopeLock Lock(&GStillLock);
+        GPendingStills.RemoveAll([RequestId](const FPendingStill& Entry) { return Entry.RequestId == RequestId; });
+        return INDEX_NONE;
+    }
+    return RequestId;
+#else
+    UE_LOG(LogSimpleCamera2, Warning, TEXT("CaptureStill only available on Android"));
+    return INDEX_NONE;
+#endif
+}
+
+bool USimpleCamera2Test::TakeLatestStill(FCamera2StillImage& OutStill)
+{
+    FScopeLock Lock(&GStillLock);
+    if (!GLatestStill.IsValid())
+    {
+        return false;
+    }
+    OutStill = MoveTemp(*GLatestStill);
+    GLatestStill.Reset();
+    GLatestStillReservation.Reset();
+    return true;
+}
+
+FOnCamera2StillCaptured& USimpleCamera2Test::OnStillCaptured()
+{
+    return GOnStillCaptured;
+}
+
+static bool PublishStreamingStats(float DeltaTime)
+{
+    if (GPreviewStreamer)
+    {
+        const FCamera2PipelineStats Stats = USimpleCamera2Test::GetPipelineStats();
+        const FCamera2FramePipeline& Pipeline = FCamera2FramePipeline::Get(GStreamingStreamId);
+        GPreviewStreamer->SetStatsText(FString::Printf(
+            TEXT("stream_id=%d\nstream_size=%dx%d\ncamera_fps=%.1f\ncaptures=%lld\ndelivered=%lld\nqueue_drops=%lld\n")
+            TEXT("sensor_drops=%lld\nbuffers_lost=%lld\npipeline_drops=%lld\nuploads_superseded=%lld\nupload_latency_ms=%.2f\n")
+            TEXT("upload_cost_ms=%.2f\nupload_stalls=%lld\npaused=%d\ntime_to_first_frame_ms=%.1f\n")
+            TEXT("frame_memory_kb=%lld\nframe_memory_peak_kb=%lld\nframe_memory_budget_kb=%lld\nbudget_drops=%lld\n"),
+            GStreamingStreamId, Pipeline.GetWidth(), Pipeline.GetHeight(), Stats.MeasuredFps, Stats.CapturesCompleted,
+            Stats.FramesDelivered, Stats.QueueDrops, Stats.SensorDrops, Stats.BuffersLost, Stats.PipelineDrops,
+            Stats.UploadsSuperseded, Stats.UploadLatencyMs, Stats.UploadCostMs, Stats.UploadStalls, Stats.bPaused ? 1 : 0,
+            Stats.TimeToFirstFrameMs, Stats.FrameMemoryBytes / 1024, Stats.FrameMemoryPeakBytes / 1024,
+            Stats.FrameMemoryBudgetBytes / 1024, Stats.BudgetDrops));
+    }
+    return true;
+}
+
+bool USimpleCamera2Test::SetPreviewStreaming(bool bEnable, const FCamera2StreamingConfig& Config)
+{
+    // Unregister first: once RemoveConsumer returns no worker is inside the streamer's consumer
+    if (GStreamingStreamId != INDEX_NONE)
+    {
+        FCamera2FramePipeline::Get(GStreamingStreamId).RemoveConsumer(GStreamingConsumerHandle);
+        GStreamingStreamId = INDEX_NONE;
+        GStreamingConsumerHandle.Reset();
+    }
+    if (GStreamingStatsTicker.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(GStreamingStatsTicker);
+        GStreamingStatsTicker.Reset();
+    }
+    GPreviewStreamer.Reset();
+    if (!bEnable)
+    {
+        return true;
+    }
+    if (Config.StreamId < 0 || Config.StreamId >= FCamera2FramePipeline::MaxStreams)
+    {
+        UE_LOG(LogSimpleCamera2, Warning, TEXT("SetPreviewStreaming: invalid stream id %d"), Config.StreamId);
+        return false;
+    }
+
+    TUniquePtr<FCamera2PreviewStreamer> Streamer = MakeUnique<FCamera2PreviewStreamer>();
+    if (!Streamer->Start(Config))
+    {
+        return false;
+    }
+    GPreviewStreamer = MoveTemp(Streamer);
+    GStreamingStreamId = Config.StreamId;
+    GStreamingConsumerHandle = FCamera2FramePipeline::Get(Config.StreamId).AddConsumer(
+        FOnCamera2StreamFrame::FDelegate::CreateRaw(GPreviewStreamer.Get(), &FCamera2PreviewStreamer::OnFrame));
+    if (Config.StatsIntervalSeconds > 0.0f)
+    {
+        GStreamingStatsTicker = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateStatic(&PublishStreamingStats), Config.StatsIntervalSeconds);
+    }
+    return true;
+}
+
+FCamera2StreamingStats USimpleCamera2Test::GetStreamingStats()
+{
+    FCamera2StreamingStats Stats;
+    if (GPreviewStreamer)
+    {
+        GPreviewStreamer->FillStats(Stats);
+    }
+    return Stats;
+}
+
+void USimpleCamera2Test::SetFrameMemoryBudget(int64 BudgetBytes)
+{
+    Camera2Memory::SetBudget(BudgetBytes);
+    FCamera2MemoryStats Stats;
+    Camera2Memory::FillStats(Stats);
+    UE_LOG(LogSimpleCamera2, Log, TEXT("Frame memory budget %s (%.1f MB in use)"),
+        Stats.BudgetBytes > 0 ? *FString::Printf(TEXT("%.1f MB"), Stats.BudgetBytes / (1024.0 * 1024.0)) : TEXT("unlimited"),
+        Stats.LiveBytes / (1024.0 * 1024.0));
+}
+
+FCamera2MemoryStats USimpleCamera2Test::GetFrameMemoryStats()
+{
+    FCamera2MemoryStats Stats;
+    Camera2Memory::FillStats(Stats);
+    return Stats;
+}
+
+void USimpleCamera2Test::BindCameraTextureParameter(UMaterialInstanceDynamic* Material, FName ParameterName)
+{
+    if (!Material)
+    {
+        return;
+    }
+
+    UnbindCameraTextureParameter(Material);
+    GCameraTextureBindings.Add({ Material, ParameterName });
+    if (CameraTexture)
+    {
+        Material->SetTextureParameterValue(ParameterName, CameraTexture);
+    }
+}
+
+void USimpleCamera2Test::UnbindCameraTextureParameter(UMaterialInstanceDynamic* Material)
+{
+    GCameraTextureBindings.RemoveAllSwap([Material](const FCameraTextureBinding& Binding)
+    {
+        return !Binding.Material.IsValid() || Binding.Material.Get() == Material;
+    });
+}
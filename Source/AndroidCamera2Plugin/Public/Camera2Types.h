@@ -0,0 +1,972 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera2Types.generated.h"
+
+/**
+ * How the ImageReader queue is drained when a new image becomes available
+ */
+UENUM(BlueprintType)
+enum class ECamera2FrameConsumption : uint8
+{
+    /** acquireLatestImage: always process the newest frame, older queued frames are dropped */
+    LatestOnly,
+    /** acquireNextImage: process every queued frame in capture order */
+    InOrder
+};
+
+/**
+ * Pixel layout of the camera texture produced by the native pipeline
+ */
+UENUM(BlueprintType)
+enum class ECamera2OutputFormat : uint8
+{
+    /** PF_B8G8R8A8, 4 bytes per pixel */
+    BGRA8,
+    /** PF_G8 straight from the Y plane, 1 byte per pixel (chroma is not copied) */
+    Luma,
+    /** PF_B5G6R5_UNORM packed color, 2 bytes per pixel */
+    RGB565,
+    /** PF_G8 texture of Width x Height*3/2: Y plane followed by interleaved UV rows, decoded in the material */
+    NV12
+};
+
+/**
+ * YUV -> RGB matrix standard used by the conversion kernels
+ */
+UENUM(BlueprintType)
+enum class ECamera2ColorStandard : uint8
+{
+    /** From the image DataSpace reported by the camera (JFIF / BT.601 when unspecified) */
+    Auto,
+    BT601,
+    BT709,
+    BT2020
+};
+
+UENUM(BlueprintType)
+enum class ECamera2ColorRange : uint8
+{
+    /** From the image DataSpace reported by the camera (full range when unspecified) */
+    Auto,
+    /** Y and chroma use 0-255 */
+    Full,
+    /** Y in 16-235, chroma in 16-240 */
+    Limited
+};
+
+/**
+ * ISP processing stage mode (NOISE_REDUCTION_MODE / EDGE_MODE)
+ */
+UENUM(BlueprintType)
+enum class ECamera2ProcessingMode : uint8
+{
+    /** Keep the TEMPLATE_PREVIEW default */
+    Default,
+    Off,
+    Fast,
+    HighQuality
+};
+
+/**
+ * How the last StartCameraPreview / ResumeCameraPreview got frames flowing again
+ */
+UENUM(BlueprintType)
+enum class ECamera2ResumeMode : uint8
+{
+    /** Full start: helper lookup, camera selection, readers, device open and session configuration */
+    ColdStart,
+    /** The paused session was still valid; only the repeating request was resubmitted */
+    WarmSession,
+    /** The device was lost while paused and reopened with the cached readers, textures and configuration */
+    Reopen
+};
+
+/**
+ * Snapshot of the camera pipeline counters (all counts since the last StartCameraPreview)
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2PipelineStats
+{
+    GENERATED_BODY()
+
+    // Capture results completed by the camera device
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 CapturesCompleted = 0;
+
+    // Frames handed from the ImageReader to the conversion path
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 FramesDelivered = 0;
+
+    // Completed captures whose image was skipped in the ImageReader queue (matched by SENSOR_TIMESTAMP)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 QueueDrops = 0;
+
+    // Frame numbers missing from the completed result sequence (failed or never delivered captures)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 SensorDrops = 0;
+
+    // Captures reported through onCaptureBufferLost
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 BuffersLost = 0;
+
+    // ImageReader maxImages currently in use
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int32 MaxImages = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    ECamera2FrameConsumption Consumption = ECamera2FrameConsumption::LatestOnly;
+
+    // Frames converted by the native pipeline
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 FramesConverted = 0;
+
+    // Frames dropped because every native ring slot was in use
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 PipelineDrops = 0;
+
+    // Converted frames replaced by a newer one before the texture upload (not drops: consumers still ran)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 UploadsSuperseded = 0;
+
+    // Delivered frame rate measured from sensor timestamps
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    float MeasuredFps = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int32 RingDepth = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int32 ConversionThreads = 0;
+
+    // True when a constrained high-speed session is running (never with the plugin's YUV reader outputs)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    bool bHighSpeedSession = false;
+
+    // Upper bound of the FPS range requested from the session
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int32 TargetFps = 0;
+
+    // The device rejected the capture session for the last start, even with the display stream alone
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    bool bSessionFailed = false;
+
+    // Camera textures rotated per upload (1 = single texture)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int32 TextureBuffers = 0;
+
+    // Texture updates that held the render thread longer than 1 ms
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 UploadStalls = 0;
+
+    // Average time from upload enqueue on the game thread until the texture holds the frame
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    float UploadLatencyMs = 0.0f;
+
+    // Average render-thread time spent in UpdateTexture2D
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    float UploadCostMs = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    ECamera2OutputFormat OutputFormat = ECamera2OutputFormat::BGRA8;
+
+    // Bytes uploaded to the GPU per displayed frame
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int32 UploadBytesPerFrame = 0;
+
+    // YUV matrix and range the display stream is converted with (resolved, never Auto)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    ECamera2ColorStandard ColorStandard = ECamera2ColorStandard::BT601;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    ECamera2ColorRange ColorRange = ECamera2ColorRange::Full;
+
+    // Edge length of the calibration 3D LUT applied during conversion (0 = none)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int32 ColorLutSize = 0;
+
+    // True between PauseCameraPreview and ResumeCameraPreview (the session and texture are kept)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    bool bPaused = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    ECamera2ResumeMode LastStartMode = ECamera2ResumeMode::ColdStart;
+
+    // From the last start or resume call until its first frame reached the camera texture (0 while waiting)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    float TimeToFirstFrameMs = 0.0f;
+
+    // Frame memory the plugin holds and its budget (0 = unlimited); per pool in GetFrameMemoryStats
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 FrameMemoryBytes = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 FrameMemoryPeakBytes = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 FrameMemoryBudgetBytes = 0;
+
+    // Frames, stills and streamed frames dropped because their memory did not fit in the budget
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Stats")
+    int64 BudgetDrops = 0;
+
+    int64 GetTotalDrops() const { return QueueDrops + SensorDrops + BuffersLost + PipelineDrops; }
+};
+
+/**
+ * Per-frame capture metadata taken from the TotalCaptureResult matching the frame's SENSOR_TIMESTAMP
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2FrameMetadata
+{
+    GENERATED_BODY()
+
+    // False when no capture result with this frame's timestamp was received in time
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    bool bValid = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    int64 FrameNumber = -1;
+
+    // SENSOR_TIMESTAMP (ns, start of exposure of the first row)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    int64 SensorTimestampNs = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    int64 ExposureTimeNs = 0;
+
+    // SENSOR_SENSITIVITY (ISO)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    int32 Sensitivity = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    int64 FrameDurationNs = 0;
+
+    // CONTROL_AE_STATE / CONTROL_AF_STATE raw values (-1 if not reported)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    int32 AeState = -1;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    int32 AfState = -1;
+
+    // LENS_FOCUS_DISTANCE (diopters, 0 = infinity)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    float LensFocusDistance = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Metadata")
+    int64 RollingShutterSkewNs = 0;
+};
+
+/**
+ * Current estimate of the SENSOR_TIMESTAMP clock -> FPlatformTime::Seconds mapping
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2ClockMapping
+{
+    GENERATED_BODY()
+
+    // False until the first capture of the session started
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Timing")
+    bool bValid = false;
+
+    // SENSOR_INFO_TIMESTAMP_SOURCE: 0 = UNKNOWN, 1 = REALTIME (elapsedRealtimeNanos), -1 = not reported
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Timing")
+    int32 TimestampSource = -1;
+
+    // Engine seconds minus sensor seconds at the newest sample
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Timing")
+    double OffsetSeconds = 0.0;
+
+    // Engine clock rate relative to the sensor clock, parts per million
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Timing")
+    float DriftPpm = 0.0f;
+
+    // 3-sigma bound of the mapping at the newest sample
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Timing")
+    double ErrorSeconds = 0.0;
+
+    // Half-second windows in the fit (up to 17) and clock samples seen
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Timing")
+    int32 WindowPoints = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Timing")
+    int64 Samples = 0;
+
+    // Persistent offset steps that restarted the fit (e.g. after device suspend)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Timing")
+    int32 ClockSteps = 0;
+};
+
+/**
+ * Manual capture controls applied to the repeating preview request.
+ * Changes are coalesced on the Java side into at most one request rebuild per frame.
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2CaptureControls
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls")
+    bool bAeLock = false;
+
+    // Locks AF where it is (CONTROL_AF_TRIGGER_START); no effect on fixed-focus lenses
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls")
+    bool bAfLock = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls")
+    bool bAwbLock = false;
+
+    // Turns AE off and uses ExposureTimeNs/Sensitivity/FrameDurationNs (clamped to the sensor ranges).
+    // Needs the MANUAL_SENSOR capability; AE stays on without it.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls")
+    bool bManualExposure = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls", meta = (EditCondition = "bManualExposure"))
+    int64 ExposureTimeNs = 8000000;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls", meta = (EditCondition = "bManualExposure"))
+    int32 Sensitivity = 400;
+
+    // 0 = sensor default
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls", meta = (EditCondition = "bManualExposure"))
+    int64 FrameDurationNs = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls")
+    ECamera2ProcessingMode NoiseReduction = ECamera2ProcessingMode::Default;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls")
+    ECamera2ProcessingMode EdgeEnhancement = ECamera2ProcessingMode::Default;
+
+    // CONTROL_AE_TARGET_FPS_RANGE; ignored unless 0 < Min <= Max
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls")
+    int32 FpsRangeMin = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Controls")
+    int32 FpsRangeMax = 0;
+};
+
+/**
+ * Color stage of the display conversion: YUV matrix/range plus an optional per-device 3D LUT
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2ColorConfig
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Color")
+    ECamera2ColorStandard Standard = ECamera2ColorStandard::Auto;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Color")
+    ECamera2ColorRange Range = ECamera2ColorRange::Auto;
+
+    // Apply a calibration LUT (.cube, 2-65 points per axis) after the matrix
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Color")
+    bool bUseLut = true;
+
+    // Empty = per-device default: color_lut_<cameraId>.cube next to the characteristics dump
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Color", meta = (EditCondition = "bUseLut"))
+    FString LutFile;
+};
+
+/**
+ * FAST-9 keypoint stage run natively on a stream's Y plane
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2FeatureConfig
+{
+    GENERATED_BODY()
+
+    // 0 = display stream, otherwise an id returned by AddAnalysisStream
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Features")
+    int32 StreamId = 0;
+
+    // Minimum intensity difference of the 9-pixel arc to the center (1-254)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Features")
+    int32 Threshold = 20;
+
+    // Detect on the Y plane downsampled 2^Level times (0-3); positions are reported at full stream resolution
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Features")
+    int32 PyramidLevel = 0;
+
+    // Keep only corners whose score is a 3x3 local maximum
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Features")
+    bool bNonMaxSuppression = true;
+
+    // Keypoint budget spread over a GridColumns x GridRows grid (strongest per cell first, leftovers by score)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Features")
+    int32 MaxKeypoints = 500;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Features")
+    int32 GridColumns = 8;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Features")
+    int32 GridRows = 6;
+
+    // Skip frames whose image stats change score is below this (needs SetImageStats on the stream; 0 = every frame)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Features")
+    float MinChangeScore = 0.0f;
+};
+
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2Keypoint
+{
+    GENERATED_BODY()
+
+    // Stream pixel coordinates (pixel indices at level 0; pyramid corners map to the center of their 2^Level box)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    FVector2D Position = FVector2D::ZeroVector;
+
+    // Pinhole-normalized coordinates from the lens intrinsics scaled to the stream; zero when intrinsics are unknown
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    FVector2D Normalized = FVector2D::ZeroVector;
+
+    // FAST score: smallest center difference along the best arc (> Threshold)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    int32 Score = 0;
+};
+
+/**
+ * Keypoints detected on one frame
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2KeypointFrame
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    int32 StreamId = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    int64 FrameNumber = -1;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    int64 SensorTimestampNs = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    FIntPoint StreamSize = FIntPoint::ZeroValue;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    TArray<FCamera2Keypoint> Keypoints;
+
+    // Corners found (after non-max suppression) before the budget was applied
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    int32 CornersDetected = 0;
+
+    // Pyramid + detection + selection time on the worker thread
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Features")
+    float DetectMs = 0.0f;
+};
+
+/**
+ * Square fiducial marker stage run natively on a stream's Y plane
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2MarkerConfig
+{
+    GENERATED_BODY()
+
+    // 0 = display stream, otherwise an id returned by AddAnalysisStream
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    int32 StreamId = 0;
+
+    // Edge length of the black square (border included); pose translations use this unit
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    float MarkerSizeCm = 10.0f;
+
+    // Threshold and quad search run on the image downsampled by 1, 2 or 4; corners are refined at full resolution
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    int32 Decimation = 2;
+
+    // Worker threads used for thresholding and per-quad decoding (1-4)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    int32 Threads = 1;
+
+    // Run on every Nth frame of the stream
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    int32 FrameInterval = 1;
+
+    // Skip frames whose image stats change score is below this (needs SetImageStats on the stream; 0 = every frame)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    float MinChangeScore = 0.0f;
+
+    // Smallest marker edge considered, in stream pixels
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    int32 MinMarkerPixels = 24;
+
+    // Minimum black/white difference for thresholding and decoding
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    int32 MinContrast = 20;
+
+    // Bit errors tolerated when matching a code against the dictionary
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    int32 MaxHammingDistance = 0;
+
+    // Custom dictionary: interior size in cells (3-8) and one code per id, row-major with the first cell in the
+    // most significant bit and 1 = white. Empty = original ArUco dictionary (5x5, 1024 ids).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    int32 DictionaryBits = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Markers")
+    TArray<int64> DictionaryCodes;
+};
+
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2Marker
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    int32 Id = INDEX_NONE;
+
+    // Stream pixel coordinates of the marker's top-left, top-right, bottom-right and bottom-left corners
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    TArray<FVector2D> Corners;
+
+    // False when the intrinsics are unknown or the solve did not converge
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    bool bPoseValid = false;
+
+    // Marker in camera space, UE axes (X forward, Y right, Z up) and cm. The marker's X axis points into its
+    // printed face, Y to its right edge and Z to its top edge, so a marker seen head-on has no rotation.
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    FTransform Pose;
+
+    // RMS corner reprojection error of the pose
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    float ReprojectionErrorPx = 0.0f;
+};
+
+/**
+ * Markers detected on one frame
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2MarkerFrame
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    int32 StreamId = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    int64 FrameNumber = -1;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    int64 SensorTimestampNs = 0;
+
+    // SensorTimestampNs mapped to FPlatformTime::Seconds (0 until the clock mapping has samples)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    double EngineSeconds = 0.0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    TArray<FCamera2Marker> Markers;
+
+    // Quads that were decoded (markers plus rejects)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    int32 Candidates = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Markers")
+    float DetectMs = 0.0f;
+};
+
+/**
+ * Per-frame luma statistics computed natively on a stream's Y plane before its consumers run
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2ImageStatsConfig
+{
+    GENERATED_BODY()
+
+    // 0 = display stream, otherwise an id returned by AddAnalysisStream
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|ImageStats")
+    int32 StreamId = 0;
+
+    // Edge of the blocks compared between frames for the change score (multiple of 16, 16-128)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|ImageStats")
+    int32 BlockSize = 32;
+
+    // Luma levels a block mean has to move (beyond the frame-wide shift) to count as changed
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|ImageStats")
+    float ChangeThreshold = 6.0f;
+};
+
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2ImageStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|ImageStats")
+    int32 StreamId = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|ImageStats")
+    int64 FrameNumber = -1;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|ImageStats")
+    int64 SensorTimestampNs = 0;
+
+    // 256 luma bins
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|ImageStats")
+    TArray<int32> Histogram;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|ImageStats")
+    float Mean = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|ImageStats")
+    float Variance = 0.0f;
+
+    // Variance of the 4-neighbour Laplacian; drops with blur, but also depends on scene texture, so compare it over time
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|ImageStats")
+    float Sharpness = 0.0f;
+
+    // Fraction of blocks that changed since the previous frame of the stream (1 for the first frame)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|ImageStats")
+    float ChangeScore = 1.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|ImageStats")
+    float ComputeMs = 0.0f;
+};
+
+/**
+ * Lens intrinsics of one output stream, derived from LENS_INTRINSIC_CALIBRATION and the sensor arrays for the
+ * region of the sensor the stream sees. Pixel coordinates have pixel centers at integers.
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2StreamIntrinsics
+{
+    GENERATED_BODY()
+
+    // False until the camera reported a calibration and the stream is configured
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    bool bValid = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    FIntPoint Size = FIntPoint::ZeroValue;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float Fx = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float Fy = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float Cx = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float Cy = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float Skew = 0.0f;
+
+    // Brown-Conrady radial and tangential terms on normalized coordinates (independent of the stream size)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float K1 = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float K2 = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float K3 = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float P1 = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float P2 = 0.0f;
+
+    // Sensor region imaged by the stream, in active array pixels (the crop region cut to the stream aspect)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    FVector2D CropOrigin = FVector2D::ZeroVector;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    FVector2D CropSize = FVector2D::ZeroVector;
+
+    // Undistorted field of view through the principal point
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float HorizontalFovDegrees = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Intrinsics")
+    float VerticalFovDegrees = 0.0f;
+};
+
+/**
+ * Undistorted unit view ray of every pixel of a stream in UE camera axes (X forward, Y right, Z up),
+ * row-major. Built once per stream configuration and shared read-only.
+ */
+struct FCamera2RayTable
+{
+    int32 Width = 0;
+    int32 Height = 0;
+    TArray<FVector3f> Directions;
+
+    const FVector3f& GetRay(int32 X, int32 Y) const { return Directions[Y * Width + X]; }
+};
+
+/**
+ * Encoding of still captures
+ */
+UENUM(BlueprintType)
+enum class ECamera2StillFormat : uint8
+{
+    /** JPEG file bytes encoded by the camera HAL */
+    Jpeg,
+    /** Uncompressed I420: Y plane followed by the U and V planes, tightly packed */
+    Yuv
+};
+
+/**
+ * Full-resolution still output added to the capture session next to the preview
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2StillConfig
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Still")
+    ECamera2StillFormat Format = ECamera2StillFormat::Jpeg;
+
+    // Requested size; the exact size if offered, else the smallest covering it. Zero = largest output size.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Still")
+    FIntPoint Size = FIntPoint::ZeroValue;
+
+    // JPEG_QUALITY, 1-100
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Still")
+    int32 JpegQuality = 95;
+};
+
+/**
+ * One still capture with the capture result and the intrinsics at its resolution
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2StillImage
+{
+    GENERATED_BODY()
+
+    // Id returned by CaptureStill
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    int32 RequestId = INDEX_NONE;
+
+    // False when the capture failed; Data is empty then
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    bool bSuccess = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    ECamera2StillFormat Format = ECamera2StillFormat::Jpeg;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    FIntPoint Size = FIntPoint::ZeroValue;
+
+    // JPEG file, or I420 planes (Y: Width x Height, U and V: (Width+1)/2 x (Height+1)/2 each)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    TArray<uint8> Data;
+
+    // Capture result of the still request (bValid is false if it had not arrived when the image was delivered)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    FCamera2FrameMetadata Metadata;
+
+    // Sensor timestamp mapped to FPlatformTime::Seconds (0 until the clock mapping has samples)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    double EngineSeconds = 0.0;
+
+    // Pinhole intrinsics at the still resolution; lens distortion coefficients are resolution independent
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    bool bIntrinsicsValid = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    float Fx = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    float Fy = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    float Cx = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    float Cy = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    float Skew = 0.0f;
+
+    // CaptureStill call until the result was ready
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Still")
+    float LatencyMs = 0.0f;
+};
+
+/**
+ * Development preview streaming of one stream to a desktop viewer (Tools/Camera2Viewer) over TCP
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2StreamingConfig
+{
+    GENERATED_BODY()
+
+    // 0 = display stream, otherwise an id returned by AddAnalysisStream (luma-only streams send Y only)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    int32 StreamId = 0;
+
+    // TCP port the device listens on for one viewer (forward it with adb forward tcp:8555 tcp:8555)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    int32 Port = 8555;
+
+    // Listen on all interfaces instead of loopback only; anyone on the network can then watch the camera.
+    // Not needed with adb forward. Streaming is never available in shipping builds.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    bool bAllowRemoteViewers = false;
+
+    // Frames are taken from the stream at most this often
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    float MaxFps = 15.0f;
+
+    // Average send budget; after a large frame the next one waits until the budget is paid back (0 = unlimited)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    int32 MaxKilobytesPerSecond = 4096;
+
+    // Send the Y plane only
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    bool bLumaOnly = false;
+
+    // Luma tile edge in pixels (8-64, multiple of 8); chroma tiles are half as wide
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    int32 TileSize = 16;
+
+    // A tile is resent when its mean absolute difference to the viewer's image exceeds this (8-bit levels)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    float ChangeThreshold = 2.0f;
+
+    // Low bits dropped from every sample before delta coding (0-4)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    int32 QuantizationBits = 1;
+
+    // Sent frames between full keyframes (0 = only when a viewer connects)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    int32 KeyframeInterval = 120;
+
+    // Pipeline stats are sent to the viewer this often (0 = never)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera2|Streaming")
+    float StatsIntervalSeconds = 1.0f;
+};
+
+/**
+ * Counters of the preview streamer since SetPreviewStreaming enabled it
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2StreamingStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    bool bListening = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    bool bViewerConnected = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    int64 FramesSent = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    int64 KeyframesSent = 0;
+
+    // Stream frames passed over because the encoder was still busy with the previous one (the rate limits are not counted)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    int64 FramesSkippedBusy = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    int64 BytesSent = 0;
+
+    // Moving averages over the sent frames
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    float SentFps = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    float KilobytesPerSecond = 0.0f;
+
+    // Plane bytes per sent byte
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    float CompressionRatio = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    float ChangedTilesPercent = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    float EncodeMs = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Streaming")
+    float SendMs = 0.0f;
+};
+
+/**
+ * Frame memory owned by the plugin, accounted against the budget set with SetFrameMemoryBudget
+ */
+USTRUCT(BlueprintType)
+struct ANDROIDCAMERA2PLUGIN_API FCamera2MemoryStats
+{
+    GENERATED_BODY()
+
+    // 0 = unlimited
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 BudgetBytes = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 LiveBytes = 0;
+
+    // Highest LiveBytes since the budget was last set
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 PeakBytes = 0;
+
+    // Native ring slots of all streams (plane copies and converted frames)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 PipelineSlotBytes = 0;
+
+    // Camera textures (texel data, estimated from the layout)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 TextureBytes = 0;
+
+    // Frame copies queued for the render thread (texture clears and the legacy RGBA path)
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 UploadBytes = 0;
+
+    // Stills from capture until TakeLatestStill hands them out or a newer one replaces them
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 StillBytes = 0;
+
+    // Preview streamer staging and encoder buffers
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 StreamingBytes = 0;
+
+    // Reservations refused because they would have exceeded the budget
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 DeniedReservations = 0;
+
+    // Frames, stills and streamed frames dropped for lack of budget
+    UPROPERTY(BlueprintReadOnly, Category = "Camera2|Memory")
+    int64 BudgetDrops = 0;
+};
+
+/**
+ * Read-only view of one frame's planes handed to native stream consumers on a pipeline worker thread.
+ * Planes are tightly packed; U/V are null for luma-only streams. Valid only for the duration of the callback.
+ */
+struct FCamera2FrameView
+{
+    int32 StreamId = 0;
+    int32 Width = 0;
+    int32 Height = 0;
+    const uint8* Y = nullptr;
+    const uint8* U = nullptr;
+    const uint8* V = nullptr;
+    const FCamera2FrameMetadata* Metadata = nullptr;
+    // Set when the image stats stage runs on this stream
+    const FCamera2ImageStats* Stats = nullptr;
+    // Intrinsics of this stream's configuration (null until the camera reported a calibration)
+    const FCamera2StreamIntrinsics* Intrinsics = nullptr;
+};
+
+/** Per-stream native consumer callback (worker thread) */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCamera2StreamFrame, const FCamera2FrameView& /*Frame*/);
+
+/** Keypoints of one frame (worker thread) */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCamera2Keypoints, const FCamera2KeypointFrame& /*Keypoints*/);
+
+/** Markers of one frame (worker thread) */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCamera2Markers, const FCamera2MarkerFrame& /*Markers*/);
+
+/** Finished or failed still capture (worker thread) */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCamera2StillCaptured, const FCamera2StillImage& /*Still*/);
@@ -2,10 +2,14 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "Camera2Types.h"
 #include "SimpleCamera2Test.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSimpleCamera2, Log, All);
 
+/** Fired on the game thread for every frame enqueued to the camera texture */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCamera2FrameReady, const FCamera2FrameMetadata& /*Metadata*/);
+
 /**
  * Simple Camera2 API - Basic camera to texture functionality
  */
@@ -28,8 +32,30 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Camera2")
     static void StopCameraPreview();
 
+    /**
+     * Stop frame delivery but keep the capture session, readers, textures and caches for a fast resume.
+     * Called automatically when the application enters the background (see SetPauseOnBackground).
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2")
+    static void PauseCameraPreview();
+
+    /**
+     * Resume a paused preview: resubmits the repeating request on the kept session, reopens the device with the
+     * cached configuration if it was taken away in the background, or falls back to a full restart.
+     * Time to the first frame is reported in GetPipelineStats.
+     * @return true if frames are flowing again (or about to)
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2")
+    static bool ResumeCameraPreview();
+
+    /** Pause on ApplicationWillEnterBackground and resume on ApplicationHasEnteredForeground (default on) */
+    UFUNCTION(BlueprintCallable, Category = "Camera2")
+    static void SetPauseOnBackground(bool bEnable);
+
     /**
      * Get the camera preview texture (null if preview not started)
+     * With more than one texture buffer this is the buffer holding the latest frame and changes per frame;
+     * use BindCameraTextureParameter for materials.
      * @return texture containing camera feed
      */
     UFUNCTION(BlueprintCallable, Category = "Camera2")
@@ -60,9 +86,212 @@ public:
     // Mapped coefficients for typical UE usage: [K1,K2,P1,P2,K3,K4,K5,K6]
     UFUNCTION(BlueprintPure, Category = "Camera2|Lens Distortion")
     static TArray<float> GetLensDistortionUE();
-    
+
+    /**
+     * Intrinsics and distortion of a configured stream (0 = display stream), derived from the sensor calibration
+     * for the part of the active array the stream shows. Also handed to consumers with every frame.
+     * @return false if the stream is not configured or the camera reported no calibration
+     */
+    UFUNCTION(BlueprintPure, Category = "Camera2|Intrinsics")
+    static bool GetStreamIntrinsics(int32 StreamId, FCamera2StreamIntrinsics& OutIntrinsics);
+
+    /** Undistorted view ray of every pixel of a stream, built on first use per stream configuration (null if none) */
+    static TSharedPtr<const FCamera2RayTable, ESPMode::ThreadSafe> GetStreamRayTable(int32 StreamId);
+
     // Unified access to camera characteristics JSON + saved file path
     UFUNCTION(BlueprintCallable, Category = "Camera2|Characteristics")
     static void GetCameraCharacteristics(bool bRedump, FString& OutJson, FString& OutFilePath);
+
+    /**
+     * Configure the ImageReader queue used by the next StartCameraPreview
+     * @param MaxImages number of buffers in the ImageReader (1-16, LatestOnly needs at least 2)
+     * @param Consumption whether to keep only the newest frame or process every queued frame
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Pipeline")
+    static void SetImageQueueConfig(int32 MaxImages, ECamera2FrameConsumption Consumption);
+
+    /**
+     * Request the highest fixed frame rate for the next StartCameraPreview: the session runs at the highest
+     * fixed AE target FPS range. Constrained high-speed sessions (90/120 fps) are not used, since they accept
+     * only preview and video-encoder surfaces and every plugin output is a CPU-readable YUV ImageReader.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Pipeline")
+    static void SetHighSpeedMode(bool bEnable, int32 TargetFps = 120);
+
+    /**
+     * Get capture/delivery/drop counters for the running preview
+     */
+    UFUNCTION(BlueprintPure, Category = "Camera2|Pipeline")
+    static FCamera2PipelineStats GetPipelineStats();
+
+    /**
+     * Capture metadata of the frame most recently enqueued to the camera texture
+     */
+    UFUNCTION(BlueprintPure, Category = "Camera2|Metadata")
+    static FCamera2FrameMetadata GetLatestFrameMetadata();
+
+    /**
+     * Map a frame's SENSOR_TIMESTAMP (start of exposure of the first row) to FPlatformTime::Seconds using the
+     * online sensor/engine clock estimate. Lock-free, callable from any thread.
+     * @param OutErrorSeconds 3-sigma bound of the estimate (excludes the constant capture callback latency floor)
+     * @return false before the first capture of the session started
+     */
+    UFUNCTION(BlueprintPure, Category = "Camera2|Timing")
+    static bool GetFrameEngineTime(const FCamera2FrameMetadata& Frame, double& OutEngineSeconds, double& OutErrorSeconds);
+
+    /** Offset, drift and error bound of the sensor clock -> engine clock estimate */
+    UFUNCTION(BlueprintPure, Category = "Camera2|Timing")
+    static FCamera2ClockMapping GetSensorClockMapping();
+
+    /**
+     * Set manual capture controls (locks, exposure/ISO, NR/edge mode, FPS range).
+     * Safe to call every tick: updates are coalesced into one repeating request rebuild per frame.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Controls")
+    static void SetCaptureControls(const FCamera2CaptureControls& Controls);
+
+    UFUNCTION(BlueprintPure, Category = "Camera2|Controls")
+    static FCamera2CaptureControls GetCaptureControls();
+
+    /**
+     * Add an extra output surface to the session for the next StartCameraPreview, e.g. a 320x240 luma-only
+     * stream for CV next to the display stream. The combination is validated against the device's
+     * guaranteed stream combinations; rejected streams are left out of the session.
+     * @return stream id to use with AddStreamConsumer/GetStreamStats, or INDEX_NONE
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Streams")
+    static int32 AddAnalysisStream(FIntPoint Size, bool bLumaOnly = true);
+
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Streams")
+    static void ClearAnalysisStreams();
+
+    /** Pipeline counters for one stream (0 = display stream) */
+    UFUNCTION(BlueprintPure, Category = "Camera2|Streams")
+    static FCamera2PipelineStats GetStreamStats(int32 StreamId);
+
+    /** Register a native consumer for a stream's frames; called on a pipeline worker thread */
+    static FDelegateHandle AddStreamConsumer(int32 StreamId, FOnCamera2StreamFrame::FDelegate&& Consumer);
+    static void RemoveStreamConsumer(int32 StreamId, FDelegateHandle Handle);
+
+    /**
+     * Number of camera textures rotated per upload (1-3, applies on the next StartCameraPreview).
+     * With 2-3 buffers a frame is never written into the texture the GPU sampled for the previous frame.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Texture")
+    static void SetCameraTextureBufferCount(int32 Count);
+
+    /**
+     * Camera texture format for the next StartCameraPreview: BGRA8 (4 B/px), Luma as PF_G8 (1 B/px),
+     * RGB565 (2 B/px) or NV12 packed into a Width x Height*3/2 PF_G8 texture (1.5 B/px, decode in the material)
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Texture")
+    static void SetOutputFormat(ECamera2OutputFormat Format);
+
+    /**
+     * Set the color stage of the display conversion: YUV matrix and range (Auto follows the stream DataSpace)
+     * and an optional .cube calibration LUT applied with tetrahedral interpolation. Applies immediately.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Color")
+    static void SetColorConfig(const FCamera2ColorConfig& Config);
+
+    UFUNCTION(BlueprintPure, Category = "Camera2|Color")
+    static FCamera2ColorConfig GetColorConfig();
+
+    /**
+     * Run a FAST-9 corner detector (non-max suppression, grid-bucketed keypoint budget) on a stream's Y plane
+     * or a pyramid level of it, on the pipeline worker thread of every frame. Replaces any previous stage.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Features")
+    static void SetFeatureDetection(bool bEnable, const FCamera2FeatureConfig& Config);
+
+    /** Keypoints of the most recently detected frame with its timestamp */
+    UFUNCTION(BlueprintPure, Category = "Camera2|Features")
+    static FCamera2KeypointFrame GetLatestKeypoints();
+
+    /** Native per-frame keypoint event, fired on the worker thread; handlers must not call SetFeatureDetection */
+    static FOnCamera2Keypoints& OnKeypoints();
+
+    /**
+     * Detect square fiducial markers (original ArUco dictionary or a custom one) on a stream's Y plane on the
+     * pipeline worker thread, with poses from the stream intrinsics and lens distortion. Replaces any previous stage.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Markers")
+    static void SetMarkerDetection(bool bEnable, const FCamera2MarkerConfig& Config);
+
+    /** Markers of the most recently processed frame with its sensor and engine timestamps */
+    UFUNCTION(BlueprintPure, Category = "Camera2|Markers")
+    static FCamera2MarkerFrame GetLatestMarkers();
+
+    /** Native per-frame marker event, fired on the worker thread; handlers must not call SetMarkerDetection */
+    static FOnCamera2Markers& OnMarkers();
+
+    /**
+     * Measure the luma histogram, mean, variance, sharpness and change score of every frame of a stream on the
+     * pipeline worker, before its analysis stages (which can skip frames below their MinChangeScore)
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|ImageStats")
+    static void SetImageStats(bool bEnable, const FCamera2ImageStatsConfig& Config);
+
+    /** Stats of the stream's most recent frame; false until a frame was measured */
+    UFUNCTION(BlueprintPure, Category = "Camera2|ImageStats")
+    static bool GetLatestImageStats(int32 StreamId, FCamera2ImageStats& OutStats);
+
+    /**
+     * Add a full-resolution JPEG or YUV output to the session for the next StartCameraPreview. It is left out if
+     * it does not form a guaranteed stream combination with the preview and analysis streams.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Still")
+    static void SetStillCapture(bool bEnable, const FCamera2StillConfig& Config);
+
+    /**
+     * Issue one TEMPLATE_STILL_CAPTURE request on the running session; the preview keeps streaming. The result
+     * arrives through OnStillCaptured / TakeLatestStill with its capture metadata and intrinsics.
+     * @return request id, or INDEX_NONE if there is no still output or two captures are already in flight
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Still")
+    static int32 CaptureStill();
+
+    /** Move the most recently completed still out (false if none arrived since the last call) */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Still")
+    static bool TakeLatestStill(FCamera2StillImage& OutStill);
+
+    /** Native still event, fired on a worker thread for every completed or failed request */
+    static FOnCamera2StillCaptured& OnStillCaptured();
+
+    /**
+     * Development preview streaming: serve a stream's frames and the pipeline stats to one desktop viewer
+     * (Tools/Camera2Viewer) over TCP, tile-delta + LZ4 encoded on a separate thread under a frame rate and
+     * byte budget. Listens on loopback only unless Config.bAllowRemoteViewers. Replaces any previous streamer.
+     * Keeps running across camera restarts.
+     * @return false if enabling failed (invalid stream id or the port could not be bound), always in shipping builds
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Streaming")
+    static bool SetPreviewStreaming(bool bEnable, const FCamera2StreamingConfig& Config);
+
+    UFUNCTION(BlueprintPure, Category = "Camera2|Streaming")
+    static FCamera2StreamingStats GetStreamingStats();
+
+    /**
+     * Hard limit for the frame memory the plugin owns (ring slots, camera textures, queued frame copies, stills,
+     * streaming buffers). Allocations that would exceed it fail and the plugin degrades instead: rings and the
+     * texture set get fewer buffers on the next start, frames, stills and streamed frames are dropped.
+     * Lowering it does not free memory already held. Also resets the peak in GetFrameMemoryStats.
+     * @param BudgetBytes 0 = unlimited
+     */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Memory")
+    static void SetFrameMemoryBudget(int64 BudgetBytes);
+
+    UFUNCTION(BlueprintPure, Category = "Camera2|Memory")
+    static FCamera2MemoryStats GetFrameMemoryStats();
+
+    /** Keep a material texture parameter pointed at the latest camera texture (updated on every upload) */
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Texture")
+    static void BindCameraTextureParameter(class UMaterialInstanceDynamic* Material, FName ParameterName);
+
+    UFUNCTION(BlueprintCallable, Category = "Camera2|Texture")
+    static void UnbindCameraTextureParameter(class UMaterialInstanceDynamic* Material);
+
+    /** Native per-frame event carrying the metadata matched to each frame */
+    static FOnCamera2FrameReady& OnFrameReady();
     
 };
\ No newline at end of file
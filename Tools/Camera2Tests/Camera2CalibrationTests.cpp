@@ -0,0 +1,212 @@
+#include "Camera2Tests.h"
+#include "Camera2Calibration.h"
+#include "Camera2MarkerDetector.h"
+#include <random>
+
+using namespace Camera2Calibration;
+
+namespace
+{
+    bool IsNear(double A, double B, double Tolerance)
+    {
+        return std::fabs(A - B) <= Tolerance;
+    }
+
+    FSensorCalibration MakeSensor(double Fx, double Fy, double Cx, double Cy, double Skew, const FIntRect& ActiveArray, const FIntRect& PreCorrectionArray)
+    {
+        FSensorCalibration Sensor;
+        Sensor.Fx = Fx;
+        Sensor.Fy = Fy;
+        Sensor.Cx = Cx;
+        Sensor.Cy = Cy;
+        Sensor.Skew = Skew;
+        Sensor.ActiveArray = ActiveArray;
+        Sensor.PreCorrectionArray = PreCorrectionArray;
+        return Sensor;
+    }
+
+    Camera2Markers::FCameraModel MakeCameraModel(const FCamera2StreamIntrinsics& Intrinsics)
+    {
+        Camera2Markers::FCameraModel Model;
+        Model.Fx = Intrinsics.Fx;
+        Model.Fy = Intrinsics.Fy;
+        Model.Cx = Intrinsics.Cx;
+        Model.Cy = Intrinsics.Cy;
+        Model.Skew = Intrinsics.Skew;
+        Model.K[0] = Intrinsics.K1;
+        Model.K[1] = Intrinsics.K2;
+        Model.K[2] = Intrinsics.K3;
+        Model.P[0] = Intrinsics.P1;
+        Model.P[1] = Intrinsics.P2;
+        return Model;
+    }
+
+    /**
+     * Projects a camera-space point with the sensor model, then carries the sensor pixel into the stream by the
+     * Camera2 crop and scale. Written independently of GetOutputCrop: pixel edges scale, centers sit at integers.
+     */
+    void ReferenceProject(const FSensorCalibration& Sensor, const FIntRect& CropRegion, int32 Width, int32 Height, const double Point[3],
+        double& OutU, double& OutV)
+    {
+        double DistortedX;
+        double DistortedY;
+        DistortNormalized(Sensor.K, Sensor.P, Point[0] / Point[2], Point[1] / Point[2], DistortedX, DistortedY);
+        const double SensorU = Sensor.Fx * DistortedX + Sensor.Skew * DistortedY + Sensor.Cx + Sensor.PreCorrectionArray.Min.X - Sensor.ActiveArray.Min.X;
+        const double SensorV = Sensor.Fy * DistortedY + Sensor.Cy + Sensor.PreCorrectionArray.Min.Y - Sensor.ActiveArray.Min.Y;
+
+        double CropWidth = CropRegion.Width();
+        double CropHeight = CropRegion.Height();
+        double Left = CropRegion.Min.X;
+        double Top = CropRegion.Min.Y;
+        const double Aspect = static_cast<double>(Width) / Height;
+        if (CropWidth / CropHeight > Aspect)
+        {
+            Left += (CropWidth - CropHeight * Aspect) / 2;
+            CropWidth = CropHeight * Aspect;
+        }
+        else if (CropWidth / CropHeight < Aspect)
+        {
+            Top += (CropHeight - CropWidth / Aspect) / 2;
+            CropHeight = CropWidth / Aspect;
+        }
+        OutU = (SensorU + 0.5 - Left) * (Width / CropWidth) - 0.5;
+        OutV = (SensorV + 0.5 - Top) * (Height / CropHeight) - 0.5;
+    }
+}
+
+CAMERA2_TEST(IntrinsicsOfFullSensorStream)
+{
+    const FSensorCalibration Sensor = MakeSensor(868.31, 868.31, 640.18, 482.07, 0.0, FIntRect(0, 0, 1280, 960), FIntRect(0, 0, 1280, 960));
+    FCamera2StreamIntrinsics K;
+    CAMERA2_EXPECT(ComputeStreamIntrinsics(Sensor, 1280, 960, K) && K.bValid);
+    CAMERA2_EXPECT(IsNear(K.Fx, 868.31, 1e-3) && IsNear(K.Cx, 640.18, 1e-3) && IsNear(K.Cy, 482.07, 1e-3));
+    CAMERA2_EXPECT(IsNear(K.CropSize.X, 1280, 1e-9) && IsNear(K.CropSize.Y, 960, 1e-9));
+    const double ExpectedFov = (std::atan(640.68 / 868.31) + std::atan(639.32 / 868.31)) * 180.0 / UE_DOUBLE_PI;
+    CAMERA2_EXPECT_MSG(IsNear(K.HorizontalFovDegrees, ExpectedFov, 1e-3), "fov %f, expected %f", K.HorizontalFovDegrees, ExpectedFov);
+}
+
+CAMERA2_TEST(IntrinsicsScaleAboutPixelEdges)
+{
+    const FSensorCalibration Sensor = MakeSensor(868, 868, 640, 480, 0.0, FIntRect(0, 0, 1280, 960), FIntRect(0, 0, 1280, 960));
+    FCamera2StreamIntrinsics K;
+    ComputeStreamIntrinsics(Sensor, 640, 480, K);
+    CAMERA2_EXPECT_MSG(IsNear(K.Fx, 434, 1e-4) && IsNear(K.Cx, 640.5 / 2 - 0.5, 1e-4) && IsNear(K.Cy, 480.5 / 2 - 0.5, 1e-4), "%f %f", K.Cx, K.Cy);
+
+    // A principal point at the exact image center stays centered at any scale
+    const FSensorCalibration Centered = MakeSensor(868, 868, 639.5, 479.5, 0.0, FIntRect(0, 0, 1280, 960), FIntRect(0, 0, 1280, 960));
+    ComputeStreamIntrinsics(Centered, 320, 240, K);
+    CAMERA2_EXPECT(IsNear(K.Cx, 159.5, 1e-4) && IsNear(K.Cy, 119.5, 1e-4));
+}
+
+CAMERA2_TEST(IntrinsicsFollowAspectCrop)
+{
+    const FSensorCalibration Sensor = MakeSensor(868, 868, 640, 480, 0.0, FIntRect(0, 0, 1280, 960), FIntRect(0, 0, 1280, 960));
+    FCamera2StreamIntrinsics K;
+
+    // 16:9 from 4:3 cuts 120 rows from the top and the bottom
+    ComputeStreamIntrinsics(Sensor, 1280, 720, K);
+    CAMERA2_EXPECT(IsNear(K.Fx, 868, 1e-4) && IsNear(K.Fy, 868, 1e-4) && IsNear(K.Cx, 640, 1e-4) && IsNear(K.Cy, 360, 1e-4));
+    CAMERA2_EXPECT(IsNear(K.CropOrigin.Y, 120, 1e-9) && IsNear(K.CropSize.Y, 720, 1e-9));
+
+    // 1:1 cuts 160 columns from each side
+    ComputeStreamIntrinsics(Sensor, 480, 480, K);
+    CAMERA2_EXPECT(IsNear(K.CropOrigin.X, 160, 1e-9) && IsNear(K.Fx, 434, 1e-4) && IsNear(K.Cx, (640.5 - 160) / 2 - 0.5, 1e-4));
+}
+
+CAMERA2_TEST(IntrinsicsShiftByActiveArrayOffset)
+{
+    FSensorCalibration Sensor = MakeSensor(1000, 1000, 2024, 1520, 0.0, FIntRect(8, 8, 4040, 3032), FIntRect(0, 0, 4048, 3040));
+    FCamera2StreamIntrinsics K;
+    ComputeStreamIntrinsics(Sensor, 4032, 3024, K);
+    CAMERA2_EXPECT(IsNear(K.Cx, 2016, 1e-3) && IsNear(K.Cy, 1512, 1e-3));
+
+    // Without a pre-correction array the calibration is taken to be in active array pixels
+    Sensor.PreCorrectionArray = FIntRect();
+    ComputeStreamIntrinsics(Sensor, 4032, 3024, K);
+    CAMERA2_EXPECT(IsNear(K.Cx, 2024, 1e-3));
+
+    FCamera2StreamIntrinsics Invalid;
+    CAMERA2_EXPECT(!ComputeStreamIntrinsics(FSensorCalibration(), 640, 480, Invalid) && !Invalid.bValid);
+    CAMERA2_EXPECT(!ComputeStreamIntrinsics(Sensor, 0, 480, Invalid));
+}
+
+CAMERA2_TEST(IntrinsicsMatchReferenceProjection)
+{
+    // Skew, distortion, offset arrays, zoomed crop regions and many output sizes
+    std::mt19937 Rng(7);
+    std::uniform_real_distribution<double> Unit(-1.0, 1.0);
+    const int32 Sizes[][2] = { { 1280, 960 }, { 640, 480 }, { 320, 240 }, { 1920, 1080 }, { 1280, 720 }, { 800, 800 }, { 176, 144 }, { 4032, 3024 }, { 3000, 2000 }, { 720, 1280 } };
+    double MaxError = 0.0;
+    for (int32 Case = 0; Case < 200; ++Case)
+    {
+        const FIntRect ActiveArray(8, 6, 4040, 3034);
+        FSensorCalibration Sensor = MakeSensor(2900 + 200 * Unit(Rng), 2900 + 200 * Unit(Rng), 2020 + 30 * Unit(Rng), 1516 + 30 * Unit(Rng), 2 * Unit(Rng),
+            ActiveArray, FIntRect(0, 0, 4048, 3040));
+        Sensor.K[0] = 0.08 * Unit(Rng);
+        Sensor.K[1] = 0.03 * Unit(Rng);
+        Sensor.K[2] = 0.01 * Unit(Rng);
+        Sensor.P[0] = 0.001 * Unit(Rng);
+        Sensor.P[1] = 0.001 * Unit(Rng);
+        const FIntRect CropRegion = (Case % 3 == 0)
+            ? FIntRect(0, 0, ActiveArray.Width(), ActiveArray.Height())
+            : FIntRect(500 + static_cast<int32>(300 * Unit(Rng)), 400 + static_cast<int32>(200 * Unit(Rng)),
+                2500 + static_cast<int32>(300 * Unit(Rng)), 2200 + static_cast<int32>(300 * Unit(Rng)));
+        const int32 Width = Sizes[Case % 10][0];
+        const int32 Height = Sizes[Case % 10][1];
+
+        FCamera2StreamIntrinsics K;
+        ComputeStreamIntrinsics(Sensor, CropRegion, Width, Height, K);
+        const Camera2Markers::FCameraModel Model = MakeCameraModel(K);
+        for (int32 i = 0; i < 50; ++i)
+        {
+            const double Point[3] = { 0.4 * Unit(Rng), 0.3 * Unit(Rng), 1.0 };
+            double ExpectedU, ExpectedV, U, V;
+            ReferenceProject(Sensor, CropRegion, Width, Height, Point, ExpectedU, ExpectedV);
+            Camera2Markers::ProjectPoint(Model, Point, U, V);
+            // Float intrinsics: the error grows with the stream size
+            MaxError = std::max(MaxError, std::max(std::fabs(ExpectedU - U), std::fabs(ExpectedV - V)) / std::max(1.0, Width / 1000.0));
+        }
+    }
+    CAMERA2_EXPECT_MSG(MaxError < 2e-3, "max projection error %g px", MaxError);
+}
+
+CAMERA2_TEST(RayTableRoundTrips)
+{
+    FSensorCalibration Sensor = MakeSensor(868.31, 870.1, 640.18, 482.07, 0.3, FIntRect(0, 0, 1280, 960), FIntRect(0, 0, 1280, 960));
+    Sensor.K[0] = -0.12;
+    Sensor.K[1] = 0.03;
+    Sensor.K[2] = -0.002;
+    Sensor.P[0] = 0.0007;
+    Sensor.P[1] = -0.0004;
+    FCamera2StreamIntrinsics K;
+    ComputeStreamIntrinsics(Sensor, 1280, 960, K);
+    FCamera2RayTable Table;
+    BuildRayTable(K, Table);
+
+    // Rays are X forward, Y right, Z up; projecting them back lands on the pixel they were built for
+    const Camera2Markers::FCameraModel Model = MakeCameraModel(K);
+    double MaxError = 0.0;
+    double MaxNormError = 0.0;
+    for (int32 Y = 0; Y < 960; Y += 7)
+    {
+        for (int32 X = 0; X < 1280; X += 5)
+        {
+            const FVector3f& Ray = Table.GetRay(X, Y);
+            MaxNormError = std::max(MaxNormError, std::fabs(std::sqrt(static_cast<double>(Ray.X) * Ray.X + Ray.Y * Ray.Y + Ray.Z * Ray.Z) - 1.0));
+            const double Point[3] = { Ray.Y, -Ray.Z, Ray.X };
+            double U, V;
+            Camera2Markers::ProjectPoint(Model, Point, U, V);
+            MaxError = std::max(MaxError, std::max(std::fabs(U - X), std::fabs(V - Y)));
+        }
+    }
+    CAMERA2_EXPECT_MSG(MaxError < 5e-3 && MaxNormError < 1e-6, "round trip %g px, norm %g", MaxError, MaxNormError);
+
+    FCamera2StreamIntrinsics Pinhole = K;
+    Pinhole.Cx = 640;
+    Pinhole.Cy = 480;
+    Pinhole.K1 = Pinhole.K2 = Pinhole.K3 = Pinhole.P1 = Pinhole.P2 = 0;
+    Pinhole.Skew = 0;
+    BuildRayTable(Pinhole, Table);
+    CAMERA2_EXPECT(IsNear(Table.GetRay(640, 480).X, 1, 1e-7) && IsNear(Table.GetRay(640, 480).Y, 0, 1e-7));
+    CAMERA2_EXPECT(Table.GetRay(1279, 480).Y > 0 && Table.GetRay(640, 0).Z > 0);
+}
@@ -0,0 +1,177 @@
+#include "Camera2Tests.h"
+#include "Camera2ClockMapper.h"
+#include <random>
+
+namespace
+{
+    /**
+     * Camera at 30 fps whose sensor clock runs 80 ppm fast against the engine clock. Each capture callback is
+     * observed 0.3 ms late plus exponential scheduler jitter; TrueEngineSeconds excludes the latency.
+     */
+    struct FSimulatedCamera
+    {
+        static constexpr int64 FirstTimestampNs = 987654321000LL;
+        static constexpr int64 FrameNs = 33333333LL;
+        static constexpr double LatencyFloorSeconds = 0.0003;
+        static constexpr double DriftPpm = 80.0;
+
+        std::mt19937_64 Rng{1};
+        std::exponential_distribution<double> Jitter{1.0 / 0.0004};
+        double OffsetSeconds = 1234.5;
+
+        static int64 TimestampOfFrame(int32 Frame) { return FirstTimestampNs + static_cast<int64>(Frame) * FrameNs; }
+
+        double TrueEngineSeconds(int64 TimestampNs) const
+        {
+            return OffsetSeconds + TimestampNs * 1e-9 * (1.0 + DriftPpm * 1e-6);
+        }
+
+        double ObservedEngineSeconds(int64 TimestampNs)
+        {
+            return TrueEngineSeconds(TimestampNs) + LatencyFloorSeconds + Jitter(Rng);
+        }
+    };
+
+    /** Mapping error beyond the unobservable latency floor, compared with the mapper's own bound */
+    bool IsWithinBound(const FCamera2ClockMapper& Mapper, const FSimulatedCamera& Camera, int64 TimestampNs, double& OutErrorSeconds)
+    {
+        double EngineSeconds = 0.0;
+        double BoundSeconds = 0.0;
+        if (!Mapper.MapToEngineSeconds(TimestampNs, EngineSeconds, BoundSeconds))
+        {
+            OutErrorSeconds = MAX_dbl;
+            return false;
+        }
+        OutErrorSeconds = EngineSeconds - Camera.TrueEngineSeconds(TimestampNs) - FSimulatedCamera::LatencyFloorSeconds;
+        return std::fabs(OutErrorSeconds) <= BoundSeconds + 50e-6;
+    }
+}
+
+CAMERA2_TEST(ClockMapperTracksDrift)
+{
+    FCamera2ClockMapper Mapper;
+    Mapper.Reset();
+    FSimulatedCamera Camera;
+
+    double ErrorSeconds = 0.0;
+    CAMERA2_EXPECT(!Mapper.MapToEngineSeconds(FSimulatedCamera::FirstTimestampNs, ErrorSeconds, ErrorSeconds));
+
+    int32 Violations = 0;
+    for (int32 Frame = 0; Frame < 30 * 60; ++Frame)
+    {
+        const int64 TimestampNs = FSimulatedCamera::TimestampOfFrame(Frame);
+        Mapper.AddSample(TimestampNs, Camera.ObservedEngineSeconds(TimestampNs));
+        if (Frame >= 90 && Frame % 30 == 0 && !IsWithinBound(Mapper, Camera, TimestampNs, ErrorSeconds))
+        {
+            ++Violations;
+            std::printf("    frame %d: error %.1f us outside the bound\n", Frame, ErrorSeconds * 1e6);
+        }
+    }
+    CAMERA2_EXPECT(Violations == 0);
+
+    const FCamera2ClockMapping Mapping = Mapper.GetMapping();
+    CAMERA2_EXPECT(Mapping.bValid);
+    CAMERA2_EXPECT(Mapping.ClockSteps == 0);
+    CAMERA2_EXPECT(Mapping.Samples == 30 * 60);
+    CAMERA2_EXPECT_MSG(std::fabs(Mapping.DriftPpm - FSimulatedCamera::DriftPpm) < 5.0, "drift %.2f ppm", Mapping.DriftPpm);
+
+    // Extrapolating a second ahead stays within the bound as well
+    CAMERA2_EXPECT(IsWithinBound(Mapper, Camera, FSimulatedCamera::TimestampOfFrame(30 * 61), ErrorSeconds));
+}
+
+CAMERA2_TEST(ClockMapperRejectsStalls)
+{
+    FCamera2ClockMapper Mapper;
+    Mapper.Reset();
+    FSimulatedCamera Camera;
+
+    int32 Violations = 0;
+    double ErrorSeconds = 0.0;
+    for (int32 Frame = 0; Frame < 30 * 40; ++Frame)
+    {
+        const int64 TimestampNs = FSimulatedCamera::TimestampOfFrame(Frame);
+        double Observed = Camera.ObservedEngineSeconds(TimestampNs);
+        // A 0.66 s scheduler stall delays every callback by 100 ms, and an occasional single one by 30 ms
+        if (Frame >= 30 * 20 && Frame < 30 * 20 + 20)
+        {
+            Observed += 0.1;
+        }
+        else if (Frame % 97 == 0)
+        {
+            Observed += 0.03;
+        }
+        Mapper.AddSample(TimestampNs, Observed);
+        if (Frame >= 90 && Frame % 15 == 0 && !IsWithinBound(Mapper, Camera, TimestampNs, ErrorSeconds))
+        {
+            ++Violations;
+            std::printf("    frame %d: error %.1f us outside the bound\n", Frame, ErrorSeconds * 1e6);
+        }
+    }
+    CAMERA2_EXPECT(Violations == 0);
+    CAMERA2_EXPECT(Mapper.GetMapping().ClockSteps == 0);
+}
+
+CAMERA2_TEST(ClockMapperFollowsClockStep)
+{
+    FCamera2ClockMapper Mapper;
+    Mapper.Reset();
+    FSimulatedCamera Camera;
+
+    const int32 StepFrame = 30 * 30;
+    int32 Violations = 0;
+    double ErrorSeconds = 0.0;
+    for (int32 Frame = 0; Frame < 30 * 60; ++Frame)
+    {
+        if (Frame == StepFrame)
+        {
+            // Device suspend with a boot-time sensor clock: the engine clock jumps 5 s against it
+            Camera.OffsetSeconds += 5.0;
+        }
+        const int64 TimestampNs = FSimulatedCamera::TimestampOfFrame(Frame);
+        Mapper.AddSample(TimestampNs, Camera.ObservedEngineSeconds(TimestampNs));
+
+        // The new offset has to persist before the mapper trusts it; allow two seconds to refit
+        const bool bSettling = Frame >= StepFrame && Frame < StepFrame + 60;
+        if (Frame >= 90 && Frame % 30 == 0 && !bSettling && !IsWithinBound(Mapper, Camera, TimestampNs, ErrorSeconds))
+        {
+            ++Violations;
+            std::printf("    frame %d: error %.1f us outside the bound\n", Frame, ErrorSeconds * 1e6);
+        }
+    }
+    CAMERA2_EXPECT(Violations == 0);
+    CAMERA2_EXPECT(Mapper.GetMapping().ClockSteps == 1);
+}
+
+CAMERA2_TEST(ClockMapperReadersNeverSeeTornEstimates)
+{
+    FCamera2ClockMapper Mapper;
+    Mapper.Reset();
+    FSimulatedCamera Camera;
+
+    std::atomic<bool> bDone{false};
+    std::atomic<int32> TornReads{0};
+    std::thread Reader([&]()
+    {
+        const int64 ProbeNs = FSimulatedCamera::FirstTimestampNs + 5000000000LL;
+        while (!bDone.load())
+        {
+            double EngineSeconds = 0.0;
+            double ErrorSeconds = 0.0;
+            // Every published estimate maps the probe close to the truth, before and after the step
+            if (Mapper.MapToEngineSeconds(ProbeNs, EngineSeconds, ErrorSeconds)
+                && std::fabs(EngineSeconds - Camera.TrueEngineSeconds(ProbeNs)) > 10.0)
+            {
+                TornReads.fetch_add(1);
+            }
+        }
+    });
+
+    for (int32 Frame = 0; Frame < 30 * 40; ++Frame)
+    {
+        const int64 TimestampNs = FSimulatedCamera::TimestampOfFrame(Frame);
+        Mapper.AddSample(TimestampNs, Camera.ObservedEngineSeconds(TimestampNs) + (Frame >= 30 * 20 ? 5.0 : 0.0));
+    }
+    bDone.store(true);
+    Reader.join();
+    CAMERA2_EXPECT(TornReads.load() == 0);
+}
@@ -0,0 +1,212 @@
+#include "Camera2TestImages.h"
+
+using namespace Camera2Tests;
+using namespace Camera2Yuv;
+
+namespace
+{
+    /** Tetrahedral interpolation written per tetrahedron, in the LUT's fixed point */
+    void ReferenceLut(const FColorLut& Lut, uint8 Bgra[4])
+    {
+        const int32 Mask = (1 << FColorLut::FractionBits) - 1;
+        const int32 LookupR = Lut.Lookup[0][Bgra[2]];
+        const int32 LookupG = Lut.Lookup[1][Bgra[1]];
+        const int32 LookupB = Lut.Lookup[2][Bgra[0]];
+        const int32 X = LookupR & Mask;
+        const int32 Y = LookupG & Mask;
+        const int32 Z = LookupB & Mask;
+        const int32 Base = (LookupR >> FColorLut::FractionBits) + (LookupG >> FColorLut::FractionBits) + (LookupB >> FColorLut::FractionBits);
+        const int32 SR = 1;
+        const int32 SG = Lut.Size;
+        const int32 SB = Lut.Size * Lut.Size;
+
+        // Corners visited from the near to the far corner and the weights of the four vertices
+        int32 First = 0;
+        int32 Second = 0;
+        int32 W[4] = {};
+        if (X >= Y && Y >= Z) { First = SR; Second = SR + SG; W[0] = 256 - X; W[1] = X - Y; W[2] = Y - Z; W[3] = Z; }
+        else if (X >= Z && Z >= Y) { First = SR; Second = SR + SB; W[0] = 256 - X; W[1] = X - Z; W[2] = Z - Y; W[3] = Y; }
+        else if (Z >= X && X >= Y) { First = SB; Second = SR + SB; W[0] = 256 - Z; W[1] = Z - X; W[2] = X - Y; W[3] = Y; }
+        else if (Y >= X && X >= Z) { First = SG; Second = SR + SG; W[0] = 256 - Y; W[1] = Y - X; W[2] = X - Z; W[3] = Z; }
+        else if (Y >= Z && Z >= X) { First = SG; Second = SG + SB; W[0] = 256 - Y; W[1] = Y - Z; W[2] = Z - X; W[3] = X; }
+        else { First = SB; Second = SG + SB; W[0] = 256 - Z; W[1] = Z - Y; W[2] = Y - X; W[3] = X; }
+
+        const uint32 Corners[4] = { Lut.Entries[Base], Lut.Entries[Base + First], Lut.Entries[Base + Second], Lut.Entries[Base + SR + SG + SB] };
+        for (int32 Channel = 0; Channel < 4; ++Channel)
+        {
+            int32 Value = 0;
+            for (int32 Corner = 0; Corner < 4; ++Corner)
+            {
+                Value += W[Corner] * static_cast<int32>((Corners[Corner] >> (Channel * 8)) & 0xFF);
+            }
+            Bgra[Channel] = static_cast<uint8>((Value + 128) >> 8);
+        }
+    }
+
+    /** A smooth non-linear grade, so every tetrahedron sees distinct corner colors */
+    FColorLut MakeTestLut(int32 Size)
+    {
+        std::vector<float> Rgb(static_cast<size_t>(Size) * Size * Size * 3);
+        for (int32 B = 0; B < Size; ++B)
+        {
+            for (int32 G = 0; G < Size; ++G)
+            {
+                for (int32 R = 0; R < Size; ++R)
+                {
+                    const float Rf = R / (Size - 1.0f);
+                    const float Gf = G / (Size - 1.0f);
+                    const float Bf = B / (Size - 1.0f);
+                    float* Entry = &Rgb[((static_cast<size_t>(B) * Size + G) * Size + R) * 3];
+                    Entry[0] = std::min(1.0f, std::pow(Rf, 0.8f) * 0.9f + 0.05f * Gf);
+                    Entry[1] = std::min(1.0f, Gf * Gf * 0.7f + 0.3f * Bf);
+                    Entry[2] = std::max(0.0f, 1.0f - Bf * 0.6f + 0.1f * Rf * Gf - 0.1f);
+                }
+            }
+        }
+        FColorLut Lut;
+        BuildColorLut(Size, Rgb.data(), Lut);
+        return Lut;
+    }
+}
+
+CAMERA2_TEST(ColorLutMatchesTetrahedralReference)
+{
+    std::mt19937 Rng(3);
+    for (int32 Size : { 2, 17, 33, MaxLutSize })
+    {
+        const FColorLut Lut = MakeTestLut(Size);
+        CAMERA2_EXPECT(Lut.IsValid() && Lut.Size == Size);
+
+        // Every value of each channel, plus random colors; odd counts leave a tail for the SIMD loops
+        std::vector<uint8> Pixels;
+        for (int32 Value = 0; Value < 256; ++Value)
+        {
+            const uint8 Shuffled = static_cast<uint8>(Value * 37);
+            Pixels.insert(Pixels.end(), { static_cast<uint8>(Value), static_cast<uint8>(255 - Value), Shuffled, 255 });
+        }
+        for (int32 i = 0; i < 4099; ++i)
+        {
+            Pixels.insert(Pixels.end(), { static_cast<uint8>(Rng()), static_cast<uint8>(Rng()), static_cast<uint8>(Rng()), 255 });
+        }
+        std::vector<uint8> Expected = Pixels;
+        for (size_t i = 0; i < Expected.size(); i += 4)
+        {
+            ReferenceLut(Lut, &Expected[i]);
+        }
+        ApplyColorLut(Lut, Pixels.data(), static_cast<int32>(Pixels.size() / 4));
+        CAMERA2_EXPECT_MSG(Pixels == Expected, "%d^3 LUT differs from the reference", Size);
+    }
+
+    // An identity lattice reproduces its input within rounding
+    const int32 Size = 33;
+    std::vector<float> Identity(static_cast<size_t>(Size) * Size * Size * 3);
+    for (int32 i = 0; i < Size * Size * Size; ++i)
+    {
+        Identity[i * 3 + 0] = (i % Size) / (Size - 1.0f);
+        Identity[i * 3 + 1] = ((i / Size) % Size) / (Size - 1.0f);
+        Identity[i * 3 + 2] = (i / (Size * Size)) / (Size - 1.0f);
+    }
+    FColorLut Lut;
+    CAMERA2_EXPECT(BuildColorLut(Size, Identity.data(), Lut));
+    std::vector<uint8> Pixels(4 * 1000);
+    for (uint8& Value : Pixels)
+    {
+        Value = static_cast<uint8>(Rng());
+    }
+    const std::vector<uint8> Source = Pixels;
+    ApplyColorLut(Lut, Pixels.data(), 1000);
+    int32 MaxDifference = 0;
+    for (size_t i = 0; i < Pixels.size(); ++i)
+    {
+        MaxDifference = std::max(MaxDifference, (i % 4 == 3) ? 0 : std::abs(Pixels[i] - Source[i]));
+    }
+    CAMERA2_EXPECT_MSG(MaxDifference <= 1, "identity LUT max difference %d", MaxDifference);
+
+    CAMERA2_EXPECT(!BuildColorLut(1, Identity.data(), Lut));
+    CAMERA2_EXPECT(!BuildColorLut(MaxLutSize + 1, Identity.data(), Lut));
+}
+
+CAMERA2_TEST(ConvertWithColorLutMatchesReference)
+{
+    std::mt19937 Rng(8);
+    FColorTransform Color;
+    Color.Matrix = MakeYuvMatrix(ECamera2ColorStandard::BT709, false);
+    Color.Lut = MakeTestLut(17);
+    for (const auto& Size : GSizes)
+    {
+        const FI420Image Image(Size[0], Size[1], Rng);
+        const int32 ChromaWidth = (Image.Width + 1) / 2;
+        const FOutputLayout Bgra = GetOutputLayout(ECamera2OutputFormat::BGRA8, Image.Width, Image.Height);
+        const FOutputLayout Rgb565 = GetOutputLayout(ECamera2OutputFormat::RGB565, Image.Width, Image.Height);
+        std::vector<uint8> OutBgra(Bgra.GetSizeBytes());
+        std::vector<uint8> Out565(Rgb565.GetSizeBytes());
+        ConvertInBands(Image.Height, [&](int32 Begin, int32 End) { ConvertI420ToBGRA(Image.View(), Color, OutBgra.data(), Bgra.Pitch, Begin, End); });
+        ConvertInBands(Image.Height, [&](int32 Begin, int32 End) { ConvertI420ToRGB565(Image.View(), Color, Out565.data(), Rgb565.Pitch, Begin, End); });
+
+        int32 Mismatches = 0;
+        for (int32 Row = 0; Row < Image.Height; ++Row)
+        {
+            for (int32 Col = 0; Col < Image.Width; ++Col)
+            {
+                uint8 Expected[4];
+                const int32 Chroma = (Row / 2) * ChromaWidth + Col / 2;
+                ReferenceBGRA(Color.Matrix, Image.Y[Row * Image.Width + Col], Image.U[Chroma], Image.V[Chroma], Expected);
+                ReferenceLut(Color.Lut, Expected);
+                Mismatches += std::memcmp(Expected, &OutBgra[Row * Bgra.Pitch + Col * 4], 4) != 0 ? 1 : 0;
+
+                const uint16 Expected565 = static_cast<uint16>(((Expected[2] >> 3) << 11) | ((Expected[1] >> 2) << 5) | (Expected[0] >> 3));
+                uint16 Actual565;
+                std::memcpy(&Actual565, &Out565[Row * Rgb565.Pitch + Col * 2], 2);
+                Mismatches += Actual565 != Expected565 ? 1 : 0;
+            }
+        }
+        CAMERA2_EXPECT_MSG(Mismatches == 0, "%dx%d: %d pixels differ", Image.Width, Image.Height, Mismatches);
+    }
+}
+
+CAMERA2_TEST(ResolveDataSpaceMatrices)
+{
+    ECamera2ColorStandard Standard;
+    bool bFullRange = false;
+    ResolveDataSpace(0x101, Standard, bFullRange);
+    CAMERA2_EXPECT(Standard == ECamera2ColorStandard::BT601 && bFullRange);
+    ResolveDataSpace(0x104, Standard, bFullRange);
+    CAMERA2_EXPECT(Standard == ECamera2ColorStandard::BT709 && !bFullRange);
+    // STANDARD_BT2020 | TRANSFER_ST2084 | RANGE_LIMITED
+    ResolveDataSpace((6 << 16) | (7 << 22) | (2 << 27), Standard, bFullRange);
+    CAMERA2_EXPECT(Standard == ECamera2ColorStandard::BT2020 && !bFullRange);
+
+    // Limited range stretches 16..235 to the full output range
+    const FYuvMatrix Limited = MakeYuvMatrix(ECamera2ColorStandard::BT709, false);
+    uint8 Black[4];
+    uint8 White[4];
+    ReferenceBGRA(Limited, 16, 128, 128, Black);
+    ReferenceBGRA(Limited, 235, 128, 128, White);
+    CAMERA2_EXPECT(Black[0] == 0 && Black[1] == 0 && Black[2] == 0);
+    CAMERA2_EXPECT(White[0] == 255 && White[1] == 255 && White[2] == 255);
+}
+
+CAMERA2_BENCHMARK(ColorLutBenchmark)
+{
+    // The LUT's share of the BGRA conversion: the same frame converted without a LUT and with a 17^3 and 33^3 one
+    const int32 Sizes[][2] = { { 1280, 960 }, { 640, 480 } };
+    std::mt19937 Rng(9);
+    for (const auto& Size : Sizes)
+    {
+        const FI420Image Image(Size[0], Size[1], Rng);
+        const FOutputLayout Layout = GetOutputLayout(ECamera2OutputFormat::BGRA8, Image.Width, Image.Height);
+        std::vector<uint8> Out(Layout.GetSizeBytes());
+        const int32 Iterations = Image.Width * Image.Height > 640 * 480 ? 20 : 80;
+        FColorTransform Color;
+        ReportTiming("I420 -> BGRA8", Image.Width, Image.Height,
+            MeasureMs(Iterations, [&]() { ConvertI420ToBGRA(Image.View(), Color, Out.data(), Layout.Pitch, 0, Image.Height); }));
+        for (int32 LutSize : { 17, 33 })
+        {
+            Color.Lut = MakeTestLut(LutSize);
+            char Kernel[64];
+            std::snprintf(Kernel, sizeof(Kernel), "I420 -> BGRA8 + %d^3 LUT", LutSize);
+            ReportTiming(Kernel, Image.Width, Image.Height,
+                MeasureMs(Iterations, [&]() { ConvertI420ToBGRA(Image.View(), Color, Out.data(), Layout.Pitch, 0, Image.Height); }));
+        }
+    }
+}
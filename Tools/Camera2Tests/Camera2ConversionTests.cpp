@@ -0,0 +1,184 @@
+#include "Camera2TestImages.h"
+
+using namespace Camera2Tests;
+using namespace Camera2Yuv;
+
+namespace
+{
+    uint16 Pack565(const uint8 Bgra[4])
+    {
+        return static_cast<uint16>(((Bgra[2] >> 3) << 11) | ((Bgra[1] >> 2) << 5) | (Bgra[0] >> 3));
+    }
+
+    uint16 Actual565(const std::vector<uint8>& Out, int32 Pitch, int32 Row, int32 Col)
+    {
+        uint16 Value;
+        std::memcpy(&Value, &Out[Row * Pitch + Col * 2], 2);
+        return Value;
+    }
+}
+
+CAMERA2_TEST(ConvertBGRAMatchesScalarReference)
+{
+    std::mt19937 Rng(1);
+    const ECamera2ColorStandard Standards[] = { ECamera2ColorStandard::BT601, ECamera2ColorStandard::BT709, ECamera2ColorStandard::BT2020 };
+    for (const auto& Size : GSizes)
+    {
+        const FI420Image Image(Size[0], Size[1], Rng);
+        const int32 ChromaWidth = (Image.Width + 1) / 2;
+        for (ECamera2ColorStandard Standard : Standards)
+        {
+            for (bool bFullRange : { true, false })
+            {
+                FColorTransform Color;
+                Color.Matrix = MakeYuvMatrix(Standard, bFullRange);
+                const FOutputLayout Layout = GetOutputLayout(ECamera2OutputFormat::BGRA8, Image.Width, Image.Height);
+                std::vector<uint8> Out(Layout.GetSizeBytes());
+                ConvertInBands(Image.Height, [&](int32 Begin, int32 End) { ConvertI420ToBGRA(Image.View(), Color, Out.data(), Layout.Pitch, Begin, End); });
+
+                int32 Mismatches = 0;
+                for (int32 Row = 0; Row < Image.Height; ++Row)
+                {
+                    for (int32 Col = 0; Col < Image.Width; ++Col)
+                    {
+                        uint8 Expected[4];
+                        const int32 Chroma = (Row / 2) * ChromaWidth + Col / 2;
+                        ReferenceBGRA(Color.Matrix, Image.Y[Row * Image.Width + Col], Image.U[Chroma], Image.V[Chroma], Expected);
+                        Mismatches += std::memcmp(Expected, &Out[Row * Layout.Pitch + Col * 4], 4) != 0 ? 1 : 0;
+                    }
+                }
+                CAMERA2_EXPECT_MSG(Mismatches == 0, "%dx%d standard %d full %d: %d pixels differ", Image.Width, Image.Height,
+                    static_cast<int32>(Standard), bFullRange ? 1 : 0, Mismatches);
+            }
+        }
+    }
+}
+
+CAMERA2_TEST(ConvertRGB565MatchesScalarReference)
+{
+    std::mt19937 Rng(2);
+    FColorTransform Color;
+    for (const auto& Size : GSizes)
+    {
+        const FI420Image Image(Size[0], Size[1], Rng);
+        const int32 ChromaWidth = (Image.Width + 1) / 2;
+        const FOutputLayout Layout = GetOutputLayout(ECamera2OutputFormat::RGB565, Image.Width, Image.Height);
+        CAMERA2_EXPECT(Layout.PixelFormat == PF_B5G6R5_UNORM && Layout.Pitch == Image.Width * 2);
+        std::vector<uint8> Out(Layout.GetSizeBytes());
+        ConvertInBands(Image.Height, [&](int32 Begin, int32 End) { ConvertI420ToRGB565(Image.View(), Color, Out.data(), Layout.Pitch, Begin, End); });
+
+        int32 Mismatches = 0;
+        for (int32 Row = 0; Row < Image.Height; ++Row)
+        {
+            for (int32 Col = 0; Col < Image.Width; ++Col)
+            {
+                uint8 Bgra[4];
+                const int32 Chroma = (Row / 2) * ChromaWidth + Col / 2;
+                ReferenceBGRA(Color.Matrix, Image.Y[Row * Image.Width + Col], Image.U[Chroma], Image.V[Chroma], Bgra);
+                Mismatches += Actual565(Out, Layout.Pitch, Row, Col) != Pack565(Bgra) ? 1 : 0;
+            }
+        }
+        CAMERA2_EXPECT_MSG(Mismatches == 0, "%dx%d: %d pixels differ", Image.Width, Image.Height, Mismatches);
+    }
+}
+
+CAMERA2_TEST(PackNV12MatchesPlanes)
+{
+    std::mt19937 Rng(4);
+    for (const auto& Size : GSizes)
+    {
+        const FI420Image Image(Size[0], Size[1], Rng);
+        const int32 ChromaWidth = (Image.Width + 1) / 2;
+        const int32 ChromaHeight = (Image.Height + 1) / 2;
+        const FOutputLayout Layout = GetOutputLayout(ECamera2OutputFormat::NV12, Image.Width, Image.Height);
+        CAMERA2_EXPECT(Layout.PixelFormat == PF_G8 && Layout.Pitch == ChromaWidth * 2 && Layout.TextureHeight == Image.Height + ChromaHeight);
+
+        std::vector<uint8> Out(Layout.GetSizeBytes(), 0xCD);
+        ConvertInBands(Image.Height, [&](int32 Begin, int32 End) { PackI420ToNV12(Image.View(), Out.data(), Layout.Pitch, Begin, End); });
+
+        int32 Mismatches = 0;
+        for (int32 Row = 0; Row < Image.Height; ++Row)
+        {
+            Mismatches += std::memcmp(&Out[Row * Layout.Pitch], &Image.Y[Row * Image.Width], Image.Width) != 0 ? 1 : 0;
+            // The padding column of odd widths repeats the last pixel
+            if (Layout.Pitch > Image.Width)
+            {
+                Mismatches += Out[Row * Layout.Pitch + Image.Width] != Image.Y[Row * Image.Width + Image.Width - 1] ? 1 : 0;
+            }
+        }
+        for (int32 Row = 0; Row < ChromaHeight; ++Row)
+        {
+            const uint8* UV = &Out[(Image.Height + Row) * Layout.Pitch];
+            for (int32 Col = 0; Col < ChromaWidth; ++Col)
+            {
+                Mismatches += (UV[Col * 2] != Image.U[Row * ChromaWidth + Col] || UV[Col * 2 + 1] != Image.V[Row * ChromaWidth + Col]) ? 1 : 0;
+            }
+        }
+        CAMERA2_EXPECT_MSG(Mismatches == 0, "%dx%d: %d rows or pairs differ", Image.Width, Image.Height, Mismatches);
+    }
+}
+
+CAMERA2_TEST(CopyPlaneHandlesStrides)
+{
+    // Semi-planar chroma (pixel stride 2) with row padding, as YUV_420_888 delivers it on most devices
+    const int32 Width = 13;
+    const int32 Height = 5;
+    const int32 RowStride = 32;
+    std::vector<uint8> Src(RowStride * Height);
+    for (size_t i = 0; i < Src.size(); ++i)
+    {
+        Src[i] = static_cast<uint8>(i * 7 + 3);
+    }
+    std::vector<uint8> Dst(Width * Height);
+    CopyPlane(Src.data(), RowStride, 2, Width, Height, Dst.data());
+    int32 Mismatches = 0;
+    for (int32 Row = 0; Row < Height; ++Row)
+    {
+        for (int32 Col = 0; Col < Width; ++Col)
+        {
+            Mismatches += Dst[Row * Width + Col] != Src[Row * RowStride + Col * 2] ? 1 : 0;
+        }
+    }
+    CopyPlane(Src.data(), RowStride, 1, Width, Height, Dst.data());
+    for (int32 Row = 0; Row < Height; ++Row)
+    {
+        Mismatches += std::memcmp(&Dst[Row * Width], &Src[Row * RowStride], Width) != 0 ? 1 : 0;
+    }
+    CAMERA2_EXPECT(Mismatches == 0);
+}
+
+CAMERA2_BENCHMARK(ConversionKernelsBenchmark)
+{
+    // The preview sizes the plugin selects by default, one full frame per call
+    const int32 Sizes[][2] = { { 1280, 960 }, { 640, 480 } };
+    std::mt19937 Rng(7);
+    FColorTransform Color;
+    for (const auto& Size : Sizes)
+    {
+        const FI420Image Image(Size[0], Size[1], Rng);
+        const FI420View Src = Image.View();
+        const int32 Width = Image.Width;
+        const int32 Height = Image.Height;
+        const int32 Iterations = Width * Height > 640 * 480 ? 50 : 200;
+
+        const FOutputLayout Bgra = GetOutputLayout(ECamera2OutputFormat::BGRA8, Width, Height);
+        std::vector<uint8> Out(Bgra.GetSizeBytes());
+        ReportTiming("I420 -> BGRA8", Width, Height,
+            MeasureMs(Iterations, [&]() { ConvertI420ToBGRA(Src, Color, Out.data(), Bgra.Pitch, 0, Height); }));
+
+        const FOutputLayout Rgb565 = GetOutputLayout(ECamera2OutputFormat::RGB565, Width, Height);
+        ReportTiming("I420 -> RGB565", Width, Height,
+            MeasureMs(Iterations, [&]() { ConvertI420ToRGB565(Src, Color, Out.data(), Rgb565.Pitch, 0, Height); }));
+
+        const FOutputLayout Nv12 = GetOutputLayout(ECamera2OutputFormat::NV12, Width, Height);
+        ReportTiming("I420 -> NV12", Width, Height,
+            MeasureMs(Iterations, [&]() { PackI420ToNV12(Src, Out.data(), Nv12.Pitch, 0, Height); }));
+
+        // Luma is the Y plane copied as is; the chroma copy deinterleaves a semi-planar (pixel stride 2) plane
+        ReportTiming("Y plane -> Luma", Width, Height,
+            MeasureMs(Iterations, [&]() { CopyPlane(Image.Y.data(), Width, 1, Width, Height, Out.data()); }));
+        std::vector<uint8> SemiPlanar(static_cast<size_t>(Width) * (Height / 2));
+        ReportTiming("semi-planar chroma -> U plane", Width, Height,
+            MeasureMs(Iterations, [&]() { CopyPlane(SemiPlanar.data(), Width, 2, Width / 2, Height / 2, Out.data()); }));
+    }
+}
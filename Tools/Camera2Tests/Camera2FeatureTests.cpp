@@ -0,0 +1,251 @@
+#include "Camera2Tests.h"
+#include "Camera2FeatureDetector.h"
+#include <random>
+
+using namespace Camera2Features;
+using namespace Camera2Tests;
+
+namespace
+{
+    const int32 GCircleX[16] = { 0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3, -3, -3, -2, -1 };
+    const int32 GCircleY[16] = { -3, -3, -2, -1, 0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3 };
+
+    /** Textured scene: a diagonal gradient under random flat rectangles, plus noise */
+    std::vector<uint8> MakeScene(int32 Width, int32 Height, uint32 Seed)
+    {
+        std::vector<uint8> Image(static_cast<size_t>(Width) * Height);
+        std::mt19937 Rng(Seed);
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            for (int32 X = 0; X < Width; ++X)
+            {
+                Image[Y * Width + X] = static_cast<uint8>(((X + Y) / 5) & 0xFF);
+            }
+        }
+        for (int32 Rect = 0; Rect < Width * Height / 768; ++Rect)
+        {
+            const int32 X0 = Rng() % Width;
+            const int32 Y0 = Rng() % Height;
+            const int32 X1 = std::min(Width, X0 + 5 + static_cast<int32>(Rng() % 60));
+            const int32 Y1 = std::min(Height, Y0 + 5 + static_cast<int32>(Rng() % 60));
+            const uint8 Value = static_cast<uint8>(Rng());
+            for (int32 Y = Y0; Y < Y1; ++Y)
+            {
+                std::memset(&Image[Y * Width + X0], Value, X1 - X0);
+            }
+        }
+        for (uint8& Value : Image)
+        {
+            Value = static_cast<uint8>(FMath::Clamp(static_cast<int32>(Value) + static_cast<int32>(Rng() % 9) - 4, 0, 255));
+        }
+        return Image;
+    }
+
+    /** Segment test and score straight from the definition: the score if the pixel is a corner, else 0 */
+    int32 ReferenceScore(const std::vector<uint8>& Image, int32 Width, int32 X, int32 Y, int32 Threshold)
+    {
+        const int32 Center = Image[Y * Width + X];
+        int32 Differences[16];
+        for (int32 i = 0; i < 16; ++i)
+        {
+            Differences[i] = Image[(Y + GCircleY[i]) * Width + X + GCircleX[i]] - Center;
+        }
+        bool bCorner = false;
+        int32 Best = 0;
+        for (int32 Start = 0; Start < 16; ++Start)
+        {
+            int32 Min = 1000;
+            int32 Max = -1000;
+            for (int32 i = 0; i < 9; ++i)
+            {
+                Min = std::min(Min, Differences[(Start + i) & 15]);
+                Max = std::max(Max, Differences[(Start + i) & 15]);
+            }
+            bCorner |= Min > Threshold || Max < -Threshold;
+            Best = std::max(Best, std::max(Min, -Max));
+        }
+        return bCorner ? Best : 0;
+    }
+}
+
+CAMERA2_TEST(Fast9MatchesNaiveSegmentTest)
+{
+    // Widths that are not multiples of 16 leave a scalar tail on every row
+    const int32 Sizes[][2] = { { 640, 480 }, { 333, 211 }, { 23, 17 }, { 7, 7 } };
+    FDetectorScratch Scratch;
+    TArray<FCorner> Corners;
+    for (const auto& Size : Sizes)
+    {
+        const int32 Width = Size[0];
+        const int32 Height = Size[1];
+        const std::vector<uint8> Image = MakeScene(Width, Height, 3);
+        for (int32 Threshold : { 10, 20, 60 })
+        {
+            std::vector<int32> Scores(Image.size(), 0);
+            for (int32 Y = 3; Y < Height - 3; ++Y)
+            {
+                for (int32 X = 3; X < Width - 3; ++X)
+                {
+                    Scores[Y * Width + X] = ReferenceScore(Image, Width, X, Y, Threshold);
+                }
+            }
+
+            for (bool bNonMaxSuppression : { false, true })
+            {
+                // Equal neighbours keep the corner that comes first in raster order
+                std::vector<uint8> bExpected(Image.size(), 0);
+                int32 ExpectedCount = 0;
+                for (int32 Y = 3; Y < Height - 3; ++Y)
+                {
+                    for (int32 X = 3; X < Width - 3; ++X)
+                    {
+                        const int32 Score = Scores[Y * Width + X];
+                        bool bKeep = Score > 0;
+                        for (int32 DY = -1; bKeep && bNonMaxSuppression && DY <= 1; ++DY)
+                        {
+                            for (int32 DX = -1; DX <= 1; ++DX)
+                            {
+                                const int32 Neighbour = Scores[(Y + DY) * Width + X + DX];
+                                const bool bEarlier = DY < 0 || (DY == 0 && DX < 0);
+                                if ((DX != 0 || DY != 0) && (bEarlier ? Neighbour > Score : Neighbour >= Score))
+                                {
+                                    bKeep = false;
+                                }
+                            }
+                        }
+                        bExpected[Y * Width + X] = bKeep ? 1 : 0;
+                        ExpectedCount += bKeep ? 1 : 0;
+                    }
+                }
+
+                DetectFast9(Image.data(), Width, Height, Width, Threshold, bNonMaxSuppression, Scratch, Corners);
+                int32 Mismatches = 0;
+                for (const FCorner& Corner : Corners)
+                {
+                    Mismatches += (!bExpected[Corner.Y * Width + Corner.X] || Corner.Score != Scores[Corner.Y * Width + Corner.X]) ? 1 : 0;
+                }
+                CAMERA2_EXPECT_MSG(Mismatches == 0 && Corners.Num() == ExpectedCount, "%dx%d threshold %d nms %d: %d corners, %d expected, %d wrong",
+                    Width, Height, Threshold, bNonMaxSuppression ? 1 : 0, Corners.Num(), ExpectedCount, Mismatches);
+            }
+        }
+    }
+}
+
+CAMERA2_TEST(Fast9HonoursStride)
+{
+    const int32 Width = 200;
+    const int32 Height = 120;
+    const int32 Stride = 256;
+    const std::vector<uint8> Tight = MakeScene(Width, Height, 8);
+    std::vector<uint8> Padded(static_cast<size_t>(Stride) * Height, 0);
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        std::memcpy(&Padded[Y * Stride], &Tight[Y * Width], Width);
+        // Padding that would produce corners if it were read
+        for (int32 X = Width; X < Stride; X += 2)
+        {
+            Padded[Y * Stride + X] = 255;
+        }
+    }
+    FDetectorScratch Scratch;
+    TArray<FCorner> Expected;
+    TArray<FCorner> Actual;
+    DetectFast9(Tight.data(), Width, Height, Width, 20, true, Scratch, Expected);
+    DetectFast9(Padded.data(), Width, Height, Stride, 20, true, Scratch, Actual);
+    bool bSame = Expected.Num() == Actual.Num();
+    for (int32 i = 0; bSame && i < Expected.Num(); ++i)
+    {
+        bSame = Expected[i].X == Actual[i].X && Expected[i].Y == Actual[i].Y && Expected[i].Score == Actual[i].Score;
+    }
+    CAMERA2_EXPECT(bSame && Expected.Num() > 0);
+}
+
+CAMERA2_TEST(DownsampleHalfRoundsPairs)
+{
+    const int32 Width = 75;
+    const int32 Height = 33;
+    const std::vector<uint8> Image = MakeScene(Width, Height, 9);
+    std::vector<uint8> Half((Width / 2) * (Height / 2));
+    DownsampleHalf(Image.data(), Width, Height, Width, Half.data());
+    int32 Mismatches = 0;
+    for (int32 Y = 0; Y < Height / 2; ++Y)
+    {
+        for (int32 X = 0; X < Width / 2; ++X)
+        {
+            const uint8* Row0 = &Image[(2 * Y) * Width];
+            const uint8* Row1 = Row0 + Width;
+            const int32 Even = (Row0[2 * X] + Row1[2 * X] + 1) >> 1;
+            const int32 Odd = (Row0[2 * X + 1] + Row1[2 * X + 1] + 1) >> 1;
+            Mismatches += Half[Y * (Width / 2) + X] != ((Even + Odd + 1) >> 1) ? 1 : 0;
+        }
+    }
+    CAMERA2_EXPECT(Mismatches == 0);
+}
+
+CAMERA2_TEST(KeypointsRespectBudgetAndGrid)
+{
+    const int32 Width = 640;
+    const int32 Height = 480;
+    const std::vector<uint8> Image = MakeScene(Width, Height, 3);
+    FDetectorScratch Scratch;
+    TArray<FCamera2Keypoint> Keypoints;
+    FCamera2FeatureConfig Config;
+
+    for (int32 Level = 0; Level <= MaxPyramidLevel; ++Level)
+    {
+        Config.PyramidLevel = Level;
+        const int32 Detected = DetectKeypoints(Image.data(), Width, Height, Config, Scratch, Keypoints);
+        CAMERA2_EXPECT_MSG(Keypoints.Num() == std::min(Detected, Config.MaxKeypoints), "level %d: %d of %d", Level, Keypoints.Num(), Detected);
+
+        bool bInside = true;
+        bool bStrongEnough = true;
+        for (const FCamera2Keypoint& Keypoint : Keypoints)
+        {
+            bInside &= Keypoint.Position.X >= 0 && Keypoint.Position.X < Width && Keypoint.Position.Y >= 0 && Keypoint.Position.Y < Height;
+            bStrongEnough &= Keypoint.Score > Config.Threshold;
+        }
+        CAMERA2_EXPECT_MSG(bInside && bStrongEnough, "level %d", Level);
+    }
+
+    // The textured scene has corners everywhere, so the budget covers every cell
+    Config.PyramidLevel = 0;
+    DetectKeypoints(Image.data(), Width, Height, Config, Scratch, Keypoints);
+    std::vector<int32> Cells(Config.GridColumns * Config.GridRows, 0);
+    for (const FCamera2Keypoint& Keypoint : Keypoints)
+    {
+        ++Cells[static_cast<int32>(Keypoint.Position.Y * Config.GridRows / Height) * Config.GridColumns + static_cast<int32>(Keypoint.Position.X * Config.GridColumns / Width)];
+    }
+    const int32 MinPerCell = *std::min_element(Cells.begin(), Cells.end());
+    CAMERA2_EXPECT_MSG(MinPerCell > 0, "an empty grid cell");
+
+    Config.MaxKeypoints = 0;
+    DetectKeypoints(Image.data(), Width, Height, Config, Scratch, Keypoints);
+    CAMERA2_EXPECT(Keypoints.Num() == 0);
+}
+
+CAMERA2_BENCHMARK(KeypointsBenchmark)
+{
+    // The stage's per-frame cost on the textured scene with the default config; the target is under 1 ms at 640x480
+    FDetectorScratch Scratch;
+    TArray<FCamera2Keypoint> Keypoints;
+    TArray<FCorner> Corners;
+    const int32 Sizes[][2] = { { 640, 480 }, { 1280, 960 } };
+    for (const auto& Size : Sizes)
+    {
+        const int32 Width = Size[0];
+        const int32 Height = Size[1];
+        const std::vector<uint8> Image = MakeScene(Width, Height, 4);
+        FCamera2FeatureConfig Config;
+        const int32 Iterations = Width * Height > 640 * 480 ? 50 : 200;
+        ReportTiming("FAST-9 + non-max suppression", Width, Height,
+            MeasureMs(Iterations, [&]() { DetectFast9(Image.data(), Width, Height, Width, Config.Threshold, true, Scratch, Corners); }));
+        for (int32 Level : { 0, 1 })
+        {
+            Config.PyramidLevel = Level;
+            char Kernel[64];
+            std::snprintf(Kernel, sizeof(Kernel), "DetectKeypoints, level %d", Level);
+            ReportTiming(Kernel, Width, Height,
+                MeasureMs(Iterations, [&]() { DetectKeypoints(Image.data(), Width, Height, Config, Scratch, Keypoints); }));
+        }
+    }
+}
@@ -0,0 +1,350 @@
+#include "Camera2Tests.h"
+#include "Camera2MarkerDetector.h"
+#include <random>
+
+using namespace Camera2Markers;
+
+namespace
+{
+    struct FMarkerPose
+    {
+        int32 Id = 0;
+        // Marker to camera, as FMarkerDetection reports it
+        double Rotation[9] = {};
+        double Translation[3] = {};
+    };
+
+    void AxisAngleToMatrix(const double W[3], double Out[9])
+    {
+        const double Angle = std::sqrt(W[0] * W[0] + W[1] * W[1] + W[2] * W[2]);
+        double Axis[3] = { 0.0, 0.0, 1.0 };
+        if (Angle > 1e-12)
+        {
+            Axis[0] = W[0] / Angle;
+            Axis[1] = W[1] / Angle;
+            Axis[2] = W[2] / Angle;
+        }
+        const double C = std::cos(Angle);
+        const double S = std::sin(Angle);
+        const double V = 1.0 - C;
+        Out[0] = C + Axis[0] * Axis[0] * V;           Out[1] = Axis[0] * Axis[1] * V - Axis[2] * S; Out[2] = Axis[0] * Axis[2] * V + Axis[1] * S;
+        Out[3] = Axis[1] * Axis[0] * V + Axis[2] * S; Out[4] = C + Axis[1] * Axis[1] * V;           Out[5] = Axis[1] * Axis[2] * V - Axis[0] * S;
+        Out[6] = Axis[2] * Axis[0] * V - Axis[1] * S; Out[7] = Axis[2] * Axis[1] * V + Axis[0] * S; Out[8] = C + Axis[2] * Axis[2] * V;
+    }
+
+    void Multiply(const double A[9], const double B[9], double Out[9])
+    {
+        for (int32 Row = 0; Row < 3; ++Row)
+        {
+            for (int32 Col = 0; Col < 3; ++Col)
+            {
+                Out[Row * 3 + Col] = A[Row * 3] * B[Col] + A[Row * 3 + 1] * B[3 + Col] + A[Row * 3 + 2] * B[6 + Col];
+            }
+        }
+    }
+
+    /** Facing the camera, spun about its normal, tilted by up to MaxTilt, centered near (CenterX, CenterY) * depth */
+    FMarkerPose MakePose(std::mt19937& Rng, int32 Id, double MinDepth, double MaxDepth, double MaxTilt, double CenterX, double CenterY, double Spread)
+    {
+        std::uniform_real_distribution<double> Unit(-1.0, 1.0);
+        std::uniform_real_distribution<double> Fraction(0.0, 1.0);
+        FMarkerPose Pose;
+        Pose.Id = Id;
+        const double Facing[9] = { 1, 0, 0, 0, -1, 0, 0, 0, -1 };
+        const double Spin[3] = { 0.0, 0.0, Unit(Rng) * UE_DOUBLE_PI };
+        double SpinMatrix[9];
+        AxisAngleToMatrix(Spin, SpinMatrix);
+        const double AxisX = Unit(Rng);
+        const double AxisY = Unit(Rng);
+        const double AxisLength = std::sqrt(AxisX * AxisX + AxisY * AxisY) + 1e-9;
+        const double TiltAngle = MaxTilt * Fraction(Rng);
+        const double Tilt[3] = { AxisX / AxisLength * TiltAngle, AxisY / AxisLength * TiltAngle, 0.0 };
+        double TiltMatrix[9];
+        AxisAngleToMatrix(Tilt, TiltMatrix);
+        double Spun[9];
+        Multiply(Facing, SpinMatrix, Spun);
+        Multiply(TiltMatrix, Spun, Pose.Rotation);
+        const double Depth = MinDepth + (MaxDepth - MinDepth) * Fraction(Rng);
+        Pose.Translation[0] = (CenterX + Spread * Unit(Rng)) * Depth;
+        Pose.Translation[1] = (CenterY + Spread * Unit(Rng)) * Depth;
+        Pose.Translation[2] = Depth;
+        return Pose;
+    }
+
+    /**
+     * Ray-traces markers of the given size in front of a textured background through the distorted camera,
+     * 3x3 supersampled per pixel, plus Gaussian noise
+     */
+    struct FMarkerScene
+    {
+        int32 Width;
+        int32 Height;
+        FCameraModel Camera;
+        std::vector<float> Rays;
+
+        FMarkerScene(int32 InWidth, int32 InHeight, const FCameraModel& InCamera)
+            : Width(InWidth)
+            , Height(InHeight)
+            , Camera(InCamera)
+            , Rays(static_cast<size_t>(InWidth) * InHeight * Samples * Samples * 2)
+        {
+            size_t Index = 0;
+            for (int32 Y = 0; Y < Height; ++Y)
+            {
+                for (int32 X = 0; X < Width; ++X)
+                {
+                    for (int32 SY = 0; SY < Samples; ++SY)
+                    {
+                        for (int32 SX = 0; SX < Samples; ++SX)
+                        {
+                            double RayX, RayY;
+                            UndistortPixel(Camera, X - 0.5 + (SX + 0.5) / Samples, Y - 0.5 + (SY + 0.5) / Samples, RayX, RayY);
+                            Rays[Index++] = static_cast<float>(RayX);
+                            Rays[Index++] = static_cast<float>(RayY);
+                        }
+                    }
+                }
+            }
+        }
+
+        void Render(const std::vector<FMarkerPose>& Markers, double Size, const FDictionary& Dictionary, std::mt19937& Rng, double Noise,
+            std::vector<uint8>& OutImage) const
+        {
+            std::normal_distribution<double> NoiseDistribution(0.0, Noise);
+            OutImage.resize(static_cast<size_t>(Width) * Height);
+            size_t Index = 0;
+            for (int32 Y = 0; Y < Height; ++Y)
+            {
+                for (int32 X = 0; X < Width; ++X)
+                {
+                    double Sum = 0.0;
+                    for (int32 SY = 0; SY < Samples; ++SY)
+                    {
+                        for (int32 SX = 0; SX < Samples; ++SX)
+                        {
+                            const double PX = X - 0.5 + (SX + 0.5) / Samples;
+                            const double PY = Y - 0.5 + (SY + 0.5) / Samples;
+                            const double Ray[3] = { Rays[Index], Rays[Index + 1], 1.0 };
+                            Index += 2;
+                            double Value = 120 + 50 * std::sin(PX * 0.013) * std::cos(PY * 0.021)
+                                + ((((static_cast<int32>(PX / 37)) ^ (static_cast<int32>(PY / 53))) % 5 == 0) ? -60 : 0);
+                            double NearestDepth = 1e30;
+                            for (const FMarkerPose& Marker : Markers)
+                            {
+                                const double* R = Marker.Rotation;
+                                const double* T = Marker.Translation;
+                                const double Normal[3] = { R[2], R[5], R[8] };
+                                const double Facing = Normal[0] * Ray[0] + Normal[1] * Ray[1] + Normal[2] * Ray[2];
+                                if (std::fabs(Facing) < 1e-9)
+                                {
+                                    continue;
+                                }
+                                const double Depth = (Normal[0] * T[0] + Normal[1] * T[1] + Normal[2] * T[2]) / Facing;
+                                if (Depth <= 0.0 || Depth > NearestDepth)
+                                {
+                                    continue;
+                                }
+                                const double Offset[3] = { Depth * Ray[0] - T[0], Depth * Ray[1] - T[1], Depth - T[2] };
+                                const double MarkerX = R[0] * Offset[0] + R[3] * Offset[1] + R[6] * Offset[2];
+                                const double MarkerY = R[1] * Offset[0] + R[4] * Offset[1] + R[7] * Offset[2];
+                                // A white quiet zone of a quarter marker around the black border
+                                if (std::fabs(MarkerX) > 0.75 * Size || std::fabs(MarkerY) > 0.75 * Size)
+                                {
+                                    continue;
+                                }
+                                NearestDepth = Depth;
+                                Value = 230;
+                                if (std::fabs(MarkerX) < Size / 2 && std::fabs(MarkerY) < Size / 2)
+                                {
+                                    const int32 Cells = Dictionary.Bits + 2;
+                                    const int32 Col = std::min(static_cast<int32>(std::floor((MarkerX + Size / 2) / (Size / Cells))), Cells - 1);
+                                    const int32 Row = std::min(static_cast<int32>(std::floor((Size / 2 - MarkerY) / (Size / Cells))), Cells - 1);
+                                    bool bWhite = false;
+                                    if (Row > 0 && Row < Cells - 1 && Col > 0 && Col < Cells - 1)
+                                    {
+                                        const int32 Bit = (Row - 1) * Dictionary.Bits + (Col - 1);
+                                        bWhite = (Dictionary.Codes[Marker.Id] >> (Dictionary.Bits * Dictionary.Bits - 1 - Bit)) & 1;
+                                    }
+                                    Value = bWhite ? 230 : 30;
+                                }
+                            }
+                            Sum += Value;
+                        }
+                    }
+                    OutImage[Y * Width + X] = static_cast<uint8>(FMath::Clamp(Sum / (Samples * Samples) + NoiseDistribution(Rng), 0.0, 255.0));
+                }
+            }
+        }
+
+        /** Top-left, top-right, bottom-right, bottom-left, the order FMarkerDetection uses */
+        void ProjectCorners(const FMarkerPose& Marker, double Size, double OutCorners[4][2]) const
+        {
+            const double Local[4][2] = { { -Size / 2, Size / 2 }, { Size / 2, Size / 2 }, { Size / 2, -Size / 2 }, { -Size / 2, -Size / 2 } };
+            for (int32 i = 0; i < 4; ++i)
+            {
+                double Point[3];
+                for (int32 Row = 0; Row < 3; ++Row)
+                {
+                    Point[Row] = Marker.Rotation[Row * 3] * Local[i][0] + Marker.Rotation[Row * 3 + 1] * Local[i][1] + Marker.Translation[Row];
+                }
+                ProjectPoint(Camera, Point, OutCorners[i][0], OutCorners[i][1]);
+            }
+        }
+
+        static constexpr int32 Samples = 3;
+    };
+
+    FCameraModel MakeCamera()
+    {
+        FCameraModel Camera;
+        Camera.Fx = 1000.0;
+        Camera.Fy = 1000.0;
+        Camera.Cx = 640.0;
+        Camera.Cy = 480.0;
+        Camera.K[0] = -0.05;
+        Camera.K[1] = 0.01;
+        Camera.P[0] = 0.0005;
+        Camera.P[1] = -0.0003;
+        return Camera;
+    }
+
+    double RotationErrorDegrees(const double A[9], const double B[9])
+    {
+        double Trace = 0.0;
+        for (int32 i = 0; i < 9; ++i)
+        {
+            Trace += A[i] * B[i];
+        }
+        return std::acos(FMath::Clamp((Trace - 1.0) / 2.0, -1.0, 1.0)) * 180.0 / UE_DOUBLE_PI;
+    }
+
+    /**
+     * No ids other than the markers', each found at most once with corners within MaxCornerError px and the pose
+     * within tolerance
+     * @return markers found
+     */
+    int32 ExpectDetections(const FMarkerScene& Scene, const std::vector<FMarkerPose>& Markers, double Size, const TArray<FMarkerDetection>& Detections,
+        double MaxCornerError, const char* Context)
+    {
+        int32 MarkersFound = 0;
+        for (const FMarkerDetection& Detection : Detections)
+        {
+            const auto Match = std::find_if(Markers.begin(), Markers.end(), [&](const FMarkerPose& Marker) { return Marker.Id == Detection.Id; });
+            CAMERA2_EXPECT_MSG(Match != Markers.end(), "%s: false id %d", Context, Detection.Id);
+        }
+        for (const FMarkerPose& Marker : Markers)
+        {
+            int32 Found = 0;
+            for (const FMarkerDetection& Detection : Detections)
+            {
+                if (Detection.Id != Marker.Id)
+                {
+                    continue;
+                }
+                ++Found;
+                double Expected[4][2];
+                Scene.ProjectCorners(Marker, Size, Expected);
+                double CornerError = 0.0;
+                for (int32 i = 0; i < 4; ++i)
+                {
+                    CornerError = std::max(CornerError, std::hypot(Detection.Corners[i][0] - Expected[i][0], Detection.Corners[i][1] - Expected[i][1]));
+                }
+                CAMERA2_EXPECT_MSG(CornerError < MaxCornerError, "%s: id %d corner error %.3f px", Context, Marker.Id, CornerError);
+
+                const double* T = Marker.Translation;
+                const double TranslationError = std::sqrt(FMath::Square(Detection.Translation[0] - T[0]) + FMath::Square(Detection.Translation[1] - T[1])
+                    + FMath::Square(Detection.Translation[2] - T[2])) / T[2];
+                const double RotationError = RotationErrorDegrees(Detection.Rotation, Marker.Rotation);
+                CAMERA2_EXPECT_MSG(Detection.bPoseValid && TranslationError < 0.02 && RotationError < 3.0, "%s: id %d pose off by %.2f%% of range, %.2f deg",
+                    Context, Marker.Id, TranslationError * 100.0, RotationError);
+            }
+            CAMERA2_EXPECT_MSG(Found <= 1, "%s: id %d found %d times", Context, Marker.Id, Found);
+            MarkersFound += Found > 0 ? 1 : 0;
+        }
+        return MarkersFound;
+    }
+}
+
+CAMERA2_TEST(MarkersDetectedAtEveryDecimation)
+{
+    const int32 Width = 1280;
+    const int32 Height = 960;
+    const double Size = 10.0;
+    const FMarkerScene Scene(Width, Height, MakeCamera());
+    const FDictionary Dictionary = MakeArucoOriginalDictionary();
+    CAMERA2_EXPECT(Dictionary.IsValid() && Dictionary.Codes.Num() == 1024);
+
+    // Four markers, one per quadrant, tilted up to 30 degrees
+    std::mt19937 Rng(5);
+    const double MaxTilt = 30.0 * UE_DOUBLE_PI / 180.0;
+    const std::vector<FMarkerPose> Markers = {
+        MakePose(Rng, 11, 50, 70, MaxTilt, -0.3, -0.2, 0.05),
+        MakePose(Rng, 222, 50, 70, MaxTilt, 0.3, -0.2, 0.05),
+        MakePose(Rng, 333, 50, 70, MaxTilt, -0.3, 0.2, 0.05),
+        MakePose(Rng, 1000, 50, 70, MaxTilt, 0.3, 0.2, 0.05) };
+    std::vector<uint8> Image;
+    Scene.Render(Markers, Size, Dictionary, Rng, 2.0, Image);
+
+    FDetectorScratch Scratch;
+    TArray<FMarkerDetection> Detections;
+    for (int32 Decimation : { 1, 2, 4 })
+    {
+        for (int32 Threads : { 1, 2 })
+        {
+            FCamera2MarkerConfig Config;
+            Config.Decimation = Decimation;
+            Config.Threads = Threads;
+            DetectMarkers(Image.data(), Width, Height, Config, Dictionary, Scene.Camera, Size, Scratch, Detections);
+            char Context[64];
+            std::snprintf(Context, sizeof(Context), "decimation %d, %d threads", Decimation, Threads);
+            const int32 Found = ExpectDetections(Scene, Markers, Size, Detections, 0.75, Context);
+            CAMERA2_EXPECT_MSG(Found == static_cast<int32>(Markers.size()), "%s: %d of %d markers found", Context, Found, static_cast<int32>(Markers.size()));
+        }
+    }
+}
+
+CAMERA2_TEST(MarkersDetectedInRandomPoses)
+{
+    const int32 Width = 1280;
+    const int32 Height = 960;
+    const double Size = 10.0;
+    const FMarkerScene Scene(Width, Height, MakeCamera());
+    const FDictionary Dictionary = MakeArucoOriginalDictionary();
+    std::mt19937 Rng(101);
+    std::uniform_int_distribution<int32> Ids(0, 1023);
+    FDetectorScratch Scratch;
+    TArray<FMarkerDetection> Detections;
+    std::vector<uint8> Image;
+    const int32 Trials = 10;
+    int32 Found = 0;
+    for (int32 Trial = 0; Trial < Trials; ++Trial)
+    {
+        // Between about 90 and 290 px across, tilted up to 55 degrees
+        const std::vector<FMarkerPose> Markers = { MakePose(Rng, Ids(Rng), 35, 110, 55.0 * UE_DOUBLE_PI / 180.0, 0.0, 0.0, 0.35) };
+        Scene.Render(Markers, Size, Dictionary, Rng, 2.0, Image);
+        FCamera2MarkerConfig Config;
+        Config.Decimation = 1 + Trial % 2;
+        Config.MinMarkerPixels = 24;
+        DetectMarkers(Image.data(), Width, Height, Config, Dictionary, Scene.Camera, Size, Scratch, Detections);
+        char Context[64];
+        std::snprintf(Context, sizeof(Context), "trial %d, decimation %d", Trial, Config.Decimation);
+        Found += ExpectDetections(Scene, Markers, Size, Detections, 0.75, Context);
+    }
+    // Steeply tilted small markers are occasionally lost to the quad fit; a wrong pose or id never passes
+    CAMERA2_EXPECT_MSG(Found >= Trials - 1, "%d of %d markers found", Found, Trials);
+}
+
+CAMERA2_TEST(MarkersIgnoreUnmarkedScene)
+{
+    const int32 Width = 640;
+    const int32 Height = 480;
+    const FMarkerScene Scene(Width, Height, MakeCamera());
+    const FDictionary Dictionary = MakeArucoOriginalDictionary();
+    std::mt19937 Rng(12);
+    std::vector<uint8> Image;
+    Scene.Render({}, 10.0, Dictionary, Rng, 2.0, Image);
+    FDetectorScratch Scratch;
+    TArray<FMarkerDetection> Detections;
+    DetectMarkers(Image.data(), Width, Height, FCamera2MarkerConfig(), Dictionary, Scene.Camera, 10.0, Scratch, Detections);
+    CAMERA2_EXPECT(Detections.Num() == 0);
+}
@@ -0,0 +1,201 @@
+#include "Camera2Tests.h"
+#include "Camera2FrameMemory.h"
+#include <atomic>
+#include <random>
+#include <thread>
+
+using namespace Camera2Memory;
+
+// The budget and counters are process-wide, so every test leaves nothing live and sets the budget it needs
+
+namespace
+{
+    FCamera2MemoryStats GetStats()
+    {
+        FCamera2MemoryStats Stats;
+        FillStats(Stats);
+        return Stats;
+    }
+}
+
+CAMERA2_TEST(MemoryUnlimitedBudget)
+{
+    SetBudget(0);
+    ResetPeak();
+    {
+        FBuffer Buffer;
+        CAMERA2_EXPECT(Buffer.Allocate(EPool::PipelineSlots, 1 << 20));
+        CAMERA2_EXPECT(Buffer.GetData() != nullptr && Buffer.Num() == (1 << 20));
+        CAMERA2_EXPECT(GetStats().LiveBytes == (1 << 20) && GetStats().PipelineSlotBytes == (1 << 20));
+    }
+    CAMERA2_EXPECT(GetStats().LiveBytes == 0 && GetStats().PeakBytes == (1 << 20));
+}
+
+CAMERA2_TEST(MemoryBudgetDeniesReservations)
+{
+    SetBudget(1000);
+    ResetPeak();
+    const int64 DeniedBefore = GetStats().DeniedReservations;
+    {
+        FBuffer Still;
+        FBuffer Other;
+        CAMERA2_EXPECT(Still.Allocate(EPool::Stills, 600));
+        CAMERA2_EXPECT(!Other.Allocate(EPool::Streaming, 500));
+        CAMERA2_EXPECT(Other.GetData() == nullptr && Other.Num() == 0);
+        CAMERA2_EXPECT(GetStats().DeniedReservations == DeniedBefore + 1 && GetStats().LiveBytes == 600 && GetStats().StreamingBytes == 0);
+
+        // Same size keeps the memory; a resize frees first; too large leaves the buffer empty
+        uint8* Kept = Still.GetData();
+        CAMERA2_EXPECT(Still.Allocate(EPool::Stills, 600) && Still.GetData() == Kept);
+        CAMERA2_EXPECT(Still.Allocate(EPool::Stills, 900) && GetStats().LiveBytes == 900);
+        CAMERA2_EXPECT(!Still.Allocate(EPool::Stills, 1001) && GetStats().LiveBytes == 0);
+
+        // Memory the plugin cannot work without is accounted past the budget, and then nothing else fits
+        FReservation Required;
+        CAMERA2_EXPECT(Required.Reserve(EPool::Textures, 1500, true));
+        CAMERA2_EXPECT(GetStats().LiveBytes == 1500 && GetStats().TextureBytes == 1500 && GetStats().PeakBytes == 1500);
+        CAMERA2_EXPECT(!Other.Allocate(EPool::Uploads, 1));
+        CAMERA2_EXPECT(!TryReserve(EPool::Uploads, 1));
+
+        FReservation Moved = MoveTemp(Required);
+        CAMERA2_EXPECT(!Required.IsValid() && Moved.GetBytes() == 1500);
+
+        // Empty is not a failure
+        FBuffer Empty;
+        CAMERA2_EXPECT(Empty.Allocate(EPool::Uploads, 0));
+    }
+    const FCamera2MemoryStats Stats = GetStats();
+    CAMERA2_EXPECT(Stats.LiveBytes == 0 && Stats.TextureBytes == 0 && Stats.StillBytes == 0);
+}
+
+CAMERA2_TEST(MemoryBuffersMove)
+{
+    SetBudget(1000);
+    {
+        FBuffer First;
+        First.Allocate(EPool::PipelineSlots, 400);
+        FBuffer Second = MoveTemp(First);
+        CAMERA2_EXPECT(First.GetData() == nullptr && Second.Num() == 400);
+        FBuffer Third;
+        Third.Allocate(EPool::PipelineSlots, 100);
+        Third = MoveTemp(Second);
+        CAMERA2_EXPECT(GetStats().LiveBytes == 400 && Third.Num() == 400);
+    }
+    CAMERA2_EXPECT(GetStats().LiveBytes == 0);
+
+    uint8* Raw = Allocate(EPool::Uploads, 1000);
+    CAMERA2_EXPECT(Raw != nullptr && Allocate(EPool::Uploads, 1) == nullptr);
+    Free(EPool::Uploads, Raw, 1000);
+    CAMERA2_EXPECT(GetStats().LiveBytes == 0);
+    CAMERA2_EXPECT(GLLMTagScopes_Camera2_PipelineSlots > 0 && GLLMTagScopes_Camera2_Stills > 0 && GLLMTagScopes_Camera2_Uploads > 0);
+}
+
+CAMERA2_TEST(MemoryRingStopsAtBudget)
+{
+    ResetPeak();
+
+    // Pipeline slots: Y, U, V and converted buffer, the chroma planes empty as for a luma-only stream
+    const int64 LumaOnly[] = { 300, 0, 0, 100 };
+    SetBudget(1000);
+    {
+        TArray<FBuffer> Buffers;
+        CAMERA2_EXPECT(AllocateRing(EPool::PipelineSlots, LumaOnly, 4, 5, Buffers) == 2);
+        CAMERA2_EXPECT(Buffers.Num() == 8 && GetStats().PipelineSlotBytes == 800);
+        CAMERA2_EXPECT(Buffers[4].Num() == 300 && !Buffers[5].GetData() && !Buffers[6].GetData() && Buffers[7].Num() == 100);
+    }
+    CAMERA2_EXPECT(GetStats().LiveBytes == 0);
+
+    // The third slot's Y fits, its U does not: the partial slot is freed again
+    const int64 Color[] = { 150, 250 };
+    {
+        TArray<FBuffer> Buffers;
+        const int64 DropsBefore = GetStats().BudgetDrops;
+        CAMERA2_EXPECT(AllocateRing(EPool::PipelineSlots, Color, 2, 4, Buffers) == 2);
+        CAMERA2_EXPECT(Buffers.Num() == 4 && GetStats().LiveBytes == 800 && GetStats().BudgetDrops == DropsBefore);
+
+        // Reallocating frees the previous ring first; no slot fits next to what another owner holds
+        CAMERA2_EXPECT(AllocateRing(EPool::PipelineSlots, Color, 2, 4, Buffers) == 2 && GetStats().LiveBytes == 800);
+        Buffers.Reset();
+        FBuffer Other;
+        CAMERA2_EXPECT(Other.Allocate(EPool::Textures, 900));
+        CAMERA2_EXPECT(AllocateRing(EPool::PipelineSlots, Color, 2, 4, Buffers) == 0);
+        CAMERA2_EXPECT(Buffers.Num() == 0 && GetStats().LiveBytes == 900);
+    }
+
+    SetBudget(0);
+    {
+        TArray<FBuffer> Buffers;
+        CAMERA2_EXPECT(AllocateRing(EPool::PipelineSlots, Color, 2, 8, Buffers) == 8 && Buffers.Num() == 16);
+    }
+    CAMERA2_EXPECT(GetStats().LiveBytes == 0);
+}
+
+CAMERA2_TEST(MemoryInFlightBuffersBoundFramesAndBudget)
+{
+    SetBudget(0);
+    ResetPeak();
+    FInFlightBuffers Frames(EPool::Uploads, 2);
+    const int64 DropsBefore = GetStats().BudgetDrops;
+
+    uint8* First = Frames.TryAllocate(100);
+    uint8* Second = Frames.TryAllocate(100);
+    CAMERA2_EXPECT(First && Second && Frames.Num() == 2);
+    CAMERA2_EXPECT(!Frames.TryAllocate(100) && Frames.Num() == 2);
+    CAMERA2_EXPECT(GetStats().BudgetDrops == DropsBefore + 1 && GetStats().UploadBytes == 200);
+
+    // A free slot is not enough when the budget is spent
+    Frames.Free(First, 100);
+    SetBudget(150);
+    CAMERA2_EXPECT(!Frames.TryAllocate(100) && Frames.Num() == 1);
+    CAMERA2_EXPECT(GetStats().BudgetDrops == DropsBefore + 2);
+
+    Frames.Free(Second, 100);
+    uint8* Third = Frames.TryAllocate(100);
+    CAMERA2_EXPECT(Third && Frames.Num() == 1 && GetStats().UploadBytes == 100);
+    Frames.Free(Third, 100);
+    Frames.Free(nullptr, 100);
+    CAMERA2_EXPECT(Frames.Num() == 0 && GetStats().LiveBytes == 0 && GetStats().BudgetDrops == DropsBefore + 2);
+    SetBudget(0);
+}
+
+CAMERA2_TEST(MemoryConcurrentReservationsStayInBudget)
+{
+    SetBudget(1 << 20);
+    ResetPeak();
+    std::vector<std::thread> Threads;
+    std::atomic<int64> Granted{ 0 };
+    std::atomic<int64> Refused{ 0 };
+    for (int32 ThreadIndex = 0; ThreadIndex < 8; ++ThreadIndex)
+    {
+        Threads.emplace_back([&, ThreadIndex]()
+        {
+            std::mt19937 Rng(ThreadIndex);
+            std::vector<FBuffer> Held(4);
+            for (int32 i = 0; i < 100000; ++i)
+            {
+                FBuffer& Buffer = Held[Rng() % 4];
+                if (Buffer.GetData())
+                {
+                    Buffer.Free();
+                }
+                else if (Buffer.Allocate(static_cast<EPool>(Rng() % static_cast<uint32>(EPool::Num)), 1 + Rng() % 100000))
+                {
+                    ++Granted;
+                }
+                else
+                {
+                    ++Refused;
+                }
+            }
+        });
+    }
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+    const FCamera2MemoryStats Stats = GetStats();
+    CAMERA2_EXPECT_MSG(Stats.PeakBytes <= (1 << 20) && Refused > 0 && Granted > 0, "peak %lld", static_cast<long long>(Stats.PeakBytes));
+    CAMERA2_EXPECT(Stats.LiveBytes == 0 && Stats.PipelineSlotBytes == 0 && Stats.TextureBytes == 0 && Stats.UploadBytes == 0
+        && Stats.StillBytes == 0 && Stats.StreamingBytes == 0);
+    SetBudget(0);
+}
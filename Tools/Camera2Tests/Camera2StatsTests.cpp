@@ -0,0 +1,123 @@
+#include "Camera2Tests.h"
+#include "Camera2ImageStats.h"
+#include <random>
+
+namespace
+{
+    void ReferenceLumaTotals(const std::vector<uint8>& Y, int32 Width, int32 Height, int32 BlockSize,
+        Camera2Stats::FLumaTotals& Out, std::vector<uint32>& OutBlocks)
+    {
+        std::memset(Out.Histogram, 0, sizeof(Out.Histogram));
+        Out.Sum = 0;
+        Out.SumSquares = 0;
+        Out.LaplacianSum = 0;
+        Out.LaplacianSumSquares = 0;
+        Out.LaplacianCount = 0;
+        Out.BlocksX = Width / BlockSize;
+        Out.BlocksY = Height / BlockSize;
+        OutBlocks.assign(static_cast<size_t>(Out.BlocksX) * Out.BlocksY, 0);
+        for (int32 Row = 0; Row < Height; ++Row)
+        {
+            for (int32 Col = 0; Col < Width; ++Col)
+            {
+                const int32 Value = Y[Row * Width + Col];
+                ++Out.Histogram[Value];
+                Out.Sum += Value;
+                Out.SumSquares += Value * Value;
+                if (Col / BlockSize < Out.BlocksX && Row / BlockSize < Out.BlocksY)
+                {
+                    OutBlocks[(Row / BlockSize) * Out.BlocksX + Col / BlockSize] += Value;
+                }
+                if (Col > 0 && Row > 0 && Col < Width - 1 && Row < Height - 1)
+                {
+                    const int32 Laplacian = 4 * Value - Y[Row * Width + Col - 1] - Y[Row * Width + Col + 1]
+                        - Y[(Row - 1) * Width + Col] - Y[(Row + 1) * Width + Col];
+                    Out.LaplacianSum += Laplacian;
+                    Out.LaplacianSumSquares += static_cast<uint64>(Laplacian * Laplacian);
+                    ++Out.LaplacianCount;
+                }
+            }
+        }
+    }
+}
+
+CAMERA2_TEST(LumaTotalsMatchScalarReference)
+{
+    std::mt19937 Rng(5);
+    for (int32 Case = 0; Case < 40; ++Case)
+    {
+        const int32 Width = 3 + Rng() % 700;
+        const int32 Height = 3 + Rng() % 300;
+        const int32 BlockSize = Camera2Stats::ClampBlockSize(16 * (1 + Rng() % 8));
+        std::vector<uint8> Y(static_cast<size_t>(Width) * Height);
+        for (uint8& Value : Y)
+        {
+            // Every third image is near white to catch accumulator overflow
+            Value = static_cast<uint8>(Case % 3 == 0 ? 255 - Rng() % 3 : Rng());
+        }
+
+        Camera2Stats::FLumaTotals Actual;
+        TArray<uint32> ActualBlocks;
+        Camera2Stats::ComputeLumaTotals(Y.data(), Width, Height, BlockSize, Actual, ActualBlocks);
+        Camera2Stats::FLumaTotals Expected;
+        std::vector<uint32> ExpectedBlocks;
+        ReferenceLumaTotals(Y, Width, Height, BlockSize, Expected, ExpectedBlocks);
+
+        const bool bMatch = std::memcmp(Actual.Histogram, Expected.Histogram, sizeof(Expected.Histogram)) == 0
+            && Actual.Sum == Expected.Sum && Actual.SumSquares == Expected.SumSquares
+            && Actual.LaplacianSum == Expected.LaplacianSum && Actual.LaplacianSumSquares == Expected.LaplacianSumSquares
+            && Actual.LaplacianCount == Expected.LaplacianCount && Actual.BlocksX == Expected.BlocksX && Actual.BlocksY == Expected.BlocksY
+            && ActualBlocks.Num() == static_cast<int32>(ExpectedBlocks.size())
+            && std::equal(ExpectedBlocks.begin(), ExpectedBlocks.end(), ActualBlocks.begin());
+        CAMERA2_EXPECT_MSG(bMatch, "%dx%d block %d", Width, Height, BlockSize);
+    }
+}
+
+CAMERA2_TEST(ChangeScoreSeparatesStaticAndMovingScenes)
+{
+    const int32 Width = 640;
+    const int32 Height = 480;
+    auto Scene = [&](int32 Shift, int32 Brightness)
+    {
+        std::vector<uint8> Y(static_cast<size_t>(Width) * Height);
+        for (int32 Row = 0; Row < Height; ++Row)
+        {
+            for (int32 Col = 0; Col < Width; ++Col)
+            {
+                const int32 Checker = ((((Col + Shift) / 40) + (Row / 40)) & 1) ? 180 : 60;
+                Y[Row * Width + Col] = static_cast<uint8>(FMath::Clamp(Checker + Brightness + (Col * 7 + Row * 13) % 5, 0, 255));
+            }
+        }
+        return Y;
+    };
+    auto Blocks = [&](const std::vector<uint8>& Y)
+    {
+        Camera2Stats::FLumaTotals Totals;
+        TArray<uint32> Sums;
+        Camera2Stats::ComputeLumaTotals(Y.data(), Width, Height, 32, Totals, Sums);
+        return Sums;
+    };
+
+    const TArray<uint32> Reference = Blocks(Scene(0, 0));
+    std::vector<uint8> Noisy = Scene(0, 0);
+    std::mt19937 Rng(6);
+    for (uint8& Value : Noisy)
+    {
+        Value = static_cast<uint8>(FMath::Clamp(Value + static_cast<int32>(Rng() % 7) - 3, 0, 255));
+    }
+    std::vector<uint8> Object = Scene(0, 0);
+    for (int32 Row = 150; Row < 250; ++Row)
+    {
+        std::memset(&Object[Row * Width + 250], 240, 100);
+    }
+
+    const float Static = Camera2Stats::ComputeChangeScore(Blocks(Scene(0, 0)), Reference, 32 * 32, 6.0f);
+    const float Noise = Camera2Stats::ComputeChangeScore(Blocks(Noisy), Reference, 32 * 32, 6.0f);
+    const float Moved = Camera2Stats::ComputeChangeScore(Blocks(Object), Reference, 32 * 32, 6.0f);
+    const float Panned = Camera2Stats::ComputeChangeScore(Blocks(Scene(12, 0)), Reference, 32 * 32, 6.0f);
+    const float First = Camera2Stats::ComputeChangeScore(Reference, TArray<uint32>(), 32 * 32, 6.0f);
+    CAMERA2_EXPECT(Static == 0.0f);
+    CAMERA2_EXPECT_MSG(Noise < 0.05f, "noise %.3f", Noise);
+    CAMERA2_EXPECT_MSG(Moved > 0.02f && Moved < Panned, "object %.3f pan %.3f", Moved, Panned);
+    CAMERA2_EXPECT(First == 1.0f);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Camera2Tests.h"
+#include "Camera2YuvConvert.h"
+#include <random>
+
+/** Synthetic I420 frames and the per-pixel references the conversion and color tests share */
+namespace Camera2Tests
+{
+    struct FI420Image
+    {
+        int32 Width = 0;
+        int32 Height = 0;
+        std::vector<uint8> Y;
+        std::vector<uint8> U;
+        std::vector<uint8> V;
+
+        FI420Image(int32 InWidth, int32 InHeight, std::mt19937& Rng)
+            : Width(InWidth)
+            , Height(InHeight)
+            , Y(static_cast<size_t>(InWidth) * InHeight)
+            , U(static_cast<size_t>((InWidth + 1) / 2) * ((InHeight + 1) / 2))
+            , V(U.size())
+        {
+            for (uint8& Value : Y) { Value = static_cast<uint8>(Rng()); }
+            for (uint8& Value : U) { Value = static_cast<uint8>(Rng()); }
+            for (uint8& Value : V) { Value = static_cast<uint8>(Rng()); }
+        }
+
+        Camera2Yuv::FI420View View() const
+        {
+            Camera2Yuv::FI420View Src;
+            Src.Y = Y.data();
+            Src.U = U.data();
+            Src.V = V.data();
+            Src.Width = Width;
+            Src.Height = Height;
+            return Src;
+        }
+    };
+
+    // Odd sizes exercise the scalar tails and the half-covered last chroma column and row
+    inline const int32 GSizes[][2] = { { 1280, 960 }, { 320, 240 }, { 37, 23 }, { 17, 9 }, { 2, 2 }, { 1, 1 } };
+
+    inline uint8 Clamp255(int32 Value)
+    {
+        return static_cast<uint8>(std::min(std::max(Value, 0), 255));
+    }
+
+    /** Fixed-point matrix reference, one pixel at a time */
+    inline void ReferenceBGRA(const Camera2Yuv::FYuvMatrix& M, int32 Y, int32 U, int32 V, uint8 Out[4])
+    {
+        const int32 YTerm = M.YScale * (Y - M.YOffset) + (1 << (Camera2Yuv::MatrixShift - 1));
+        U -= 128;
+        V -= 128;
+        Out[0] = Clamp255((YTerm + M.BU * U) >> Camera2Yuv::MatrixShift);
+        Out[1] = Clamp255((YTerm + M.GU * U + M.GV * V) >> Camera2Yuv::MatrixShift);
+        Out[2] = Clamp255((YTerm + M.RV * V) >> Camera2Yuv::MatrixShift);
+        Out[3] = 255;
+    }
+
+    /** Converts in two bands split at an even row, as the pipeline's conversion threads do */
+    template <class ConvertFunction>
+    void ConvertInBands(int32 Height, ConvertFunction Convert)
+    {
+        const int32 Split = (Height / 2) & ~1;
+        Convert(0, Split);
+        Convert(Split, Height);
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * Host tests of the plugin's engine-independent modules: clock mapping, the YUV conversion, packing and color LUT
+ * kernels, image statistics, FAST keypoints, marker detection, stream intrinsics and the frame memory budget. SIMD
+ * paths are checked against scalar references in the tests, so run both builds: the default one uses the SSE2 (x64)
+ * or NEON (arm64) kernels, CAMERA2_TESTS_SCALAR=1 the portable fallbacks. EngineShim stands in for the few engine
+ * headers these modules include.
+ *
+ * Build and run (Linux/macOS, c++17, no other dependencies):
+ *   P=../../Source/AndroidCamera2Plugin/Private
+ *   g++ -std=c++17 -O2 -pthread -IEngineShim -I../../Source/AndroidCamera2Plugin/Public -I$P -I. *.cpp \
+ *       $P/Camera2ClockMapper.cpp $P/Camera2YuvConvert.cpp $P/Camera2ColorTransform.cpp $P/Camera2ImageStats.cpp \
+ *       $P/Camera2FeatureDetector.cpp $P/Camera2MarkerDetector.cpp $P/Camera2Calibration.cpp \
+ *       $P/Camera2FrameMemory.cpp -o camera2_tests && ./camera2_tests
+ * Add -DCAMERA2_TESTS_SCALAR=1 for the scalar build, -fsanitize=address,undefined or -fsanitize=thread to run
+ * under the sanitizers. Pass test names to run only those. Benchmarks print the cost per frame of each kernel at
+ * the stream sizes their requests quote; run them by name or all of them with --benchmarks, on an -O2 build
+ * without sanitizers.
+ */
+
+#include "Camera2Tests.h"
+#include <chrono>
+#include <cstring>
+
+namespace Camera2Tests
+{
+    struct FTest
+    {
+        const char* Name;
+        FTestFunction Function;
+        bool bBenchmark;
+    };
+
+    static TArray<FTest>& GetTests()
+    {
+        static TArray<FTest> Tests;
+        return Tests;
+    }
+
+    static int32 GFailures = 0;
+
+    FTestRegistration::FTestRegistration(const char* Name, FTestFunction Function, bool bBenchmark)
+    {
+        GetTests().Add(FTest{ Name, Function, bBenchmark });
+    }
+
+    void ReportFailure(const char* File, int32 Line, const char* Expression)
+    {
+        std::printf("  FAILED %s:%d: %s\n", File, Line, Expression);
+        ++GFailures;
+    }
+
+    void ReportTiming(const char* Kernel, int32 Width, int32 Height, double MsPerFrame)
+    {
+        std::printf("  %-32s %4dx%-4d %8.3f ms/frame\n", Kernel, Width, Height, MsPerFrame);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace Camera2Tests;
+    std::setvbuf(stdout, nullptr, _IONBF, 0);
+#if CAMERA2_TESTS_SCALAR
+    std::printf("Scalar kernels\n");
+#else
+    std::printf("SIMD kernels\n");
+#endif
+
+    // No names runs every test, --benchmarks adds the benchmarks, names pick tests or benchmarks
+    bool bAllBenchmarks = false;
+    bool bNamed = false;
+    for (int32 Arg = 1; Arg < argc; ++Arg)
+    {
+        const bool bBenchmarksFlag = std::strcmp(argv[Arg], "--benchmarks") == 0;
+        bAllBenchmarks |= bBenchmarksFlag;
+        bNamed |= !bBenchmarksFlag;
+    }
+
+    int32 Run = 0;
+    int32 FailedTests = 0;
+    for (const FTest& Test : GetTests())
+    {
+        bool bSelected = !bNamed && (!Test.bBenchmark || bAllBenchmarks);
+        for (int32 Arg = 1; Arg < argc; ++Arg)
+        {
+            bSelected |= std::strcmp(argv[Arg], Test.Name) == 0;
+        }
+        if (!bSelected)
+        {
+            continue;
+        }
+
+        const int32 FailuresBefore = GFailures;
+        const auto Start = std::chrono::steady_clock::now();
+        Test.Function();
+        const double Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+        const bool bPassed = GFailures == FailuresBefore;
+        std::printf("%s %s (%.0f ms)\n", bPassed ? "[ok]    " : "[FAILED]", Test.Name, Ms);
+        ++Run;
+        FailedTests += bPassed ? 0 : 1;
+    }
+
+    std::printf("%d tests, %d failed\n", Run, FailedTests);
+    return FailedTests == 0 && Run > 0 ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <chrono>
+#include <cstdio>
+
+/**
+ * Minimal test registry: every CAMERA2_TEST registers itself at static initialization and main() runs them in
+ * registration order. Expectations record failures and keep going, so one run reports every broken check.
+ * CAMERA2_BENCHMARK registers a timing run that only runs when named or with --benchmarks.
+ */
+namespace Camera2Tests
+{
+    typedef void (*FTestFunction)();
+
+    struct FTestRegistration
+    {
+        FTestRegistration(const char* Name, FTestFunction Function, bool bBenchmark = false);
+    };
+
+    void ReportFailure(const char* File, int32 Line, const char* Expression);
+
+    /** Milliseconds per call of Function: the best average of a few rounds of Iterations calls, after a warm-up call */
+    template <class FunctionType>
+    double MeasureMs(int32 Iterations, FunctionType Function)
+    {
+        Function();
+        double Best = MAX_dbl;
+        for (int32 Round = 0; Round < 5; ++Round)
+        {
+            const auto Start = std::chrono::steady_clock::now();
+            for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+            {
+                Function();
+            }
+            const double Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+            Best = FMath::Min(Best, Ms / Iterations);
+        }
+        return Best;
+    }
+
+    /** One line of a benchmark's output: kernel, frame size and cost per frame */
+    void ReportTiming(const char* Kernel, int32 Width, int32 Height, double MsPerFrame);
+}
+
+#define CAMERA2_TEST(Name) \
+    static void Name(); \
+    static Camera2Tests::FTestRegistration Name##Registration(#Name, &Name); \
+    static void Name()
+
+#define CAMERA2_BENCHMARK(Name) \
+    static void Name(); \
+    static Camera2Tests::FTestRegistration Name##Registration(#Name, &Name, true); \
+    static void Name()
+
+#define CAMERA2_EXPECT(Expression) \
+    do \
+    { \
+        if (!(Expression)) \
+        { \
+            Camera2Tests::ReportFailure(__FILE__, __LINE__, #Expression); \
+        } \
+    } while (0)
+
+// Prints the formatted detail under the failure
+#define CAMERA2_EXPECT_MSG(Expression, ...) \
+    do \
+    { \
+        if (!(Expression)) \
+        { \
+            Camera2Tests::ReportFailure(__FILE__, __LINE__, #Expression); \
+            std::printf("    "); \
+            std::printf(__VA_ARGS__); \
+            std::printf("\n"); \
+        } \
+    } while (0)
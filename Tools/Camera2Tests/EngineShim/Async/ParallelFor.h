@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EParallelForFlags
+{
+    None,
+    ForceSingleThread
+};
+
+/** One thread per index, so multi-band paths really run concurrently (under TSan as well) */
+template <class FunctionType>
+void ParallelFor(int32 Num, FunctionType Body, EParallelForFlags Flags = EParallelForFlags::None)
+{
+    if (Flags == EParallelForFlags::ForceSingleThread || Num <= 1)
+    {
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            Body(Index);
+        }
+        return;
+    }
+    std::vector<std::thread> Threads;
+    for (int32 Index = 1; Index < Num; ++Index)
+    {
+        Threads.emplace_back([&Body, Index]() { Body(Index); });
+    }
+    Body(0);
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+// Stands in for the UnrealHeaderTool output included by Camera2Types.h
@@ -0,0 +1,240 @@
+#pragma once
+
+/**
+ * The subset of CoreMinimal the plugin's engine-independent modules use, on top of the C++ standard library,
+ * so Camera2Tests can build them with a plain host compiler. Semantics follow the engine where the modules
+ * depend on them (TArray indices and Num, FMath rounding); everything else is left out.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+typedef int8_t int8;
+typedef int16_t int16;
+typedef int32_t int32;
+typedef int64_t int64;
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+
+#define FORCEINLINE inline __attribute__((always_inline))
+#define INDEX_NONE (-1)
+#define MAX_int32 0x7fffffff
+#define MAX_dbl 1.7976931348623158e+308
+#define UE_DOUBLE_PI 3.141592653589793238462643383279502884197169399
+#define UE_INV_SQRT_2 0.70710678118654752440
+#define TEXT(Text) Text
+
+// check() stays active in the tests
+#define check(Expr) do { if (!(Expr)) { std::abort(); } } while (0)
+#define checkSlow(Expr) check(Expr)
+
+// SIMD selection as in the engine's platform headers; -DCAMERA2_TESTS_SCALAR=1 builds the scalar paths
+#if !CAMERA2_TESTS_SCALAR && defined(__aarch64__)
+#define PLATFORM_ENABLE_VECTORINTRINSICS_NEON 1
+#elif !CAMERA2_TESTS_SCALAR && (defined(__x86_64__) || defined(__i386__))
+#define PLATFORM_ENABLE_VECTORINTRINSICS 1
+#define PLATFORM_CPU_X86_FAMILY 1
+#endif
+
+// Reflection markup of the public headers
+#define UENUM(...)
+#define USTRUCT(...)
+#define UPROPERTY(...)
+#define UMETA(...)
+#define GENERATED_BODY()
+#define ANDROIDCAMERA2PLUGIN_API
+#define DECLARE_MULTICAST_DELEGATE_OneParam(Name, Param1) struct Name {};
+
+struct FMemory
+{
+    static void* Memcpy(void* Dest, const void* Src, size_t Count) { return std::memcpy(Dest, Src, Count); }
+    static void* Memset(void* Dest, uint8 Value, size_t Count) { return std::memset(Dest, Value, Count); }
+    static void Memzero(void* Dest, size_t Count) { std::memset(Dest, 0, Count); }
+    static void* Malloc(size_t Count, size_t Alignment = 16) { return std::aligned_alloc(Alignment, (Count + Alignment - 1) / Alignment * Alignment); }
+    static void Free(void* Ptr) { std::free(Ptr); }
+};
+
+struct FMath
+{
+    template <class T> static T Min(T A, T B) { return A < B ? A : B; }
+    template <class T> static T Max(T A, T B) { return A > B ? A : B; }
+    template <class T> static T Clamp(T Value, T Low, T High) { return Value < Low ? Low : (Value > High ? High : Value); }
+    template <class T> static T Abs(T Value) { return Value < 0 ? -Value : Value; }
+    template <class T> static T Square(T Value) { return Value * Value; }
+    template <class T, class U> static T Lerp(T A, T B, U Alpha) { return static_cast<T>(A + (B - A) * Alpha); }
+    static float Sqrt(float Value) { return std::sqrt(Value); }
+    static double Sqrt(double Value) { return std::sqrt(Value); }
+    static float Sin(float Value) { return std::sin(Value); }
+    static double Sin(double Value) { return std::sin(Value); }
+    static float Cos(float Value) { return std::cos(Value); }
+    static double Cos(double Value) { return std::cos(Value); }
+    static float Atan(float Value) { return std::atan(Value); }
+    static double Atan(double Value) { return std::atan(Value); }
+    static float Atan2(float Y, float X) { return std::atan2(Y, X); }
+    static double Atan2(double Y, double X) { return std::atan2(Y, X); }
+    static float RadiansToDegrees(float Value) { return Value * (180.0f / static_cast<float>(UE_DOUBLE_PI)); }
+    static double RadiansToDegrees(double Value) { return Value * (180.0 / UE_DOUBLE_PI); }
+    static int32 RoundToInt(float Value) { return static_cast<int32>(std::floor(Value + 0.5f)); }
+    static int32 RoundToInt(double Value) { return static_cast<int32>(std::floor(Value + 0.5)); }
+    static int32 FloorToInt(float Value) { return static_cast<int32>(std::floor(Value)); }
+    static int32 FloorToInt(double Value) { return static_cast<int32>(std::floor(Value)); }
+    static int32 CeilToInt(float Value) { return static_cast<int32>(std::ceil(Value)); }
+    static int32 CeilToInt(double Value) { return static_cast<int32>(std::ceil(Value)); }
+    static uint32 CountTrailingZeros(uint32 Value) { return Value ? __builtin_ctz(Value) : 32; }
+};
+
+struct FPlatformMath
+{
+    static uint32 CountBits(uint64 Bits) { return static_cast<uint32>(__builtin_popcountll(Bits)); }
+};
+
+struct FPlatformProcess
+{
+    static void YieldThread() { std::this_thread::yield(); }
+    static void Sleep(float Seconds) { std::this_thread::sleep_for(std::chrono::duration<float>(Seconds)); }
+};
+
+template <class T> inline void Swap(T& A, T& B) { std::swap(A, B); }
+template <class T> inline typename std::remove_reference<T>::type&& MoveTemp(T&& Value) { return std::move(Value); }
+
+template <int32 NumInlineElements> struct TInlineAllocator {};
+struct FDefaultAllocator {};
+
+/** std::vector with the TArray members the modules call */
+template <class T, class Allocator = FDefaultAllocator>
+class TArray
+{
+public:
+    TArray() = default;
+    TArray(std::initializer_list<T> Init) : Items(Init) {}
+
+    T* GetData() { return Items.data(); }
+    const T* GetData() const { return Items.data(); }
+    int32 Num() const { return static_cast<int32>(Items.size()); }
+    bool IsEmpty() const { return Items.empty(); }
+    bool IsValidIndex(int32 Index) const { return Index >= 0 && Index < Num(); }
+
+    T& operator[](int32 Index) { check(IsValidIndex(Index)); return Items[Index]; }
+    const T& operator[](int32 Index) const { check(IsValidIndex(Index)); return Items[Index]; }
+    T& Last() { return Items.back(); }
+    const T& Last() const { return Items.back(); }
+
+    int32 Add(const T& Item) { Items.push_back(Item); return Num() - 1; }
+    int32 Add(T&& Item) { Items.push_back(std::move(Item)); return Num() - 1; }
+    template <class... ArgTypes> int32 Emplace(ArgTypes&&... Args) { Items.emplace_back(std::forward<ArgTypes>(Args)...); return Num() - 1; }
+    T& AddDefaulted_GetRef() { Items.emplace_back(); return Items.back(); }
+    int32 AddUninitialized(int32 Count = 1) { const int32 Index = Num(); Items.resize(Items.size() + Count); return Index; }
+    int32 AddZeroed(int32 Count = 1) { const int32 Index = Num(); Items.resize(Items.size() + Count, T()); return Index; }
+    void Append(const T* Ptr, int32 Count) { Items.insert(Items.end(), Ptr, Ptr + Count); }
+    void Append(const TArray& Other) { Items.insert(Items.end(), Other.Items.begin(), Other.Items.end()); }
+    void Init(const T& Value, int32 Count) { Items.assign(Count, Value); }
+    T Pop() { T Item = std::move(Items.back()); Items.pop_back(); return Item; }
+    void RemoveAt(int32 Index, int32 Count = 1) { Items.erase(Items.begin() + Index, Items.begin() + Index + Count); }
+    void RemoveAtSwap(int32 Index) { std::swap(Items[Index], Items.back()); Items.pop_back(); }
+
+    void SetNum(int32 Count) { Items.resize(Count); }
+    void SetNumUninitialized(int32 Count) { Items.resize(Count); }
+    void SetNumZeroed(int32 Count) { Items.assign(Count, T()); }
+    void Reserve(int32 Count) { Items.reserve(Count); }
+    void Reset(int32 Slack = 0) { Items.clear(); Items.reserve(Slack); }
+    void Empty(int32 Slack = 0) { Items.clear(); Items.shrink_to_fit(); Items.reserve(Slack); }
+
+    void Sort() { std::sort(Items.begin(), Items.end()); }
+    template <class Predicate> void Sort(Predicate Pred) { std::sort(Items.begin(), Items.end(), Pred); }
+    template <class Predicate> void StableSort(Predicate Pred) { std::stable_sort(Items.begin(), Items.end(), Pred); }
+    template <class Predicate> T* FindByPredicate(Predicate Pred) { for (T& Item : Items) { if (Pred(Item)) { return &Item; } } return nullptr; }
+
+    T* begin() { return Items.data(); }
+    T* end() { return Items.data() + Items.size(); }
+    const T* begin() const { return Items.data(); }
+    const T* end() const { return Items.data() + Items.size(); }
+
+private:
+    std::vector<T> Items;
+};
+
+class FString
+{
+public:
+    FString() = default;
+    FString(const char* Text) : Chars(Text) {}
+    bool IsEmpty() const { return Chars.empty(); }
+
+private:
+    std::string Chars;
+};
+
+struct FVector2D
+{
+    double X = 0.0;
+    double Y = 0.0;
+    FVector2D() = default;
+    FVector2D(double InX, double InY) : X(InX), Y(InY) {}
+    static const FVector2D ZeroVector;
+};
+inline const FVector2D FVector2D::ZeroVector{};
+
+struct FVector
+{
+    double X = 0.0;
+    double Y = 0.0;
+    double Z = 0.0;
+    FVector() = default;
+    FVector(double InX, double InY, double InZ) : X(InX), Y(InY), Z(InZ) {}
+};
+
+struct FVector3f
+{
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Z = 0.0f;
+    FVector3f() = default;
+    FVector3f(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+};
+
+struct FIntPoint
+{
+    int32 X = 0;
+    int32 Y = 0;
+    FIntPoint() = default;
+    FIntPoint(int32 InX, int32 InY) : X(InX), Y(InY) {}
+    bool operator==(const FIntPoint& Other) const { return X == Other.X && Y == Other.Y; }
+    bool operator!=(const FIntPoint& Other) const { return !(*this == Other); }
+    static const FIntPoint ZeroValue;
+};
+inline const FIntPoint FIntPoint::ZeroValue{};
+
+struct FIntRect
+{
+    FIntPoint Min;
+    FIntPoint Max;
+    FIntRect() = default;
+    FIntRect(int32 X0, int32 Y0, int32 X1, int32 Y1) : Min(X0, Y0), Max(X1, Y1) {}
+    FIntRect(FIntPoint InMin, FIntPoint InMax) : Min(InMin), Max(InMax) {}
+    int32 Width() const { return Max.X - Min.X; }
+    int32 Height() const { return Max.Y - Min.Y; }
+};
+
+/** Only stored by the public structs; the tests never transform with it */
+struct FTransform
+{
+    static const FTransform Identity;
+};
+inline const FTransform FTransform::Identity{};
+
+enum EPixelFormat
+{
+    PF_B8G8R8A8,
+    PF_G8,
+    PF_B5G6R5_UNORM
+};
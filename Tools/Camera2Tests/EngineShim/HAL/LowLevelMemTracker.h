@@ -0,0 +1,8 @@
+#pragma once
+
+#include <atomic>
+
+// LLM tags count the allocation scopes opened under them, so the tests can check the tagging
+#define LLM_DECLARE_TAG(Name) extern std::atomic<int> GLLMTagScopes_##Name
+#define LLM_DEFINE_TAG(Name) std::atomic<int> GLLMTagScopes_##Name{0}
+#define LLM_SCOPE_BYTAG(Name) ++GLLMTagScopes_##Name
@@ -0,0 +1,541 @@
+/**
+ * Desktop receiver for the plugin's preview stream (USimpleCamera2Test::SetPreviewStreaming), plus a synthetic
+ * sender to test the codec and the transport over localhost without a device.
+ *
+ * Build (Linux/macOS, no dependencies besides the plugin's engine-independent codec):
+ *   g++ -std=c++17 -O2 -I../../Source/AndroidCamera2Plugin/Private Camera2Viewer.cpp \
+ *       ../../Source/AndroidCamera2Plugin/Private/Camera2StreamCodec.cpp -o camera2_viewer
+ *
+ * Receive from a headset (after `adb forward tcp:8555 tcp:8555`), print stats and show the video with ffplay:
+ *   ./camera2_viewer --raw | ffplay -f rawvideo -pixel_format yuv420p -video_size <WxH printed on stderr> -
+ * or keep a snapshot file that any image viewer can reload:
+ *   ./camera2_viewer --snapshot latest.ppm
+ *
+ * Localhost test:
+ *   ./camera2_viewer --serve --frames 300 &
+ *   ./camera2_viewer --frames 300 --verify-test-pattern
+ */
+
+#include "Camera2StreamCodec.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct FOptions
+    {
+        std::string Host = "127.0.0.1";
+        int Port = Camera2Stream::DefaultPort;
+        bool bServe = false;
+        bool bRaw = false;
+        bool bVerify = false;
+        std::string SnapshotPath;
+        long MaxFrames = 0;
+        // Test sender
+        int Width = 640;
+        int Height = 480;
+        double Fps = 30.0;
+        bool bLumaOnly = false;
+        Camera2Stream::FEncoderConfig Encoder;
+    };
+
+    double NowSeconds()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool SendAll(int Socket, const uint8_t* Data, size_t Size)
+    {
+        while (Size > 0)
+        {
+            const ssize_t Sent = send(Socket, Data, Size, MSG_NOSIGNAL);
+            if (Sent <= 0)
+            {
+                return false;
+            }
+            Data += Sent;
+            Size -= static_cast<size_t>(Sent);
+        }
+        return true;
+    }
+
+    bool ReceiveAll(int Socket, uint8_t* Data, size_t Size)
+    {
+        while (Size > 0)
+        {
+            const ssize_t Received = recv(Socket, Data, Size, 0);
+            if (Received <= 0)
+            {
+                return false;
+            }
+            Data += Received;
+            Size -= static_cast<size_t>(Received);
+        }
+        return true;
+    }
+
+    // Deterministic test image as a function of the timestamp, so the receiver can regenerate what was sent:
+    // drifting smooth luma, a moving bright box, +-1 sensor-like noise and slowly varying chroma
+    void MakeTestPattern(int Width, int Height, int64_t TimestampNs, std::vector<uint8_t>& Y, std::vector<uint8_t>& U, std::vector<uint8_t>& V)
+    {
+        const double T = TimestampNs * 1e-9;
+        const int ChromaWidth = (Width + 1) / 2;
+        const int ChromaHeight = (Height + 1) / 2;
+        Y.resize(static_cast<size_t>(Width) * Height);
+        U.resize(static_cast<size_t>(ChromaWidth) * ChromaHeight);
+        V.resize(U.size());
+
+        const int BoxSize = Height / 6 > 8 ? Height / 6 : 8;
+        const int BoxX = static_cast<int>((0.5 + 0.45 * std::sin(T * 1.3)) * (Width - BoxSize));
+        const int BoxY = static_cast<int>((0.5 + 0.45 * std::cos(T * 0.9)) * (Height - BoxSize));
+        const uint32_t FrameSeed = static_cast<uint32_t>(TimestampNs / 1000) * 2654435761u;
+        for (int Row = 0; Row < Height; ++Row)
+        {
+            for (int Column = 0; Column < Width; ++Column)
+            {
+                double Value = 128.0 + 60.0 * std::sin(Column / 40.0 + T * 0.2) * std::cos(Row / 30.0);
+                if (Column >= BoxX && Column < BoxX + BoxSize && Row >= BoxY && Row < BoxY + BoxSize)
+                {
+                    Value = 230.0;
+                }
+                uint32_t Hash = (static_cast<uint32_t>(Row * Width + Column) ^ FrameSeed) * 2246822519u;
+                Hash ^= Hash >> 15;
+                Value += static_cast<int>(Hash % 3) - 1;
+                Y[static_cast<size_t>(Row) * Width + Column] = static_cast<uint8_t>(Value < 0.0 ? 0.0 : (Value > 255.0 ? 255.0 : Value));
+            }
+        }
+        for (int Row = 0; Row < ChromaHeight; ++Row)
+        {
+            for (int Column = 0; Column < ChromaWidth; ++Column)
+            {
+                const size_t Index = static_cast<size_t>(Row) * ChromaWidth + Column;
+                U[Index] = static_cast<uint8_t>(128 + 40.0 * std::sin(Column / 50.0 + T * 0.1));
+                V[Index] = static_cast<uint8_t>(128 + 40.0 * std::cos(Row / 45.0 - T * 0.1));
+            }
+        }
+    }
+
+    // BT.601 full range; the device stream may use another matrix, good enough for a development preview
+    bool WriteSnapshot(const std::string& Path, const Camera2Stream::FFrameDecoder& Decoder)
+    {
+        const int Width = Decoder.GetWidth();
+        const int Height = Decoder.GetHeight();
+        const int ChromaWidth = (Width + 1) / 2;
+        const uint8_t* Y = Decoder.GetPlane(0);
+        const uint8_t* U = Decoder.GetPlane(1);
+        const uint8_t* V = Decoder.GetPlane(2);
+        std::vector<uint8_t> Rgb(static_cast<size_t>(Width) * Height * 3);
+        for (int Row = 0; Row < Height; ++Row)
+        {
+            for (int Column = 0; Column < Width; ++Column)
+            {
+                const double L = Y[static_cast<size_t>(Row) * Width + Column];
+                const size_t ChromaIndex = static_cast<size_t>(Row / 2) * ChromaWidth + Column / 2;
+                const double Cb = U ? U[ChromaIndex] - 128.0 : 0.0;
+                const double Cr = V ? V[ChromaIndex] - 128.0 : 0.0;
+                const double Channels[3] = { L + 1.402 * Cr, L - 0.344136 * Cb - 0.714136 * Cr, L + 1.772 * Cb };
+                uint8_t* Out = &Rgb[(static_cast<size_t>(Row) * Width + Column) * 3];
+                for (int Channel = 0; Channel < 3; ++Channel)
+                {
+                    Out[Channel] = static_cast<uint8_t>(Channels[Channel] < 0.0 ? 0.0 : (Channels[Channel] > 255.0 ? 255.0 : Channels[Channel] + 0.5));
+                }
+            }
+        }
+
+        // Write next to the target and rename, so a viewer reloading the file never reads half of it
+        const std::string TempPath = Path + ".tmp";
+        FILE* File = fopen(TempPath.c_str(), "wb");
+        if (!File)
+        {
+            return false;
+        }
+        fprintf(File, "P6\n%d %d\n255\n", Width, Height);
+        const bool bWritten = fwrite(Rgb.data(), 1, Rgb.size(), File) == Rgb.size();
+        fclose(File);
+        return bWritten && rename(TempPath.c_str(), Path.c_str()) == 0;
+    }
+
+    bool WriteRawFrame(const Camera2Stream::FFrameDecoder& Decoder)
+    {
+        const size_t LumaSize = static_cast<size_t>(Decoder.GetWidth()) * Decoder.GetHeight();
+        const size_t ChromaSize = static_cast<size_t>((Decoder.GetWidth() + 1) / 2) * ((Decoder.GetHeight() + 1) / 2);
+        static std::vector<uint8_t> Gray;
+        if (!Decoder.HasChroma())
+        {
+            Gray.assign(ChromaSize, 128);
+        }
+        const uint8_t* U = Decoder.HasChroma() ? Decoder.GetPlane(1) : Gray.data();
+        const uint8_t* V = Decoder.HasChroma() ? Decoder.GetPlane(2) : Gray.data();
+        return fwrite(Decoder.GetPlane(0), 1, LumaSize, stdout) == LumaSize && fwrite(U, 1, ChromaSize, stdout) == ChromaSize
+            && fwrite(V, 1, ChromaSize, stdout) == ChromaSize && fflush(stdout) == 0;
+    }
+
+    std::map<std::string, std::string> ParseStats(const std::string& Text)
+    {
+        std::map<std::string, std::string> Values;
+        size_t Start = 0;
+        while (Start < Text.size())
+        {
+            size_t End = Text.find('\n', Start);
+            End = End == std::string::npos ? Text.size() : End;
+            const size_t Equals = Text.find('=', Start);
+            if (Equals != std::string::npos && Equals < End)
+            {
+                Values[Text.substr(Start, Equals - Start)] = Text.substr(Equals + 1, End - Equals - 1);
+            }
+            Start = End + 1;
+        }
+        return Values;
+    }
+
+    int Connect(const FOptions& Options)
+    {
+        addrinfo Hints = {};
+        Hints.ai_family = AF_UNSPEC;
+        Hints.ai_socktype = SOCK_STREAM;
+        addrinfo* Addresses = nullptr;
+        const std::string Port = std::to_string(Options.Port);
+        if (getaddrinfo(Options.Host.c_str(), Port.c_str(), &Hints, &Addresses) != 0)
+        {
+            return -1;
+        }
+        int Socket = -1;
+        for (addrinfo* Address = Addresses; Address && Socket < 0; Address = Address->ai_next)
+        {
+            Socket = socket(Address->ai_family, Address->ai_socktype, Address->ai_protocol);
+            if (Socket >= 0 && connect(Socket, Address->ai_addr, Address->ai_addrlen) != 0)
+            {
+                close(Socket);
+                Socket = -1;
+            }
+        }
+        freeaddrinfo(Addresses);
+        return Socket;
+    }
+
+    int RunViewer(const FOptions& Options)
+    {
+        long FramesDecoded = 0;
+        long DecodeErrors = 0;
+        double WorstMeanError = 0.0;
+        std::vector<uint8_t> ExpectedY, ExpectedU, ExpectedV;
+        std::vector<uint8_t> Payload;
+        std::string LastStats;
+
+        while (Options.MaxFrames == 0 || FramesDecoded < Options.MaxFrames)
+        {
+            const int Socket = Connect(Options);
+            if (Socket < 0)
+            {
+                fprintf(stderr, "waiting for %s:%d ...\n", Options.Host.c_str(), Options.Port);
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                continue;
+            }
+            fprintf(stderr, "connected to %s:%d\n", Options.Host.c_str(), Options.Port);
+
+            Camera2Stream::FFrameDecoder Decoder;
+            int LastWidth = 0;
+            int LastHeight = 0;
+            double WindowStart = NowSeconds();
+            long WindowFrames = 0;
+            long WindowKeyframes = 0;
+            size_t WindowBytes = 0;
+            size_t WindowPlaneBytes = 0;
+            long WindowChangedTiles = 0;
+            long WindowTotalTiles = 0;
+            double LastSnapshot = 0.0;
+
+            uint8_t Header[Camera2Stream::MessageHeaderSize];
+            while ((Options.MaxFrames == 0 || FramesDecoded < Options.MaxFrames) && ReceiveAll(Socket, Header, sizeof(Header)))
+            {
+                Camera2Stream::EMessageType Type;
+                uint32_t PayloadSize = 0;
+                if (!Camera2Stream::ReadMessageHeader(Header, Type, PayloadSize))
+                {
+                    fprintf(stderr, "bad message header, reconnecting\n");
+                    break;
+                }
+                Payload.resize(PayloadSize);
+                if (!ReceiveAll(Socket, Payload.data(), PayloadSize))
+                {
+                    break;
+                }
+
+                if (Type == Camera2Stream::EMessageType::Stats)
+                {
+                    LastStats.assign(reinterpret_cast<const char*>(Payload.data()), PayloadSize);
+                    continue;
+                }
+                if (Type != Camera2Stream::EMessageType::Frame)
+                {
+                    continue;
+                }
+                if (!Decoder.Decode(Payload.data(), static_cast<int32_t>(PayloadSize)))
+                {
+                    // Cannot happen over TCP unless the sender is broken; wait for the next keyframe
+                    ++DecodeErrors;
+                    Decoder.Reset();
+                    continue;
+                }
+                ++FramesDecoded;
+                ++WindowFrames;
+                WindowKeyframes += Decoder.IsKeyframe() ? 1 : 0;
+                WindowBytes += Camera2Stream::MessageHeaderSize + PayloadSize;
+                const size_t LumaSize = static_cast<size_t>(Decoder.GetWidth()) * Decoder.GetHeight();
+                WindowPlaneBytes += LumaSize + (Decoder.HasChroma() ? 2 * static_cast<size_t>((Decoder.GetWidth() + 1) / 2) * ((Decoder.GetHeight() + 1) / 2) : 0);
+                WindowChangedTiles += Decoder.GetChangedTiles();
+                WindowTotalTiles += Decoder.GetTotalTiles();
+
+                if (Decoder.GetWidth() != LastWidth || Decoder.GetHeight() != LastHeight)
+                {
+                    LastWidth = Decoder.GetWidth();
+                    LastHeight = Decoder.GetHeight();
+                    fprintf(stderr, "stream %dx%d %s (yuv420p video size %dx%d)\n", LastWidth, LastHeight,
+                        Decoder.HasChroma() ? "yuv" : "luma only", LastWidth, LastHeight);
+                }
+                if (Options.bVerify)
+                {
+                    MakeTestPattern(Decoder.GetWidth(), Decoder.GetHeight(), Decoder.GetTimestampNs(), ExpectedY, ExpectedU, ExpectedV);
+                    double ErrorSum = 0.0;
+                    const uint8_t* Decoded = Decoder.GetPlane(0);
+                    for (size_t i = 0; i < LumaSize; ++i)
+                    {
+                        ErrorSum += std::abs(Decoded[i] - ExpectedY[i]);
+                    }
+                    WorstMeanError = std::max(WorstMeanError, ErrorSum / LumaSize);
+                }
+                if (Options.bRaw && !WriteRawFrame(Decoder))
+                {
+                    fprintf(stderr, "stdout closed\n");
+                    close(Socket);
+                    return 1;
+                }
+
+                const double Now = NowSeconds();
+                if (!Options.SnapshotPath.empty() && Now - LastSnapshot >= 1.0)
+                {
+                    LastSnapshot = Now;
+                    if (!WriteSnapshot(Options.SnapshotPath, Decoder))
+                    {
+                        fprintf(stderr, "could not write %s\n", Options.SnapshotPath.c_str());
+                    }
+                }
+                if (Now - WindowStart >= 1.0)
+                {
+                    const double Seconds = Now - WindowStart;
+                    std::map<std::string, std::string> Device = ParseStats(LastStats);
+                    fprintf(stderr, "%5.1f fps %7.1f kB/s ratio %5.1f changed %4.1f%% keyframes %ld | camera %s fps drops q%s s%s p%s encode %s ms\n",
+                        WindowFrames / Seconds, WindowBytes / 1024.0 / Seconds,
+                        WindowBytes ? static_cast<double>(WindowPlaneBytes) / WindowBytes : 0.0,
+                        WindowTotalTiles ? 100.0 * WindowChangedTiles / WindowTotalTiles : 0.0, WindowKeyframes,
+                        Device["camera_fps"].c_str(), Device["queue_drops"].c_str(), Device["sensor_drops"].c_str(),
+                        Device["pipeline_drops"].c_str(), Device["stream_encode_ms"].c_str());
+                    WindowStart = Now;
+                    WindowFrames = WindowKeyframes = 0;
+                    WindowBytes = WindowPlaneBytes = 0;
+                    WindowChangedTiles = WindowTotalTiles = 0;
+                }
+            }
+            close(Socket);
+            if (Options.MaxFrames == 0 || FramesDecoded < Options.MaxFrames)
+            {
+                fprintf(stderr, "disconnected\n");
+            }
+        }
+
+        fprintf(stderr, "%ld frames decoded, %ld decode errors\n", FramesDecoded, DecodeErrors);
+        if (Options.bVerify)
+        {
+            // Skipped tiles may be off by the change threshold, changed ones by the quantization step
+            const double Tolerance = Options.Encoder.ChangeThreshold + 1.0;
+            fprintf(stderr, "worst mean luma error %.3f (tolerance %.3f)\n", WorstMeanError, Tolerance);
+            return DecodeErrors == 0 && WorstMeanError <= Tolerance ? 0 : 1;
+        }
+        return DecodeErrors == 0 ? 0 : 1;
+    }
+
+    int RunTestSender(const FOptions& Options)
+    {
+        const int Listener = socket(AF_INET, SOCK_STREAM, 0);
+        const int Reuse = 1;
+        setsockopt(Listener, SOL_SOCKET, SO_REUSEADDR, &Reuse, sizeof(Reuse));
+        sockaddr_in Address = {};
+        Address.sin_family = AF_INET;
+        Address.sin_addr.s_addr = htonl(INADDR_ANY);
+        Address.sin_port = htons(static_cast<uint16_t>(Options.Port));
+        if (Listener < 0 || bind(Listener, reinterpret_cast<sockaddr*>(&Address), sizeof(Address)) != 0 || listen(Listener, 1) != 0)
+        {
+            fprintf(stderr, "could not listen on port %d\n", Options.Port);
+            return 1;
+        }
+        fprintf(stderr, "test sender %dx%d %s at %.1f fps on port %d\n", Options.Width, Options.Height,
+            Options.bLumaOnly ? "luma" : "yuv", Options.Fps, Options.Port);
+
+        std::vector<uint8_t> Y, U, V, Message;
+        long FramesSent = 0;
+        while (Options.MaxFrames == 0 || FramesSent < Options.MaxFrames)
+        {
+            const int Socket = accept(Listener, nullptr, nullptr);
+            if (Socket < 0)
+            {
+                continue;
+            }
+            const int NoDelay = 1;
+            setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, &NoDelay, sizeof(NoDelay));
+            fprintf(stderr, "viewer connected\n");
+
+            // Fresh encoder per viewer: the first frame is a keyframe
+            Camera2Stream::FFrameEncoder Encoder;
+            Encoder.SetConfig(Options.Encoder);
+            const double Start = NowSeconds();
+            double EncodeSeconds = 0.0;
+            double LastStats = 0.0;
+            bool bConnected = true;
+            for (long Frame = 0; bConnected && (Options.MaxFrames == 0 || FramesSent < Options.MaxFrames); ++Frame)
+            {
+                const double Due = Start + Frame / Options.Fps;
+                const double Wait = Due - NowSeconds();
+                if (Wait > 0.0)
+                {
+                    std::this_thread::sleep_for(std::chrono::duration<double>(Wait));
+                }
+                const int64_t TimestampNs = static_cast<int64_t>(FramesSent * 1e9 / Options.Fps);
+                MakeTestPattern(Options.Width, Options.Height, TimestampNs, Y, U, V);
+
+                Camera2Stream::FPlanes Planes;
+                Planes.Y = Y.data();
+                Planes.U = Options.bLumaOnly ? nullptr : U.data();
+                Planes.V = Options.bLumaOnly ? nullptr : V.data();
+                Planes.Width = Options.Width;
+                Planes.Height = Options.Height;
+                const double EncodeStart = NowSeconds();
+                Encoder.Encode(Planes, TimestampNs, Message);
+                EncodeSeconds += NowSeconds() - EncodeStart;
+                bConnected = SendAll(Socket, Message.data(), Message.size());
+                FramesSent += bConnected ? 1 : 0;
+
+                if (bConnected && NowSeconds() - LastStats >= 1.0)
+                {
+                    LastStats = NowSeconds();
+                    char Text[128];
+                    const int Length = snprintf(Text, sizeof(Text), "camera_fps=%.1f\nqueue_drops=0\nsensor_drops=0\npipeline_drops=0\nstream_encode_ms=%.2f\n",
+                        Options.Fps, 1000.0 * EncodeSeconds / (Frame + 1));
+                    std::vector<uint8_t> Stats(Camera2Stream::MessageHeaderSize + Length);
+                    Camera2Stream::WriteMessageHeader(Stats.data(), Camera2Stream::EMessageType::Stats, static_cast<uint32_t>(Length));
+                    memcpy(Stats.data() + Camera2Stream::MessageHeaderSize, Text, Length);
+                    bConnected = SendAll(Socket, Stats.data(), Stats.size());
+                }
+            }
+            close(Socket);
+            fprintf(stderr, "viewer gone after %ld frames in total\n", FramesSent);
+        }
+        close(Listener);
+        return 0;
+    }
+
+    void PrintUsage()
+    {
+        fprintf(stderr,
+            "camera2_viewer [--host H] [--port P] [--raw] [--snapshot file.ppm] [--frames N] [--verify-test-pattern]\n"
+            "camera2_viewer --serve [--port P] [--size WxH] [--fps F] [--luma] [--frames N]\n"
+            "               [--tile N] [--threshold T] [--quant B] [--keyframes N]\n"
+            "  --raw                  write decoded frames to stdout as yuv420p\n"
+            "  --snapshot             rewrite an RGB PPM of the latest frame once per second\n"
+            "  --frames               exit after N frames\n"
+            "  --verify-test-pattern  compare against the --serve pattern (pass the sender's --threshold)\n"
+            "  --serve                send a synthetic pattern instead of receiving\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    FOptions Options;
+    Options.Encoder.QuantizationBits = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string Argument = argv[i];
+        const bool bHasValue = i + 1 < argc;
+        if (Argument == "--host" && bHasValue)
+        {
+            Options.Host = argv[++i];
+        }
+        else if (Argument == "--port" && bHasValue)
+        {
+            Options.Port = atoi(argv[++i]);
+        }
+        else if (Argument == "--raw")
+        {
+            Options.bRaw = true;
+        }
+        else if (Argument == "--snapshot" && bHasValue)
+        {
+            Options.SnapshotPath = argv[++i];
+        }
+        else if (Argument == "--frames" && bHasValue)
+        {
+            Options.MaxFrames = atol(argv[++i]);
+        }
+        else if (Argument == "--verify-test-pattern")
+        {
+            Options.bVerify = true;
+        }
+        else if (Argument == "--serve")
+        {
+            Options.bServe = true;
+        }
+        else if (Argument == "--size" && bHasValue && sscanf(argv[i + 1], "%dx%d", &Options.Width, &Options.Height) == 2)
+        {
+            ++i;
+        }
+        else if (Argument == "--fps" && bHasValue)
+        {
+            Options.Fps = atof(argv[++i]);
+        }
+        else if (Argument == "--luma")
+        {
+            Options.bLumaOnly = true;
+        }
+        else if (Argument == "--tile" && bHasValue)
+        {
+            Options.Encoder.TileSize = atoi(argv[++i]);
+        }
+        else if (Argument == "--threshold" && bHasValue)
+        {
+            Options.Encoder.ChangeThreshold = static_cast<float>(atof(argv[++i]));
+        }
+        else if (Argument == "--quant" && bHasValue)
+        {
+            Options.Encoder.QuantizationBits = atoi(argv[++i]);
+        }
+        else if (Argument == "--keyframes" && bHasValue)
+        {
+            Options.Encoder.KeyframeInterval = atoi(argv[++i]);
+        }
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (Options.Width <= 0 || Options.Height <= 0 || Options.Fps <= 0.0 || Options.Port <= 0 || Options.Port > 65535)
+    {
+        PrintUsage();
+        return 2;
+    }
+    return Options.bServe ? RunTestSender(Options) : RunViewer(Options);
+}